@@ -0,0 +1,204 @@
+// Define the STATSAUTOCORRELATION_H macro to act as an include guard
+#ifndef STATSAUTOCORRELATION_H
+#define STATSAUTOCORRELATION_H
+
+/* This header file declares C++-only language constructs. It must never be
+ * included by C code.
+ */
+
+// Include the <stddef.h> header to provide the size_t type.
+#include <stddef.h>
+
+// Include the <vector> header to provide the STL std::vector type.
+#include <vector>
+
+/* Include StatsCalculator.h to provide the definition of the
+ * StatsAutocorrelationResult structure.
+ */
+#include "StatsCalculator.h"
+
+/** \class StatsFourierTransform
+ * The StatsFourierTransform class computes discrete Fourier transforms of a
+ * fixed power-of-two size with the iterative radix-2 Cooley-Tukey algorithm.
+ *
+ * The real and imaginary parts are held in separate arrays, so the butterflies
+ * of each stage operate on contiguous runs of doubles that the compiler can
+ * process with vector instructions. The twiddle factors of every stage are
+ * computed once, when the instance is constructed, and are also stored stage
+ * by stage so that they too are read contiguously.
+ */
+class StatsFourierTransform {
+
+    /** \brief The number of points in each transform.
+     */
+    size_t size;
+
+    /** \brief The real parts of the twiddle factors. The factors of the stage
+     * that combines transforms of h points start at element h.
+     */
+    std::vector<double> twiddleReal;
+
+    /** \brief The imaginary parts of the twiddle factors, stored like "twiddleReal".
+     */
+    std::vector<double> twiddleImaginary;
+
+public:
+
+    /** \brief Constructor.
+     *
+     * \param size - The number of points in each transform, which must be a
+     * power of two.
+     */
+    explicit StatsFourierTransform(size_t size);
+
+    /** \brief Public method that returns the number of points in each transform.
+     */
+    size_t getSize() const;
+
+    /** \brief Public method that replaces an array of complex values by its
+     * discrete Fourier transform, \f$X_f = \sum_j x_j e^{-2\pi i jf/N}\f$.
+     *
+     * \param real - The "size" real parts.
+     * \param imaginary - The "size" imaginary parts.
+     */
+    void forward(double * real, double * imaginary) const;
+
+    /** \brief Public method that replaces an array of complex values by its
+     * inverse discrete Fourier transform, including the factor of 1/N.
+     *
+     * \param real - The "size" real parts.
+     * \param imaginary - The "size" imaginary parts.
+     */
+    void inverse(double * real, double * imaginary) const;
+
+};
+
+/** \class StatsAutocorrelation
+ * The StatsAutocorrelation class analyses a series of values that were sampled
+ * in order (a TIME SERIES), whose successive values may be correlated. The
+ * standard error of the mean of n correlated values is larger than the familiar
+ * \f$\sigma/\sqrt{n}\f$, by the square root of the INTEGRATED AUTOCORRELATION
+ * TIME \f$\tau = 1 + 2\sum_{t \geq 1} \rho(t)\f$, where \f$\rho(t)\f$ is the
+ * autocorrelation at lag t. The series is then worth \f$n/\tau\f$ independent
+ * values: its EFFECTIVE SAMPLE SIZE.
+ *
+ * The autocovariance is computed through fast Fourier transforms. Only the lags
+ * below some maximum L are needed, so the series is divided into segments of
+ * L values (rounded up to a power of two) and the products of each segment
+ * with itself and with the following segment are accumulated in the frequency
+ * domain, using transforms of 2L points. The cost is proportional to
+ * \f$n \log L\f$ and the memory to L, so series of 10^8 values can be analysed.
+ * Two real segments are transformed together as the real and imaginary parts
+ * of one complex transform, and the segments are shared between the calling
+ * thread and the threads of StatsCalculatorWorkerPool::shared().
+ *
+ * The sum in \f$\tau\f$ is truncated with the automatic window of Sokal: at the
+ * smallest lag W for which \f$W \geq c\tau(W)\f$, where c is the "window
+ * factor". The standard error is also estimated independently by the BLOCKING
+ * method of Flyvbjerg and Petersen, which repeatedly averages neighbouring
+ * pairs of values and recomputes the naive standard error of the averages; it
+ * rises until the blocks are longer than the correlations, and then levels off.
+ */
+class StatsAutocorrelation {
+
+    /** \brief The maximum number of threads that may share each analysis, or zero
+     * to use one per thread of the shared worker pool.
+     */
+    unsigned threadCount;
+
+    /** \brief The factor c of Sokal's automatic window.
+     */
+    double windowFactor;
+
+public:
+
+    /** \brief The number of segments that are transformed by each parallel task.
+     * It must be even.
+     */
+    static const size_t segmentsPerTask = 256;
+
+    /** \brief The smallest number of lags whose autocovariances are computed
+     * when searching for the window.
+     */
+    static const size_t initialLagCount = 1024;
+
+    /** \brief The base-2 logarithm of the number of values in each chunk of the
+     * series that is blocked by a parallel task.
+     */
+    static const unsigned chunkLevels = 16;
+
+    /** \brief The smallest number of blocks whose standard error is trusted when
+     * looking for the plateau of the blocking estimates.
+     */
+    static const long long minimumBlocks = 32;
+
+    /** \brief Default constructor. The window factor is five.
+     */
+    StatsAutocorrelation();
+
+    /** \brief Public method that sets the maximum number of threads that may share
+     * each analysis. One performs every analysis on the calling thread; zero (the
+     * default) allows as many threads as there are in StatsCalculatorWorkerPool::shared().
+     */
+    void setThreadCount(unsigned threads);
+
+    /** \brief Public method that sets the factor c of Sokal's automatic window.
+     * Values between four and ten are usual.
+     *
+     * \return True on success, or false (and no change) if the factor is not positive.
+     */
+    bool setWindowFactor(double factor);
+
+    /** \brief Public method that returns the factor c of Sokal's automatic window.
+     */
+    double getWindowFactor() const;
+
+    /** \brief Public method that computes the autocovariances of a series,
+     * \f$C(t) = \frac{1}{n}\sum_{j=0}^{n-1-t}(x_j - \mu)(x_{j+t} - \mu)\f$.
+     *
+     * \param values - A pointer to the first of the values, which must be finite.
+     * \param count - The number of values.
+     * \param mean - The mean, \f$\mu\f$, about which the covariances are computed.
+     * \param lagCount - The number of lags, starting from zero.
+     * \param autocovariances - Space for "lagCount" autocovariances. Those at lags
+     * of "count" or more are zero.
+     */
+    void computeAutocovariances(const double * values, size_t count, double mean, size_t lagCount,
+                                double * autocovariances) const;
+
+    /** \brief Public method that computes the autocorrelations of a series,
+     * \f$\rho(t) = C(t)/C(0)\f$, about its mean.
+     *
+     * \param values - A pointer to the first of the values, which must be finite.
+     * \param count - The number of values.
+     * \param lagCount - The number of lags, starting from zero.
+     * \param autocorrelations - Space for "lagCount" autocorrelations. If the
+     * values are all equal, the autocorrelation at lag zero is one and the
+     * others are zero.
+     */
+    void computeAutocorrelations(const double * values, size_t count, size_t lagCount,
+                                 double * autocorrelations) const;
+
+    /** \brief Public method that computes the blocking estimates of the standard
+     * error of the mean.
+     *
+     * \param values - A pointer to the first of the values, which must be finite.
+     * \param count - The number of values.
+     * \param standardErrors - Receives one estimate for each block length
+     * \f$2^k\f$ for which there are at least two blocks, starting from k = 0
+     * (which is the naive standard error).
+     */
+    void computeBlockingErrors(const double * values, size_t count, std::vector<double> & standardErrors) const;
+
+    /** \brief Public method that computes every statistic of the analysis.
+     *
+     * \param values - A pointer to the first of the values, which must be finite.
+     * \param count - The number of values.
+     * \param result - A StatsAutocorrelationResult structure that is filled with
+     * the statistics. If there are no values, every statistic is zero.
+     */
+    void analyze(const double * values, size_t count, StatsAutocorrelationResult & result) const;
+
+};
+
+#endif /* End #ifndef STATSAUTOCORRELATION_H preprocessor conditional block. */
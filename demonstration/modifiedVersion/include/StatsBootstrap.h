@@ -0,0 +1,225 @@
+// Define the STATSBOOTSTRAP_H macro to act as an include guard
+#ifndef STATSBOOTSTRAP_H
+#define STATSBOOTSTRAP_H
+
+/* This header file declares C++-only language constructs. It must never be
+ * included by C code.
+ */
+
+// Include the <stddef.h> header to provide the size_t type.
+#include <stddef.h>
+
+// Include the <cstdint> header to provide the std::uint32_t and std::uint64_t types.
+#include <cstdint>
+
+/* Include StatsCalculator.h to provide the definition of the StatsBootstrapResult
+ * structure.
+ */
+#include "StatsCalculator.h"
+
+/** \class StatsPhiloxGenerator
+ * The StatsPhiloxGenerator class generates pseudo-random numbers with the
+ * COUNTER-BASED Philox4x32-10 algorithm of Salmon et al. ("Parallel random
+ * numbers: as easy as 1, 2, 3", 2011). Each block of four 32-bit outputs is a
+ * keyed bijection of a 128-bit counter, so there is no state to advance: any
+ * block of any stream can be computed directly, and streams that differ only in
+ * their counters are statistically independent.
+ *
+ * The key is the seed. The upper half of the counter is the STREAM number and
+ * the lower half numbers the blocks within the stream. Giving each independent
+ * task (e.g. each bootstrap resample) its own stream makes the numbers that it
+ * draws depend only on the seed and the task, and not on which thread executes
+ * it or in which order.
+ */
+class StatsPhiloxGenerator {
+
+    /** \brief The key of the bijection, which is the seed.
+     */
+    std::uint32_t key[2];
+
+    /** \brief The counter of the next block: the block number in elements 0 and 1
+     * and the stream number in elements 2 and 3.
+     */
+    std::uint32_t counter[4];
+
+    /** \brief The most recently generated block of outputs.
+     */
+    std::uint32_t outputs[4];
+
+    /** \brief The number of elements of "outputs" that have been returned.
+     */
+    unsigned outputsUsed;
+
+public:
+
+    /** \brief Constructor that positions the generator at the start of a stream.
+     *
+     * \param seed - The seed, which selects the bijection.
+     * \param stream - The stream number.
+     */
+    StatsPhiloxGenerator(std::uint64_t seed, std::uint64_t stream);
+
+    /** \brief Public static method that applies the Philox4x32-10 bijection.
+     *
+     * \param counter - The four words of the counter.
+     * \param key - The two words of the key.
+     * \param outputs - Space for the four words of output.
+     */
+    static void generateBlock(const std::uint32_t counter[4], const std::uint32_t key[2],
+                              std::uint32_t outputs[4]);
+
+    /** \brief Public method that generates the next blocks of the stream in a
+     * single batch, which is considerably faster than generating them one at a
+     * time because the rounds of several blocks are computed together.
+     *
+     * \param words - Space for 4*blockCount words.
+     * \param blockCount - The number of blocks.
+     */
+    void generateBlocks(std::uint32_t * words, size_t blockCount);
+
+    /** \brief Public method that returns the next uniformly distributed 32-bit word.
+     */
+    std::uint32_t nextWord();
+
+    /** \brief Public method that returns a uniformly distributed double in [0, 1),
+     * built from 53 random bits.
+     */
+    double nextDouble();
+
+    /** \brief Public method that returns an integer uniformly distributed in
+     * [0, bound), without bias.
+     *
+     * \param bound - The number of possible results, which must not be zero.
+     */
+    std::uint32_t nextBelow(std::uint32_t bound);
+
+    /** \brief Public method that returns a binomially distributed integer: the
+     * number of successes in a number of independent trials.
+     *
+     * \param trials - The number of trials.
+     * \param probability - The probability of success in each trial.
+     */
+    std::uint64_t nextBinomial(std::uint64_t trials, double probability);
+
+};
+
+/** \class StatsBootstrap
+ * The StatsBootstrap class computes BOOTSTRAP confidence intervals for the mean
+ * and the (population) standard deviation of an array of values, by computing
+ * the statistics of many RESAMPLES, each formed by drawing as many values as
+ * there are in the array, with replacement.
+ *
+ * A resample is never materialized. Drawing n values with replacement from n
+ * is equivalent to choosing how many times each value is drawn, and those
+ * counts follow a multinomial distribution. The array is divided into blocks
+ * of "blockValues": the number of draws that land in each block is a binomial
+ * variate (given the draws that landed in the blocks before it), and those
+ * draws are then scattered over the block by incrementing a small array of
+ * counts that stays in the processor cache. The statistics of the resample are
+ * the count-weighted sums over the block, so each resample reads the values
+ * once, in order, and writes nothing but the counts.
+ *
+ * Resamples are independent, so they are shared between the calling thread and
+ * the threads of StatsCalculatorWorkerPool::shared(). Resample r draws its
+ * random numbers from stream r of a StatsPhiloxGenerator, so the intervals
+ * depend only on the values, the options and the seed, and are reproducible
+ * whatever the number of threads.
+ */
+class StatsBootstrap {
+
+    /** \brief The number of resamples.
+     */
+    unsigned resampleCount;
+
+    /** \brief The probability that an interval covers the statistic, e.g. 0.95.
+     */
+    double confidenceLevel;
+
+    /** \brief The seed of the random number generator.
+     */
+    std::uint64_t seed;
+
+    /** \brief The maximum number of threads that may share the resamples, or zero
+     * to use one per thread of the shared worker pool.
+     */
+    unsigned threadCount;
+
+public:
+
+    /** \brief The number of values in each block whose draws are counted together.
+     * It must not exceed 65536, because each draw uses 16 random bits.
+     */
+    static const size_t blockValues = 4096;
+
+    /** \brief The number of resamples that are computed by each parallel task.
+     */
+    static const unsigned resamplesPerTask = 16;
+
+    /** \brief Constructor.
+     *
+     * \param resampleCount - The number of resamples, which must not be zero.
+     * \param confidenceLevel - The confidence level, between zero and one.
+     * \param seed - The seed of the random number generator.
+     */
+    explicit StatsBootstrap(unsigned resampleCount = 2000, double confidenceLevel = 0.95,
+                            std::uint64_t seed = 0);
+
+    /** \brief Public method that sets the number of resamples.
+     *
+     * \return True on success, or false (and no change) if resampleCount is zero.
+     */
+    bool setResampleCount(unsigned resampleCount);
+
+    /** \brief Public method that returns the number of resamples.
+     */
+    unsigned getResampleCount() const;
+
+    /** \brief Public method that sets the confidence level.
+     *
+     * \return True on success, or false (and no change) if the level is not
+     * strictly between zero and one.
+     */
+    bool setConfidenceLevel(double confidenceLevel);
+
+    /** \brief Public method that returns the confidence level.
+     */
+    double getConfidenceLevel() const;
+
+    /** \brief Public method that sets the seed of the random number generator.
+     */
+    void setSeed(std::uint64_t seed);
+
+    /** \brief Public method that returns the seed of the random number generator.
+     */
+    std::uint64_t getSeed() const;
+
+    /** \brief Public method that sets the maximum number of threads that may share
+     * the resamples. One computes every resample on the calling thread; zero (the
+     * default) allows as many threads as there are in StatsCalculatorWorkerPool::shared().
+     */
+    void setThreadCount(unsigned threads);
+
+    /** \brief Public method that computes the mean and the standard deviation of
+     * every resample.
+     *
+     * \param values - A pointer to the first of the values, which must be finite.
+     * \param count - The number of values, which must not be zero.
+     * \param means - Space for "resampleCount" means.
+     * \param standardDeviations - Space for "resampleCount" (population) standard
+     * deviations.
+     */
+    void resample(const double * values, size_t count, double * means, double * standardDeviations) const;
+
+    /** \brief Public method that computes percentile confidence intervals and
+     * standard errors for the mean and the standard deviation.
+     *
+     * \param values - A pointer to the first of the values, which must be finite.
+     * \param count - The number of values.
+     * \param result - A StatsBootstrapResult structure that is filled with the
+     * intervals. If there are no values, every interval is zero.
+     */
+    void computeIntervals(const double * values, size_t count, StatsBootstrapResult & result) const;
+
+};
+
+#endif /* End #ifndef STATSBOOTSTRAP_H preprocessor conditional block. */
@@ -5,6 +5,365 @@
 // Include StatsCalculatorLabView.h to provide preprocessor macros
 #include "StatsCalculatorLabView.h"
 
+/* Include <stddef.h> to provide the size_t type, which is used by both the C++
+ * class and the C API to express the lengths of arrays.
+ */
+#include <stddef.h>
+
+/** \brief Status codes that are returned by those C API functions that can
+ * fail. Zero always indicates success.
+ */
+enum StatsCalcStatus {
+    /// The operation succeeded.
+    STATSCALC_OK = 0,
+    /// The handle does not refer to a live StatsCalculator instance.
+    STATSCALC_INVALID_HANDLE = 1,
+    /// A required pointer argument was null.
+    STATSCALC_NULL_ARGUMENT = 2,
+    /// The instance contains no values, so the statistics are all zero.
+    STATSCALC_NO_DATA = 3,
+    /// An asynchronous operation on the instance has not yet completed.
+    STATSCALC_BUSY = 4,
+    /// A file could not be opened.
+    STATSCALC_FILE_ERROR = 5,
+    /// An argument was outside the range of values that the function accepts.
+    STATSCALC_INVALID_ARGUMENT = 6,
+    /// The request is not one that is recognized, such as a server message of an unknown type.
+    STATSCALC_UNSUPPORTED = 7,
+    /// The request would exceed a resource limit, such as the number of datasets a server holds.
+    STATSCALC_LIMIT_REACHED = 8
+};
+
+/** \brief Policies that determine how StatsCalculator::ingestFile() treats a
+ * MALFORMED token, i.e. one that is not a decimal number (such as a column
+ * header or the string "nan").
+ */
+enum StatsCalcParsePolicy {
+    /// Malformed tokens are counted and skipped. This is the default.
+    STATSCALC_PARSE_SKIP = 0,
+    /// Malformed tokens are counted and recorded as NaN (not-a-number) values.
+    STATSCALC_PARSE_NAN = 1,
+    /// Parsing stops at the first malformed token. The values before it are kept.
+    STATSCALC_PARSE_STOP = 2
+};
+
+/** \brief Modes that determine whether NaN (not-a-number) and infinite values
+ * contribute to the statistics. In the modes that discard values, the count in
+ * a StatsResult is the number of values that were NOT discarded.
+ */
+enum StatsCalcNonFiniteMode {
+    /// Every value is included, so a single NaN makes the sum, mean and standard deviation NaN. This is the default.
+    STATSCALC_NONFINITE_INCLUDE = 0,
+    /// NaN values are discarded (the "nan-sum", "nan-mean" and "nan-std" of other packages).
+    STATSCALC_NONFINITE_SKIP_NAN = 1,
+    /// NaN, positive infinite and negative infinite values are all discarded.
+    STATSCALC_NONFINITE_SKIP_ALL = 2
+};
+
+/** \struct StatsResult
+ * A plain structure holding every statistic that StatsCalculator computes.
+ * It is declared using only C-compatible constructs so that C callers can
+ * allocate one and have it filled by statsCalcGetAll().
+ */
+typedef struct StatsResult {
+    /// The number of values that the statistics were computed over.
+    long long count;
+    /// The sum of the values.
+    double sum;
+    /// The mean of the values.
+    double mean;
+    /// The (population) standard deviation of the values.
+    double standardDeviation;
+    /// The smallest value.
+    double minimum;
+    /// The largest value.
+    double maximum;
+} StatsResult;
+
+/** \brief The meanings that the second column of a two-column file can have
+ * (see StatsCalculator::ingestWeightedFile()).
+ */
+enum StatsCalcWeightColumn {
+    /// The second column holds the weight of each value.
+    STATSCALC_WEIGHT_COLUMN_WEIGHTS = 0,
+    /// The second column holds the uncertainty (standard error) of each value, whose weight is its inverse square.
+    STATSCALC_WEIGHT_COLUMN_UNCERTAINTIES = 1
+};
+
+/** \brief The methods with which StatsCalculator can watch the values that are
+ * appended, parsed or streamed for a shift in their mean (see
+ * StatsCalculator::setChangeDetection()).
+ */
+enum StatsCalcChangeMethod {
+    /// No change detection. This is the default.
+    STATSCALC_CHANGE_NONE = 0,
+    /// Page's two-sided CUSUM test, about the mean of the warm-up values.
+    STATSCALC_CHANGE_CUSUM = 1,
+    /// The two-sided Page-Hinkley test, about the running mean of the values.
+    STATSCALC_CHANGE_PAGE_HINKLEY = 2
+};
+
+/** \struct StatsWeightedResult
+ * A plain structure holding the weighted statistics that StatsCalculator
+ * computes for values that were appended with weights. It is declared using
+ * only C-compatible constructs so that C callers can have it filled by
+ * statsCalcGetWeighted().
+ *
+ * Two unbiased variances are provided, because the correction depends on what
+ * the weights mean. FREQUENCY weights count repeated observations, so the total
+ * weight W is the sample size and the variance is \f$M_{2}/(W-1)\f$. RELIABILITY
+ * weights (e.g. inverse variances) only express relative confidence, and the
+ * variance is \f$M_{2}/(W - \sum w^{2}/W)\f$.
+ */
+typedef struct StatsWeightedResult {
+    /// The number of values that had usable (positive and finite) weights.
+    long long count;
+    /// The sum of the weights.
+    double sumOfWeights;
+    /// The sum of the products of the values and their weights.
+    double weightedSum;
+    /// The weighted mean of the values.
+    double weightedMean;
+    /// The weighted (population) variance, i.e. the weighted mean squared deviation.
+    double populationVariance;
+    /// The unbiased weighted variance for frequency weights.
+    double frequencyVariance;
+    /// The unbiased weighted variance for reliability weights.
+    double reliabilityVariance;
+} StatsWeightedResult;
+
+/** \struct StatsBivariateResult
+ * A plain structure holding the statistics of pairs of values (x, y) from two
+ * channels, including the least-squares line \f$y = a + bx\f$. It is declared
+ * using only C-compatible constructs so that C callers can have it filled by
+ * statsCalcGetBivariate().
+ */
+typedef struct StatsBivariateResult {
+    /// The number of pairs.
+    long long count;
+    /// The mean of the first channel.
+    double meanX;
+    /// The mean of the second channel.
+    double meanY;
+    /// The (population) standard deviation of the first channel.
+    double standardDeviationX;
+    /// The (population) standard deviation of the second channel.
+    double standardDeviationY;
+    /// The (population) covariance of the channels.
+    double covariance;
+    /// The unbiased (sample) covariance of the channels.
+    double sampleCovariance;
+    /// Pearson's correlation coefficient, or zero if either channel is constant.
+    double correlation;
+    /// The slope, b, of the least-squares line, or zero if the first channel is constant.
+    double slope;
+    /// The intercept, a, of the least-squares line.
+    double intercept;
+} StatsBivariateResult;
+
+/** \struct StatsRobustResult
+ * A plain structure holding statistics that are insensitive to outliers. It is
+ * declared using only C-compatible constructs so that C callers can have it
+ * filled by statsCalcGetRobust().
+ *
+ * The trimmed and winsorized statistics discard (or, respectively, clamp) the
+ * \f$k = \lfloor fn \rfloor\f$ smallest and k largest of the n values, where f
+ * is the trim fraction.
+ */
+typedef struct StatsRobustResult {
+    /// The number of values that the statistics were computed over.
+    long long count;
+    /// The fraction of the values that was trimmed (or winsorized) from EACH end.
+    double trimFraction;
+    /// The median of the values.
+    double median;
+    /// The median of the absolute deviations of the values from their median (unscaled).
+    double medianAbsoluteDeviation;
+    /// The mean of the values that remain after trimming.
+    double trimmedMean;
+    /// The mean of the values after the trimmed ones are replaced by the nearest remaining value.
+    double winsorizedMean;
+    /// The (population) variance of the winsorized values.
+    double winsorizedVariance;
+    /// Non-zero if the statistics were estimated from a quantile sketch rather than computed exactly.
+    int approximate;
+} StatsRobustResult;
+
+/** \struct StatsBootstrapResult
+ * A plain structure holding bootstrap confidence intervals for the mean and the
+ * (population) standard deviation. It is declared using only C-compatible
+ * constructs so that C callers can have it filled by statsCalcGetBootstrap().
+ *
+ * The intervals are percentile intervals: their ends are the quantiles of the
+ * statistic over many resamples of the values, drawn with replacement.
+ */
+typedef struct StatsBootstrapResult {
+    /// The number of values that were resampled.
+    long long count;
+    /// The number of resamples.
+    long long resampleCount;
+    /// The probability that each interval covers the statistic, e.g. 0.95.
+    double confidenceLevel;
+    /// The lower end of the confidence interval for the mean.
+    double meanLower;
+    /// The upper end of the confidence interval for the mean.
+    double meanUpper;
+    /// The bootstrap estimate of the standard error of the mean.
+    double meanStandardError;
+    /// The lower end of the confidence interval for the standard deviation.
+    double standardDeviationLower;
+    /// The upper end of the confidence interval for the standard deviation.
+    double standardDeviationUpper;
+    /// The bootstrap estimate of the standard error of the standard deviation.
+    double standardDeviationStandardError;
+} StatsBootstrapResult;
+
+/** \struct StatsAutocorrelationResult
+ * A plain structure holding the statistics of a series of values whose order
+ * matters, such as a time series, whose successive values may be correlated.
+ * It is declared using only C-compatible constructs so that C callers can have
+ * it filled by statsCalcGetAutocorrelationStatistics().
+ */
+typedef struct StatsAutocorrelationResult {
+    /// The number of values in the series.
+    long long count;
+    /// The mean of the values.
+    double mean;
+    /// The (population) variance of the values.
+    double variance;
+    /// The integrated autocorrelation time, 1 + 2 times the sum of the autocorrelations up to the window.
+    double integratedAutocorrelationTime;
+    /// The lag at which the sum of the autocorrelations was truncated.
+    long long window;
+    /// Non-zero if the window satisfied Sokal's criterion, zero if the sum was truncated at the last lag.
+    int windowConverged;
+    /// The number of independent values that the series is worth, count divided by the integrated autocorrelation time.
+    double effectiveSampleSize;
+    /// The standard error of the mean if the values were independent, sqrt(variance/(count - 1)).
+    double naiveStandardError;
+    /// The standard error of the mean, corrected by the integrated autocorrelation time.
+    double standardErrorOfMean;
+    /// The standard error of the mean estimated by blocking.
+    double blockingStandardError;
+    /// The base-2 logarithm of the length of the blocks from which "blockingStandardError" was estimated.
+    int blockingLevel;
+    /// Non-zero if the blocking estimates reached a plateau, zero if the last trusted estimate was used.
+    int blockingConverged;
+} StatsAutocorrelationResult;
+
+/** \struct StatsHeavyHitter
+ * A plain structure describing one of the most frequent values, as estimated by
+ * a frequency sketch. It is declared using only C-compatible constructs so that
+ * C callers can have an array of them filled by statsCalcGetHeavyHitters().
+ *
+ * The estimated count never underestimates the true number of occurrences, and
+ * overestimates it by at most "error".
+ */
+typedef struct StatsHeavyHitter {
+    /// The value.
+    double value;
+    /// An upper bound on the number of times the value occurred.
+    long long count;
+    /// The largest possible overestimate: the value occurred at least count - error times.
+    long long error;
+} StatsHeavyHitter;
+
+/** \struct StatsTimeBucket
+ * A plain structure describing the values whose timestamps fell within one
+ * interval of time (a "bucket"), as accumulated by a time rollup. It is
+ * declared using only C-compatible constructs so that C callers can have an
+ * array of them filled by statsCalcTakeTimeBuckets().
+ *
+ * Buckets of the same width can be combined exactly, e.g. by merging their
+ * statistics with RunningStatistics::merge().
+ */
+typedef struct StatsTimeBucket {
+    /// The start of the bucket, a multiple of its width, in the units of the timestamps.
+    double start;
+    /// The width of the bucket, in the units of the timestamps.
+    double width;
+    /// The statistics of the values in the bucket.
+    StatsResult statistics;
+} StatsTimeBucket;
+
+/** \struct StatsChangePoint
+ * A plain structure describing a shift in the mean of a stream of values, as
+ * detected by a change detector. It is declared using only C-compatible
+ * constructs so that C callers can obtain it with statsCalcTakeChangePoint()
+ * or receive it through a StatsCalcChangeCallback.
+ *
+ * Positions count the values examined by the detector, starting from one when
+ * it was configured. Values that are not finite are not examined.
+ */
+typedef struct StatsChangePoint {
+    /// The position of the value at which the change was detected.
+    long long detectedAt;
+    /// The estimated position of the first value after the change.
+    long long changedAt;
+    /// +1 if the mean increased, -1 if it decreased.
+    int direction;
+    /// The mean of the values examined since the detector (re)started, before the change.
+    double meanBefore;
+    /// The mean of the values from the change to its detection.
+    double meanAfter;
+} StatsChangePoint;
+
+/** \brief The type of a function that is called when a change detector detects
+ * a shift in the mean (see statsCalcSetChangeCallback()).
+ *
+ * \param change - The change that was detected, which is only valid during the call.
+ * \param userData - The pointer that was given when the function was registered.
+ */
+typedef void (*StatsCalcChangeCallback)(const StatsChangePoint * change, void * userData);
+
+/** \struct StatsSnapshot
+ * A plain structure holding a snapshot of the statistics of a StatsCalculator
+ * instance, as delivered to a subscriber (see statsCalcSubscribe()). It is
+ * declared using only C-compatible constructs so that C callers can receive it
+ * through a StatsCalcSnapshotCallback.
+ */
+typedef struct StatsSnapshot {
+    /// The number of the snapshot, counting from one when the subscription was made. Gaps show that snapshots were coalesced.
+    long long sequence;
+    /// The time at which the snapshot was taken, in seconds since the subscription was made.
+    double elapsedSeconds;
+    /// The statistics of every value at the time the snapshot was taken.
+    StatsResult statistics;
+} StatsSnapshot;
+
+/** \brief The type of a function that receives snapshots of the statistics of a
+ * StatsCalculator instance (see statsCalcSubscribe()).
+ *
+ * \param snapshot - The snapshot, which is only valid during the call.
+ * \param userData - The pointer that was given when the function was registered.
+ */
+typedef void (*StatsCalcSnapshotCallback)(const StatsSnapshot * snapshot, void * userData);
+
+/** \brief An opaque type through which any thread can read the statistics of a
+ * StatsCalculator instance while another thread appends values to it (see
+ * statsCalcGetLiveStatistics() and statsCalcReadLiveStatistics()). It is
+ * defined for C++ callers only.
+ */
+typedef struct StatsLiveStatistics StatsLiveStatistics;
+
+/** \struct StatsParseReport
+ * A plain structure that describes the outcome of the most recent file parse,
+ * declared using only C-compatible constructs so that C callers can obtain it
+ * with statsCalcGetParseReport().
+ */
+typedef struct StatsParseReport {
+    /// The number of values that were parsed successfully.
+    long long valuesParsed;
+    /// The number of malformed tokens that were encountered.
+    long long malformedTokens;
+    /// The line (counting from 1) on which the first malformed token appeared, or 0 if there were none.
+    long long firstErrorLine;
+    /// The offset in bytes of the first malformed token from the start of the file, or -1 if there were none.
+    long long firstErrorOffset;
+    /// Non-zero if parsing stopped at a malformed token because the policy was STATSCALC_PARSE_STOP.
+    int stoppedEarly;
+} StatsParseReport;
+
 /* This header file may be parsed by a C compiler. If this happens, any 
  * C++-only language constructs (e.g. class definitions or references to 
  * std::string or std::vector) in the code will cause the compilation to 
@@ -24,6 +383,601 @@
 // Include the <string> header to provide the STL std::vector type.
 #include <string>
 
+// Include the <atomic> header to provide the STL std::atomic type.
+#include <atomic>
+
+// Include the <memory> header to provide the STL std::shared_ptr and std::unique_ptr types.
+#include <memory>
+
+/* The StatsObserver class is declared in "StatsObserver.h". Only pointers to it
+ * are needed here, so it is declared rather than defined.
+ */
+class StatsObserver;
+
+/* The IncrementalIngest structure is private to "StatsCalculator.cpp". Only
+ * pointers to it are needed here, so it is declared rather than defined.
+ */
+struct IncrementalIngest;
+
+/** \struct IngestProgress
+ * A structure through which StatsCalculator::ingestFile() reports its progress
+ * while it runs. The members are atomic so that another thread can read them
+ * safely while the file is being parsed.
+ */
+struct IngestProgress {
+    /// The number of bytes of the file that have been parsed so far.
+    std::atomic<long long> bytesConsumed;
+    /// The total size of the file in bytes, or zero if it is not yet known.
+    std::atomic<long long> bytesTotal;
+    
+    /// Default constructor zero-initializes both counters.
+    IngestProgress() : bytesConsumed(0), bytesTotal(0) {}
+};
+
+/** \struct ParseErrorLocation
+ * The position of a malformed token within a file that was parsed by
+ * StatsCalculator::ingestFile().
+ */
+struct ParseErrorLocation {
+    /// The line (counting from 1) on which the token appeared.
+    long long line;
+    /// The offset in bytes of the first character of the token from the start of the file.
+    long long offset;
+};
+
+/** \struct RunningStatistics
+ * A compact accumulator from which every statistic in a StatsResult can be
+ * obtained without storing the values it summarizes. Values can be added one at
+ * a time (using Welford's update) and accumulators can be merged (using Chan's
+ * pairwise formula), so partial results from separate batches or threads can be
+ * combined exactly.
+ */
+struct RunningStatistics {
+    /// The number of values that have been accumulated.
+    long long count;
+    /// The sum of the accumulated values.
+    double sum;
+    /// The mean of the accumulated values.
+    double mean;
+    /// The sum of squared deviations of the accumulated values from "mean".
+    double sumOfSquaredDeviations;
+    /// The smallest accumulated value.
+    double minimum;
+    /// The largest accumulated value.
+    double maximum;
+    
+    /// Default constructor creates an empty accumulator.
+    RunningStatistics();
+    
+    /// Accumulate a single value.
+    void add(double value);
+    
+    /// Accumulate every value summarized by another accumulator.
+    void merge(const RunningStatistics & other);
+    
+    /// Accumulate every value summarized by a StatsResult.
+    void merge(const StatsResult & other);
+    
+    /// Fill a StatsResult with the statistics of the accumulated values.
+    void fill(StatsResult & result) const;
+};
+
+/** \struct WeightedRunningStatistics
+ * The weighted counterpart of RunningStatistics. Weighted values can be added
+ * one at a time (using West's weighted form of Welford's update) and
+ * accumulators can be merged exactly.
+ */
+struct WeightedRunningStatistics {
+    /// The number of values that have been accumulated.
+    long long count;
+    /// The sum of the weights.
+    double sumOfWeights;
+    /// The sum of the squared weights, which is needed by the reliability-weighted variance.
+    double sumOfSquaredWeights;
+    /// The sum of the products of the values and their weights.
+    double weightedSum;
+    /// The weighted mean of the accumulated values.
+    double mean;
+    /// The weighted sum of squared deviations of the accumulated values from "mean".
+    double sumOfSquaredDeviations;
+    
+    /// Default constructor creates an empty accumulator.
+    WeightedRunningStatistics();
+    
+    /// Returns true if a weight is positive and finite. Values with other weights are ignored.
+    static bool isUsableWeight(double weight);
+    
+    /// Accumulate a single weighted value.
+    void add(double value, double weight);
+    
+    /// Accumulate every weighted value summarized by another accumulator.
+    void merge(const WeightedRunningStatistics & other);
+    
+    /// Fill a StatsWeightedResult with the statistics of the accumulated values.
+    void fill(StatsWeightedResult & result) const;
+};
+
+/** \struct BivariateRunningStatistics
+ * An accumulator for pairs of values from two channels, from which every
+ * statistic in a StatsBivariateResult can be obtained. Pairs can be added one
+ * at a time (using the bivariate "co-moment" form of Welford's update) and
+ * accumulators can be merged exactly, so partial results from separate
+ * threads or files can be combined.
+ */
+struct BivariateRunningStatistics {
+    /// The number of pairs that have been accumulated.
+    long long count;
+    /// The mean of the first channel.
+    double meanX;
+    /// The mean of the second channel.
+    double meanY;
+    /// The sum of squared deviations of the first channel from "meanX".
+    double sumOfSquaredDeviationsX;
+    /// The sum of squared deviations of the second channel from "meanY".
+    double sumOfSquaredDeviationsY;
+    /// The sum of the products of the deviations of the two channels (the co-moment).
+    double coMoment;
+    
+    /// Default constructor creates an empty accumulator.
+    BivariateRunningStatistics();
+    
+    /// Accumulate a single pair.
+    void add(double x, double y);
+    
+    /// Accumulate every pair summarized by another accumulator.
+    void merge(const BivariateRunningStatistics & other);
+    
+    /// Fill a StatsBivariateResult with the statistics of the accumulated pairs.
+    void fill(StatsBivariateResult & result) const;
+};
+
+/** \struct QuantileSketchCentroid
+ * A cluster of nearby values in a QuantileSketch, summarized by their number,
+ * mean and sum of squared deviations.
+ */
+struct QuantileSketchCentroid {
+    /// The mean of the values in the cluster.
+    double mean;
+    /// The number of values in the cluster.
+    double weight;
+    /// The sum of squared deviations of the values in the cluster from "mean".
+    double sumOfSquaredDeviations;
+};
+
+/** \struct QuantileSketch
+ * A mergeable summary of the distribution of a stream of values (a "t-digest"),
+ * from which quantiles and the robust statistics in a StatsRobustResult can be
+ * estimated without storing the values. Values are clustered into centroids
+ * whose permitted size shrinks towards both tails of the distribution, so the
+ * extreme quantiles are estimated much more precisely than a histogram of the
+ * same size would allow. The number of centroids is proportional to
+ * "compression" and does not depend on the number of values.
+ *
+ * Only finite values are accumulated; NaN and infinite values are ignored.
+ */
+struct QuantileSketch {
+    /// Determines the number of centroids, and hence the precision, of the sketch.
+    double compression;
+    /// The centroids, in ascending order of their means.
+    std::vector<QuantileSketchCentroid> centroids;
+    /// Values (and centroids of merged sketches) that have not yet been clustered.
+    std::vector<QuantileSketchCentroid> unmerged;
+    /// The smallest accumulated value.
+    double minimum;
+    /// The largest accumulated value.
+    double maximum;
+    
+    /// Constructor creates an empty sketch with the given compression.
+    explicit QuantileSketch(double compression = 200.0);
+    
+    /// Accumulate a single value.
+    void add(double value);
+    
+    /// Accumulate every element of an array of values.
+    void add(const double * values, size_t count);
+    
+    /// Accumulate every value summarized by another sketch.
+    void merge(const QuantileSketch & other);
+    
+    /// Cluster any unmerged values into the centroids.
+    void compress();
+    
+    /// Return the number of values that have been accumulated.
+    long long getCount() const;
+    
+    /// Return an estimate of a quantile, interpolating as StatsCalculator::getQuantile() does.
+    double quantile(double probability);
+    
+    /// Fill a StatsRobustResult with estimates of the robust statistics of the accumulated values.
+    void fill(StatsRobustResult & result, double trimFraction);
+    
+    /// Discard every value, keeping the compression.
+    void reset();
+};
+
+/** \struct DistinctCountSketch
+ * A mergeable estimator of the number of DISTINCT values in a stream (a
+ * "HyperLogLog" sketch). Each value is hashed, the leading bits of the hash
+ * select one of 2^precision registers, and the register records the largest
+ * number of leading zeros (plus one) seen in the remaining bits. Roughly one
+ * hash in 2^r has r leading zeros, so the registers reveal how many different
+ * hashes were seen. The relative standard error of the estimate is about
+ * \f$1.04/\sqrt{2^{precision}}\f$, i.e. 2.3%, and repeated values cost
+ * nothing. Merging two sketches takes the larger of each pair of registers.
+ *
+ * The registers occupy 2^precision bytes and are only allocated once a value
+ * is added. Only finite values are accumulated; NaN and infinite values are
+ * ignored.
+ */
+struct DistinctCountSketch {
+    /// The base-2 logarithm of the number of registers.
+    static const unsigned precision = 11;
+    /// The registers, or an empty vector if no value has been added.
+    std::vector<unsigned char> registers;
+    
+    /// Accumulate a single value.
+    void add(double value);
+    
+    /// Accumulate every element of an array of values.
+    void add(const double * values, size_t count);
+    
+    /// Accumulate every value summarized by another sketch.
+    void merge(const DistinctCountSketch & other);
+    
+    /// Return an estimate of the number of distinct values that have been accumulated.
+    double estimate() const;
+    
+    /// Discard every value, releasing the registers.
+    void reset();
+};
+
+/** \struct FrequencySketch
+ * A mergeable summary of how often each value occurs in a stream, from which
+ * the most frequent values (the "heavy hitters") and an upper bound on the
+ * number of occurrences of any value can be obtained in a few kilobytes.
+ *
+ * It combines two classic sketches. The "SpaceSaving" algorithm of Metwally et
+ * al. monitors "capacity" values with a count for each: a monitored value has
+ * its count incremented, and an unmonitored value replaces the monitored value
+ * with the smallest count, inheriting that count plus one (which is recorded
+ * as its possible overestimate). Every value that occurs more than
+ * total/capacity times is therefore monitored. (Here, a value only replaces
+ * another if its Count-Min estimate exceeds the smallest monitored count, which
+ * keeps that guarantee while sparing the monitored values from being replaced
+ * by values that are too rare to matter.) The "Count-Min" sketch of
+ * Cormode and Muthukrishnan adds each value to one counter in each of "depth"
+ * rows of "width" counters, selected by hashing; the smallest of a value's
+ * counters bounds its count from above, with an overestimate of at most
+ * e*total/width with probability \f$1 - e^{-depth}\f$. The counters are
+ * updated CONSERVATIVELY (only those that equal the smallest are incremented),
+ * which keeps that bound while greatly reducing the overestimates.
+ *
+ * The monitored values are kept in descending order of count, so the value to
+ * be replaced is always the last, and a small open-addressing hash table maps
+ * each monitored value to its position. Storage is only
+ * allocated once a value is added. Only finite values are accumulated; NaN and
+ * infinite values are ignored.
+ */
+struct FrequencySketch {
+    /// The number of values that SpaceSaving monitors.
+    static const unsigned capacity = 64;
+    /// The number of rows of Count-Min counters.
+    static const unsigned depth = 4;
+    /// The number of Count-Min counters in each row, which must be a power of two.
+    static const unsigned width = 128;
+    /// The number of slots in the hash table of monitored values, which must be a power of two.
+    static const unsigned slotCount = 2*capacity;
+    
+    /// The number of values that have been accumulated.
+    long long total;
+    /// The Count-Min counters, row by row, or an empty vector if no value has been added.
+    std::vector<long long> counters;
+    /// The monitored values, in descending order of count.
+    std::vector<StatsHeavyHitter> monitored;
+    /// The slot of the hash table that refers to each element of "monitored".
+    std::vector<unsigned char> monitoredSlots;
+    /// The hash table: one plus the position in "monitored" of the value in each slot, or zero if the slot is empty.
+    std::vector<unsigned char> slots;
+    
+    /// Default constructor creates an empty sketch.
+    FrequencySketch();
+    
+    /// Accumulate a single value.
+    void add(double value);
+    
+    /// Accumulate every element of an array of values.
+    void add(const double * values, size_t count);
+    
+    /// Accumulate every value summarized by another sketch.
+    void merge(const FrequencySketch & other);
+    
+    /// Return an upper bound on the number of times a value has been accumulated.
+    long long estimate(double value) const;
+    
+    /// Fill a vector with at most "count" of the most frequent values, in descending order of count.
+    void getHeavyHitters(size_t count, std::vector<StatsHeavyHitter> & hitters) const;
+    
+    /// Discard every value, releasing the storage.
+    void reset();
+};
+
+/** \struct ReservoirSample
+ * A fixed-size, uniformly random sample of the values in a stream (a
+ * "reservoir"), which keeps a representative subset of the values for plotting
+ * when the values themselves are not stored. After n values have been added,
+ * every subset of min(n, size) of them is equally likely to be the sample.
+ *
+ * Values are sampled with "Algorithm L" of Li (1994). Each value that has been
+ * seen can be thought of as carrying a random KEY, uniform in (0, 1), and the
+ * sample holds the values with the "size" smallest keys; "threshold" is the
+ * largest key in the sample. Rather than drawing a key for every value, the
+ * number of values to skip before the next one enters the sample is drawn
+ * directly from its geometric distribution, so almost every value costs only a
+ * decrement of "skip", and only about size*log(n/size) values draw random numbers.
+ *
+ * Reservoirs that sampled separate parts of a stream (e.g. on separate threads)
+ * can be merged into a uniform sample of the whole. Given its threshold, the keys
+ * of the other values in a reservoir are independent and uniform below it, so
+ * they can be drawn afresh and the values with the smallest keys kept. Reservoirs
+ * that are to be merged must be seeded differently.
+ *
+ * Random numbers are drawn from stream zero of a StatsPhiloxGenerator with the
+ * given seed, so the sample depends only on the seed and the values.
+ */
+struct ReservoirSample {
+    /// The largest number of values in the sample, or zero if sampling is disabled.
+    size_t size;
+    /// The seed of the random numbers.
+    unsigned long long seed;
+    /// The number of random blocks that have been drawn.
+    unsigned long long blocks;
+    /// The number of values that have been added.
+    long long count;
+    /// The largest key of a value in the sample, once it is full.
+    double threshold;
+    /// The number of values to be skipped before the next one enters the sample.
+    long long skip;
+    /// The sampled values.
+    std::vector<double> values;
+    
+    /// Default constructor creates a disabled reservoir.
+    ReservoirSample();
+    
+    /// Discard every value and set the size and seed.
+    void configure(size_t size, unsigned long long seed);
+    
+    /// Add a single value.
+    void add(double value);
+    
+    /// Add every element of an array of values.
+    void add(const double * newValues, size_t newCount);
+    
+    /// Add every value sampled by another reservoir, whose size must be at least as large unless it is not full.
+    bool merge(const ReservoirSample & other);
+    
+    /// Discard every value, keeping the size and seed.
+    void reset();
+    
+    /// Return a random number uniformly distributed in (0, 1).
+    double nextUniform();
+    
+    /// Draw the number of values to be skipped after the sample changes.
+    void drawSkip();
+};
+
+/** \struct TimeRollup
+ * An accumulator that divides a stream of timestamped values into consecutive
+ * intervals of time ("buckets") at several resolutions at once, e.g. seconds,
+ * minutes and hours, and records the statistics of the values in each bucket.
+ *
+ * The resolutions form a CASCADE: each width is a whole multiple of the one
+ * before it, so every bucket is made up of whole buckets of the finer
+ * resolutions. Each value is only accumulated into the open bucket of the finest
+ * resolution, which costs two comparisons and a Welford update. When a bucket
+ * is completed its record is emitted and its accumulator is merged into the open
+ * bucket of the next resolution, so the work per value is constant however many
+ * resolutions there are.
+ *
+ * The timestamps should not decrease. A value whose timestamp falls before the
+ * open bucket of the finest resolution is added to the open bucket of the finest
+ * resolution that it does fall within (so it is missing only from the records of
+ * finer buckets that were already emitted). If it falls before every open
+ * bucket, or its timestamp is not finite, it is counted in "lateValues" and
+ * otherwise ignored. Buckets in which no values fall are not recorded.
+ */
+struct TimeRollup {
+    /// The width of the buckets at each resolution, in ascending order, or an empty vector if the rollup is disabled.
+    std::vector<double> widths;
+    /// The number of buckets at each resolution that make up one bucket at the next (the first element is unused).
+    std::vector<long long> multiples;
+    /// The number of the open bucket at each resolution: its start divided by its width.
+    std::vector<long long> openBuckets;
+    /// The values in the open bucket at each resolution that are not in the open buckets of the finer resolutions.
+    std::vector<RunningStatistics> open;
+    /// The completed buckets at each resolution, oldest first.
+    std::vector<std::vector<StatsTimeBucket> > completed;
+    /// The start of the open bucket of the finest resolution.
+    double openStart;
+    /// The end of the open bucket of the finest resolution.
+    double openEnd;
+    /// True if the buckets in "openBuckets" are open, i.e. a value has been added since the rollup was configured, reset or flushed.
+    bool started;
+    /// The number of values that were ignored because their timestamps were too early or not finite.
+    long long lateValues;
+    
+    /// Default constructor creates a disabled rollup.
+    TimeRollup();
+    
+    /// Discard every bucket and set the widths, returning false (and making no change) if they do not form a cascade.
+    bool configure(const std::vector<double> & bucketWidths);
+    
+    /// Add a single value with its timestamp.
+    void add(double time, double value);
+    
+    /// Return the number of leading elements of an array of timestamps that fall within the open bucket of the finest resolution.
+    size_t openRun(const double * times, size_t count) const;
+    
+    /// Complete the open buckets of the finest "levels" resolutions.
+    void complete(size_t levels);
+    
+    /// Complete every open bucket, e.g. at the end of the stream.
+    void flush();
+    
+    /// Discard every bucket, keeping the widths.
+    void reset();
+};
+
+/** \struct ChangeDetector
+ * An online detector of shifts in the mean of a stream of values, which costs a
+ * constant amount of work per value.
+ *
+ * Each value x is first standardized, \f$z = (x - c)/\sigma\f$, where
+ * \f$\sigma\f$ is the standard deviation of the first "warmupCount" values
+ * and the centre c is their mean (CUSUM) or the running mean of every value so
+ * far (Page-Hinkley). Two cumulative sums then look for an increase and a
+ * decrease: \f$g^+ \leftarrow \max(0, g^+ + z - k)\f$ and
+ * \f$g^- \leftarrow \max(0, g^- - z - k)\f$, where the DRIFT k is the
+ * smallest shift (in standard deviations) worth detecting, typically half of
+ * the shift to be detected. A change is detected when either sum exceeds the
+ * THRESHOLD h, and is estimated to have begun just after that sum was last zero.
+ * The threshold trades the delay before a change is detected against the rate
+ * of false alarms: with k = 0.5 and h = 5, a shift of one standard deviation is
+ * detected after about ten values, and false alarms occur about once in 470
+ * values of a normally distributed stream (h = 8 makes them some twenty times
+ * rarer, at the cost of about six more values of delay).
+ *
+ * After a detection the detector starts again, learning a new centre and scale
+ * from the next "warmupCount" values. No detection is made during the warm-up.
+ * Values that are not finite are ignored.
+ */
+struct ChangeDetector {
+    /// The method, or STATSCALC_CHANGE_NONE if the detector is disabled.
+    StatsCalcChangeMethod method;
+    /// The threshold h, in standard deviations.
+    double threshold;
+    /// The drift k, in standard deviations.
+    double drift;
+    /// The number of values from which the centre and scale are learned after every (re)start.
+    long long warmupCount;
+    /// The number of values that have been examined since the detector was configured or reset.
+    long long examined;
+    /// The statistics of the warm-up values.
+    RunningStatistics reference;
+    /// The number of values examined since the detector (re)started.
+    long long count;
+    /// The sum of the values examined since the detector (re)started.
+    double sum;
+    /// The centre about which the CUSUM test standardizes the values.
+    double center;
+    /// The reciprocal of the standard deviation by which the values are standardized.
+    double inverseScale;
+    /// The cumulative sums that look for an increase (element 0) and a decrease (element 1).
+    double sums[2];
+    /// The position of the first value since each cumulative sum was last zero.
+    long long starts[2];
+    /// The number of values since each cumulative sum was last zero.
+    long long runCounts[2];
+    /// The sum of the values since each cumulative sum was last zero.
+    double runSums[2];
+    /// The number of changes that have been detected since the detector was configured or reset.
+    long long detections;
+    /// True if a change has been detected that has not been taken.
+    bool pending;
+    /// The most recently detected change.
+    StatsChangePoint lastChange;
+    /// A function to call when a change is detected, or null.
+    StatsCalcChangeCallback callback;
+    /// The pointer that is passed to "callback".
+    void * userData;
+    
+    /// Default constructor creates a disabled detector.
+    ChangeDetector();
+    
+    /// Set the method and its parameters, returning false (and making no change) if a parameter is out of range.
+    bool configure(StatsCalcChangeMethod changeMethod, double changeThreshold, double changeDrift,
+                   long long changeWarmupCount);
+    
+    /// Examine a single value, returning true if a change was detected.
+    bool add(double value);
+    
+    /// Examine every element of an array of values.
+    void add(const double * values, size_t valueCount);
+    
+    /// Record a change detected by the cumulative sum for an increase (side 0) or a decrease (side 1), and restart.
+    void detect(int side);
+    
+    /// Forget the values examined since the last detection and start learning the centre and scale again.
+    void restart();
+    
+    /// Restart and forget every detection, keeping the method, its parameters and the callback.
+    void reset();
+};
+
+/** \struct StatsLiveStatistics
+ * A copy of the accumulators of a StatsCalculator instance that other threads
+ * can read WITHOUT BLOCKING the thread that appends values (see
+ * StatsCalculator::setLiveStatisticsEnabled()).
+ *
+ * The accumulators are protected by a SEQLOCK. The single writer increments
+ * "sequence" to an odd number, stores the accumulators and increments it to
+ * an even number again. A reader loads "sequence", loads the accumulators and
+ * loads "sequence" once more; the accumulators are consistent if both loads
+ * returned the same even number, and otherwise the reader tries again. The
+ * writer therefore never waits for readers and never executes an atomic
+ * read-modify-write instruction, and a reader only retries if a write overlaps
+ * its read. Every member is atomic (and accessed with relaxed ordering between
+ * fences) so that the reads that are discarded are not data races.
+ *
+ * The accumulators are published together with a TAG, an integer with which the
+ * owner of the structure identifies what it currently describes (the C API uses
+ * the handle of the instance). A reader that kept a pointer to the structure can
+ * check the tag to tell whether it still describes the instance it expects.
+ *
+ * Only one thread may write at a time. Any number of threads may read.
+ */
+struct StatsLiveStatistics {
+    /// Odd while a write is in progress. Half of it is the number of writes that have completed.
+    std::atomic<unsigned long long> sequence;
+    /// The number of values.
+    std::atomic<long long> count;
+    /// The sum of the values.
+    std::atomic<double> sum;
+    /// The mean of the values.
+    std::atomic<double> mean;
+    /// The sum of squared deviations of the values from "mean".
+    std::atomic<double> sumOfSquaredDeviations;
+    /// The smallest value.
+    std::atomic<double> minimum;
+    /// The largest value.
+    std::atomic<double> maximum;
+    /// Identifies what the accumulator describes, or -1. It is not copied by the copy operations.
+    std::atomic<int> tag;
+    
+    /// Default constructor publishes an empty accumulator with a tag of -1.
+    StatsLiveStatistics();
+    
+    /// Copy constructor publishes the accumulator that another instance holds.
+    StatsLiveStatistics(const StatsLiveStatistics & other);
+    
+    /// Copy assignment publishes the accumulator that another instance holds.
+    StatsLiveStatistics & operator=(const StatsLiveStatistics & other);
+    
+    /// Publish an accumulator. Only one thread may call this at a time.
+    void write(const RunningStatistics & statistics);
+    
+    /// Publish a new tag, keeping the accumulator. Only one thread may write at a time.
+    void setTag(int newTag);
+    
+    /// Make a single attempt to read a consistent accumulator (and, optionally, its tag), returning false (and no change) if a write overlapped it.
+    bool tryRead(RunningStatistics & statistics, int * readTag = 0) const;
+    
+    /// Read a consistent accumulator (and, optionally, its tag), trying again for as long as writes overlap the read.
+    void read(RunningStatistics & statistics, int * readTag = 0) const;
+    
+    /// Return the number of writes that have completed, from which a reader can tell whether anything has changed.
+    unsigned long long getVersion() const;
+};
+
 /** \class StatsCalculator
  * The StatsCalculator class reads a list of whitespace-separated numeric
  * values from a text file. It stores those values internally and supplies
@@ -36,131 +990,1682 @@
  */
 class StatsCalculator {
     
-    /** \brief An STL vector of double precision values to store parsed numeric
-     * values.
+    /** \brief An STL vector of double precision values to store parsed numeric
+     * values.
+     */
+    std::vector<double> numericValues;
+    
+    /** \brief A pointer to a caller-owned array of double precision values that
+     * this instance is "viewing" instead of storing its own copy. This is null
+     * unless the instance was constructed as (or converted into) a view.
+     */
+    const double * externalValues;
+    
+    /** \brief The number of elements in the caller-owned array referenced by
+     * "externalValues".
+     */
+    size_t externalCount;
+    
+    /** \brief Private method that returns a pointer to the first of the values
+     * that the statistics should be computed over. This is either the first element
+     * of "numericValues" or the first element of the caller-owned view.
+     */
+    const double * valuesData() const;
+    
+    /** \brief Private method that returns the number of values that the statistics
+     * should be computed over.
+     */
+    size_t valuesCount() const;
+    
+    /** \brief Private method that copies the values of a caller-owned view into
+     * "numericValues" and forgets the view, so that new values can be appended.
+     */
+    void detachView();
+    
+    /** \brief The statistics computed by the most recent call to computeStatistics(),
+     * which remain valid until the stored values change.
+     */
+    StatsResult cachedStatistics;
+    
+    /** \brief True if "cachedStatistics" is up to date with the stored values.
+     */
+    bool cachedStatisticsValid;
+    
+    /** \brief The values that contribute to the statistics, sorted into ascending
+     * order by the most recent call to getSortedValues().
+     */
+    std::vector<double> sortedValues;
+    
+    /** \brief True if "sortedValues" is up to date with the stored values.
+     */
+    bool sortedValuesValid;
+    
+    /** \brief The robust statistics computed by the most recent call to
+     * getRobustStatistics(), which remain valid until the stored values change.
+     */
+    StatsRobustResult cachedRobustStatistics;
+    
+    /** \brief True if "cachedRobustStatistics" is up to date with the stored values.
+     */
+    bool cachedRobustStatisticsValid;
+    
+    /** \brief The bootstrap confidence intervals computed by the most recent call
+     * to getBootstrapIntervals(), which remain valid until the stored values or
+     * the bootstrap options change.
+     */
+    StatsBootstrapResult cachedBootstrapResult;
+    
+    /** \brief True if "cachedBootstrapResult" is up to date with the stored values.
+     */
+    bool cachedBootstrapResultValid;
+    
+    /** \brief True if printStats() and writeStats() report bootstrap confidence
+     * intervals.
+     */
+    bool bootstrapEnabled;
+    
+    /** \brief The number of resamples from which the bootstrap intervals are computed.
+     */
+    unsigned bootstrapResampleCount;
+    
+    /** \brief The confidence level of the bootstrap intervals.
+     */
+    double bootstrapConfidenceLevel;
+    
+    /** \brief The seed of the random number generator that draws the resamples.
+     */
+    unsigned long long bootstrapSeed;
+    
+    /** \brief The autocorrelation statistics computed by the most recent call to
+     * getAutocorrelationStatistics(), which remain valid until the stored values change.
+     */
+    StatsAutocorrelationResult cachedAutocorrelationResult;
+    
+    /** \brief True if "cachedAutocorrelationResult" is up to date with the stored values.
+     */
+    bool cachedAutocorrelationResultValid;
+    
+    /** \brief True if printStats() and writeStats() report the autocorrelation
+     * statistics.
+     */
+    bool autocorrelationEnabled;
+    
+    /** \brief Private method that discards every cached result, because the values
+     * they describe have changed.
+     */
+    void discardCachedResults();
+    
+    /** \brief True if values are accumulated into "streamedStatistics" instead of
+     * being stored in "numericValues".
+     */
+    bool streaming;
+    
+    /** \brief An accumulator that summarizes every value that was added while
+     * streaming was enabled. These values are not stored.
+     */
+    RunningStatistics streamedStatistics;
+    
+    /** \brief Private method that adds a single parsed or appended value, either by
+     * storing it or (when streaming) by accumulating it.
+     */
+    void consumeValue(double value);
+    
+    /** \brief True if values that are streamed are also accumulated into
+     * "streamedSketch".
+     */
+    bool sketchEnabled;
+    
+    /** \brief A quantile sketch that summarizes the distribution of every value
+     * that was streamed while the sketch was enabled.
+     */
+    QuantileSketch streamedSketch;
+    
+    /** \brief True if every value that is appended, parsed or streamed is also
+     * accumulated into "distinctSketch" and "frequencySketch".
+     */
+    bool frequencySketchesEnabled;
+    
+    /** \brief A sketch that estimates the number of distinct values.
+     */
+    DistinctCountSketch distinctSketch;
+    
+    /** \brief A sketch that estimates the most frequent values.
+     */
+    FrequencySketch frequencySketch;
+    
+    /** \brief A uniformly random sample of every value that is appended, parsed or
+     * streamed while its size is not zero.
+     */
+    ReservoirSample reservoir;
+    
+    /** \brief An accumulator that divides the values that were appended with
+     * timestamps into buckets of time at one or more resolutions.
+     */
+    TimeRollup timeRollup;
+    
+    /** \brief A detector of shifts in the mean of the values that are appended,
+     * parsed or streamed.
+     */
+    ChangeDetector changeDetector;
+    
+    /** \brief The observer that delivers snapshots of the statistics to a
+     * subscriber (see subscribe()), or null. It is owned by this instance alone
+     * and is never shared with copies.
+     */
+    std::unique_ptr<StatsObserver> observer;
+    
+    /** \brief The number of values that have been appended since the observer
+     * last posted a snapshot.
+     */
+    long long unpublishedCount;
+    
+    /** \brief An accumulator that summarizes the first "observedCount" elements
+     * of "numericValues", so that each snapshot only needs to summarize the values
+     * that were stored since the previous one.
+     */
+    RunningStatistics observedStatistics;
+    
+    /** \brief The number of elements of "numericValues" that "observedStatistics"
+     * summarizes.
+     */
+    size_t observedCount;
+    
+    /** \brief Private method that forgets "observedStatistics", because the stored
+     * values (or the non-finite mode that selects them) have changed.
+     */
+    void forgetObservedValues();
+    
+    /** \brief Private method that summarizes every value, stored, viewed or
+     * streamed, bringing "observedStatistics" up to date on the way.
+     *
+     * \param summary - An accumulator that receives the summary.
+     */
+    void summarizeValues(RunningStatistics & summary);
+    
+    /** \brief True if the statistics are published to "liveStatistics" whenever
+     * they change.
+     */
+    bool liveStatisticsEnabled;
+    
+    /** \brief The statistics as last published for other threads to read.
+     */
+    StatsLiveStatistics liveStatistics;
+    
+    /** \brief Private method that publishes the statistics to "liveStatistics" (if
+     * enabled), counts values that have been appended and posts a snapshot to the
+     * observer (if any) once one is due.
+     *
+     * \param count - The number of values that have been appended.
+     */
+    void publishUpdates(size_t count);
+    
+    /** \brief The state of the incremental ingest that was begun by beginIngest()
+     * or beginAppend() and has not yet finished, or null. It refers to this
+     * instance, so it is never shared with copies.
+     */
+    std::shared_ptr<IncrementalIngest> incrementalIngest;
+    
+    /** \brief An accumulator that summarizes every value that was appended with a
+     * weight. The weights themselves are not stored.
+     */
+    WeightedRunningStatistics weightedStatistics;
+    
+    /** \brief An accumulator that summarizes every pair of values that was appended.
+     * The pairs themselves are not stored.
+     */
+    BivariateRunningStatistics bivariateStatistics;
+    
+    /** \brief Determines whether NaN and infinite values contribute to the statistics.
+     */
+    StatsCalcNonFiniteMode nonFiniteMode;
+    
+    /** \brief Private method that returns true if "nonFiniteMode" discards a value.
+     */
+    bool isExcluded(double value) const;
+    
+    /** \brief Private method that selects the stored values that "nonFiniteMode"
+     * does not discard, copying them only if some are discarded.
+     *
+     * \param selected - Receives the copy, if one is needed.
+     * \param values - Receives a pointer to the first selected value.
+     * \param count - Receives the number of selected values.
+     *
+     * \return True if any of the selected values is NaN or infinite.
+     */
+    bool selectValues(std::vector<double> & selected, const double * & values, size_t & count) const;
+    
+    /** \brief The policy that ingestFile() applies to malformed tokens.
+     */
+    StatsCalcParsePolicy parsePolicy;
+    
+    /** \brief A summary of the outcome of the most recent call to ingestFile().
+     */
+    StatsParseReport parseReport;
+    
+    /** \brief The positions of (at most "maxRecordedParseErrors" of) the malformed
+     * tokens that the most recent call to ingestFile() encountered.
+     */
+    std::vector<ParseErrorLocation> parseErrors;
+    
+    /** \brief Private method that resets "parseReport" and "parseErrors".
+     */
+    void clearParseReport();
+    
+    /** \brief Private static method that actually computes every statistic of an
+     * array of numeric values in a single pass over them.
+     *
+     * \param values - A pointer to the first element of the array.
+     * \param count - The number of elements in the array.
+     * \param result - A StatsResult structure that is filled with the statistics.
+     * \param mode - Determines whether NaN and infinite values are included.
+     */
+    static void computeStatistics(const double * values, size_t count, StatsResult & result,
+                                  StatsCalcNonFiniteMode mode);
+    
+    /** \brief Private static method that computes the weighted statistics of an array
+     * of values and a parallel array of weights in a single pass over them.
+     */
+    static void computeWeightedStatistics(const double * values, const double * weights, size_t count,
+                                          WeightedRunningStatistics & result, StatsCalcNonFiniteMode mode);
+    
+    /** \brief Private static method that computes the bivariate statistics of two
+     * parallel arrays of values in a single pass over them.
+     */
+    static void computeBivariateStatistics(const double * x, const double * y, size_t count,
+                                           BivariateRunningStatistics & result, StatsCalcNonFiniteMode mode);
+    
+public:
+    
+    /** \brief The maximum number of malformed token positions that are recorded
+     * by each call to ingestFile(). Any further malformed tokens are only counted.
+     */
+    static const size_t maxRecordedParseErrors = 64;
+    
+    /** \brief The number of bytes of a file that each call to resumeIngest()
+     * reads and parses.
+     */
+    static const size_t ingestChunkBytes = 1 << 16;
+    
+    /** \brief The length, in bytes, of the longest token that the file parsers
+     * accept. A longer token is counted as ONE malformed token (and the parse
+     * policy is applied to it), whether the file is parsed by ingestFile() or a
+     * chunk at a time by resumeIngest().
+     */
+    static const size_t maxTokenBytes = ingestChunkBytes - 1;
+    
+    /** \brief The number of values of an array that each call to resumeIngest()
+     * appends.
+     */
+    static const size_t ingestChunkValues = 1 << 14;
+    
+    /** \brief Default constructor.
+     */
+    StatsCalculator();
+    
+    /** \brief View constructor. The instance computes its statistics directly
+     * from a caller-owned array without copying it.
+     *
+     * \param values - A pointer to the first element of a caller-owned array of
+     * double precision values. The array must remain valid for as long as the
+     * instance views it.
+     * \param count - The number of elements in the array.
+     */
+    StatsCalculator(const double * values, size_t count);
+    
+    /** \brief Copy constructor. The copy holds the same values, settings and
+     * results as the original, but an incremental ingest that the original has
+     * begun is not carried over (see beginIngest()), and the copy starts
+     * unsubscribed (see subscribe()).
+     *
+     * \param other - The instance to copy.
+     */
+    StatsCalculator(const StatsCalculator & other);
+    
+    /** \brief Copy assignment operator. Any incremental ingest that this instance
+     * has begun is abandoned, and one that "other" has begun is not carried over.
+     * This instance keeps its own subscription, if any, and not that of "other".
+     *
+     * \param other - The instance to copy.
+     */
+    StatsCalculator & operator=(const StatsCalculator & other);
+    
+    /** \brief Destructor. If the instance is subscribed, it waits for the
+     * delivery thread to finish (see subscribe()).
+     */
+    ~StatsCalculator();
+    
+    /** \brief Public method returns the sum of the internally stored numeric values.
+     */
+    double getSum();
+    
+    /** \brief Public method returns the mean of the internally stored numeric values.
+     */
+    double getMean();
+    
+    /** \brief Public method returns the standard deviation of the internally stored
+     * numeric values.
+     */
+    double getStandardDeviation();
+    
+    /** \brief Public method returns every statistic of the internally stored numeric
+     * values, computed together in a single pass.
+     */
+    const StatsResult & getStatistics();
+    
+    /** \brief Public method that returns the values that contribute to the
+     * statistics, sorted into ascending order with any NaN values last. The
+     * sorted view is cached until the stored values change.
+     */
+    const std::vector<double> & getSortedValues();
+    
+    /** \brief Public method that returns an exact quantile of the values that
+     * contribute to the statistics, interpolating linearly between the two
+     * closest values.
+     *
+     * \param probability - The probability, between zero and one. For example,
+     * 0.5 gives the median.
+     */
+    double getQuantile(double probability);
+    
+    /** \brief Public method that returns statistics that are insensitive to
+     * outliers: the median, the median absolute deviation and the trimmed and
+     * winsorized means and variance. They are computed exactly from the stored
+     * values by selection, without sorting them, unless values have been streamed
+     * into the quantile sketch, in which case they are estimated from it.
+     *
+     * \param trimFraction - The fraction of the values to trim (or winsorize) from
+     * EACH end, which is clamped to the range [0, 0.5].
+     */
+    const StatsRobustResult & getRobustStatistics(double trimFraction = 0.1);
+    
+    /** \brief Public method returns the median of the internally stored numeric values.
+     */
+    double getMedian();
+    
+    /** \brief Public method returns the median absolute deviation of the internally
+     * stored numeric values from their median.
+     */
+    double getMedianAbsoluteDeviation();
+    
+    /** \brief Public method returns the mean of the internally stored numeric values
+     * after the given fraction has been discarded from each end.
+     */
+    double getTrimmedMean(double trimFraction = 0.1);
+    
+    /** \brief Public method returns the mean of the internally stored numeric values
+     * after the given fraction at each end has been replaced by the nearest
+     * remaining value.
+     */
+    double getWinsorizedMean(double trimFraction = 0.1);
+    
+    /** \brief Public method returns the (population) variance of the internally
+     * stored numeric values after the given fraction at each end has been replaced
+     * by the nearest remaining value.
+     */
+    double getWinsorizedVariance(double trimFraction = 0.1);
+    
+    /** \brief Public method that returns bootstrap confidence intervals for the
+     * mean and the standard deviation of the internally stored numeric values.
+     * Values that were streamed are not stored, so they cannot be resampled and
+     * are not included.
+     *
+     * \return An immutable reference to the cached intervals, which remains valid
+     * until the next non-const method call on this instance.
+     */
+    const StatsBootstrapResult & getBootstrapIntervals();
+    
+    /** \brief Public method that returns the autocorrelation statistics of the
+     * internally stored numeric values, taken in the order in which they were
+     * appended: the integrated autocorrelation time, the effective sample size
+     * and two estimates of the standard error of the mean that allow for the
+     * correlation of successive values.
+     *
+     * \return An immutable reference to the cached statistics, which remains
+     * valid until the next non-const method call on this instance.
+     */
+    const StatsAutocorrelationResult & getAutocorrelationStatistics();
+    
+    /** \brief Public method returns the integrated autocorrelation time of the
+     * internally stored numeric values.
+     */
+    double getIntegratedAutocorrelationTime();
+    
+    /** \brief Public method returns the number of independent values that the
+     * internally stored numeric values are worth.
+     */
+    double getEffectiveSampleSize();
+    
+    /** \brief Public method that returns the autocorrelations of the internally
+     * stored numeric values at lags 0 to lagCount - 1, computed through fast
+     * Fourier transforms.
+     *
+     * \param lagCount - The number of lags.
+     *
+     * \return The autocorrelations. They are all NaN if any of the values is NaN
+     * or infinite, and all zero if there are no values.
+     */
+    std::vector<double> getAutocorrelations(size_t lagCount);
+    
+    /** \brief Public method that returns an estimate of the number of distinct
+     * finite values that were accumulated while the frequency sketches were enabled.
+     */
+    double getDistinctCount() const;
+    
+    /** \brief Public method that returns an upper bound on the number of times a
+     * value was accumulated while the frequency sketches were enabled.
+     */
+    long long estimateFrequency(double value) const;
+    
+    /** \brief Public method that returns the most frequent of the values that were
+     * accumulated while the frequency sketches were enabled.
+     *
+     * \param count - The largest number of values to return. At most
+     * FrequencySketch::capacity values are monitored.
+     *
+     * \return The values, in descending order of their estimated counts.
+     */
+    std::vector<StatsHeavyHitter> getHeavyHitters(size_t count) const;
+    
+    /** \brief Public method that returns the sketch that estimates the number of
+     * distinct values, so that it can be merged with those of other instances.
+     */
+    const DistinctCountSketch & getDistinctCountSketch() const;
+    
+    /** \brief Public method that returns the sketch that estimates the most
+     * frequent values, so that it can be merged with those of other instances.
+     */
+    const FrequencySketch & getFrequencySketch() const;
+    
+    /** \brief Public method that returns the reservoir sample, whose "values"
+     * member holds a uniformly random sample of the values that were appended,
+     * parsed or streamed while sampling was enabled (e.g. for plotting the
+     * distribution of streamed values, which are not stored).
+     */
+    const ReservoirSample & getReservoirSample() const;
+    
+    /** \brief Public method that makes this instance a view over a caller-owned
+     * array of double precision values, discarding any values it currently stores.
+     *
+     * \param values - A pointer to the first element of a caller-owned array of
+     * double precision values. The array must remain valid for as long as the
+     * instance views it. Statistics of a view are never cached, so its contents
+     * may be updated between (but not during) calls to the getters.
+     * \param count - The number of elements in the array.
+     */
+    void wrapValues(const double * values, size_t count);
+    
+    /** \brief Public method that returns true if this instance is currently a
+     * view over a caller-owned array.
+     */
+    bool isView() const;
+    
+    /** \brief Public method that discards all stored values (and any view), returning
+     * the instance to the state of a newly constructed one. By default the memory that
+     * held the values is retained, so that refilling the instance with a similar number
+     * of values does not allocate.
+     *
+     * \param releaseMemory - If true, the memory that held the values is released too.
+     */
+    void reset(bool releaseMemory = false);
+    
+    /** \brief Public method that accepts a appends a new double precision value to  
+     * the "numericValues" member datum.
+     *
+     * \param value - A double precision value to append to the "numericValues" member 
+     * datum.
+     */
+    void appendValue(double value);
+    
+    /** \brief Public method that appends every element of an array of double
+     * precision values. This is equivalent to (but much faster than) calling
+     * appendValue() for each element.
+     *
+     * \param values - A pointer to the first element of the array.
+     * \param count - The number of elements in the array.
+     */
+    void appendValues(const double * values, size_t count);
+    
+    /** \brief Public method that appends a single value together with its weight.
+     * The value also contributes to the unweighted statistics.
+     *
+     * \param value - A double precision value.
+     * \param weight - Its weight. Values whose weights are not positive and finite
+     * only contribute to the unweighted statistics.
+     */
+    void appendWeightedValue(double value, double weight);
+    
+    /** \brief Public method that appends every element of an array of values
+     * together with the corresponding element of a parallel array of weights. The
+     * values also contribute to the unweighted statistics.
+     *
+     * \param values - A pointer to the first element of the array of values.
+     * \param weights - A pointer to the first element of the array of weights.
+     * \param count - The number of elements in each array.
+     */
+    void appendWeightedValues(const double * values, const double * weights, size_t count);
+    
+    /** \brief Public method that returns the weighted statistics of every value that
+     * was appended with a weight.
+     */
+    StatsWeightedResult getWeightedStatistics() const;
+    
+    /** \brief Public method that accumulates a pair of values from two channels.
+     * Pairs are summarized separately from (and do not contribute to) the other
+     * statistics.
+     *
+     * \param x - The value from the first channel.
+     * \param y - The value from the second channel.
+     */
+    void appendPair(double x, double y);
+    
+    /** \brief Public method that accumulates the pairs of values in two parallel
+     * arrays.
+     *
+     * \param x - A pointer to the first element of the first channel.
+     * \param y - A pointer to the first element of the second channel.
+     * \param count - The number of elements in each array.
+     */
+    void appendPairs(const double * x, const double * y, size_t count);
+    
+    /** \brief Public method that returns the accumulator that summarizes every pair
+     * of values, so that it can be merged with those of other instances.
+     */
+    const BivariateRunningStatistics & getBivariateAccumulator() const;
+    
+    /** \brief Public method that returns the covariance, correlation and least-squares
+     * line of every pair of values that was appended.
+     */
+    StatsBivariateResult getBivariateStatistics() const;
+    
+    /** \brief Public method that sets the resolutions at which values that are
+     * appended with timestamps are divided into buckets of time (see TimeRollup),
+     * discarding any buckets that have been recorded.
+     *
+     * \param widths - The width of the buckets at each resolution, in the units of
+     * the timestamps (e.g. 1, 60 and 3600 for seconds, minutes and hours). Each
+     * width must be a whole multiple (of at least two) of the one before it. An
+     * empty vector disables the buckets.
+     *
+     * \return True on success, or false (and no change) if the widths do not
+     * form such a cascade.
+     */
+    bool setTimeResolutions(const std::vector<double> & widths);
+    
+    /** \brief Public method that appends a single value together with its
+     * timestamp. The value also contributes to the other statistics.
+     *
+     * \param time - The timestamp. Timestamps should not decrease.
+     * \param value - A double precision value.
+     */
+    void appendTimedValue(double time, double value);
+    
+    /** \brief Public method that appends every element of an array of values
+     * together with the corresponding element of a parallel array of timestamps.
+     * The values also contribute to the other statistics.
+     *
+     * \param times - A pointer to the first element of the array of timestamps.
+     * \param values - A pointer to the first element of the array of values.
+     * \param count - The number of elements in each array.
+     */
+    void appendTimedValues(const double * times, const double * values, size_t count);
+    
+    /** \brief Public method that completes every open bucket of time, so that
+     * their records become available. It should be called at the end of the input:
+     * values with later timestamps start new buckets.
+     */
+    void flushTimeBuckets();
+    
+    /** \brief Public method that returns the accumulator that divides timestamped
+     * values into buckets of time, whose "completed" member holds the records of
+     * the completed buckets at each resolution.
+     */
+    const TimeRollup & getTimeRollup() const;
+    
+    /** \brief Public method that removes and returns the oldest of the completed
+     * buckets at one resolution, so that a dashboard can poll for new buckets.
+     *
+     * \param resolution - The index of the resolution, in the order given to
+     * setTimeResolutions().
+     * \param maxCount - The largest number of buckets to return.
+     *
+     * \return The buckets, oldest first. The vector is empty if the resolution
+     * does not exist.
+     */
+    std::vector<StatsTimeBucket> takeTimeBuckets(size_t resolution, size_t maxCount);
+    
+    /** \brief Public method that writes the records of the completed buckets of
+     * time to a text file, as a table with one line per bucket.
+     *
+     * \param outfileName - A string specifying the path of the output file.
+     *
+     * \return True if the file was written, otherwise false.
+     */
+    bool writeTimeBuckets(const std::string & outfileName) const;
+    
+    /** \brief Public method that enables or disables CHANGE DETECTION (see
+     * ChangeDetector). While it is enabled, every value that is subsequently
+     * appended, parsed or streamed is examined for a shift in the mean, at a
+     * constant cost per value. Values that are already stored are not examined.
+     *
+     * \param method - One of the StatsCalcChangeMethod values.
+     * STATSCALC_CHANGE_NONE disables the detection.
+     * \param threshold - The threshold h, in standard deviations. Five is usual.
+     * \param drift - The drift k, in standard deviations: half of the smallest
+     * shift worth detecting. One half is usual.
+     * \param warmupCount - The number of values from which the mean and standard
+     * deviation are learned at the start and after every detection. It must be
+     * at least two.
+     *
+     * \return True on success, or false (and no change) if a parameter is out of
+     * range.
+     */
+    bool setChangeDetection(StatsCalcChangeMethod method, double threshold = 5.0, double drift = 0.5,
+                            long long warmupCount = 100);
+    
+    /** \brief Public method that registers a function to be called whenever a
+     * change is detected. It is called on the thread that appends the value at
+     * which the change is detected (which is a worker thread during an
+     * asynchronous load), before the append returns.
+     *
+     * \param callback - The function, or null to call none.
+     * \param userData - A pointer that is passed to the function.
+     */
+    void setChangeCallback(StatsCalcChangeCallback callback, void * userData);
+    
+    /** \brief Public method that returns the most recently detected change, if
+     * one has been detected since the previous call, so that detections can also
+     * be collected by polling.
+     *
+     * \param change - A StatsChangePoint structure that receives the change.
+     *
+     * \return True if a change was taken, false (and no change to "change") if
+     * none has been detected since the previous call.
+     */
+    bool takeChangePoint(StatsChangePoint & change);
+    
+    /** \brief Public method that returns the number of changes that have been
+     * detected since change detection was configured.
+     */
+    long long getChangeCount() const;
+    
+    /** \brief Public method that SUBSCRIBES a function to snapshots of the
+     * statistics, so that consumers are told about new statistics instead of
+     * polling for them. The function is called on a background thread that belongs
+     * to the subscription (see StatsObserver), so the threads that append values
+     * never wait for it. Snapshots that are posted while the function is still
+     * running are coalesced into the most recent one.
+     *
+     * A snapshot is posted once every "everySamples" values have been appended,
+     * parsed or streamed and, if "everyMilliseconds" is not zero, by the first
+     * append after each period has elapsed. A producer that stops appending should
+     * call publishStatistics() so that its final values are delivered.
+     *
+     * The subscription belongs to this instance: a copy starts unsubscribed, and
+     * destroying the instance waits for the function to return.
+     *
+     * \param callback - The function. It must not call the methods of this
+     * instance, which may be in use by the thread that appends values.
+     * \param userData - A pointer that is passed to the function.
+     * \param everySamples - The number of values after which a snapshot is
+     * posted, or zero.
+     * \param everyMilliseconds - The period, in milliseconds, with which
+     * snapshots are posted, or zero.
+     *
+     * \return True on success, or false (and no change) if callback is null,
+     * everySamples is negative or both intervals are zero.
+     */
+    bool subscribe(StatsCalcSnapshotCallback callback, void * userData, long long everySamples,
+                   unsigned everyMilliseconds = 0);
+    
+    /** \brief Public method that cancels the subscription, if any, after
+     * delivering any snapshot that has been posted. It must not be called from
+     * the subscribed function.
+     */
+    void unsubscribe();
+    
+    /** \brief Public method that returns true if a function is subscribed to
+     * snapshots of the statistics.
+     */
+    bool isSubscribed() const;
+    
+    /** \brief Public method that posts a snapshot of the current statistics to
+     * the subscribed function, if any, without waiting for one to be due.
+     */
+    void publishStatistics();
+    
+    /** \brief Public method that enables or disables the publication of LIVE
+     * STATISTICS. While enabled, the accumulators (count, sum, mean, sum of squared
+     * deviations, minimum and maximum) of every value are published to the
+     * structure returned by getLiveStatistics() at the end of every call that
+     * changes them. Other threads can then read them consistently, without locks,
+     * while this instance is being appended to.
+     *
+     * \param enabled - True to publish the statistics, false to stop.
+     */
+    void setLiveStatisticsEnabled(bool enabled);
+    
+    /** \brief Public method that returns true if live statistics are published.
+     */
+    bool isLiveStatisticsEnabled() const;
+    
+    /** \brief Public method that returns the structure to which the live
+     * statistics are published. Unlike every other method, the structure may be
+     * read by any thread while another thread appends values to this instance.
+     *
+     * \return A reference that remains valid until this instance is destroyed.
+     */
+    const StatsLiveStatistics & getLiveStatistics() const;
+    
+    /** \brief Public method that publishes a tag with the live statistics (see
+     * StatsLiveStatistics), so that a reader holding a reference to them can
+     * check what they describe. It is not copied with the instance.
+     *
+     * \param tag - The tag, or -1 to clear it.
+     */
+    void setLiveStatisticsTag(int tag);
+    
+    /** \brief Public method that enables or disables STREAMING. While streaming,
+     * appended and parsed values update a running accumulator and are not stored,
+     * so memory use does not grow with the number of values. The statistics always
+     * describe every value, whether it was stored or streamed.
+     *
+     * \param enabled - True to enable streaming, false to resume storing values.
+     */
+    void setStreaming(bool enabled);
+    
+    /** \brief Public method that returns true if streaming is enabled.
+     */
+    bool isStreaming() const;
+    
+    /** \brief Public method that enables or disables the QUANTILE SKETCH. While
+     * the sketch is enabled, values that are streamed are also accumulated into
+     * a QuantileSketch, from which getRobustStatistics() can estimate the robust
+     * statistics of values that were never stored. Enabling the sketch does not
+     * add values that were streamed earlier; disabling it discards the sketch.
+     *
+     * \param enabled - True to enable the sketch, false to disable it.
+     */
+    void setQuantileSketchEnabled(bool enabled);
+    
+    /** \brief Public method that returns true if the quantile sketch is enabled.
+     */
+    bool isQuantileSketchEnabled() const;
+    
+    /** \brief Public method that enables or disables the FREQUENCY SKETCHES. While
+     * they are enabled, every value that is appended, parsed or streamed is also
+     * accumulated into a DistinctCountSketch and a FrequencySketch, from which the
+     * number of distinct values and the most frequent values can be estimated in
+     * a few kilobytes, however many values there are. Enabling the sketches adds
+     * the values that are currently stored (or viewed); disabling them discards
+     * the sketches.
+     *
+     * \param enabled - True to enable the sketches, false to disable them.
+     */
+    void setFrequencySketchesEnabled(bool enabled);
+    
+    /** \brief Public method that returns true if the frequency sketches are enabled.
+     */
+    bool areFrequencySketchesEnabled() const;
+    
+    /** \brief Public method that merges the frequency sketches of another instance
+     * (e.g. one that ingested another shard of the values on another thread) into
+     * those of this instance. The merged sketches describe the values accumulated
+     * by both.
+     *
+     * \param distinct - The other instance's DistinctCountSketch.
+     * \param frequency - The other instance's FrequencySketch.
+     *
+     * \return True on success, or false (and no change) if the frequency sketches
+     * of this instance are disabled.
+     */
+    bool mergeFrequencySketches(const DistinctCountSketch & distinct, const FrequencySketch & frequency);
+    
+    /** \brief Public method that enables, resizes or disables RESERVOIR SAMPLING.
+     * While the size is not zero, a uniformly random sample of that many of the
+     * values that are appended, parsed or streamed is kept, at the cost of a
+     * decrement for almost every value. Any current sample is discarded, and
+     * the values that are currently stored (or viewed) are added.
+     *
+     * \param size - The largest number of values in the sample, or zero to
+     * disable sampling.
+     * \param seed - The seed of the random numbers. Instances whose samples are
+     * to be merged must be given different seeds.
+     */
+    void setReservoirSampling(size_t size, unsigned long long seed);
+    
+    /** \brief Public method that returns the largest number of values in the
+     * reservoir sample, which is zero if sampling is disabled.
+     */
+    size_t getReservoirSize() const;
+    
+    /** \brief Public method that merges the reservoir sample of another instance
+     * (e.g. one that ingested another shard of the values on another thread) into
+     * that of this instance. The merged sample is a uniformly random sample of the
+     * values sampled by both.
+     *
+     * \param other - The other instance's ReservoirSample.
+     *
+     * \return True on success, or false (and no change) if sampling is disabled
+     * in this instance or the other sample is full and smaller than this one.
+     */
+    bool mergeReservoirSample(const ReservoirSample & other);
+    
+    /** \brief Public method that determines whether printStats() and writeStats()
+     * report bootstrap confidence intervals. Computing the intervals resamples the
+     * stored values thousands of times, so they are not reported by default.
+     *
+     * \param enabled - True to report the intervals, false to omit them.
+     */
+    void setBootstrapEnabled(bool enabled);
+    
+    /** \brief Public method that returns true if bootstrap confidence intervals
+     * are reported.
+     */
+    bool isBootstrapEnabled() const;
+    
+    /** \brief Public method that sets the options of the bootstrap.
+     *
+     * \param resampleCount - The number of resamples, which must not be zero.
+     * The default is 2000.
+     * \param confidenceLevel - The probability that each interval covers the
+     * statistic, strictly between zero and one. The default is 0.95.
+     * \param seed - The seed of the random number generator. The same seed and
+     * values always give the same intervals. The default is zero.
+     *
+     * \return True on success, or false (and no change) if an option is out of range.
+     */
+    bool setBootstrapOptions(unsigned resampleCount, double confidenceLevel, unsigned long long seed);
+    
+    /** \brief Public method that determines whether printStats() and writeStats()
+     * report the autocorrelation statistics. They are only meaningful if the order
+     * of the values matters, so they are not reported by default.
+     *
+     * \param enabled - True to report the statistics, false to omit them.
+     */
+    void setAutocorrelationEnabled(bool enabled);
+    
+    /** \brief Public method that returns true if the autocorrelation statistics
+     * are reported.
+     */
+    bool isAutocorrelationEnabled() const;
+    
+    /** \brief Public method that determines whether NaN and infinite values
+     * contribute to the statistics. Stored values are filtered whenever the
+     * statistics are computed, so changing the mode affects them retrospectively.
+     * Streamed values are filtered as they arrive, using the mode at that time.
+     *
+     * \param mode - One of the StatsCalcNonFiniteMode values.
+     */
+    void setNonFiniteMode(StatsCalcNonFiniteMode mode);
+    
+    /** \brief Public method that returns the mode that determines whether NaN and
+     * infinite values contribute to the statistics.
+     */
+    StatsCalcNonFiniteMode getNonFiniteMode() const;
+    
+    /** \brief Public method that reads a list of whitespace-separated numeric
+     * values from a text file. It appends those values to the "numericValues"
+     * member datum.
+     *
+     * \param infileName - A string specifying to the path of a text file containing
+     *    a whitespace-separated list of numeric values.
+     */
+    void readFile(const std::string & infileName);
+    
+    /** \brief Public method that reads a list of whitespace-separated numeric
+     * values from a text file and appends them to the "numericValues" member
+     * datum WITHOUT printing anything to the terminal. It is suitable for use
+     * on a background thread.
+     *
+     * \param infileName - A string specifying to the path of a text file containing
+     *    a whitespace-separated list of numeric values.
+     * \param progress - An optional pointer to an IngestProgress structure that is
+     *    updated as the file is parsed.
+     *
+     * \return True if the file was opened successfully, otherwise false.
+     */
+    bool ingestFile(const std::string & infileName, IngestProgress * progress = 0);
+    
+    /** \brief Public method that begins to ingest a file INCREMENTALLY: the file
+     * is opened, but its values are parsed and appended one chunk at a time by
+     * resumeIngest(). Between chunks no thread is occupied, so an event loop or
+     * coroutine framework can interleave many ingests (see StatsIngestScheduler).
+     * The other methods of this instance must not be called until the ingest has
+     * finished. The ingest belongs to this instance: a copy does not continue it,
+     * so the instance must not be moved while it is pending (for example, by a
+     * std::vector that relocates its elements).
+     *
+     * \param infileName - A string specifying to the path of a text file
+     *    containing a whitespace-separated list of numeric values.
+     * \param progress - An optional pointer to an IngestProgress structure that
+     *    is updated after every chunk.
+     *
+     * \return True if the file was opened successfully, or false if it could not
+     * be opened or another incremental ingest is in progress.
+     */
+    bool beginIngest(const std::string & infileName, IngestProgress * progress = 0);
+    
+    /** \brief Public method that begins to append a caller-owned array of values
+     * INCREMENTALLY, one chunk at a time, in the same way as beginIngest().
+     *
+     * \param values - A pointer to the first element of the array, which must
+     * remain valid until the ingest has finished.
+     * \param count - The number of elements in the array.
+     *
+     * \return True on success, or false if another incremental ingest is in
+     * progress.
+     */
+    bool beginAppend(const double * values, size_t count);
+    
+    /** \brief Public method that ingests the next chunk (ingestChunkBytes bytes of
+     * a file or ingestChunkValues values of an array) of the incremental ingest.
+     *
+     * \return True if the ingest has finished (or none was in progress), in which
+     * case the statistics are the same as after ingestFile() or appendValues(),
+     * otherwise false.
+     */
+    bool resumeIngest();
+    
+    /** \brief Public method that returns true if an incremental ingest has begun
+     * but not yet finished.
+     */
+    bool isIngestPending() const;
+    
+    /** \brief Public method that reads a two-column text file in which each line
+     * holds a value followed by its weight or its uncertainty, and appends the
+     * weighted values.
+     *
+     * \param infileName - A string specifying to the path of the text file.
+     * \param column - Determines whether the second column holds weights or
+     *    uncertainties.
+     * \param progress - An optional pointer to an IngestProgress structure that is
+     *    updated as the file is parsed.
+     *
+     * \return True if the file was opened successfully, otherwise false.
+     */
+    bool ingestWeightedFile(const std::string & infileName,
+                            StatsCalcWeightColumn column = STATSCALC_WEIGHT_COLUMN_WEIGHTS,
+                            IngestProgress * progress = 0);
+    
+    /** \brief Public method that reads a two-column text file in which each line
+     * holds a pair of values from two channels, and accumulates the pairs.
+     *
+     * \param infileName - A string specifying to the path of the text file.
+     * \param progress - An optional pointer to an IngestProgress structure that is
+     *    updated as the file is parsed.
+     *
+     * \return True if the file was opened successfully, otherwise false.
+     */
+    bool ingestPairsFile(const std::string & infileName, IngestProgress * progress = 0);
+    
+    /** \brief Public method that reads a two-column text file in which each line
+     * holds a timestamp followed by a value, and appends the timed values (see
+     * appendTimedValues()).
+     *
+     * \param infileName - A string specifying to the path of the text file.
+     * \param progress - An optional pointer to an IngestProgress structure that is
+     *    updated as the file is parsed.
+     *
+     * \return True if the file was opened successfully, otherwise false.
+     */
+    bool ingestTimedFile(const std::string & infileName, IngestProgress * progress = 0);
+    
+    /** \brief Public method that sets the policy that ingestFile() (and readFile())
+     * apply to tokens that are not decimal numbers.
+     *
+     * \param policy - One of the StatsCalcParsePolicy values.
+     */
+    void setParsePolicy(StatsCalcParsePolicy policy);
+    
+    /** \brief Public method that returns the policy that ingestFile() applies to
+     * tokens that are not decimal numbers.
+     */
+    StatsCalcParsePolicy getParsePolicy() const;
+    
+    /** \brief Public method that returns a summary of the outcome of the most recent
+     * call to ingestFile() (or readFile()).
+     */
+    const StatsParseReport & getParseReport() const;
+    
+    /** \brief Public method that returns the positions of the malformed tokens that
+     * the most recent call to ingestFile() (or readFile()) encountered, up to a
+     * maximum of "maxRecordedParseErrors".
+     */
+    const std::vector<ParseErrorLocation> & getParseErrors() const;
+    
+    /** \brief Public method that prints a summary of the statistical properties that this
+     * class computes to the terminal.
+     */
+    void printStats();
+    
+    /** \brief Public method that writes a summary of the statistical properties that this
+     * class computes to a caller-specified output file.
+     *
+     * \param outfileName - A string specifying to the path for a text file to which
+     * the statistics summary should be written.
+     */
+    void writeStats(const std::string & outfileName);
+    
+};
+
+/* This is the end of the first block of C++-only code, so end the __cplusplus conditional block.
+ */
+#endif // __cplusplus was defined
+
+/* Now declare some WAPPER FUNCTIONS that provide access for C compilers to
+ * the functionality provided by StatsCalculator.
+ * 
+ * The IMPLEMENTATIONS of these functions will reference C++-only language 
+ * constructs that must be compiled using a C++ compiler. However the default
+ * NAME MANGLING behaviour of the C++ compiler must be suppressed. This is 
+ * done by specifying that the functions should be declared with C-STYLE
+ * LINKAGE. This is achieved by enclosing the function definititions within a
+ * code block that is prpended with the keyword "extern" and the string literal
+ * "C".
+ *
+ * The final complication is that C compilers cannot parse the 'extern "C"' token
+ * pair, so a PREPROCESSOR CONDITIONAL that depends on the __cplusplus macro
+ * is required. Another conditional block is also required to hide the closing 
+ * brace of the code block from C compilers.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus was defined
+    
+    /** \brief C API function that instantiates a StatsCalculator object and returns an
+     * integer "handle" to the user that can be used to reference the object.
+     *
+     * Handles of destroyed objects are recycled, but a recycled handle never
+     * compares equal to any handle previously issued for the same storage (until
+     * 2048 objects have occupied it), so stale handles are reported as invalid.
+     *
+     * \return An integer "handle" that uniquely refers to the instantiated 
+     * StatsCalculator object, or -1 if too many objects are alive at once.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcCreate();
+    
+    /** \brief C API function that instantiates a StatsCalculator object that is
+     * a VIEW over a caller-owned array, and returns an integer "handle" to it.
+     *
+     * No copy of the array is made. The caller retains ownership of the array and
+     * MUST keep it valid until statsCalcDestroy() has been called for the returned
+     * handle. The contents may be updated between (but not during) calls that
+     * compute statistics, since the statistics of a view are never cached. Appending values to, or reading a file into, a view
+     * first copies the viewed values into the instance, after which the caller's
+     * array is no longer referenced.
+     *
+     * \param values - A pointer to the first element of the caller-owned array.
+     * \param count - The number of elements in the array.
+     *
+     * \return An integer "handle" that uniquely refers to the instantiated
+     * StatsCalculator object, or -1 if values is null and count is non-zero or
+     * too many objects are alive at once.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcCreateView(const double * values, size_t count);
+    
+    /** \brief Destroy a previously instantiated StatsCalculator object. If an
+     * asynchronous load into the object is in progress, it is allowed to finish.
+     * 
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be destroyed.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcDestroy(int handle);
+    
+    /** \brief Expose the functionality of StatsCalculator::reset() in the C API.
+     * Resetting an instance and reusing it for the next run avoids reallocating
+     * the memory that holds its values.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be reset.
+     * \param releaseMemory - If non-zero, the memory that held the values is
+     * released. If zero, it is retained for reuse.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcReset(int handle, int releaseMemory);
+    
+    /** \brief Expose the functionality of StatsCalculator::appendValue() in the
+     * C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to parse the file.
+     * \param value - A double precision value to append to the "numericValues" 
+     * member datum of the StatsCalculator instance to which handle refers.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcAppendValue(int handle, double value);
+    
+    /** \brief Expose the functionality of StatsCalculator::appendValues() in the
+     * C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * append the values.
+     * \param values - A pointer to the first element of an array of values. The
+     * values are copied (or, when streaming, accumulated) before the call returns.
+     * \param count - The number of elements in the array.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if values is null and count is
+     * non-zero.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcAppendValues(int handle, const double * values, size_t count);
+    
+    /** \brief Expose the functionality of StatsCalculator::setStreaming() in the
+     * C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * start or stop streaming.
+     * \param enabled - Non-zero to enable streaming, zero to disable it.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcSetStreaming(int handle, int enabled);
+    
+    /** \brief Expose the functionality of StatsCalculator::appendWeightedValues()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * append the values.
+     * \param values - A pointer to the first element of an array of values.
+     * \param weights - A pointer to the first element of an array of weights with
+     * the same number of elements.
+     * \param count - The number of elements in each array.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if values or weights is null and
+     * count is non-zero.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcAppendWeightedValues(int handle, const double * values,
+                                                                 const double * weights, size_t count);
+    
+    /** \brief Expose the functionality of StatsCalculator::ingestWeightedFile() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to parse the file.
+     * \param fileName - A C-string specifying the path of the file to be
+     * opened and parsed.
+     * \param column - One of the StatsCalcWeightColumn values.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid, STATSCALC_NULL_ARGUMENT if fileName is null,
+     * STATSCALC_INVALID_ARGUMENT if column is not one of the StatsCalcWeightColumn
+     * values or STATSCALC_FILE_ERROR if the file could not be opened.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcReadWeightedFile(int handle, const char * fileName, int column);
+    
+    /** \brief Expose the functionality of StatsCalculator::getWeightedStatistics()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to return its weighted statistics.
+     * \param result - A pointer to a caller-allocated StatsWeightedResult structure
+     * that is filled with the weighted statistics.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no values with usable
+     * weights have been appended (in which case the statistics are zero-filled),
+     * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT
+     * if result is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetWeighted(int handle, StatsWeightedResult * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::appendPairs() in the
+     * C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * accumulate the pairs.
+     * \param x - A pointer to the first element of the first channel.
+     * \param y - A pointer to the first element of the second channel.
+     * \param count - The number of elements in each array.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if x or y is null and count is
+     * non-zero.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcAppendPairs(int handle, const double * x, const double * y, size_t count);
+    
+    /** \brief Expose the functionality of StatsCalculator::ingestPairsFile() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to parse the file.
+     * \param fileName - A C-string specifying the path of the file to be
+     * opened and parsed.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid, STATSCALC_NULL_ARGUMENT if fileName is null or
+     * STATSCALC_FILE_ERROR if the file could not be opened.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcReadPairsFile(int handle, const char * fileName);
+    
+    /** \brief Expose the functionality of StatsCalculator::getBivariateStatistics()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to return its bivariate statistics.
+     * \param result - A pointer to a caller-allocated StatsBivariateResult
+     * structure that is filled with the bivariate statistics.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no pairs have been
+     * appended (in which case the statistics are zero-filled),
+     * STATSCALC_INVALID_HANDLE if the handle is not valid or
+     * STATSCALC_NULL_ARGUMENT if result is null.
      */
-    std::vector<double> numericValues;
+	STATSCALCULATORLABVIEW_API int statsCalcGetBivariate(int handle, StatsBivariateResult * result);
     
-    /** \brief Private method that actually computes the sum of the stored numeric
-     * values.
+    /** \brief Expose the functionality of StatsCalculator::setTimeResolutions() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose buckets of time
+     * should be configured.
+     * \param widths - A pointer to the first element of an array holding the
+     * width of the buckets at each resolution, in ascending order. Each must be a
+     * whole multiple (of at least two) of the one before it.
+     * \param count - The number of resolutions, or zero to disable the buckets.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid, STATSCALC_NULL_ARGUMENT if widths is null and count is
+     * non-zero or STATSCALC_INVALID_ARGUMENT if the widths do not form a cascade.
      */
-    double computeSum();
+	STATSCALCULATORLABVIEW_API int statsCalcSetTimeResolutions(int handle, const double * widths, size_t count);
     
-    /** \brief Private method that actually computes the mean of the stored numeric
-     * values.
+    /** \brief Expose the functionality of StatsCalculator::appendTimedValues() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator to which the values
+     * should be appended.
+     * \param times - A pointer to the first element of the array of timestamps.
+     * \param values - A pointer to the first element of the array of values.
+     * \param count - The number of elements in each array.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if times or values is null and
+     * count is non-zero.
      */
-    double computeMean();
+	STATSCALCULATORLABVIEW_API int statsCalcAppendTimedValues(int handle, const double * times, const double * values,
+                                                              size_t count);
     
-    /** \brief Private method that actually computes the standard deviation of the
-     * stored numeric values.
+    /** \brief Expose the functionality of StatsCalculator::ingestTimedFile() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to parse the file.
+     * \param fileName - A C-string specifying the path of the file to be
+     * opened and parsed.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid, STATSCALC_NULL_ARGUMENT if fileName is null or
+     * STATSCALC_FILE_ERROR if the file could not be opened.
      */
-    double computeStandardDeviation();
+	STATSCALCULATORLABVIEW_API int statsCalcReadTimedFile(int handle, const char * fileName);
     
-public:
+    /** \brief Expose the functionality of StatsCalculator::flushTimeBuckets() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose open buckets
+     * of time should be completed.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcFlushTimeBuckets(int handle);
     
-    /** \brief Default constructor.
+    /** \brief Expose the functionality of StatsCalculator::takeTimeBuckets() in
+     * the C API. The buckets that are copied are removed, so repeated calls
+     * return each completed bucket once.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose completed
+     * buckets of time are required.
+     * \param resolution - The index of the resolution, in the order given to
+     * statsCalcSetTimeResolutions().
+     * \param buckets - A pointer to a caller-allocated array of "capacity"
+     * StatsTimeBucket structures, which receives the oldest completed buckets.
+     * It may be null if capacity is zero.
+     * \param capacity - The number of elements in the array.
+     * \param count - A pointer to a caller-allocated size_t that receives the
+     * number of elements that were filled.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if there were no
+     * completed buckets, STATSCALC_INVALID_HANDLE if the handle is not valid,
+     * STATSCALC_NULL_ARGUMENT if count is null (or buckets is null and capacity
+     * is non-zero) or STATSCALC_INVALID_ARGUMENT if the resolution does not exist.
      */
-    StatsCalculator();
+	STATSCALCULATORLABVIEW_API int statsCalcTakeTimeBuckets(int handle, size_t resolution, StatsTimeBucket * buckets,
+                                                            size_t capacity, size_t * count);
     
-    /** \brief Destructor.
+    /** \brief Expose the functionality of StatsCalculator::writeTimeBuckets() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose completed
+     * buckets of time should be written.
+     * \param fileName - A C-string specifying the path of the file to be
+     * written.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid, STATSCALC_NULL_ARGUMENT if fileName is null or
+     * STATSCALC_FILE_ERROR if the file could not be opened.
      */
-    ~StatsCalculator();
+	STATSCALCULATORLABVIEW_API int statsCalcWriteTimeBuckets(int handle, const char * fileName);
     
-    /** \brief Public method returns the sum of the internally stored numeric values.
+    /** \brief Expose the functionality of StatsCalculator::setChangeDetection() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose change detection
+     * should be configured.
+     * \param method - One of the StatsCalcChangeMethod values.
+     * STATSCALC_CHANGE_NONE disables the detection.
+     * \param threshold - The threshold h, in standard deviations (e.g. 5).
+     * \param drift - The drift k, in standard deviations (e.g. 0.5).
+     * \param warmupCount - The number of values from which the mean and standard
+     * deviation are learned at the start and after every detection (e.g. 100).
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_INVALID_ARGUMENT if method is not one of the
+     * StatsCalcChangeMethod values or another parameter is out of range.
      */
-    double getSum();
+	STATSCALCULATORLABVIEW_API int statsCalcSetChangeDetection(int handle, int method, double threshold, double drift,
+                                                               long long warmupCount);
     
-    /** \brief Public method returns the mean of the internally stored numeric values.
+    /** \brief Expose the functionality of StatsCalculator::setChangeCallback() in
+     * the C API, so that a change is signalled as soon as it is detected instead
+     * of being polled for.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose detections
+     * should be signalled.
+     * \param callback - The function to call, or null to call none. It is called
+     * on the thread that appends the value at which the change is detected (a
+     * worker thread during statsCalcReadFileAsync()), and must not call any C API
+     * function for the same handle.
+     * \param userData - A pointer that is passed to the function.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
      */
-    double getMean();
+	STATSCALCULATORLABVIEW_API int statsCalcSetChangeCallback(int handle, StatsCalcChangeCallback callback,
+                                                              void * userData);
     
-    /** \brief Public method returns the standard deviation of the internally stored
-     * numeric values.
+    /** \brief Expose the functionality of StatsCalculator::takeChangePoint() in
+     * the C API. The status serves as a flag that is raised when a change is
+     * detected and lowered when the change is taken.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose most recent
+     * change is required.
+     * \param change - A pointer to a caller-allocated StatsChangePoint structure
+     * that receives the change.
+     *
+     * \return STATSCALC_OK if a change was taken, STATSCALC_NO_DATA if none has
+     * been detected since the previous call, STATSCALC_INVALID_HANDLE if the
+     * handle is not valid or STATSCALC_NULL_ARGUMENT if change is null.
      */
-    double getStandardDeviation();
+	STATSCALCULATORLABVIEW_API int statsCalcTakeChangePoint(int handle, StatsChangePoint * change);
     
-    /** \brief Public method that accepts a appends a new double precision value to  
-     * the "numericValues" member datum.
+    /** \brief Expose the functionality of StatsCalculator::getChangeCount() in
+     * the C API.
      *
-     * \param value - A double precision value to append to the "numericValues" member 
-     * datum.
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose detections
+     * should be counted.
+     * \param result - A pointer to a caller-allocated long long that receives
+     * the number of changes detected.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if result is null.
      */
-    void appendValue(double value);
+	STATSCALCULATORLABVIEW_API int statsCalcGetChangeCount(int handle, long long * result);
     
-    /** \brief Public method that reads a list of whitespace-separated numeric
-     * values from a text file. It appends those values to the "numericValues"
-     * member datum.
+    /** \brief Expose the functionality of StatsCalculator::subscribe() in the C
+     * API, so that new statistics are delivered to the caller instead of being
+     * polled for with statsCalcGetAll(). Any previous subscription is cancelled.
      *
-     * \param infileName - A string specifying to the path of a text file containing
-     *    a whitespace-separated list of numeric values.
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose statistics
+     * should be delivered.
+     * \param callback - The function that receives the snapshots. It is called
+     * on a background thread that belongs to the subscription, and must not call
+     * any C API function for the same handle.
+     * \param userData - A pointer that is passed to the function.
+     * \param everySamples - The number of values after which a snapshot is
+     * delivered, or zero.
+     * \param everyMilliseconds - The period, in milliseconds, with which
+     * snapshots are delivered while values are being appended, or zero.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid, STATSCALC_NULL_ARGUMENT if callback is null or
+     * STATSCALC_INVALID_ARGUMENT if everySamples is negative or both intervals
+     * are zero.
      */
-    void readFile(const std::string & infileName);
+	STATSCALCULATORLABVIEW_API int statsCalcSubscribe(int handle, StatsCalcSnapshotCallback callback, void * userData,
+                                                      long long everySamples, unsigned everyMilliseconds);
     
-    /** \brief Public method that prints a summary of the statistical properties that this
-     * class computes to the terminal.
+    /** \brief Expose the functionality of StatsCalculator::unsubscribe() in the
+     * C API. Subscriptions are also cancelled by statsCalcDestroy().
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose subscription
+     * should be cancelled.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
      */
-    void printStats();
+	STATSCALCULATORLABVIEW_API int statsCalcUnsubscribe(int handle);
     
-    /** \brief Public method that writes a summary of the statistical properties that this
-     * class computes to a caller-specified output file.
+    /** \brief Expose the functionality of StatsCalculator::publishStatistics()
+     * in the C API, e.g. to deliver the final statistics once a producer has
+     * finished appending values.
      *
-     * \param outfileName - A string specifying to the path for a text file to which
-     * the statistics summary should be written.
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose statistics
+     * should be delivered.
+     *
+     * \return STATSCALC_OK on success (including when there is no subscription)
+     * or STATSCALC_INVALID_HANDLE if the handle is not valid.
      */
-    void writeStats(const std::string & outfileName);
+	STATSCALCULATORLABVIEW_API int statsCalcPublishStatistics(int handle);
     
-};
-
-/* This is the end of the first block of C++-only code, so end the __cplusplus conditional block.
- */
-#endif // __cplusplus was defined
-
-/* Now declare some WAPPER FUNCTIONS that provide access for C compilers to
- * the functionality provided by StatsCalculator.
- * 
- * The IMPLEMENTATIONS of these functions will reference C++-only language 
- * constructs that must be compiled using a C++ compiler. However the default
- * NAME MANGLING behaviour of the C++ compiler must be suppressed. This is 
- * done by specifying that the functions should be declared with C-STYLE
- * LINKAGE. This is achieved by enclosing the function definititions within a
- * code block that is prpended with the keyword "extern" and the string literal
- * "C".
- *
- * The final complication is that C compilers cannot parse the 'extern "C"' token
- * pair, so a PREPROCESSOR CONDITIONAL that depends on the __cplusplus macro
- * is required. Another conditional block is also required to hide the closing 
- * brace of the code block from C compilers.
- */
-#ifdef __cplusplus
-extern "C" {
-#endif  // __cplusplus was defined
+    /** \brief Expose the functionality of StatsCalculator::setLiveStatisticsEnabled()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose statistics
+     * should be published.
+     * \param enabled - Non-zero to publish the statistics, zero to stop.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcSetLiveStatistics(int handle, int enabled);
     
-    /** \brief C API function that instantiates a StatsCalculator object and returns an
-     * integer "handle" to the user that can be used to reference the object.
+    /** \brief Expose the functionality of StatsCalculator::getLiveStatistics() in
+     * the C API. The pointer that is obtained can be passed, together with the
+     * handle, to statsCalcReadLiveStatistics() on any thread, whereas the other C
+     * API functions must not be called concurrently.
      *
-     * \return An integer "handle" that uniquely refers to the instantiated 
-     * StatsCalculator object.
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose statistics
+     * should be read.
+     * \param live - A pointer to a caller-allocated pointer that receives the
+     * address of the live statistics. The address can always be passed to
+     * statsCalcReadLiveStatistics(), but once statsCalcDestroy() has been called
+     * for the handle it no longer describes the instance, and reads fail.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if live is null.
      */
-	STATSCALCULATORLABVIEW_API int statsCalcCreate();
+	STATSCALCULATORLABVIEW_API int statsCalcGetLiveStatistics(int handle, const StatsLiveStatistics ** live);
     
-    /** \brief Destroy a previously instantiated StatsCalculator object.
-     * 
+    /** \brief Read the live statistics of a StatsCalculator instance
+     * consistently, without blocking the thread that appends values to it. Unlike
+     * the other C API functions, this function may be called by any number of
+     * threads at once.
+     *
+     * The handle is checked WITHOUT accessing the table of instances: the tag that
+     * is published with the statistics is compared with it in the same consistent
+     * read. Statistics of a destroyed instance, or of a later instance that reuses
+     * its storage, are therefore never returned.
+     *
+     * \param live - A pointer that was obtained from statsCalcGetLiveStatistics().
+     * \param handle - The handle that was passed to statsCalcGetLiveStatistics().
+     * \param result - A pointer to a caller-allocated StatsResult structure that
+     * receives the statistics.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NULL_ARGUMENT if either pointer
+     * is null, STATSCALC_INVALID_HANDLE if the handle has been destroyed (or does
+     * not belong to the pointer) or STATSCALC_NO_DATA if no values have been
+     * published.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcReadLiveStatistics(const StatsLiveStatistics * live, int handle,
+                                                               StatsResult * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::setQuantileSketchEnabled()
+     * in the C API.
+     *
      * \param handle - an integer that was returned by statsCalcCreate() and
-     * uniquely references the instance of StatsCalculator that should
-     * be destroyed.
+     * uniquely references the instance of StatsCalculator whose sketch should
+     * be enabled or disabled.
+     * \param enabled - Non-zero to enable the sketch, zero to disable it.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
      */
-	STATSCALCULATORLABVIEW_API void statsCalcDestroy(int handle);
+	STATSCALCULATORLABVIEW_API int statsCalcSetQuantileSketch(int handle, int enabled);
     
-    /** \brief Expose the functionality of StatsCalculator::appendValue() in the
-     * C API.
+    /** \brief Expose the functionality of StatsCalculator::setBootstrapEnabled()
+     * and StatsCalculator::setBootstrapOptions() in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose bootstrap should
+     * be configured.
+     * \param enabled - Non-zero to report bootstrap intervals in the summaries
+     * written by statsCalcWriteStats(), zero to omit them.
+     * \param resampleCount - The number of resamples, which must not be zero.
+     * \param confidenceLevel - The confidence level, strictly between zero and one.
+     * \param seed - The seed of the random number generator.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_INVALID_ARGUMENT (and no change) if resampleCount
+     * or confidenceLevel is out of range.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcSetBootstrap(int handle, int enabled, unsigned resampleCount,
+                                                         double confidenceLevel, unsigned long long seed);
+    
+    /** \brief Expose the functionality of StatsCalculator::setAutocorrelationEnabled()
+     * in the C API.
      *
      * \param handle - an integer that was returned by statsCalcCreate() and
      * uniquely references the instance of StatsCalculator that should
-     * be induced to parse the file.
-     * \param value - A double precision value to append to the "numericValues" 
-     * member datum of the StatsCalculator instance to which handle refers.
+     * be configured.
+     * \param enabled - Non-zero to report the autocorrelation statistics in the
+     * summaries written by statsCalcWriteStats(), zero to omit them.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcSetAutocorrelation(int handle, int enabled);
+    
+    /** \brief Expose the functionality of StatsCalculator::setFrequencySketchesEnabled()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose frequency
+     * sketches should be enabled or disabled.
+     * \param enabled - Non-zero to enable the sketches, zero to disable (and
+     * discard) them.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcSetFrequencySketches(int handle, int enabled);
+    
+    /** \brief Expose the functionality of StatsCalculator::mergeFrequencySketches()
+     * in the C API, so that instances that ingested separate shards of the values
+     * (e.g. on separate threads) can be combined.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose frequency
+     * sketches should absorb those of the other.
+     * \param sourceHandle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose frequency
+     * sketches should be merged. It is not changed.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if either handle
+     * is not valid or STATSCALC_INVALID_ARGUMENT if the frequency sketches of the
+     * first instance are disabled.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcMergeFrequencySketches(int handle, int sourceHandle);
+    
+    /** \brief Expose the functionality of StatsCalculator::setReservoirSampling()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose reservoir
+     * sampling should be configured.
+     * \param size - The largest number of values in the sample, or zero to
+     * disable sampling.
+     * \param seed - The seed of the random numbers. Instances whose samples are
+     * to be merged must be given different seeds.
+     *
+     * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle
+     * is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcSetReservoirSampling(int handle, size_t size, unsigned long long seed);
+    
+    /** \brief Expose the functionality of StatsCalculator::mergeReservoirSample()
+     * in the C API, so that instances that ingested separate shards of the values
+     * (e.g. on separate threads) can be combined into a uniform sample of them all.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose reservoir sample
+     * should absorb that of the other.
+     * \param sourceHandle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose reservoir sample
+     * should be merged. It is not changed.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if either handle
+     * is not valid or STATSCALC_INVALID_ARGUMENT if sampling is disabled in the
+     * first instance or the sample of the second is full and smaller.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcMergeReservoirSamples(int handle, int sourceHandle);
+    
+    /** \brief Expose the functionality of StatsCalculator::setNonFiniteMode() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose mode should
+     * be set.
+     * \param mode - One of the StatsCalcNonFiniteMode values.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_INVALID_ARGUMENT if mode is not one of the
+     * StatsCalcNonFiniteMode values.
      */
-	STATSCALCULATORLABVIEW_API void statsCalcAppendValue(int handle, double value);
+	STATSCALCULATORLABVIEW_API int statsCalcSetNonFiniteMode(int handle, int mode);
     
     /** \brief Expose the functionality of StatsCalculator::readFile() in the
      * C API.
@@ -170,8 +2675,87 @@ extern "C" {
      * be induced to parse the file.
      * \param fileName - A C-string specifying the path of the file to be
      * opened and parsed.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if fileName is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcReadFile(int handle, const char * fileName);
+    
+    /** \brief Asynchronous version of statsCalcReadFile(). The file is parsed by a
+     * worker thread and the function returns immediately. Files loaded into
+     * different handles are parsed in parallel.
+     *
+     * Use statsCalcPoll() to monitor the load or statsCalcWait() to wait for it.
+     * Calling any other C API function for the same handle while the load is in
+     * progress waits for it to finish first. The outcome of the load is still
+     * returned by the next call to statsCalcPoll() or statsCalcWait().
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to parse the file.
+     * \param fileName - A C-string specifying the path of the file to be
+     * opened and parsed. The string is copied, so it need not outlive the call.
+     *
+     * \return STATSCALC_OK if the load was scheduled, STATSCALC_BUSY if a previous
+     * load into the same handle has not yet completed, STATSCALC_INVALID_HANDLE
+     * if the handle is not valid or STATSCALC_NULL_ARGUMENT if fileName is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcReadFileAsync(int handle, const char * fileName);
+    
+    /** \brief Check, without blocking, whether an asynchronous load that was
+     * started by statsCalcReadFileAsync() has completed.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate().
+     * \param progress - An optional pointer to a double that receives the fraction
+     * of the file (bytes consumed divided by total bytes) that has been parsed.
+     * It may be null.
+     *
+     * \return STATSCALC_BUSY if the load is still in progress. Otherwise the outcome
+     * of the load: STATSCALC_OK, or STATSCALC_FILE_ERROR if the file could not be
+     * opened. STATSCALC_OK is also returned if no load was started.
+     * STATSCALC_INVALID_HANDLE is returned if the handle is not valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcPoll(int handle, double * progress);
+    
+    /** \brief Block until an asynchronous load that was started by
+     * statsCalcReadFileAsync() has completed.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate().
+     *
+     * \return The outcome of the load: STATSCALC_OK, or STATSCALC_FILE_ERROR if
+     * the file could not be opened. STATSCALC_OK is also returned if no load was
+     * started, or if its outcome has already been returned by statsCalcPoll() or
+     * statsCalcWait(). STATSCALC_INVALID_HANDLE is returned if the handle is not
+     * valid.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcWait(int handle);
+    
+    /** \brief Expose the functionality of StatsCalculator::setParsePolicy() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose policy should
+     * be set.
+     * \param policy - One of the StatsCalcParsePolicy values.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_INVALID_ARGUMENT if policy is not one of the
+     * StatsCalcParsePolicy values.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcSetParsePolicy(int handle, int policy);
+    
+    /** \brief Expose the functionality of StatsCalculator::getParseReport() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that parsed the file.
+     * \param report - A pointer to a caller-allocated StatsParseReport structure
+     * that is filled with the outcome of the most recent file parse.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if report is null.
      */
-	STATSCALCULATORLABVIEW_API void statsCalcReadFile(int handle, const char * fileName);
+	STATSCALCULATORLABVIEW_API int statsCalcGetParseReport(int handle, StatsParseReport * report);
     
     /** \brief Expose the functionality of StatsCalculator::writeStats() in the
      * C API.
@@ -181,8 +2765,11 @@ extern "C" {
      * be induced to write its computed statistics to a file.
      * \param fileName - A C-string specifying the path of the file to be
      * written.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if fileName is null.
      */
-	STATSCALCULATORLABVIEW_API void statsCalcWriteStats(int handle, const char * fileName);
+	STATSCALCULATORLABVIEW_API int statsCalcWriteStats(int handle, const char * fileName);
     
     /** \brief Expose the functionality of StatsCalculator::getSum() in the
      * C API.
@@ -219,6 +2806,204 @@ extern "C" {
      * StatsCalculator instance to which handle refers.
      */
 	STATSCALCULATORLABVIEW_API double statsCalcGetStdDev(int handle);
+    
+    /** \brief Expose the functionality of StatsCalculator::getRobustStatistics()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to compute its robust statistics.
+     * \param trimFraction - The fraction of the values to trim (or winsorize)
+     * from each end, which must be at least zero and less than one half.
+     * \param result - A pointer to a caller-allocated StatsRobustResult
+     * structure that is filled with the statistics.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance holds no
+     * values, STATSCALC_INVALID_HANDLE if the handle is not valid,
+     * STATSCALC_NULL_ARGUMENT if result is null or STATSCALC_INVALID_ARGUMENT if
+     * trimFraction is out of range.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetRobust(int handle, double trimFraction, StatsRobustResult * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::getBootstrapIntervals()
+     * in the C API. The intervals are computed whether or not they are enabled
+     * for reporting, using the options set by statsCalcSetBootstrap().
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to compute its bootstrap intervals.
+     * \param result - A pointer to a caller-allocated StatsBootstrapResult
+     * structure that is filled with the intervals.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance stores no
+     * values, STATSCALC_INVALID_HANDLE if the handle is not valid or
+     * STATSCALC_NULL_ARGUMENT if result is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetBootstrap(int handle, StatsBootstrapResult * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::getAutocorrelationStatistics()
+     * in the C API. The statistics are computed whether or not they are enabled
+     * for reporting.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to compute its autocorrelation statistics.
+     * \param result - A pointer to a caller-allocated StatsAutocorrelationResult
+     * structure that is filled with the statistics.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance stores no
+     * values, STATSCALC_INVALID_HANDLE if the handle is not valid or
+     * STATSCALC_NULL_ARGUMENT if result is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetAutocorrelationStatistics(int handle,
+                                                                         StatsAutocorrelationResult * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::getAutocorrelations()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose autocorrelations
+     * are required.
+     * \param values - A pointer to a caller-allocated array of at least lagCount
+     * doubles, which receives the autocorrelations at lags 0 to lagCount - 1.
+     * \param lagCount - The number of lags.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance stores no
+     * values (in which case the autocorrelations are zero-filled),
+     * STATSCALC_INVALID_HANDLE if the handle is not valid or
+     * STATSCALC_NULL_ARGUMENT if values is null and lagCount is non-zero.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcCopyAutocorrelations(int handle, double * values, size_t lagCount);
+    
+    /** \brief Expose the functionality of StatsCalculator::getDistinctCount() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose distinct values
+     * should be counted.
+     * \param result - A pointer to a caller-allocated double that receives the
+     * estimated number of distinct values.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no values have been
+     * accumulated into the frequency sketches (in which case the estimate is
+     * zero), STATSCALC_INVALID_HANDLE if the handle is not valid or
+     * STATSCALC_NULL_ARGUMENT if result is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetDistinctCount(int handle, double * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::estimateFrequency() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose frequency
+     * sketches should be queried.
+     * \param value - The value whose occurrences should be counted.
+     * \param result - A pointer to a caller-allocated long long that receives
+     * an upper bound on the number of times the value occurred.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no values have been
+     * accumulated into the frequency sketches, STATSCALC_INVALID_HANDLE if the
+     * handle is not valid or STATSCALC_NULL_ARGUMENT if result is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcEstimateFrequency(int handle, double value, long long * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::getHeavyHitters() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose most frequent
+     * values are required.
+     * \param hitters - A pointer to a caller-allocated array of "capacity"
+     * StatsHeavyHitter structures, which receives the most frequent values in
+     * descending order of their estimated counts. It may be null if capacity is zero.
+     * \param capacity - The number of elements in the array.
+     * \param count - A pointer to a caller-allocated size_t that receives the
+     * number of elements that were filled.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no values have been
+     * accumulated into the frequency sketches, STATSCALC_INVALID_HANDLE if the
+     * handle is not valid or STATSCALC_NULL_ARGUMENT if count is null (or hitters
+     * is null and capacity is non-zero).
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetHeavyHitters(int handle, StatsHeavyHitter * hitters, size_t capacity,
+                                                            size_t * count);
+    
+    /** \brief Expose the functionality of StatsCalculator::getReservoirSample()
+     * in the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose reservoir
+     * sample is required.
+     * \param values - A pointer to a caller-allocated array of "capacity"
+     * doubles, which receives the sampled values. It may be null if capacity is
+     * zero.
+     * \param capacity - The number of elements in the array. An array as large
+     * as the size given to statsCalcSetReservoirSampling() receives the whole sample.
+     * \param count - A pointer to a caller-allocated size_t that receives the
+     * number of elements that were filled.
+     * \param sampledCount - An optional pointer to a long long that receives the
+     * number of values the sample was drawn from. It may be null.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the sample is empty,
+     * STATSCALC_INVALID_HANDLE if the handle is not valid or
+     * STATSCALC_NULL_ARGUMENT if count is null (or values is null and capacity
+     * is non-zero).
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcCopyReservoirSample(int handle, double * values, size_t capacity,
+                                                                size_t * count, long long * sampledCount);
+    
+    /** \brief Expose the functionality of StatsCalculator::getQuantile() in the
+     * C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to compute the quantile.
+     * \param probability - The probability, between zero and one.
+     * \param result - A pointer to a caller-allocated double that receives the
+     * quantile.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance holds no
+     * values, STATSCALC_INVALID_HANDLE if the handle is not valid,
+     * STATSCALC_NULL_ARGUMENT if result is null or STATSCALC_INVALID_ARGUMENT if
+     * probability is not between zero and one.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetQuantile(int handle, double probability, double * result);
+    
+    /** \brief Expose the functionality of StatsCalculator::getSortedValues() in
+     * the C API.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator whose sorted values
+     * are required.
+     * \param values - A pointer to a caller-allocated array that receives (at
+     * most "capacity" of) the sorted values. It may be null if capacity is zero.
+     * \param capacity - The number of elements in the array.
+     * \param count - A pointer to a caller-allocated size_t that receives the
+     * total number of sorted values, so that a call with zero capacity can be
+     * used to size the array.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle
+     * is not valid or STATSCALC_NULL_ARGUMENT if count is null, or values is
+     * null and capacity is non-zero.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcCopySortedValues(int handle, double * values, size_t capacity,
+                                                             size_t * count);
+    
+    /** \brief Expose the functionality of StatsCalculator::getStatistics() in the
+     * C API. Every statistic is obtained with a single call and a single pass over
+     * the stored data.
+     *
+     * \param handle - an integer that was returned by statsCalcCreate() and
+     * uniquely references the instance of StatsCalculator that should
+     * be induced to compute its statistics.
+     * \param result - A pointer to a caller-allocated StatsResult structure that
+     * is filled with the statistics.
+     *
+     * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance holds no
+     * values (in which case the statistics are zero-filled), STATSCALC_INVALID_HANDLE
+     * if the handle is not valid or STATSCALC_NULL_ARGUMENT if result is null.
+     */
+	STATSCALCULATORLABVIEW_API int statsCalcGetAll(int handle, StatsResult * result);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,112 @@
+// Define the STATSCALCULATORWORKERPOOL_H macro to act as an include guard
+#ifndef STATSCALCULATORWORKERPOOL_H
+#define STATSCALCULATORWORKERPOOL_H
+
+/* This header file declares C++-only language constructs. It is used by the
+ * implementation of the C API, but it must never be included by C code.
+ */
+
+// Include the <condition_variable> header to allow idle threads to sleep.
+#include <condition_variable>
+
+// Include the <deque> header to provide the STL std::deque type.
+#include <deque>
+
+// Include the <functional> header to provide the STL std::function type.
+#include <functional>
+
+// Include the <mutex> header to provide the STL std::mutex type.
+#include <mutex>
+
+// Include the <thread> header to provide the STL std::thread type.
+#include <thread>
+
+// Include the <vector> header to provide the STL std::vector type.
+#include <vector>
+
+/** \class StatsCalculatorWorkerPool
+ * The StatsCalculatorWorkerPool class owns a fixed number of worker threads
+ * that execute tasks taken from a shared first-in-first-out queue. It is used
+ * to perform long-running work (such as parsing a large input file) without
+ * blocking the thread that requested it.
+ *
+ * Tasks that are submitted while every worker is busy wait in the queue until
+ * a worker becomes free. Tasks that are still queued when the pool is
+ * destroyed are executed before the destructor returns.
+ */
+class StatsCalculatorWorkerPool {
+    
+    /** \brief The worker threads owned by the pool.
+     */
+    std::vector<std::thread> workers;
+    
+    /** \brief Tasks that have been submitted but not yet started.
+     */
+    std::deque<std::function<void()> > tasks;
+    
+    /** \brief Mutex that protects "tasks" and "stopping".
+     */
+    std::mutex tasksMutex;
+    
+    /** \brief Condition variable that is notified when a task is submitted
+     * or the pool is stopping.
+     */
+    std::condition_variable tasksAvailable;
+    
+    /** \brief True once the destructor has asked the workers to finish.
+     */
+    bool stopping;
+    
+    /** \brief Private method executed by every worker thread. It repeatedly
+     * removes a task from the queue and executes it.
+     */
+    void workerLoop();
+    
+    // Copying a pool of threads is meaningless, so copying is prohibited.
+    StatsCalculatorWorkerPool(const StatsCalculatorWorkerPool &);
+    StatsCalculatorWorkerPool & operator=(const StatsCalculatorWorkerPool &);
+    
+public:
+    
+    /** \brief Constructor that starts the worker threads.
+     *
+     * \param threadCount - The number of worker threads to start. If zero, one
+     * thread per hardware thread is started.
+     */
+    explicit StatsCalculatorWorkerPool(unsigned threadCount = 0);
+    
+    /** \brief Destructor that waits for all submitted tasks to complete and then
+     * stops the worker threads.
+     */
+    ~StatsCalculatorWorkerPool();
+    
+    /** \brief Public method that queues a task for execution by a worker thread.
+     *
+     * \param task - A callable object that accepts no arguments.
+     */
+    void submit(const std::function<void()> & task);
+    
+    /** \brief Public method that executes a number of independent tasks, sharing
+     * them between the calling thread and worker threads, and returns once every
+     * task has completed.
+     *
+     * \param taskCount - The number of tasks.
+     * \param task - A callable object that accepts the index of a task, from zero
+     * to taskCount - 1.
+     * \param maxThreads - The maximum number of threads (including the calling
+     * thread) that may execute tasks. Zero means one per worker thread.
+     */
+    void parallelFor(size_t taskCount, const std::function<void(size_t)> & task, unsigned maxThreads = 0);
+    
+    /** \brief Public method returns the number of worker threads in the pool.
+     */
+    unsigned size() const;
+    
+    /** \brief Public static method returns a pool shared by the whole library.
+     * The pool is created the first time the method is called.
+     */
+    static StatsCalculatorWorkerPool & shared();
+    
+};
+
+#endif /* End #ifndef STATSCALCULATORWORKERPOOL_H preprocessor conditional block. */
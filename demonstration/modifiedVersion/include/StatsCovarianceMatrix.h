@@ -0,0 +1,183 @@
+// Define the STATSCOVARIANCEMATRIX_H macro to act as an include guard
+#ifndef STATSCOVARIANCEMATRIX_H
+#define STATSCOVARIANCEMATRIX_H
+
+/* This header file declares C++-only language constructs. It must never be
+ * included by C code.
+ */
+
+// Include the <stddef.h> header to provide the size_t type.
+#include <stddef.h>
+
+// Include the <vector> header to provide the STL std::vector type.
+#include <vector>
+
+/** \class StatsCovarianceMatrix
+ * The StatsCovarianceMatrix class accumulates the means and the full covariance
+ * matrix of many channels (typically 64 to 1024) that are sampled together, as
+ * required for a principal component analysis. Each sample is a ROW holding one
+ * value for every channel, and rows are stored row-major: value c of row k is
+ * element k*channelCount + c.
+ *
+ * Updating the co-moment matrix with the outer product of every row in turn
+ * reads and writes the whole matrix once per row, so for more than a few dozen
+ * channels the cost is dominated by memory traffic. Instead, rows are collected
+ * into blocks of "blockRows" and each block is folded into the matrix with a
+ * single rank-k update (a symmetric matrix multiplication, like the BLAS
+ * routine DSYRK). The update is divided into square tiles of "tileChannels"
+ * channels so that the operands of each tile fit in the processor cache, and
+ * the tiles are shared between the calling thread and the threads of
+ * StatsCalculatorWorkerPool::shared().
+ *
+ * Each block is centred on its own mean before the update and then combined
+ * with the earlier rows using the pairwise formula of Chan et al., so the
+ * result is as accurate as a two-pass computation. Only the upper triangle of
+ * the co-moment matrix is maintained; the lower triangle is filled in when the
+ * matrix is copied out.
+ */
+class StatsCovarianceMatrix {
+
+    /** \brief The number of values in each row.
+     */
+    size_t channelCount;
+
+    /** \brief The number of rows that have been folded into "means" and "coMoments".
+     */
+    long long count;
+
+    /** \brief The mean of each channel.
+     */
+    std::vector<double> means;
+
+    /** \brief The sums of the products of the deviations of every pair of channels
+     * from their means, stored row-major. Only elements with column >= row are valid.
+     */
+    std::vector<double> coMoments;
+
+    /** \brief Rows that were appended individually and have not yet been folded
+     * into the matrix.
+     */
+    std::vector<double> pendingRows;
+
+    /** \brief The number of rows in "pendingRows".
+     */
+    size_t pendingRowCount;
+
+    /** \brief Scratch space that holds a block of rows centred on the block mean.
+     */
+    std::vector<double> centredRows;
+
+    /** \brief Scratch space that holds the mean of each channel in a block.
+     */
+    std::vector<double> blockMeans;
+
+    /** \brief The maximum number of threads that may share an update, or zero to
+     * use one per thread of the shared worker pool.
+     */
+    unsigned threadCount;
+
+    /** \brief Private method that folds a block of at most "blockRows" rows into
+     * the means and the co-moment matrix.
+     */
+    void updateBlock(const double * rows, size_t rowCount);
+
+    /** \brief Private method that folds the pending rows into the matrix.
+     */
+    void flushPendingRows();
+
+public:
+
+    /** \brief The number of rows in each block that is folded into the matrix
+     * with a single rank-k update.
+     */
+    static const size_t blockRows = 64;
+
+    /** \brief The width, in channels, of the square tiles into which each rank-k
+     * update is divided.
+     */
+    static const size_t tileChannels = 64;
+
+    /** \brief Constructor that creates an empty accumulator.
+     *
+     * \param channelCount - The number of values in each row.
+     */
+    explicit StatsCovarianceMatrix(size_t channelCount);
+
+    /** \brief Public method that sets the maximum number of threads that may share
+     * each update.
+     *
+     * \param threads - The number of threads. One performs every update on the
+     * calling thread. Zero (the default) allows as many threads as there are in
+     * StatsCalculatorWorkerPool::shared().
+     */
+    void setThreadCount(unsigned threads);
+
+    /** \brief Public method that returns the number of values in each row.
+     */
+    size_t getChannelCount() const;
+
+    /** \brief Public method that returns the number of rows that have been appended.
+     */
+    long long getCount() const;
+
+    /** \brief Public method that appends a single row.
+     *
+     * \param row - A pointer to the first of "channelCount" values.
+     */
+    void appendRow(const double * row);
+
+    /** \brief Public method that appends several rows that are stored contiguously.
+     *
+     * \param rows - A pointer to the first value of the first row.
+     * \param rowCount - The number of rows.
+     */
+    void appendRows(const double * rows, size_t rowCount);
+
+    /** \brief Public method that accumulates every row summarized by another
+     * instance with the same number of channels.
+     *
+     * \param other - The instance to merge. Its pending rows are folded into its
+     * own matrix first.
+     *
+     * \return True on success, or false if the numbers of channels differ.
+     */
+    bool merge(StatsCovarianceMatrix & other);
+
+    /** \brief Public method that returns the mean of each channel.
+     */
+    const std::vector<double> & getMeans();
+
+    /** \brief Public method that returns the covariance of two channels.
+     *
+     * \param first - The index of the first channel.
+     * \param second - The index of the second channel.
+     * \param sample - If true, the unbiased (sample) covariance is returned rather
+     * than the population covariance.
+     */
+    double getCovariance(size_t first, size_t second, bool sample = false);
+
+    /** \brief Public method that copies the complete (symmetric) covariance matrix.
+     *
+     * \param matrix - A pointer to space for channelCount*channelCount values,
+     * which are written row-major.
+     * \param sample - If true, the unbiased (sample) covariances are written
+     * rather than the population covariances.
+     */
+    void getCovarianceMatrix(double * matrix, bool sample = false);
+
+    /** \brief Public method that copies the complete correlation matrix. The
+     * correlation of a channel that has zero variance is reported as zero.
+     *
+     * \param matrix - A pointer to space for channelCount*channelCount values,
+     * which are written row-major.
+     */
+    void getCorrelationMatrix(double * matrix);
+
+    /** \brief Public method that discards every row. The number of channels and
+     * the thread count are retained.
+     */
+    void reset();
+
+};
+
+#endif /* End #ifndef STATSCOVARIANCEMATRIX_H preprocessor conditional block. */
@@ -0,0 +1,151 @@
+// Define the STATSINGESTSCHEDULER_H macro to act as an include guard
+#ifndef STATSINGESTSCHEDULER_H
+#define STATSINGESTSCHEDULER_H
+
+/* This header file declares C++-only language constructs. It must never be
+ * included by C code.
+ */
+
+// Include the <condition_variable> header to allow wait() to sleep.
+#include <condition_variable>
+
+// Include the <functional> header to provide the STL std::function type.
+#include <functional>
+
+// Include the <memory> header to provide the STL std::shared_ptr type.
+#include <memory>
+
+// Include the <mutex> header to provide the STL std::mutex type.
+#include <mutex>
+
+// Include the <string> header to provide the STL std::string type.
+#include <string>
+
+/* Include the "StatsCalculator.h" header to provide the StatsCalculator class
+ * and the IngestProgress structure.
+ */
+#include "StatsCalculator.h"
+
+/* Include the "StatsCalculatorWorkerPool.h" header to provide the threads that
+ * perform the chunks of the ingests.
+ */
+#include "StatsCalculatorWorkerPool.h"
+
+/** \struct ScheduledIngest
+ * An incremental ingest that a StatsIngestScheduler is driving: the instance
+ * that is ingesting, and the function to call once it has finished.
+ */
+struct ScheduledIngest {
+    /// The instance whose incremental ingest is being driven.
+    StatsCalculator * calculator;
+    /// The function to call once the ingest has finished, if any.
+    std::function<void(StatsCalculator &)> completion;
+};
+
+/** \class StatsIngestScheduler
+ * The StatsIngestScheduler class MULTIPLEXES many incremental ingests (see
+ * StatsCalculator::beginIngest()) on the few threads of a
+ * StatsCalculatorWorkerPool, so that hundreds of files can be ingested
+ * concurrently without a thread per file.
+ *
+ * Each ingest is driven by a task that ingests ONE chunk with
+ * StatsCalculator::resumeIngest() and, unless the ingest has finished, submits
+ * a task for the next chunk to the back of the pool's queue. The ingests
+ * therefore take turns, a chunk at a time, like coroutines that yield after
+ * every chunk, and each instance is only ever used by one thread at a time.
+ * A worker that is free takes the next chunk of whichever ingest is next in the
+ * queue, so the work is shared between the threads without further locking.
+ */
+class StatsIngestScheduler {
+    
+    /** \brief The pool whose threads perform the chunks.
+     */
+    StatsCalculatorWorkerPool & pool;
+    
+    /** \brief Mutex that protects "pendingCount".
+     */
+    std::mutex pendingMutex;
+    
+    /** \brief Condition variable that is notified when "pendingCount" reaches zero.
+     */
+    std::condition_variable allFinished;
+    
+    /** \brief The number of ingests that have been scheduled but have not yet finished.
+     */
+    size_t pendingCount;
+    
+    /** \brief Private method that counts an ingest that has begun and submits the
+     * task for its first chunk.
+     */
+    void schedule(StatsCalculator & calculator, const std::function<void(StatsCalculator &)> & completion);
+    
+    /** \brief Private method, executed by a worker thread, that ingests one chunk
+     * and then either submits the task for the next chunk or finishes the ingest.
+     */
+    void resume(const std::shared_ptr<ScheduledIngest> & ingest);
+    
+    // Copying a scheduler would duplicate its count of pending ingests, so copying is prohibited.
+    StatsIngestScheduler(const StatsIngestScheduler &);
+    StatsIngestScheduler & operator=(const StatsIngestScheduler &);
+    
+public:
+    
+    /** \brief Constructor.
+     *
+     * \param workerPool - The pool whose threads perform the chunks. By default
+     * the pool that is shared by the whole library is used.
+     */
+    explicit StatsIngestScheduler(StatsCalculatorWorkerPool & workerPool = StatsCalculatorWorkerPool::shared());
+    
+    /** \brief Destructor that waits for every scheduled ingest to finish.
+     */
+    ~StatsIngestScheduler();
+    
+    /** \brief Public method that opens a file and schedules the ingest of its
+     * values into an instance, then returns without parsing anything.
+     *
+     * \param calculator - The instance, which must not be used by any other
+     * thread until the ingest has finished.
+     * \param infileName - The path of the file.
+     * \param completion - A function that is called (on a worker thread) with the
+     * instance once the ingest has finished, or an empty function.
+     * \param progress - An optional pointer to an IngestProgress structure that is
+     * updated after every chunk.
+     *
+     * \return True if the ingest was scheduled, or false if the file could not be
+     * opened or the instance is already ingesting incrementally.
+     */
+    bool ingestFile(StatsCalculator & calculator, const std::string & infileName,
+                    const std::function<void(StatsCalculator &)> & completion = std::function<void(StatsCalculator &)>(),
+                    IngestProgress * progress = 0);
+    
+    /** \brief Public method that schedules the appending of a caller-owned array
+     * of values to an instance, then returns without appending anything.
+     *
+     * \param calculator - The instance, which must not be used by any other
+     * thread until the ingest has finished.
+     * \param values - A pointer to the first element of the array, which must
+     * remain valid until the ingest has finished.
+     * \param count - The number of elements in the array.
+     * \param completion - A function that is called (on a worker thread) with the
+     * instance once the ingest has finished, or an empty function.
+     *
+     * \return True if the ingest was scheduled, or false if the instance is
+     * already ingesting incrementally.
+     */
+    bool appendValues(StatsCalculator & calculator, const double * values, size_t count,
+                      const std::function<void(StatsCalculator &)> & completion = std::function<void(StatsCalculator &)>());
+    
+    /** \brief Public method that blocks until every scheduled ingest has finished.
+     * It must not be called from a worker thread of the pool.
+     */
+    void wait();
+    
+    /** \brief Public method that returns the number of scheduled ingests that
+     * have not yet finished.
+     */
+    size_t getPendingCount();
+    
+};
+
+#endif /* End #ifndef STATSINGESTSCHEDULER_H preprocessor conditional block. */
@@ -0,0 +1,163 @@
+// Define the STATSOBSERVER_H macro to act as an include guard
+#ifndef STATSOBSERVER_H
+#define STATSOBSERVER_H
+
+/* This header file declares C++-only language constructs. It is used by the
+ * implementation of StatsCalculator, but it must never be included by C code.
+ */
+
+// Include the <atomic> header to provide the STL std::atomic type.
+#include <atomic>
+
+// Include the <chrono> header to provide the STL std::chrono::steady_clock type.
+#include <chrono>
+
+// Include the <condition_variable> header to allow the delivery thread to sleep.
+#include <condition_variable>
+
+// Include the <mutex> header to provide the STL std::mutex type.
+#include <mutex>
+
+// Include the <thread> header to provide the STL std::thread type.
+#include <thread>
+
+/* Include the "StatsCalculator.h" header to provide the StatsResult and
+ * StatsSnapshot structures and the StatsCalcSnapshotCallback type.
+ */
+#include "StatsCalculator.h"
+
+/** \class StatsObserver
+ * The StatsObserver class delivers snapshots of the statistics of a
+ * StatsCalculator instance to a subscriber's callback from a background thread
+ * of its own, so that consumers are told about new statistics instead of
+ * polling for them, and producers never wait for the callback to run.
+ *
+ * The thread that appends values (the PRODUCER) posts snapshots with publish().
+ * A snapshot is copied into a single-element MAILBOX under a mutex, which
+ * replaces any snapshot that has not yet been delivered, and the delivery
+ * thread is woken. The delivery thread copies the snapshot out of the mailbox
+ * and calls the callback WITHOUT holding the mutex, so a slow callback delays
+ * only later deliveries, which are coalesced into the most recent snapshot.
+ *
+ * A snapshot is posted every "sampleInterval" values (as counted by
+ * StatsCalculator) and, if "millisecondInterval" is not zero, whenever the
+ * delivery thread has raised the atomic "requested" flag, which it does every
+ * "millisecondInterval" milliseconds. Testing the flag costs the producer one
+ * load, whereas reading the clock after every value would cost tens of
+ * nanoseconds.
+ */
+class StatsObserver {
+    
+    /** \brief The function that receives the snapshots.
+     */
+    StatsCalcSnapshotCallback callback;
+    
+    /** \brief The pointer that is passed to "callback".
+     */
+    void * userData;
+    
+    /** \brief The number of values after which a snapshot is posted, or zero.
+     */
+    long long sampleInterval;
+    
+    /** \brief The period, in milliseconds, with which snapshots are requested, or zero.
+     */
+    unsigned millisecondInterval;
+    
+    /** \brief The time at which the observer was constructed.
+     */
+    std::chrono::steady_clock::time_point started;
+    
+    /** \brief Mutex that protects "mailbox", "mailboxFull", "published" and "stopping".
+     */
+    std::mutex mailboxMutex;
+    
+    /** \brief Condition variable that is notified when a snapshot is posted or
+     * the observer is stopping.
+     */
+    std::condition_variable mailboxChanged;
+    
+    /** \brief The most recently posted snapshot.
+     */
+    StatsSnapshot mailbox;
+    
+    /** \brief True if "mailbox" holds a snapshot that has not yet been delivered.
+     */
+    bool mailboxFull;
+    
+    /** \brief The number of snapshots that have been posted.
+     */
+    long long published;
+    
+    /** \brief The number of snapshots that have been delivered.
+     */
+    std::atomic<long long> delivered;
+    
+    /** \brief True once the destructor has asked the delivery thread to finish.
+     */
+    bool stopping;
+    
+    /** \brief Raised by the delivery thread when a timed snapshot is due and
+     * lowered by publish().
+     */
+    std::atomic<bool> requested;
+    
+    /** \brief The thread that calls "callback".
+     */
+    std::thread deliverer;
+    
+    /** \brief Private method executed by the delivery thread. It delivers the
+     * snapshots in the mailbox and raises "requested" on schedule.
+     */
+    void deliveryLoop();
+    
+    // Copying a thread is meaningless, so copying is prohibited.
+    StatsObserver(const StatsObserver &);
+    StatsObserver & operator=(const StatsObserver &);
+    
+public:
+    
+    /** \brief Constructor that starts the delivery thread.
+     *
+     * \param snapshotCallback - The function that receives the snapshots. It
+     * must not be null.
+     * \param callbackData - A pointer that is passed to the function.
+     * \param everySamples - The number of values after which a snapshot is
+     * posted, or zero.
+     * \param everyMilliseconds - The period, in milliseconds, with which
+     * snapshots are posted, or zero.
+     */
+    StatsObserver(StatsCalcSnapshotCallback snapshotCallback, void * callbackData, long long everySamples,
+                  unsigned everyMilliseconds);
+    
+    /** \brief Destructor that delivers any snapshot still in the mailbox and
+     * then stops the delivery thread. It must not be called from the callback.
+     */
+    ~StatsObserver();
+    
+    /** \brief Public method that posts a snapshot of some statistics to the
+     * mailbox, replacing any snapshot that has not yet been delivered.
+     *
+     * \param statistics - The statistics.
+     */
+    void publish(const StatsResult & statistics);
+    
+    /** \brief Public method that returns true if a snapshot is due, because
+     * "sampleInterval" values have been appended since the last one or the
+     * delivery thread has requested one.
+     *
+     * \param unpublishedCount - The number of values appended since the last snapshot.
+     */
+    bool isDue(long long unpublishedCount) const{
+        return (sampleInterval > 0 && unpublishedCount >= sampleInterval)
+               || requested.load(std::memory_order_relaxed);
+    }
+    
+    /** \brief Public method that returns the number of snapshots that have been
+     * delivered to the callback.
+     */
+    long long getDeliveredCount() const;
+    
+};
+
+#endif /* End #ifndef STATSOBSERVER_H preprocessor conditional block. */
@@ -0,0 +1,203 @@
+// Define the STATSSERVER_H macro to act as an include guard
+#ifndef STATSSERVER_H
+#define STATSSERVER_H
+
+/* This header file declares C++-only language constructs that depend on the
+ * Linux epoll interface. It is not available on other operating systems.
+ */
+
+// Include the <atomic> header to provide the STL std::atomic type.
+#include <atomic>
+
+// Include the <chrono> header to provide the clock used for subscriptions.
+#include <chrono>
+
+// Include the <map> header to provide the STL std::map type.
+#include <map>
+
+// Include the <string> header to provide the STL std::string type.
+#include <string>
+
+// Include the <vector> header to provide the STL std::vector type.
+#include <vector>
+
+/* Include StatsServerProtocol.h to provide the message definitions, and
+ * (indirectly) the StatsCalculator class.
+ */
+#include "StatsServerProtocol.h"
+
+/** \class StatsServer
+ * The StatsServer class shares live StatsCalculator datasets between several
+ * client processes. Clients connect to a Unix domain socket and exchange the
+ * binary messages described in StatsServerProtocol.h to push batches of values,
+ * query statistics and subscribe to periodic updates.
+ *
+ * The server is single-threaded and event-driven: one epoll instance reports
+ * which sockets are ready, and every socket is non-blocking. All the complete
+ * messages that a single read returns are processed together, and all the
+ * replies they generate are sent with a single write, so many small requests
+ * cost few system calls.
+ *
+ * No client can monopolize the server or exhaust its memory: at most
+ * maxReadBytesPerEvent bytes are read from a client before the other ready
+ * sockets are served, the replies waiting for a client are limited by
+ * statsServerMaxPendingOutputBytes, the number of datasets is limited by
+ * statsServerMaxDatasets and the number of subscriptions of each client is
+ * limited by statsServerMaxSubscriptions (see StatsServerProtocol.h).
+ *
+ * Datasets are StatsCalculator instances in streaming mode, so their memory use
+ * does not grow with the number of values pushed.
+ */
+class StatsServer {
+
+    /** \brief The clock used to schedule subscription updates.
+     */
+    typedef std::chrono::steady_clock Clock;
+
+    /** \struct Subscription
+     * A request from a client for periodic STATS messages about a dataset.
+     */
+    struct Subscription {
+        /// The dataset to report on.
+        std::uint32_t dataset;
+        /// The sequence number of the SUBSCRIBE message, copied into every update.
+        std::uint32_t sequence;
+        /// The interval between updates.
+        Clock::duration interval;
+        /// The time at which the next update is due.
+        Clock::time_point nextUpdate;
+    };
+
+    /** \struct Connection
+     * The state of one connected client.
+     */
+    struct Connection {
+        /// Bytes received but not yet processed.
+        std::vector<char> input;
+        /// Bytes waiting to be sent.
+        std::vector<char> output;
+        /// The client's subscriptions, at most one per dataset and at most statsServerMaxSubscriptions.
+        std::vector<Subscription> subscriptions;
+        /// True while the socket is registered for writability notifications.
+        bool waitingToWrite;
+
+        /// Default constructor.
+        Connection() : waitingToWrite(false) {}
+    };
+
+    /** \brief The path of the listening socket.
+     */
+    std::string socketPath;
+
+    /** \brief The descriptor of the listening socket, or -1.
+     */
+    int listeningSocket;
+
+    /** \brief The descriptor of the epoll instance, or -1.
+     */
+    int epollDescriptor;
+
+    /** \brief An eventfd in the epoll set that stop() writes to, so that a
+     * blocked epoll_wait() returns, or -1.
+     */
+    int wakeDescriptor;
+
+    /** \brief The connected clients, keyed by socket descriptor.
+     */
+    std::map<int, Connection> connections;
+
+    /** \brief The datasets, keyed by the identifiers that clients use.
+     */
+    std::map<std::uint32_t, StatsCalculator> datasets;
+
+    /** \brief Scratch storage for PUSH payloads that are not suitably aligned.
+     */
+    std::vector<double> alignedValues;
+
+    /** \brief Set to true to make run() return.
+     */
+    std::atomic<bool> stopRequested;
+
+    /** \brief An empty dataset that is reported for identifiers that have no dataset.
+     */
+    StatsCalculator emptyDataset;
+
+    /** \brief Private method that returns the dataset with an identifier, creating it if
+     * necessary. Returns null if it would exceed statsServerMaxDatasets.
+     */
+    StatsCalculator * createDataset(std::uint32_t identifier);
+
+    /** \brief Private method that returns the dataset with an identifier, or "emptyDataset"
+     * if it does not exist.
+     */
+    StatsCalculator & findDataset(std::uint32_t identifier);
+
+    /** \brief Private method that accepts every pending connection.
+     */
+    void acceptConnections();
+
+    /** \brief Private method that reads from a client and processes its messages.
+     * Returns false if the client should be disconnected.
+     */
+    bool readFromClient(int clientSocket, Connection & connection);
+
+    /** \brief Private method that processes one message. Returns false if the client
+     * should be disconnected.
+     */
+    bool processMessage(Connection & connection, const StatsServerMessageHeader & header, const char * payload);
+
+    /** \brief Private method that sends as much pending output as the socket accepts.
+     * Returns false if the client should be disconnected.
+     */
+    bool flushOutput(int clientSocket, Connection & connection);
+
+    /** \brief Private method that appends a message to a client's pending output. Returns
+     * false, without appending it, if the output would exceed statsServerMaxPendingOutputBytes.
+     */
+    bool queueMessage(Connection & connection, std::uint16_t type, std::uint32_t dataset,
+                      std::uint32_t sequence, const void * payload, std::uint32_t payloadBytes);
+
+    /** \brief Private method that queues every subscription update that is due and
+     * returns the number of milliseconds until the next one (or -1 if there are none).
+     */
+    int serviceSubscriptions();
+
+    /** \brief Private method that closes a client's socket and forgets it.
+     */
+    void disconnect(int clientSocket);
+
+    // Copying a server is meaningless, so copying is prohibited.
+    StatsServer(const StatsServer &);
+    StatsServer & operator=(const StatsServer &);
+
+public:
+
+    /** \brief Default constructor. The server does not listen until start() is called.
+     */
+    StatsServer();
+
+    /** \brief Destructor closes every socket and removes the socket file.
+     */
+    ~StatsServer();
+
+    /** \brief Public method that creates the listening socket.
+     *
+     * \param path - The file-system path at which to create the socket. Any
+     * existing file at that path is removed.
+     *
+     * \return True on success, otherwise false.
+     */
+    bool start(const std::string & path);
+
+    /** \brief Public method that serves clients until stop() is called.
+     */
+    void run();
+
+    /** \brief Public method that makes run() return. It is safe to call from a
+     * signal handler or from another thread, at any time after start().
+     */
+    void stop();
+
+};
+
+#endif /* End #ifndef STATSSERVER_H preprocessor conditional block. */
@@ -0,0 +1,103 @@
+// Define the STATSSERVERPROTOCOL_H macro to act as an include guard
+#ifndef STATSSERVERPROTOCOL_H
+#define STATSSERVERPROTOCOL_H
+
+/* This header file describes the binary protocol that is spoken over the Unix
+ * domain socket of the statistics server (see StatsServer.h). It is shared by
+ * the server and by its clients.
+ *
+ * Every message consists of a StatsServerMessageHeader followed by
+ * "payloadBytes" bytes of payload. All fields use the native byte order of the
+ * host, since a Unix domain socket never leaves it. Every payload is a multiple
+ * of eight bytes long, so that the double precision values in a PUSH payload
+ * remain suitably aligned within the server's input buffer.
+ */
+
+// Include the <cstdint> header to provide fixed-width integer types.
+#include <cstdint>
+
+/* Include StatsCalculator.h to provide the StatsResult structure, which forms
+ * the payload of STATS messages.
+ */
+#include "StatsCalculator.h"
+
+/** \brief The types of message that can be exchanged with the server.
+ */
+enum StatsServerMessageType {
+    /// Client to server: append the payload (an array of doubles) to the dataset.
+    STATSSERVER_PUSH = 1,
+    /// Client to server: reply with a STATS message describing the dataset.
+    STATSSERVER_QUERY = 2,
+    /// Client to server: send a STATS message periodically about an existing dataset. The payload is a StatsServerSubscription.
+    STATSSERVER_SUBSCRIBE = 3,
+    /// Client to server: discard every value in the dataset.
+    STATSSERVER_RESET = 4,
+    /// Server to client: the payload is a StatsResult.
+    STATSSERVER_STATS = 100,
+    /// Server to client: the request could not be processed. The payload is a StatsServerError.
+    STATSSERVER_ERROR = 101
+};
+
+/** \struct StatsServerMessageHeader
+ * The fixed-size header that begins every message.
+ */
+struct StatsServerMessageHeader {
+    /// The number of payload bytes that follow the header.
+    std::uint32_t payloadBytes;
+    /// A value from StatsServerMessageType.
+    std::uint16_t type;
+    /// Reserved for future use. Must be zero.
+    std::uint16_t reserved;
+    /// The dataset to which the message refers. Datasets are created by the first PUSH.
+    std::uint32_t dataset;
+    /// Chosen freely by the client and copied into every reply, so replies can be matched to requests.
+    std::uint32_t sequence;
+};
+
+/** \struct StatsServerSubscription
+ * The payload of a SUBSCRIBE message.
+ */
+struct StatsServerSubscription {
+    /// The interval between STATS messages in milliseconds, or zero to cancel the subscription.
+    std::uint32_t intervalMilliseconds;
+    /// Padding that keeps the payload a multiple of eight bytes long. Must be zero.
+    std::uint32_t reserved;
+};
+
+/** \struct StatsServerError
+ * The payload of an ERROR message.
+ */
+struct StatsServerError {
+    /** A value from StatsCalcStatus: STATSCALC_UNSUPPORTED for a message of an unknown
+     * type, STATSCALC_LIMIT_REACHED for a PUSH that would create a dataset when the
+     * server already holds statsServerMaxDatasets of them or for a SUBSCRIBE that would
+     * give the client more than statsServerMaxSubscriptions subscriptions, or
+     * STATSCALC_NO_DATA for a SUBSCRIBE to a dataset that does not exist.
+     */
+    std::uint32_t status;
+    /// Padding that keeps the payload a multiple of eight bytes long.
+    std::uint32_t reserved;
+};
+
+/** The largest payload the server accepts. A client that sends a larger one is
+ * disconnected.
+ */
+static const std::uint32_t statsServerMaxPayloadBytes = 1 << 20;
+
+/** The largest number of datasets the server holds. Only a PUSH creates a dataset,
+ * and one that would exceed this number is answered with an ERROR message.
+ */
+static const std::uint32_t statsServerMaxDatasets = 4096;
+
+/** The largest number of datasets a single client may subscribe to. A SUBSCRIBE
+ * that would exceed this number is answered with an ERROR message.
+ */
+static const std::uint32_t statsServerMaxSubscriptions = 64;
+
+/** The largest number of bytes of replies the server holds for a client that is
+ * not reading them. Subscription updates are skipped while this many bytes are
+ * waiting, and a client whose request would add a reply beyond it is disconnected.
+ */
+static const std::uint32_t statsServerMaxPendingOutputBytes = 4 << 20;
+
+#endif /* End #ifndef STATSSERVERPROTOCOL_H preprocessor conditional block. */
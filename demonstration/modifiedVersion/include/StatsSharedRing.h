@@ -0,0 +1,197 @@
+// Define the STATSSHAREDRING_H macro to act as an include guard
+#ifndef STATSSHAREDRING_H
+#define STATSSHAREDRING_H
+
+/* This header file declares C++-only language constructs that depend on the
+ * POSIX shared memory functions (shm_open(), mmap(), ...). It is not available
+ * when compiling for Windows. On older GNU/Linux systems, programs that use it
+ * must be linked with the "rt" library (-lrt).
+ */
+#ifndef _WIN32
+
+// Include the <atomic> header to provide the STL std::atomic type.
+#include <atomic>
+
+// Include the <cstdint> header to provide fixed-width integer types.
+#include <cstdint>
+
+// Include the <string> header to provide the STL std::string type.
+#include <string>
+
+/* Include StatsCalculator.h to provide the class definition of
+ * StatsCalculator, into which the consumer appends values.
+ */
+#include "StatsCalculator.h"
+
+/** \struct StatsSharedRingHeader
+ * The layout of the beginning of a shared memory segment that holds a ring
+ * buffer. The double precision values follow the header immediately.
+ *
+ * The two indices count the total number of values ever written and read. They
+ * are never wrapped; the position of a value within the ring is its index
+ * modulo the capacity. Each index is written by only one process and is placed
+ * on its own cache line, so that the producer and the consumer do not slow
+ * each other down by repeatedly invalidating the same line ("false sharing").
+ */
+struct StatsSharedRingHeader {
+    /// Set to a known constant once the segment has been initialized.
+    std::atomic<std::uint64_t> magic;
+    /// The number of values the ring can hold. Always a power of two.
+    std::uint64_t capacity;
+    /// The number of values the producer has written. Written only by the producer.
+    alignas(64) std::atomic<std::uint64_t> writeIndex;
+    /// The number of values the consumer has read. Written only by the consumer.
+    alignas(64) std::atomic<std::uint64_t> readIndex;
+    /// Non-zero once the producer has announced that it will write no more values.
+    alignas(64) std::atomic<std::uint32_t> producerClosed;
+};
+
+/** \class StatsSharedRing
+ * The StatsSharedRing class provides a single-producer, single-consumer (SPSC)
+ * ring buffer of double precision values in POSIX shared memory. It allows a
+ * separate acquisition process to pass raw values to a StatsCalculator without
+ * writing them to a file.
+ *
+ * One process creates the ring with create() and the other attaches to it with
+ * open(). Exactly one process (or thread) may write values with write() and
+ * exactly one may consume them with consumeInto(). Neither operation makes any
+ * system calls or takes any locks: the two sides communicate only through the
+ * atomic indices in the StatsSharedRingHeader.
+ *
+ * The shared memory can be written by the other process, so nothing read from it
+ * is trusted: the capacity is validated once and kept in this instance, and
+ * indices that claim more values (or more free space) than the ring can hold are
+ * treated as corruption, so that neither side can be made to access memory
+ * outside the segment.
+ */
+class StatsSharedRing {
+
+    /** \brief The name of the shared memory segment.
+     */
+    std::string segmentName;
+
+    /** \brief The address at which the segment is mapped, or null.
+     */
+    StatsSharedRingHeader * header;
+
+    /** \brief The first value stored in the segment.
+     */
+    double * ringValues;
+
+    /** \brief The size of the mapping in bytes.
+     */
+    size_t mappedBytes;
+
+    /** \brief The number of values the ring can hold, copied from the header once
+     * it has been validated. The copy in the header is never used again, since the
+     * other process could change it.
+     */
+    std::uint64_t ringCapacity;
+
+    /** \brief True if this instance created the segment, and so must remove it.
+     */
+    bool ownsSegment;
+
+    /** \brief The producer's most recent observation of "readIndex". Reading the
+     * consumer's index only when this copy suggests the ring is full keeps the
+     * producer from touching the consumer's cache line on every write.
+     */
+    std::uint64_t cachedReadIndex;
+
+    /** \brief The consumer's most recent observation of "writeIndex".
+     */
+    std::uint64_t cachedWriteIndex;
+
+    /** \brief Private method that maps an open shared memory file descriptor.
+     */
+    bool mapSegment(int fileDescriptor, size_t bytes);
+
+    // A mapping cannot be shared between two instances, so copying is prohibited.
+    StatsSharedRing(const StatsSharedRing &);
+    StatsSharedRing & operator=(const StatsSharedRing &);
+
+public:
+
+    /** \brief Default constructor. The instance is not attached to any segment.
+     */
+    StatsSharedRing();
+
+    /** \brief Destructor unmaps the segment and, if this instance created it,
+     * removes it.
+     */
+    ~StatsSharedRing();
+
+    /** \brief Public method that creates a new shared memory segment containing an
+     * empty ring buffer.
+     *
+     * \param name - The name of the segment, which should begin with a "/".
+     * \param capacity - The minimum number of values the ring must hold. It is
+     * rounded up to a power of two.
+     * \param replaceExisting - If false (the default), creation fails when a
+     * segment with the same name already exists, since another process may be
+     * using it. If true, such a segment is unlinked first, which is only safe
+     * when it is known to be stale (e.g. left behind by a process that crashed).
+     *
+     * \return True on success. False if the name is in use and "replaceExisting"
+     * is false, if the capacity is too large to be represented or if the segment
+     * could not be created.
+     */
+    bool create(const std::string & name, size_t capacity, bool replaceExisting = false);
+
+    /** \brief Public method that attaches to a segment created by another process.
+     *
+     * \param name - The name that was passed to create().
+     *
+     * \return True on success. False if the segment does not exist or has not yet
+     * been initialized, in which case the call may be retried.
+     */
+    bool open(const std::string & name);
+
+    /** \brief Public method that detaches from the segment. It is called by the
+     * destructor.
+     */
+    void close();
+
+    /** \brief Public method that returns the number of values the ring can hold, or
+     * zero if the instance is not attached.
+     */
+    size_t capacity() const;
+
+    /** \brief PRODUCER method that copies as many values as there is space for into
+     * the ring without blocking.
+     *
+     * \param values - A pointer to the first element of an array of values.
+     * \param count - The number of elements in the array.
+     *
+     * \return The number of values written, which may be less than count. Zero
+     * is returned if the consumer's index is corrupt.
+     */
+    size_t write(const double * values, size_t count);
+
+    /** \brief PRODUCER method that announces that no more values will be written.
+     */
+    void closeProducer();
+
+    /** \brief CONSUMER method that appends every value currently in the ring (up to
+     * a limit) to a StatsCalculator without blocking. The values are passed to
+     * StatsCalculator::appendValues() directly from the shared memory, so they are
+     * not copied into an intermediate buffer.
+     *
+     * \param calculator - The StatsCalculator to which the values are appended.
+     * \param maxValues - The maximum number of values to consume.
+     *
+     * \return The number of values consumed. Zero is returned if the producer's
+     * index is corrupt.
+     */
+    size_t consumeInto(StatsCalculator & calculator, size_t maxValues = static_cast<size_t>(-1));
+
+    /** \brief CONSUMER method that returns true once the producer has called
+     * closeProducer() AND every value it wrote has been consumed.
+     */
+    bool finished() const;
+
+};
+
+#endif // _WIN32 was not defined
+
+#endif /* End #ifndef STATSSHAREDRING_H preprocessor conditional block. */
@@ -0,0 +1,461 @@
+/** \file StatsCalculatorModule.cpp Native Python bindings for the StatsCalculator class.
+ *
+ * This file defines a Python extension module named "statscalculator" that exposes the
+ * StatsCalculator class directly, so that Python code does not need to drive the C API
+ * through ctypes one value at a time.
+ *
+ * Arrays are accepted through the Python BUFFER PROTOCOL, which NumPy arrays (and the
+ * standard library's array.array) support. A C-contiguous array of float64 values is used
+ * in place, without copying. The global interpreter lock (GIL) is released while statistics
+ * are computed and while files are parsed, so other Python threads keep running.
+ *
+ * The module can be built (on GNU/Linux) with a command such as:
+ *
+ *     g++ -O2 -shared -fPIC -pthread $(python3-config --includes) -Iinclude \
+ *         python/StatsCalculatorModule.cpp src/StatsCalculator.cpp \
+ *         src/StatsCalculatorWorkerPool.cpp src/StatsBootstrap.cpp \
+ *         src/StatsAutocorrelation.cpp src/StatsObserver.cpp \
+ *         -o statscalculator$(python3-config --extension-suffix)
+ *
+ * with empty "stdafx.h" and "StatsCalculatorLabView.h" headers on the include path when
+ * building outside Windows.
+ */
+
+/* Python.h must be included before any standard headers, and PY_SSIZE_T_CLEAN makes
+ * functions such as PyArg_ParseTuple() use Py_ssize_t for lengths.
+ */
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+// STL HEADER FILES
+
+// The <cstring> header is included to provide the std::strcmp(...) function.
+#include <cstring>
+
+// PROJECT HEADERS
+
+/* The "StatsCalculator.h" header file provides the definition of the StatsCalculator
+ * class.
+ */
+#include "StatsCalculator.h"
+
+/** \struct PyStatsCalculator
+ * The layout of a Python "statscalculator.StatsCalculator" object.
+ */
+struct PyStatsCalculator {
+    /// The standard header that every Python object begins with.
+    PyObject_HEAD
+    /// The wrapped StatsCalculator instance.
+    StatsCalculator * calculator;
+    /// The buffer that the instance is viewing, if any. It is held so that the array cannot be freed.
+    Py_buffer viewedBuffer;
+    /// True while "viewedBuffer" holds a buffer.
+    bool holdingBuffer;
+    /// True while a method is running with the GIL released, so that other threads must not use the instance.
+    bool busy;
+};
+
+/** Obtains a C-contiguous buffer of double precision values from a Python object.
+ *
+ * \param object - The object, e.g. a NumPy array of dtype float64.
+ * \param buffer - Receives the buffer, which the caller must release with PyBuffer_Release().
+ *
+ * \return True on success. On failure a Python exception is set.
+ */
+static bool getDoubleBuffer(PyObject * object, Py_buffer * buffer){
+    if(PyObject_GetBuffer(object, buffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0){
+        return false;
+    }
+    // Accept the native double format, with or without an explicit byte-order prefix.
+    const char * format = buffer->format != 0 ? buffer->format : "B";
+    if(format[0] == '@' || format[0] == '=' || (format[0] == '<' && PY_LITTLE_ENDIAN) || (format[0] == '>' && !PY_LITTLE_ENDIAN)){
+        ++format;
+    }
+    if(std::strcmp(format, "d") != 0 || buffer->itemsize != sizeof(double)){
+        PyBuffer_Release(buffer);
+        PyErr_SetString(PyExc_TypeError, "expected a contiguous array of float64 values "
+                        "(convert it with numpy.ascontiguousarray(x, dtype=numpy.float64))");
+        return false;
+    }
+    return true;
+}
+
+/** Releases the buffer that an object is viewing, if any.
+ */
+static void releaseViewedBuffer(PyStatsCalculator * self){
+    if(self->holdingBuffer){
+        PyBuffer_Release(&self->viewedBuffer);
+        self->holdingBuffer = false;
+    }
+}
+
+/** Releases the viewed buffer once the StatsCalculator has stopped viewing it. Appending
+ * to a view makes the StatsCalculator copy the viewed values, after which the buffer is no
+ * longer needed.
+ */
+static void releaseBufferIfDetached(PyStatsCalculator * self){
+    if(self->holdingBuffer && !self->calculator->isView()){
+        releaseViewedBuffer(self);
+    }
+}
+
+/** Marks an object as busy before the GIL is released.
+ *
+ * \return True on success. False (with a RuntimeError set) if another thread is using the object.
+ */
+static bool acquireObject(PyStatsCalculator * self){
+    if(self->busy){
+        PyErr_SetString(PyExc_RuntimeError, "StatsCalculator is being used by another thread");
+        return false;
+    }
+    self->busy = true;
+    return true;
+}
+
+/** Converts a StatsResult into a Python dictionary.
+ */
+static PyObject * statisticsToDict(const StatsResult & statistics){
+    return Py_BuildValue("{s:L,s:d,s:d,s:d,s:d,s:d}",
+                         "count", statistics.count,
+                         "sum", statistics.sum,
+                         "mean", statistics.mean,
+                         "standard_deviation", statistics.standardDeviation,
+                         "minimum", statistics.minimum,
+                         "maximum", statistics.maximum);
+}
+
+// METHODS OF THE PYTHON TYPE
+
+/** Allocates and constructs a new object (the equivalent of __new__ and __init__).
+ */
+static PyObject * PyStatsCalculator_new(PyTypeObject * type, PyObject * args, PyObject * kwargs){
+    static const char * keywords[] = { "values", 0 };
+    PyObject * values = 0;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "|O:StatsCalculator", const_cast<char **>(keywords), &values)){
+        return 0;
+    }
+    PyStatsCalculator * self = reinterpret_cast<PyStatsCalculator *>(type->tp_alloc(type, 0));
+    if(self == 0){
+        return 0;
+    }
+    self->calculator = new StatsCalculator();
+    self->holdingBuffer = false;
+    self->busy = false;
+    // If an array was given, view it.
+    if(values != 0 && values != Py_None){
+        if(!getDoubleBuffer(values, &self->viewedBuffer)){
+            Py_DECREF(self);
+            return 0;
+        }
+        self->holdingBuffer = true;
+        self->calculator->wrapValues(static_cast<const double *>(self->viewedBuffer.buf),
+                                     static_cast<size_t>(self->viewedBuffer.len/sizeof(double)));
+    }
+    return reinterpret_cast<PyObject *>(self);
+}
+
+/** Destroys an object.
+ */
+static void PyStatsCalculator_dealloc(PyStatsCalculator * self){
+    releaseViewedBuffer(self);
+    delete self->calculator;
+    Py_TYPE(self)->tp_free(reinterpret_cast<PyObject *>(self));
+}
+
+/** StatsCalculator.append(value): appends a single value.
+ */
+static PyObject * PyStatsCalculator_append(PyStatsCalculator * self, PyObject * arg){
+    double value = PyFloat_AsDouble(arg);
+    if(value == -1.0 && PyErr_Occurred()){
+        return 0;
+    }
+    if(!acquireObject(self)){
+        return 0;
+    }
+    self->calculator->appendValue(value);
+    self->busy = false;
+    releaseBufferIfDetached(self);
+    Py_RETURN_NONE;
+}
+
+/** StatsCalculator.extend(array): appends every value of an array, reading it in place.
+ */
+static PyObject * PyStatsCalculator_extend(PyStatsCalculator * self, PyObject * arg){
+    Py_buffer buffer;
+    if(!getDoubleBuffer(arg, &buffer)){
+        return 0;
+    }
+    if(!acquireObject(self)){
+        PyBuffer_Release(&buffer);
+        return 0;
+    }
+    Py_BEGIN_ALLOW_THREADS
+    self->calculator->appendValues(static_cast<const double *>(buffer.buf), static_cast<size_t>(buffer.len/sizeof(double)));
+    Py_END_ALLOW_THREADS
+    self->busy = false;
+    PyBuffer_Release(&buffer);
+    releaseBufferIfDetached(self);
+    Py_RETURN_NONE;
+}
+
+/** StatsCalculator.wrap(array): makes the object a view over an array, without copying it.
+ * The object keeps a reference to the array for as long as it views it.
+ */
+static PyObject * PyStatsCalculator_wrap(PyStatsCalculator * self, PyObject * arg){
+    Py_buffer buffer;
+    if(!getDoubleBuffer(arg, &buffer)){
+        return 0;
+    }
+    if(!acquireObject(self)){
+        PyBuffer_Release(&buffer);
+        return 0;
+    }
+    self->busy = false;
+    releaseViewedBuffer(self);
+    self->viewedBuffer = buffer;
+    self->holdingBuffer = true;
+    self->calculator->wrapValues(static_cast<const double *>(buffer.buf), static_cast<size_t>(buffer.len/sizeof(double)));
+    Py_RETURN_NONE;
+}
+
+/** StatsCalculator.read_file(path): parses a text file, with the GIL released.
+ */
+static PyObject * PyStatsCalculator_read_file(PyStatsCalculator * self, PyObject * args){
+    const char * path = 0;
+    if(!PyArg_ParseTuple(args, "s:read_file", &path)){
+        return 0;
+    }
+    if(!acquireObject(self)){
+        return 0;
+    }
+    std::string fileName(path);
+    bool opened;
+    Py_BEGIN_ALLOW_THREADS
+    opened = self->calculator->ingestFile(fileName);
+    Py_END_ALLOW_THREADS
+    self->busy = false;
+    releaseBufferIfDetached(self);
+    if(!opened){
+        PyErr_SetFromErrnoWithFilename(PyExc_OSError, path);
+        return 0;
+    }
+    Py_RETURN_NONE;
+}
+
+/** StatsCalculator.write_stats(path): writes the statistical summary to a text file.
+ */
+static PyObject * PyStatsCalculator_write_stats(PyStatsCalculator * self, PyObject * args){
+    const char * path = 0;
+    if(!PyArg_ParseTuple(args, "s:write_stats", &path)){
+        return 0;
+    }
+    if(!acquireObject(self)){
+        return 0;
+    }
+    std::string fileName(path);
+    Py_BEGIN_ALLOW_THREADS
+    self->calculator->writeStats(fileName);
+    Py_END_ALLOW_THREADS
+    self->busy = false;
+    Py_RETURN_NONE;
+}
+
+/** StatsCalculator.statistics(): returns every statistic in a dictionary, computing them
+ * with the GIL released.
+ */
+static PyObject * PyStatsCalculator_statistics(PyStatsCalculator * self, PyObject *){
+    if(!acquireObject(self)){
+        return 0;
+    }
+    StatsResult statistics;
+    Py_BEGIN_ALLOW_THREADS
+    statistics = self->calculator->getStatistics();
+    Py_END_ALLOW_THREADS
+    self->busy = false;
+    return statisticsToDict(statistics);
+}
+
+/** StatsCalculator.reset(release_memory=False): discards every value.
+ */
+static PyObject * PyStatsCalculator_reset(PyStatsCalculator * self, PyObject * args, PyObject * kwargs){
+    static const char * keywords[] = { "release_memory", 0 };
+    int releaseMemory = 0;
+    if(!PyArg_ParseTupleAndKeywords(args, kwargs, "|p:reset", const_cast<char **>(keywords), &releaseMemory)){
+        return 0;
+    }
+    if(!acquireObject(self)){
+        return 0;
+    }
+    self->calculator->reset(releaseMemory != 0);
+    self->busy = false;
+    releaseViewedBuffer(self);
+    Py_RETURN_NONE;
+}
+
+/** Getter for the StatsCalculator.streaming property.
+ */
+static PyObject * PyStatsCalculator_get_streaming(PyStatsCalculator * self, void *){
+    return PyBool_FromLong(self->calculator->isStreaming());
+}
+
+/** Setter for the StatsCalculator.streaming property.
+ */
+static int PyStatsCalculator_set_streaming(PyStatsCalculator * self, PyObject * value, void *){
+    if(value == 0){
+        PyErr_SetString(PyExc_AttributeError, "cannot delete the streaming property");
+        return -1;
+    }
+    int enabled = PyObject_IsTrue(value);
+    if(enabled < 0 || !acquireObject(self)){
+        return -1;
+    }
+    self->calculator->setStreaming(enabled != 0);
+    self->busy = false;
+    releaseBufferIfDetached(self);
+    return 0;
+}
+
+/** Shared implementation of the read-only statistic properties. The closure identifies
+ * which member of StatsResult to return.
+ */
+static PyObject * PyStatsCalculator_get_statistic(PyStatsCalculator * self, void * closure){
+    if(!acquireObject(self)){
+        return 0;
+    }
+    StatsResult statistics;
+    Py_BEGIN_ALLOW_THREADS
+    statistics = self->calculator->getStatistics();
+    Py_END_ALLOW_THREADS
+    self->busy = false;
+    const char * name = static_cast<const char *>(closure);
+    if(std::strcmp(name, "count") == 0){
+        return PyLong_FromLongLong(statistics.count);
+    }
+    if(std::strcmp(name, "sum") == 0){
+        return PyFloat_FromDouble(statistics.sum);
+    }
+    if(std::strcmp(name, "mean") == 0){
+        return PyFloat_FromDouble(statistics.mean);
+    }
+    if(std::strcmp(name, "minimum") == 0){
+        return PyFloat_FromDouble(statistics.minimum);
+    }
+    if(std::strcmp(name, "maximum") == 0){
+        return PyFloat_FromDouble(statistics.maximum);
+    }
+    return PyFloat_FromDouble(statistics.standardDeviation);
+}
+
+/** The methods of the Python type.
+ */
+static PyMethodDef PyStatsCalculator_methods[] = {
+    { "append", reinterpret_cast<PyCFunction>(PyStatsCalculator_append), METH_O,
+      "append(value)\n\nAppend a single value." },
+    { "extend", reinterpret_cast<PyCFunction>(PyStatsCalculator_extend), METH_O,
+      "extend(array)\n\nAppend every value of a contiguous float64 array without an intermediate copy." },
+    { "wrap", reinterpret_cast<PyCFunction>(PyStatsCalculator_wrap), METH_O,
+      "wrap(array)\n\nView a contiguous float64 array in place, discarding any stored values." },
+    { "read_file", reinterpret_cast<PyCFunction>(PyStatsCalculator_read_file), METH_VARARGS,
+      "read_file(path)\n\nAppend the whitespace-separated values in a text file." },
+    { "write_stats", reinterpret_cast<PyCFunction>(PyStatsCalculator_write_stats), METH_VARARGS,
+      "write_stats(path)\n\nWrite a statistical summary to a text file." },
+    { "statistics", reinterpret_cast<PyCFunction>(PyStatsCalculator_statistics), METH_NOARGS,
+      "statistics()\n\nReturn every statistic in a dictionary." },
+    { "reset", reinterpret_cast<PyCFunction>(PyStatsCalculator_reset), METH_VARARGS | METH_KEYWORDS,
+      "reset(release_memory=False)\n\nDiscard every value." },
+    { 0, 0, 0, 0 }
+};
+
+/** The properties of the Python type.
+ */
+static PyGetSetDef PyStatsCalculator_getset[] = {
+    { const_cast<char *>("streaming"), reinterpret_cast<getter>(PyStatsCalculator_get_streaming),
+      reinterpret_cast<setter>(PyStatsCalculator_set_streaming),
+      const_cast<char *>("True if values are accumulated rather than stored."), 0 },
+    { const_cast<char *>("count"), reinterpret_cast<getter>(PyStatsCalculator_get_statistic), 0,
+      const_cast<char *>("The number of values."), const_cast<char *>("count") },
+    { const_cast<char *>("sum"), reinterpret_cast<getter>(PyStatsCalculator_get_statistic), 0,
+      const_cast<char *>("The sum of the values."), const_cast<char *>("sum") },
+    { const_cast<char *>("mean"), reinterpret_cast<getter>(PyStatsCalculator_get_statistic), 0,
+      const_cast<char *>("The mean of the values."), const_cast<char *>("mean") },
+    { const_cast<char *>("standard_deviation"), reinterpret_cast<getter>(PyStatsCalculator_get_statistic), 0,
+      const_cast<char *>("The population standard deviation of the values."), const_cast<char *>("standard_deviation") },
+    { const_cast<char *>("minimum"), reinterpret_cast<getter>(PyStatsCalculator_get_statistic), 0,
+      const_cast<char *>("The smallest value."), const_cast<char *>("minimum") },
+    { const_cast<char *>("maximum"), reinterpret_cast<getter>(PyStatsCalculator_get_statistic), 0,
+      const_cast<char *>("The largest value."), const_cast<char *>("maximum") },
+    { 0, 0, 0, 0, 0 }
+};
+
+/** The Python type object, which is completed in PyInit_statscalculator().
+ */
+static PyTypeObject PyStatsCalculatorType = {
+    PyVarObject_HEAD_INIT(0, 0)
+    "statscalculator.StatsCalculator"
+};
+
+// MODULE-LEVEL FUNCTIONS
+
+/** statscalculator.statistics(array): returns every statistic of an array, computed in
+ * place with the GIL released and without creating a StatsCalculator object.
+ */
+static PyObject * module_statistics(PyObject *, PyObject * arg){
+    Py_buffer buffer;
+    if(!getDoubleBuffer(arg, &buffer)){
+        return 0;
+    }
+    StatsResult statistics;
+    Py_BEGIN_ALLOW_THREADS
+    StatsCalculator view(static_cast<const double *>(buffer.buf), static_cast<size_t>(buffer.len/sizeof(double)));
+    statistics = view.getStatistics();
+    Py_END_ALLOW_THREADS
+    PyBuffer_Release(&buffer);
+    return statisticsToDict(statistics);
+}
+
+/** The functions of the module.
+ */
+static PyMethodDef module_methods[] = {
+    { "statistics", module_statistics, METH_O,
+      "statistics(array)\n\nReturn every statistic of a contiguous float64 array in a dictionary." },
+    { 0, 0, 0, 0 }
+};
+
+/** The definition of the module.
+ */
+static PyModuleDef statscalculatorModule = {
+    PyModuleDef_HEAD_INIT,
+    "statscalculator",
+    "Native bindings for the StatsCalculator class.",
+    -1,
+    module_methods
+};
+
+/** The entry point that the Python interpreter calls when the module is imported.
+ */
+PyMODINIT_FUNC PyInit_statscalculator(){
+    PyStatsCalculatorType.tp_basicsize = sizeof(PyStatsCalculator);
+    PyStatsCalculatorType.tp_flags = Py_TPFLAGS_DEFAULT;
+    PyStatsCalculatorType.tp_doc = "StatsCalculator(values=None)\n\n"
+    "Computes statistics of numeric values. If values (a contiguous float64 array) is given,\n"
+    "it is viewed in place without copying.";
+    PyStatsCalculatorType.tp_new = PyStatsCalculator_new;
+    PyStatsCalculatorType.tp_dealloc = reinterpret_cast<destructor>(PyStatsCalculator_dealloc);
+    PyStatsCalculatorType.tp_methods = PyStatsCalculator_methods;
+    PyStatsCalculatorType.tp_getset = PyStatsCalculator_getset;
+    if(PyType_Ready(&PyStatsCalculatorType) < 0){
+        return 0;
+    }
+
+    PyObject * module = PyModule_Create(&statscalculatorModule);
+    if(module == 0){
+        return 0;
+    }
+    Py_INCREF(&PyStatsCalculatorType);
+    if(PyModule_AddObject(module, "StatsCalculator", reinterpret_cast<PyObject *>(&PyStatsCalculatorType)) < 0){
+        Py_DECREF(&PyStatsCalculatorType);
+        Py_DECREF(module);
+        return 0;
+    }
+    return module;
+}
@@ -0,0 +1,82 @@
+"""Benchmark of the statscalculator extension module against NumPy.
+
+Compares the time taken to compute the mean and standard deviation of a float64
+array with numpy.mean() and numpy.std() against the single-pass reduction of the
+statscalculator module, for several array sizes. Also measures the throughput of
+several Python threads computing statistics at once, which is only possible
+because the extension releases the global interpreter lock while it works.
+
+Usage:
+
+    python3 benchmarkStatsCalculator.py [repetitions]
+
+The statscalculator module must have been built (see StatsCalculatorModule.cpp)
+and be importable.
+"""
+
+import sys
+import threading
+import time
+
+import numpy
+
+import statscalculator
+
+
+def bestTime(function, repetitions):
+    """Return the shortest of several timings of function(), in seconds."""
+    best = float("inf")
+    for _ in range(repetitions):
+        start = time.perf_counter()
+        function()
+        best = min(best, time.perf_counter() - start)
+    return best
+
+
+def benchmarkReductions(repetitions):
+    """Compare numpy.mean and numpy.std with statscalculator.statistics."""
+    generator = numpy.random.default_rng(12345)
+    print("%12s %14s %14s %10s" % ("values", "numpy (ms)", "native (ms)", "speedup"))
+    for size in (1000, 100000, 10000000):
+        values = generator.normal(10.0, 2.0, size)
+
+        def numpyStatistics():
+            return numpy.mean(values), numpy.std(values)
+
+        def nativeStatistics():
+            return statscalculator.statistics(values)
+
+        # Check that both agree before timing them.
+        mean, standardDeviation = numpyStatistics()
+        native = nativeStatistics()
+        assert abs(native["mean"] - mean) <= 1e-9*max(1.0, abs(mean))
+        assert abs(native["standard_deviation"] - standardDeviation) <= 1e-9*max(1.0, standardDeviation)
+
+        numpySeconds = bestTime(numpyStatistics, repetitions)
+        nativeSeconds = bestTime(nativeStatistics, repetitions)
+        print("%12d %14.3f %14.3f %9.2fx" % (size, 1e3*numpySeconds, 1e3*nativeSeconds, numpySeconds/nativeSeconds))
+
+
+def benchmarkThreads(repetitions):
+    """Measure the combined throughput of several threads computing statistics."""
+    values = numpy.random.default_rng(54321).normal(0.0, 1.0, 10000000)
+    print("\n%8s %20s" % ("threads", "million values/s"))
+    for threadCount in (1, 2, 4):
+        def work():
+            for _ in range(repetitions):
+                statscalculator.statistics(values)
+
+        threads = [threading.Thread(target=work) for _ in range(threadCount)]
+        start = time.perf_counter()
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        seconds = time.perf_counter() - start
+        print("%8d %20.1f" % (threadCount, threadCount*repetitions*values.size/seconds/1e6))
+
+
+if __name__ == "__main__":
+    repetitions = int(sys.argv[1]) if len(sys.argv) > 1 else 10
+    benchmarkReductions(repetitions)
+    benchmarkThreads(repetitions)
@@ -0,0 +1,659 @@
+// IMPLEMENTATION file for StatsFourierTransform and StatsAutocorrelation classes
+
+// STL HEADER FILES
+
+// The <algorithm> header is included to provide the std::fill(...) and std::swap(...) functions.
+#include <algorithm>
+// The <cmath> header is included to provide the std::cos(...), std::sin(...) and std::sqrt(...) functions.
+#include <cmath>
+// The <functional> header is included to provide the STL std::function type.
+#include <functional>
+
+// LOCAL HEADER FILES
+
+// Include the stdafx.h header to satisfy Windows requirements
+#include "stdafx.h"
+
+/* The "StatsAutocorrelation.h" header is included to provide definitions of the
+ * StatsFourierTransform and StatsAutocorrelation classes.
+ */
+#include "StatsAutocorrelation.h"
+
+/* The "StatsCalculatorWorkerPool.h" header file provides the pool of worker threads that
+ * share the segments and chunks of each analysis.
+ */
+#include "StatsCalculatorWorkerPool.h"
+
+// METHODS OF STATSFOURIERTRANSFORM
+
+/** Constructor for the StatsFourierTransform class, which computes the twiddle
+ * factors of every stage. The stage that combines pairs of transforms of h
+ * points into transforms of 2h points multiplies the second of each pair by the
+ * factors \f$e^{-i\pi j/h}\f$, j = 0, ..., h - 1, which are stored from element
+ * h onwards. The factors are computed directly rather than by recurrence, so
+ * each is accurate to the last bit.
+ *
+ * \param size - The number of points in each transform, which must be a power of two.
+ */
+StatsFourierTransform::StatsFourierTransform(size_t size) :
+size(size),
+twiddleReal(size),
+twiddleImaginary(size){
+    const double pi = 3.14159265358979323846;
+    for(size_t half = 1; half < size; half <<= 1){
+        for(size_t index = 0; index < half; ++index){
+            const double angle = -pi*index/half;
+            twiddleReal[half + index] = std::cos(angle);
+            twiddleImaginary[half + index] = std::sin(angle);
+        }
+    }
+}
+
+/** Public method that returns the number of points in each transform.
+ */
+size_t StatsFourierTransform::getSize() const{
+    return size;
+}
+
+/** Public method that replaces an array of complex values by its discrete
+ * Fourier transform.
+ *
+ * The values are first permuted into bit-reversed order, so that the transform
+ * can be computed in place. Each stage then combines neighbouring transforms of
+ * h points into transforms of 2h points with "butterflies": the second point of
+ * each butterfly is multiplied by a twiddle factor, and the sum and difference
+ * of the pair replace it. The twiddle factors of the first two stages are 1 and
+ * -i, so those stages are combined into a single pass over the values (a
+ * radix-4 stage) that needs no multiplications.
+ *
+ * \param real - The "size" real parts.
+ * \param imaginary - The "size" imaginary parts.
+ */
+void StatsFourierTransform::forward(double * real, double * imaginary) const{
+    for(size_t index = 1, reversed = 0; index < size; ++index){
+        // Increment "reversed" as if its bits were in the reverse order.
+        size_t bit = size >> 1;
+        while(reversed & bit){
+            reversed ^= bit;
+            bit >>= 1;
+        }
+        reversed |= bit;
+        if(index < reversed){
+            std::swap(real[index], real[reversed]);
+            std::swap(imaginary[index], imaginary[reversed]);
+        }
+    }
+
+    size_t firstHalf = 1;
+    if(size >= 4){
+        for(size_t start = 0; start < size; start += 4){
+            const double sum0Real = real[start] + real[start + 1];
+            const double sum0Imaginary = imaginary[start] + imaginary[start + 1];
+            const double difference0Real = real[start] - real[start + 1];
+            const double difference0Imaginary = imaginary[start] - imaginary[start + 1];
+            const double sum1Real = real[start + 2] + real[start + 3];
+            const double sum1Imaginary = imaginary[start + 2] + imaginary[start + 3];
+            const double difference1Real = real[start + 2] - real[start + 3];
+            const double difference1Imaginary = imaginary[start + 2] - imaginary[start + 3];
+            real[start] = sum0Real + sum1Real;
+            imaginary[start] = sum0Imaginary + sum1Imaginary;
+            real[start + 2] = sum0Real - sum1Real;
+            imaginary[start + 2] = sum0Imaginary - sum1Imaginary;
+            // Multiplying by -i exchanges the real and imaginary parts and negates the new imaginary part.
+            real[start + 1] = difference0Real + difference1Imaginary;
+            imaginary[start + 1] = difference0Imaginary - difference1Real;
+            real[start + 3] = difference0Real - difference1Imaginary;
+            imaginary[start + 3] = difference0Imaginary + difference1Real;
+        }
+        firstHalf = 4;
+    }
+
+    for(size_t half = firstHalf; half < size; half <<= 1){
+        const double * factorReal = &twiddleReal[half];
+        const double * factorImaginary = &twiddleImaginary[half];
+        for(size_t start = 0; start < size; start += 2*half){
+            double * firstReal = real + start;
+            double * firstImaginary = imaginary + start;
+            double * secondReal = firstReal + half;
+            double * secondImaginary = firstImaginary + half;
+            for(size_t index = 0; index < half; ++index){
+                const double productReal = factorReal[index]*secondReal[index]
+                    - factorImaginary[index]*secondImaginary[index];
+                const double productImaginary = factorReal[index]*secondImaginary[index]
+                    + factorImaginary[index]*secondReal[index];
+                secondReal[index] = firstReal[index] - productReal;
+                secondImaginary[index] = firstImaginary[index] - productImaginary;
+                firstReal[index] += productReal;
+                firstImaginary[index] += productImaginary;
+            }
+        }
+    }
+}
+
+/** Public method that replaces an array of complex values by its inverse
+ * discrete Fourier transform. Exchanging the real and imaginary parts of the
+ * input and of the output of a forward transform gives the inverse transform
+ * without the factor of 1/N, which is then applied.
+ *
+ * \param real - The "size" real parts.
+ * \param imaginary - The "size" imaginary parts.
+ */
+void StatsFourierTransform::inverse(double * real, double * imaginary) const{
+    forward(imaginary, real);
+    const double scale = 1.0/size;
+    for(size_t index = 0; index < size; ++index){
+        real[index] *= scale;
+        imaginary[index] *= scale;
+    }
+}
+
+// AUTOCOVARIANCE HELPERS
+
+/** Computes the transforms of two consecutive segments of a series, each
+ * centred on the mean and padded with zeros to the size of the transform.
+ * The first segment is placed in the real parts and the second in the imaginary
+ * parts of a single complex transform Z, from which the two transforms are
+ * separated using the symmetry of the transforms of real sequences:
+ * \f$A_f = (Z_f + Z^*_{N-f})/2\f$ and \f$B_f = (Z_f - Z^*_{N-f})/2i\f$.
+ *
+ * \param values - A pointer to the first of the values.
+ * \param count - The number of values.
+ * \param mean - The mean of the values.
+ * \param segmentLength - The number of values in each segment.
+ * \param firstSegment - The index of the first segment. Segments beyond the
+ * end of the series are zero.
+ * \param transform - The transform, of twice "segmentLength" points.
+ * \param workReal - Scratch space for the real parts of Z.
+ * \param workImaginary - Scratch space for the imaginary parts of Z.
+ * \param first - Space for the real parts of A, followed by its imaginary parts.
+ * \param second - Space for the real parts of B, followed by its imaginary parts.
+ */
+static void transformSegmentPair(const double * values, size_t count, double mean, size_t segmentLength,
+                                 size_t firstSegment, const StatsFourierTransform & transform,
+                                 double * workReal, double * workImaginary, double * first, double * second){
+    const size_t transformSize = transform.getSize();
+    const size_t begin = firstSegment*segmentLength;
+    for(size_t index = 0; index < segmentLength; ++index){
+        const size_t position = begin + index;
+        workReal[index] = position < count ? values[position] - mean : 0.0;
+        workImaginary[index] = position + segmentLength < count ? values[position + segmentLength] - mean : 0.0;
+    }
+    std::fill(workReal + segmentLength, workReal + transformSize, 0.0);
+    std::fill(workImaginary + segmentLength, workImaginary + transformSize, 0.0);
+    transform.forward(workReal, workImaginary);
+
+    double * firstImaginary = first + transformSize;
+    double * secondImaginary = second + transformSize;
+    for(size_t frequency = 0; frequency < transformSize; ++frequency){
+        const size_t mirror = (transformSize - frequency) & (transformSize - 1);
+        first[frequency] = 0.5*(workReal[frequency] + workReal[mirror]);
+        firstImaginary[frequency] = 0.5*(workImaginary[frequency] - workImaginary[mirror]);
+        second[frequency] = 0.5*(workImaginary[frequency] + workImaginary[mirror]);
+        secondImaginary[frequency] = 0.5*(workReal[mirror] - workReal[frequency]);
+    }
+}
+
+/** Adds the cross-spectrum of one segment with itself followed by the next
+ * segment to an accumulated spectrum.
+ *
+ * Placing the next segment after the current one, L points along a transform of
+ * 2L points, multiplies its transform by \f$e^{-i\pi f} = (-1)^f\f$, so the
+ * transform of the pair is \f$X_f + (-1)^f Y_f\f$. The inverse transform of
+ * \f$X^*_f(X_f + (-1)^f Y_f)\f$ is the sum of the products of each value of the
+ * segment with the value t places later, for lags t below L, and these sums
+ * are accumulated over the segments in the frequency domain.
+ *
+ * \param segment - The transform X of the segment (real parts, then imaginary parts).
+ * \param next - The transform Y of the next segment.
+ * \param transformSize - The number of points in each transform.
+ * \param spectrumReal - The real parts of the accumulated spectrum.
+ * \param spectrumImaginary - The imaginary parts of the accumulated spectrum.
+ */
+static void accumulateCrossSpectrum(const double * segment, const double * next, size_t transformSize,
+                                    double * spectrumReal, double * spectrumImaginary){
+    const double * segmentImaginary = segment + transformSize;
+    const double * nextImaginary = next + transformSize;
+    for(size_t frequency = 0; frequency < transformSize; frequency += 2){
+        for(size_t parity = 0; parity < 2; ++parity){
+            const size_t index = frequency + parity;
+            const double sign = parity == 0 ? 1.0 : -1.0;
+            const double xReal = segment[index];
+            const double xImaginary = segmentImaginary[index];
+            const double yReal = next[index];
+            const double yImaginary = nextImaginary[index];
+            spectrumReal[index] += xReal*xReal + xImaginary*xImaginary + sign*(xReal*yReal + xImaginary*yImaginary);
+            spectrumImaginary[index] += sign*(xReal*yImaginary - xImaginary*yReal);
+        }
+    }
+}
+
+/** Accumulates the cross-spectra of a range of segments, which is the work of
+ * one parallel task. Segments are transformed in pairs. The contribution of
+ * each segment needs the transform of the segment after it, so one pair beyond
+ * the end of the range is transformed too (it is the first pair of the next task).
+ *
+ * \param values - A pointer to the first of the values.
+ * \param count - The number of values.
+ * \param mean - The mean of the values.
+ * \param segmentLength - The number of values in each segment.
+ * \param transform - The transform, of twice "segmentLength" points.
+ * \param firstSegment - The first segment of the range, which must be even.
+ * \param lastSegment - One beyond the last segment of the range.
+ * \param spectrumReal - The real parts of the spectrum, which are accumulated.
+ * \param spectrumImaginary - The imaginary parts of the spectrum, which are accumulated.
+ */
+static void accumulateSegments(const double * values, size_t count, double mean, size_t segmentLength,
+                               const StatsFourierTransform & transform, size_t firstSegment, size_t lastSegment,
+                               double * spectrumReal, double * spectrumImaginary){
+    const size_t transformSize = transform.getSize();
+    std::vector<double> workspace(10*transformSize);
+    double * workReal = &workspace[0];
+    double * workImaginary = workReal + transformSize;
+    double * current[2] = {workImaginary + transformSize, workImaginary + 3*transformSize};
+    double * following[2] = {workImaginary + 5*transformSize, workImaginary + 7*transformSize};
+
+    transformSegmentPair(values, count, mean, segmentLength, firstSegment, transform,
+                         workReal, workImaginary, current[0], current[1]);
+    for(size_t segment = firstSegment; segment < lastSegment; segment += 2){
+        const bool pairInRange = segment + 1 < lastSegment;
+        if(pairInRange){
+            transformSegmentPair(values, count, mean, segmentLength, segment + 2, transform,
+                                 workReal, workImaginary, following[0], following[1]);
+        }
+        accumulateCrossSpectrum(current[0], current[1], transformSize, spectrumReal, spectrumImaginary);
+        if(pairInRange){
+            accumulateCrossSpectrum(current[1], following[0], transformSize, spectrumReal, spectrumImaginary);
+        }
+        std::swap(current[0], following[0]);
+        std::swap(current[1], following[1]);
+    }
+}
+
+// BLOCKING HELPERS
+
+/// The largest number of blocking levels, which is enough for any series that fits in memory.
+static const unsigned maximumBlockingLevels = 64;
+
+/** \struct BlockingCascade
+ * Accumulates the sums of the block means of a series at every blocking level,
+ * in a single pass and without storing the blocked series. Level k holds the
+ * means of blocks of \f$2^k\f$ values. Each value that arrives at a level is
+ * counted there and then either held until its neighbour arrives or averaged
+ * with the held value, and the average is passed to the next level, like the
+ * carries of a binary counter. Incomplete blocks at the end of the series are
+ * never passed on, as the blocking method requires.
+ */
+struct BlockingCascade {
+    /// The sum of the block means at each level.
+    double sums[maximumBlockingLevels];
+    /// The sum of the squares of the block means at each level.
+    double squaredSums[maximumBlockingLevels];
+    /// The number of blocks at each level.
+    long long counts[maximumBlockingLevels];
+    /// The block mean that is waiting for its neighbour at each level.
+    double pending[maximumBlockingLevels];
+    /// True at each level where a block mean is waiting for its neighbour.
+    bool hasPending[maximumBlockingLevels];
+
+    /** Constructor that creates an empty cascade.
+     */
+    BlockingCascade(){
+        std::fill(sums, sums + maximumBlockingLevels, 0.0);
+        std::fill(squaredSums, squaredSums + maximumBlockingLevels, 0.0);
+        std::fill(counts, counts + maximumBlockingLevels, 0LL);
+        std::fill(pending, pending + maximumBlockingLevels, 0.0);
+        std::fill(hasPending, hasPending + maximumBlockingLevels, false);
+    }
+
+    /** Counts a block mean at a level and passes it on.
+     *
+     * \param value - The block mean.
+     * \param level - The level.
+     */
+    void add(double value, unsigned level){
+        for(;;){
+            sums[level] += value;
+            squaredSums[level] += value*value;
+            ++counts[level];
+            if(!hasPending[level]){
+                pending[level] = value;
+                hasPending[level] = true;
+                return;
+            }
+            value = 0.5*(pending[level] + value);
+            hasPending[level] = false;
+            ++level;
+        }
+    }
+
+    /** Passes on a block mean that has already been counted at its level.
+     *
+     * \param value - The block mean.
+     * \param level - The level.
+     */
+    void carry(double value, unsigned level){
+        if(!hasPending[level]){
+            pending[level] = value;
+            hasPending[level] = true;
+            return;
+        }
+        hasPending[level] = false;
+        add(0.5*(pending[level] + value), level + 1);
+    }
+};
+
+/** Blocks a whole series, sharing the work between threads.
+ *
+ * The series is divided into chunks of \f$2^c\f$ values, where c is
+ * StatsAutocorrelation::chunkLevels, which are blocked independently into
+ * levels 0 to c. No block at those levels spans two chunks, so their sums are
+ * simply added together. Each complete chunk leaves a single block mean at
+ * level c, and these are carried into a final cascade for the higher levels.
+ *
+ * The values are blocked relative to a "shift" (the mean of their first few
+ * values) so that the sums of squares are not degraded by cancellation.
+ *
+ * \param values - A pointer to the first of the values.
+ * \param count - The number of values, which must not be zero.
+ * \param threadCount - The maximum number of threads, or zero for one per
+ * thread of the shared pool.
+ * \param cascade - Receives the sums of every level, relative to the shift.
+ *
+ * \return The shift.
+ */
+static double blockSeries(const double * values, size_t count, unsigned threadCount, BlockingCascade & cascade){
+    const size_t shiftCount = count < 1024 ? count : 1024;
+    double shift = 0.0;
+    for(size_t index = 0; index < shiftCount; ++index){
+        shift += values[index];
+    }
+    shift /= shiftCount;
+
+    const unsigned chunkLevels = StatsAutocorrelation::chunkLevels;
+    const size_t chunkSize = static_cast<size_t>(1) << chunkLevels;
+    const size_t chunkCount = (count + chunkSize - 1)/chunkSize;
+    std::vector<BlockingCascade> chunks(chunkCount);
+    std::function<void(size_t)> task = [&](size_t chunk){
+        const size_t begin = chunk*chunkSize;
+        const size_t end = count - begin < chunkSize ? count : begin + chunkSize;
+        BlockingCascade & chunkCascade = chunks[chunk];
+        for(size_t index = begin; index < end; ++index){
+            chunkCascade.add(values[index] - shift, 0);
+        }
+    };
+    if(threadCount == 1 || chunkCount == 1){
+        for(size_t chunk = 0; chunk < chunkCount; ++chunk){
+            task(chunk);
+        }
+    }
+    else{
+        StatsCalculatorWorkerPool::shared().parallelFor(chunkCount, task, threadCount);
+    }
+
+    for(size_t chunk = 0; chunk < chunkCount; ++chunk){
+        const BlockingCascade & chunkCascade = chunks[chunk];
+        for(unsigned level = 0; level <= chunkLevels; ++level){
+            cascade.sums[level] += chunkCascade.sums[level];
+            cascade.squaredSums[level] += chunkCascade.squaredSums[level];
+            cascade.counts[level] += chunkCascade.counts[level];
+        }
+        if(chunkCascade.counts[chunkLevels] == 1){
+            cascade.carry(chunkCascade.pending[chunkLevels], chunkLevels);
+        }
+    }
+    return shift;
+}
+
+/** Computes the naive standard error of the mean of the block means at one
+ * level of a cascade.
+ *
+ * \param cascade - The cascade.
+ * \param level - The level, which must have at least two blocks.
+ */
+static double blockingStandardError(const BlockingCascade & cascade, unsigned level){
+    const double blocks = static_cast<double>(cascade.counts[level]);
+    const double mean = cascade.sums[level]/blocks;
+    const double variance = cascade.squaredSums[level]/blocks - mean*mean;
+    return variance > 0.0 ? std::sqrt(variance/(blocks - 1.0)) : 0.0;
+}
+
+// METHODS OF STATSAUTOCORRELATION
+
+/** Default constructor for the StatsAutocorrelation class.
+ */
+StatsAutocorrelation::StatsAutocorrelation() :
+threadCount(0),
+windowFactor(5.0)
+{}
+
+/** Public method that sets the maximum number of threads that may share each
+ * analysis.
+ *
+ * \param threads - The number of threads, including the calling thread. Zero
+ * uses one per thread of StatsCalculatorWorkerPool::shared().
+ */
+void StatsAutocorrelation::setThreadCount(unsigned threads){
+    threadCount = threads;
+}
+
+/** Public method that sets the factor c of Sokal's automatic window.
+ *
+ * \param factor - The factor. Larger factors reduce the bias of the integrated
+ * autocorrelation time, at the cost of more statistical noise.
+ *
+ * \return True on success, or false if the factor is not positive.
+ */
+bool StatsAutocorrelation::setWindowFactor(double factor){
+    if(!(factor > 0.0)){
+        return false;
+    }
+    windowFactor = factor;
+    return true;
+}
+
+/** Public method that returns the factor c of Sokal's automatic window.
+ */
+double StatsAutocorrelation::getWindowFactor() const{
+    return windowFactor;
+}
+
+/** Public method that computes the autocovariances of a series.
+ *
+ * The series is divided into segments of L values, where L is the smallest
+ * power of two (of at least 64) that covers the required lags. The cross-spectra
+ * of the segments are accumulated by tasks of "segmentsPerTask" segments, each
+ * into its own spectrum. Unless only one thread is allowed (or there is only one
+ * task), the tasks are shared between this thread and the threads of
+ * StatsCalculatorWorkerPool::shared(). The spectra are then added together in
+ * task order, so the result does not depend on the number of threads, and a
+ * single inverse transform gives the sums of the lagged products.
+ *
+ * \param values - A pointer to the first of the values, which must be finite.
+ * \param count - The number of values.
+ * \param mean - The mean about which the covariances are computed.
+ * \param lagCount - The number of lags.
+ * \param autocovariances - Space for "lagCount" autocovariances.
+ */
+void StatsAutocorrelation::computeAutocovariances(const double * values, size_t count, double mean,
+                                                  size_t lagCount, double * autocovariances) const{
+    std::fill(autocovariances, autocovariances + lagCount, 0.0);
+    const size_t requiredLags = lagCount < count ? lagCount : count;
+    if(requiredLags == 0){
+        return;
+    }
+    size_t segmentLength = 64;
+    while(segmentLength < requiredLags){
+        segmentLength <<= 1;
+    }
+    const size_t transformSize = 2*segmentLength;
+    const size_t segmentCount = (count + segmentLength - 1)/segmentLength;
+    const size_t taskCount = (segmentCount + segmentsPerTask - 1)/segmentsPerTask;
+    const StatsFourierTransform transform(transformSize);
+
+    // Each task has its own spectrum: the real parts followed by the imaginary parts.
+    std::vector<double> spectra(2*transformSize*taskCount, 0.0);
+    std::function<void(size_t)> task = [&](size_t taskIndex){
+        const size_t firstSegment = taskIndex*segmentsPerTask;
+        const size_t lastSegment = segmentCount - firstSegment < segmentsPerTask ?
+            segmentCount : firstSegment + segmentsPerTask;
+        double * spectrum = &spectra[2*transformSize*taskIndex];
+        accumulateSegments(values, count, mean, segmentLength, transform, firstSegment, lastSegment,
+                           spectrum, spectrum + transformSize);
+    };
+    if(threadCount == 1 || taskCount == 1){
+        for(size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex){
+            task(taskIndex);
+        }
+    }
+    else{
+        StatsCalculatorWorkerPool::shared().parallelFor(taskCount, task, threadCount);
+    }
+
+    double * totalReal = &spectra[0];
+    double * totalImaginary = totalReal + transformSize;
+    for(size_t taskIndex = 1; taskIndex < taskCount; ++taskIndex){
+        const double * spectrum = &spectra[2*transformSize*taskIndex];
+        for(size_t index = 0; index < 2*transformSize; ++index){
+            totalReal[index] += spectrum[index];
+        }
+    }
+    transform.inverse(totalReal, totalImaginary);
+    for(size_t lag = 0; lag < requiredLags; ++lag){
+        autocovariances[lag] = totalReal[lag]/count;
+    }
+}
+
+/** Public method that computes the autocorrelations of a series about its mean,
+ * by normalizing its autocovariances by the variance.
+ *
+ * \param values - A pointer to the first of the values, which must be finite.
+ * \param count - The number of values.
+ * \param lagCount - The number of lags.
+ * \param autocorrelations - Space for "lagCount" autocorrelations.
+ */
+void StatsAutocorrelation::computeAutocorrelations(const double * values, size_t count, size_t lagCount,
+                                                   double * autocorrelations) const{
+    double mean = 0.0;
+    if(count > 0){
+        BlockingCascade cascade;
+        mean = blockSeries(values, count, threadCount, cascade) + cascade.sums[0]/count;
+    }
+    computeAutocovariances(values, count, mean, lagCount, autocorrelations);
+    if(lagCount == 0){
+        return;
+    }
+    const double variance = autocorrelations[0];
+    for(size_t lag = 0; lag < lagCount; ++lag){
+        autocorrelations[lag] = variance > 0.0 ? autocorrelations[lag]/variance : (lag == 0 ? 1.0 : 0.0);
+    }
+}
+
+/** Public method that computes the blocking estimates of the standard error of
+ * the mean, one for each block length for which there are at least two blocks.
+ *
+ * \param values - A pointer to the first of the values, which must be finite.
+ * \param count - The number of values.
+ * \param standardErrors - Receives the estimates, starting with blocks of one value.
+ */
+void StatsAutocorrelation::computeBlockingErrors(const double * values, size_t count,
+                                                 std::vector<double> & standardErrors) const{
+    standardErrors.clear();
+    if(count < 2){
+        return;
+    }
+    BlockingCascade cascade;
+    blockSeries(values, count, threadCount, cascade);
+    for(unsigned level = 0; level < maximumBlockingLevels && cascade.counts[level] >= 2; ++level){
+        standardErrors.push_back(blockingStandardError(cascade, level));
+    }
+}
+
+/** Public method that computes every statistic of the analysis.
+ *
+ * One pass blocks the series, which also gives its mean and variance. The
+ * blocking estimate is taken from the first level, among those with at least
+ * "minimumBlocks" blocks, whose estimate is not exceeded at the next level by
+ * more than its own statistical uncertainty, \f$\sigma_k/\sqrt{2(n_k - 1)}\f$
+ * for \f$n_k\f$ blocks. If there is no such level, the estimate of the last
+ * level with enough blocks is used and the result is flagged as unconverged.
+ *
+ * The autocovariances are then computed for "initialLagCount" lags, and the
+ * integrated autocorrelation time is summed until Sokal's window is found. If
+ * it is not found, eight times as many lags are computed, and so on, until
+ * every lag of the series has been tried. The standard error of the mean is
+ * \f$\sqrt{\sigma^2\tau/n}\f$.
+ *
+ * \param values - A pointer to the first of the values, which must be finite.
+ * \param count - The number of values.
+ * \param result - A StatsAutocorrelationResult structure that is filled with the statistics.
+ */
+void StatsAutocorrelation::analyze(const double * values, size_t count, StatsAutocorrelationResult & result) const{
+    result.count = static_cast<long long>(count);
+    result.mean = 0.0;
+    result.variance = 0.0;
+    result.integratedAutocorrelationTime = 0.0;
+    result.window = 0;
+    result.windowConverged = 0;
+    result.effectiveSampleSize = 0.0;
+    result.naiveStandardError = 0.0;
+    result.standardErrorOfMean = 0.0;
+    result.blockingStandardError = 0.0;
+    result.blockingLevel = 0;
+    result.blockingConverged = 0;
+    if(count == 0){
+        return;
+    }
+
+    BlockingCascade cascade;
+    const double shift = blockSeries(values, count, threadCount, cascade);
+    const double shiftedMean = cascade.sums[0]/count;
+    const double variance = cascade.squaredSums[0]/count - shiftedMean*shiftedMean;
+    result.mean = shift + shiftedMean;
+    result.variance = variance > 0.0 ? variance : 0.0;
+    if(count > 1){
+        result.naiveStandardError = blockingStandardError(cascade, 0);
+        result.blockingStandardError = result.naiveStandardError;
+        for(unsigned level = 0; level + 1 < maximumBlockingLevels
+            && cascade.counts[level + 1] >= minimumBlocks; ++level){
+            const double error = blockingStandardError(cascade, level);
+            const double uncertainty = error/std::sqrt(2.0*(cascade.counts[level] - 1));
+            result.blockingStandardError = blockingStandardError(cascade, level + 1);
+            result.blockingLevel = static_cast<int>(level + 1);
+            if(result.blockingStandardError <= error + uncertainty){
+                result.blockingStandardError = error;
+                result.blockingLevel = static_cast<int>(level);
+                result.blockingConverged = 1;
+                break;
+            }
+        }
+    }
+
+    size_t lagCount = count < initialLagCount ? count : initialLagCount;
+    std::vector<double> autocovariances;
+    double tau = 1.0;
+    for(;;){
+        autocovariances.resize(lagCount);
+        computeAutocovariances(values, count, result.mean, lagCount, &autocovariances[0]);
+        tau = 1.0;
+        result.window = 0;
+        result.windowConverged = 1;
+        if(autocovariances[0] > 0.0){
+            result.windowConverged = 0;
+            for(size_t lag = 1; lag < lagCount; ++lag){
+                tau += 2.0*autocovariances[lag]/autocovariances[0];
+                result.window = static_cast<long long>(lag);
+                if(lag >= windowFactor*tau){
+                    result.windowConverged = 1;
+                    break;
+                }
+            }
+        }
+        if(result.windowConverged || lagCount == count){
+            break;
+        }
+        lagCount = count/8 < lagCount ? count : 8*lagCount;
+    }
+    result.integratedAutocorrelationTime = tau;
+    result.effectiveSampleSize = count/tau;
+    result.standardErrorOfMean = tau > 0.0 ? std::sqrt(result.variance*tau/count) : 0.0;
+}
@@ -0,0 +1,641 @@
+// IMPLEMENTATION file for StatsPhiloxGenerator and StatsBootstrap classes
+
+// STL HEADER FILES
+
+// The <algorithm> header is included to provide the std::fill(...) and std::sort(...) functions.
+#include <algorithm>
+// The <cmath> header is included to provide the std::exp(...), std::log(...), std::log1p(...) and std::sqrt(...) functions.
+#include <cmath>
+// The <functional> header is included to provide the STL std::function type.
+#include <functional>
+// The <vector> header is included to provide the STL std::vector type.
+#include <vector>
+
+// LOCAL HEADER FILES
+
+// Include the stdafx.h header to satisfy Windows requirements
+#include "stdafx.h"
+
+/* The "StatsBootstrap.h" header is included to provide definitions of the
+ * StatsPhiloxGenerator and StatsBootstrap classes.
+ */
+#include "StatsBootstrap.h"
+
+/* The "StatsCalculatorWorkerPool.h" header file provides the pool of worker threads that
+ * share the resamples.
+ */
+#include "StatsCalculatorWorkerPool.h"
+
+// RANDOM NUMBER GENERATION HELPERS
+
+/// The multiplier of the first and second words of the counter in each Philox round.
+static const std::uint32_t philoxMultiplier0 = 0xD2511F53u;
+/// The multiplier of the third and fourth words of the counter in each Philox round.
+static const std::uint32_t philoxMultiplier1 = 0xCD9E8D57u;
+/// The constant added to the first word of the key after each Philox round (the golden ratio).
+static const std::uint32_t philoxKeyIncrement0 = 0x9E3779B9u;
+/// The constant added to the second word of the key after each Philox round (sqrt(3) - 1).
+static const std::uint32_t philoxKeyIncrement1 = 0xBB67AE85u;
+/// The number of Philox rounds, which is the number recommended by its authors.
+static const unsigned philoxRounds = 10;
+
+/// The number of blocks whose Philox rounds are computed together by generateBlocks().
+static const size_t philoxBatchBlocks = 8;
+
+/** Binomial variates whose mean is below this limit are generated by inversion
+ * starting from zero successes; others are generated by inversion starting from
+ * the most probable number of successes.
+ */
+static const double binomialInversionLimit = 16.0;
+
+/** Computes the natural logarithm of the factorial of a whole number. Small
+ * factorials are computed exactly; larger ones are computed from Stirling's
+ * series, whose relative error is then below 1e-15.
+ *
+ * \param value - The whole number, which must not be negative.
+ *
+ * \return The logarithm of value!.
+ */
+static double logFactorial(double value){
+    if(value < 16.0){
+        double factorial = 1.0;
+        for(double factor = 2.0; factor <= value; factor += 1.0){
+            factorial *= factor;
+        }
+        return std::log(factorial);
+    }
+    const double inverse = 1.0/value;
+    const double inverseSquared = inverse*inverse;
+    return value*std::log(value) - value + 0.5*std::log(2.0*3.14159265358979323846*value)
+        + inverse*(1.0/12.0 - inverseSquared*(1.0/360.0 - inverseSquared/1260.0));
+}
+
+// METHODS OF STATSPHILOXGENERATOR
+
+/** Constructor for the StatsPhiloxGenerator class. The key is the seed and the
+ * counter starts at the first block of the stream. No numbers are generated
+ * until they are required.
+ *
+ * \param seed - The seed, which selects the bijection.
+ * \param stream - The stream number.
+ */
+StatsPhiloxGenerator::StatsPhiloxGenerator(std::uint64_t seed, std::uint64_t stream) :
+outputsUsed(4){
+    key[0] = static_cast<std::uint32_t>(seed);
+    key[1] = static_cast<std::uint32_t>(seed >> 32);
+    counter[0] = 0;
+    counter[1] = 0;
+    counter[2] = static_cast<std::uint32_t>(stream);
+    counter[3] = static_cast<std::uint32_t>(stream >> 32);
+}
+
+/** Public static method that applies the Philox4x32-10 bijection to a counter.
+ *
+ * Each round multiplies two words of the counter by fixed odd constants,
+ * producing 64-bit products. The high halves of the products are combined with
+ * the other two words and the key by exclusive-or, and the four words are
+ * permuted. The key is advanced by a Weyl sequence between rounds. Ten rounds
+ * pass the BigCrush statistical tests with a wide margin.
+ *
+ * \param counter - The four words of the counter.
+ * \param key - The two words of the key.
+ * \param outputs - Space for the four words of output.
+ */
+void StatsPhiloxGenerator::generateBlock(const std::uint32_t counter[4], const std::uint32_t key[2],
+                                         std::uint32_t outputs[4]){
+    std::uint32_t word0 = counter[0];
+    std::uint32_t word1 = counter[1];
+    std::uint32_t word2 = counter[2];
+    std::uint32_t word3 = counter[3];
+    std::uint32_t key0 = key[0];
+    std::uint32_t key1 = key[1];
+    for(unsigned round = 0; round < philoxRounds; ++round){
+        const std::uint64_t product0 = static_cast<std::uint64_t>(philoxMultiplier0)*word0;
+        const std::uint64_t product1 = static_cast<std::uint64_t>(philoxMultiplier1)*word2;
+        word0 = static_cast<std::uint32_t>(product1 >> 32) ^ word1 ^ key0;
+        word1 = static_cast<std::uint32_t>(product1);
+        word2 = static_cast<std::uint32_t>(product0 >> 32) ^ word3 ^ key1;
+        word3 = static_cast<std::uint32_t>(product0);
+        key0 += philoxKeyIncrement0;
+        key1 += philoxKeyIncrement1;
+    }
+    outputs[0] = word0;
+    outputs[1] = word1;
+    outputs[2] = word2;
+    outputs[3] = word3;
+}
+
+/** Public method that generates the next blocks of the stream in a single batch.
+ *
+ * The rounds are applied to "philoxBatchBlocks" counters at once, with the words
+ * of the counters held in separate arrays. The blocks are independent, so the
+ * inner loops contain no dependencies between iterations and the compiler can
+ * compute them with vector instructions (or at least overlap their multiplies).
+ * The words of each block are written in the same order as generateBlock()
+ * writes them, and the block number is advanced past the generated blocks.
+ *
+ * \param words - Space for 4*blockCount words.
+ * \param blockCount - The number of blocks.
+ */
+void StatsPhiloxGenerator::generateBlocks(std::uint32_t * words, size_t blockCount){
+    std::uint64_t block = counter[0] | static_cast<std::uint64_t>(counter[1]) << 32;
+    for(size_t done = 0; done < blockCount; done += philoxBatchBlocks){
+        std::uint32_t word0[philoxBatchBlocks];
+        std::uint32_t word1[philoxBatchBlocks];
+        std::uint32_t word2[philoxBatchBlocks];
+        std::uint32_t word3[philoxBatchBlocks];
+        for(size_t lane = 0; lane < philoxBatchBlocks; ++lane){
+            word0[lane] = static_cast<std::uint32_t>(block + lane);
+            word1[lane] = static_cast<std::uint32_t>((block + lane) >> 32);
+            word2[lane] = counter[2];
+            word3[lane] = counter[3];
+        }
+        std::uint32_t key0 = key[0];
+        std::uint32_t key1 = key[1];
+        for(unsigned round = 0; round < philoxRounds; ++round){
+            for(size_t lane = 0; lane < philoxBatchBlocks; ++lane){
+                const std::uint64_t product0 = static_cast<std::uint64_t>(philoxMultiplier0)*word0[lane];
+                const std::uint64_t product1 = static_cast<std::uint64_t>(philoxMultiplier1)*word2[lane];
+                word0[lane] = static_cast<std::uint32_t>(product1 >> 32) ^ word1[lane] ^ key0;
+                word1[lane] = static_cast<std::uint32_t>(product1);
+                word2[lane] = static_cast<std::uint32_t>(product0 >> 32) ^ word3[lane] ^ key1;
+                word3[lane] = static_cast<std::uint32_t>(product0);
+            }
+            key0 += philoxKeyIncrement0;
+            key1 += philoxKeyIncrement1;
+        }
+        const size_t lanes = blockCount - done < philoxBatchBlocks ? blockCount - done : philoxBatchBlocks;
+        for(size_t lane = 0; lane < lanes; ++lane){
+            std::uint32_t * output = words + 4*(done + lane);
+            output[0] = word0[lane];
+            output[1] = word1[lane];
+            output[2] = word2[lane];
+            output[3] = word3[lane];
+        }
+        block += lanes;
+    }
+    counter[0] = static_cast<std::uint32_t>(block);
+    counter[1] = static_cast<std::uint32_t>(block >> 32);
+}
+
+/** Public method that returns the next uniformly distributed 32-bit word. The
+ * words of each block are returned in turn; when they are exhausted, the next
+ * block of the stream is generated and the block number is incremented.
+ */
+std::uint32_t StatsPhiloxGenerator::nextWord(){
+    if(outputsUsed == 4){
+        generateBlock(counter, key, outputs);
+        if(++counter[0] == 0){
+            ++counter[1];
+        }
+        outputsUsed = 0;
+    }
+    return outputs[outputsUsed++];
+}
+
+/** Public method that returns a uniformly distributed double in [0, 1). Two
+ * words supply 64 random bits, of which the top 53 fill the significand.
+ */
+double StatsPhiloxGenerator::nextDouble(){
+    const std::uint64_t high = nextWord();
+    const std::uint64_t bits = (high << 32) | nextWord();
+    return static_cast<double>(bits >> 11)*(1.0/9007199254740992.0);
+}
+
+/** Public method that returns an integer uniformly distributed in [0, bound).
+ *
+ * The method of Lemire ("Fast random integer generation in an interval", 2019)
+ * is used: the high half of the 64-bit product of a random word and the bound
+ * is the result, and the low half is used to reject the few words that would
+ * make some results more likely than others. A rejection is needed for fewer
+ * than bound in 2^32 words, and the division that finds the threshold is only
+ * performed when a rejection is possible.
+ *
+ * \param bound - The number of possible results, which must not be zero.
+ */
+std::uint32_t StatsPhiloxGenerator::nextBelow(std::uint32_t bound){
+    std::uint64_t product = static_cast<std::uint64_t>(nextWord())*bound;
+    std::uint32_t low = static_cast<std::uint32_t>(product);
+    if(low < bound){
+        // The threshold is 2^32 modulo the bound.
+        const std::uint32_t threshold = (0u - bound) % bound;
+        while(low < threshold){
+            product = static_cast<std::uint64_t>(nextWord())*bound;
+            low = static_cast<std::uint32_t>(product);
+        }
+    }
+    return static_cast<std::uint32_t>(product >> 32);
+}
+
+/** Public method that returns a binomially distributed integer, by INVERSION:
+ * a uniform variate is drawn and the probabilities of successive numbers of
+ * successes are subtracted from it until it is exhausted. The probabilities
+ * are computed from one another by the ratio
+ * \f$P(k+1)/P(k) = \frac{(n-k)p}{(k+1)(1-p)}\f$,
+ * so the cost is proportional to the number of values that are visited.
+ *
+ * If the mean is small, the search starts from zero successes and visits about
+ * the mean plus one values. Otherwise it starts from the most probable number
+ * of successes (whose probability is found from log-factorials) and visits
+ * values alternately above and below it, which is a valid (if reordered)
+ * inversion that visits a number of values proportional to the standard
+ * deviation. Probabilities above one half are handled by counting failures.
+ *
+ * \param trials - The number of trials.
+ * \param probability - The probability of success in each trial.
+ */
+std::uint64_t StatsPhiloxGenerator::nextBinomial(std::uint64_t trials, double probability){
+    if(trials == 0 || probability <= 0.0){
+        return 0;
+    }
+    if(probability >= 1.0){
+        return trials;
+    }
+    if(probability > 0.5){
+        return trials - nextBinomial(trials, 1.0 - probability);
+    }
+    const double trialCount = static_cast<double>(trials);
+    const double oddsRatio = probability/(1.0 - probability);
+    double uniform = nextDouble();
+
+    if(trialCount*probability < binomialInversionLimit){
+        double mass = std::exp(trialCount*std::log1p(-probability));
+        std::uint64_t successes = 0;
+        while(uniform >= mass && successes < trials && mass > 0.0){
+            uniform -= mass;
+            mass *= oddsRatio*(trialCount - successes)/(successes + 1);
+            ++successes;
+        }
+        return successes;
+    }
+
+    std::uint64_t mode = static_cast<std::uint64_t>((trialCount + 1.0)*probability);
+    if(mode > trials){
+        mode = trials;
+    }
+    const double modeCount = static_cast<double>(mode);
+    const double modeMass = std::exp(logFactorial(trialCount) - logFactorial(modeCount)
+                                     - logFactorial(trialCount - modeCount)
+                                     + modeCount*std::log(probability)
+                                     + (trialCount - modeCount)*std::log1p(-probability));
+    uniform -= modeMass;
+    if(uniform < 0.0){
+        return mode;
+    }
+    std::uint64_t lower = mode;
+    std::uint64_t upper = mode;
+    double lowerMass = modeMass;
+    double upperMass = modeMass;
+    for(;;){
+        if(upper < trials){
+            upperMass *= oddsRatio*(trialCount - upper)/(upper + 1);
+            ++upper;
+            uniform -= upperMass;
+            if(uniform < 0.0){
+                return upper;
+            }
+        }
+        if(lower > 0){
+            lowerMass *= lower/(oddsRatio*(trialCount - lower + 1));
+            --lower;
+            uniform -= lowerMass;
+            if(uniform < 0.0){
+                return lower;
+            }
+        }
+        // Rounding can leave a sliver of the uniform variate that no value claims.
+        if((upper == trials || upperMass == 0.0) && (lower == 0 || lowerMass == 0.0)){
+            return mode;
+        }
+    }
+}
+
+// BOOTSTRAP HELPERS
+
+/// The largest number of blocks that a RandomHalfWords source generates at once.
+static const size_t halfWordBatchBlocks = 64;
+
+/** \struct RandomHalfWords
+ * Supplies uniformly distributed 16-bit integers, two from each word of a
+ * StatsPhiloxGenerator, which are generated in batches by generateBlocks().
+ * Each batch is only as large as the caller expects to need (up to a limit),
+ * so that small resamples do not generate numbers that they never use.
+ */
+struct RandomHalfWords {
+    /// The generator that supplies the words.
+    StatsPhiloxGenerator & generator;
+    /// The most recently generated batch of words.
+    std::uint32_t words[4*halfWordBatchBlocks];
+    /// The number of 16-bit halves in the batch.
+    size_t halfCount;
+    /// The index of the next half to be returned.
+    size_t nextHalf;
+
+    /** Constructor that creates an empty source.
+     *
+     * \param generator - The generator that supplies the words.
+     */
+    explicit RandomHalfWords(StatsPhiloxGenerator & generator) :
+    generator(generator),
+    halfCount(0),
+    nextHalf(0)
+    {}
+
+    /** Returns the next 16-bit integer.
+     *
+     * \param expected - The number of integers that the caller expects to need,
+     * including this one, which determines the size of the next batch.
+     */
+    std::uint32_t next(std::uint64_t expected){
+        if(nextHalf == halfCount){
+            const std::uint64_t blocks = (expected + 7)/8;
+            const size_t batch = blocks < halfWordBatchBlocks ? static_cast<size_t>(blocks) : halfWordBatchBlocks;
+            generator.generateBlocks(words, batch);
+            halfCount = 8*batch;
+            nextHalf = 0;
+        }
+        const std::uint32_t word = words[nextHalf >> 1];
+        const std::uint32_t half = nextHalf & 1 ? word >> 16 : word & 0xFFFFu;
+        ++nextHalf;
+        return half;
+    }
+};
+
+/** Computes the means and standard deviations of a range of resamples.
+ *
+ * For each resample, the draws are divided between the blocks of the array by
+ * drawing, for each block in turn, a binomial number of the draws that remain
+ * with the probability that a draw lands in this block rather than a later one.
+ * The draws in the block are then scattered over its values by incrementing
+ * "counts". Each draw takes a random 16-bit integer and maps it onto the block
+ * by Lemire's multiply-and-shift method, rejecting the few integers that would
+ * bias the result (there are none when the size of the block is a power of
+ * two, as every block but the last is). The sums of the count-weighted deviations of the values from
+ * "centre", and of their squares, give the mean and variance of the resample;
+ * because the values are centred on (approximately) their mean, the sums are
+ * not degraded by cancellation.
+ *
+ * \param values - A pointer to the first of the values.
+ * \param count - The number of values.
+ * \param centre - The mean of the values.
+ * \param seed - The seed of the random number generator.
+ * \param first - The first resample in the range.
+ * \param last - One beyond the last resample in the range.
+ * \param means - The array that receives the mean of each resample.
+ * \param standardDeviations - The array that receives the standard deviation of each resample.
+ * \param counts - Scratch space for at least min(count, StatsBootstrap::blockValues) counts.
+ */
+static void resampleRange(const double * values, size_t count, double centre, std::uint64_t seed,
+                          unsigned first, unsigned last, double * means, double * standardDeviations,
+                          std::uint32_t * counts){
+    for(unsigned resample = first; resample < last; ++resample){
+        StatsPhiloxGenerator generator(seed, resample);
+        RandomHalfWords halves(generator);
+        std::uint64_t remainingDraws = count;
+        size_t remainingValues = count;
+        double deviationSum = 0.0;
+        double squaredDeviationSum = 0.0;
+        for(size_t begin = 0; begin < count; begin += StatsBootstrap::blockValues){
+            const size_t blockSize = count - begin < StatsBootstrap::blockValues ?
+                count - begin : StatsBootstrap::blockValues;
+            const std::uint64_t draws = blockSize == remainingValues ? remainingDraws :
+                generator.nextBinomial(remainingDraws, static_cast<double>(blockSize)/remainingValues);
+            remainingDraws -= draws;
+            remainingValues -= blockSize;
+            if(draws == 0){
+                continue;
+            }
+
+            std::fill(counts, counts + blockSize, 0u);
+            const std::uint32_t bound = static_cast<std::uint32_t>(blockSize);
+            const std::uint32_t threshold = 65536u % bound;
+            for(std::uint64_t draw = 0; draw < draws; ++draw){
+                std::uint32_t product = halves.next(draws - draw)*bound;
+                while((product & 0xFFFFu) < threshold){
+                    product = halves.next(draws - draw)*bound;
+                }
+                ++counts[product >> 16];
+            }
+
+            /* Four partial sums of each kind are kept, so that successive additions
+             * do not each have to wait for the previous one to complete.
+             */
+            const double * block = values + begin;
+            double partialDeviationSums[4] = {0.0, 0.0, 0.0, 0.0};
+            double partialSquaredDeviationSums[4] = {0.0, 0.0, 0.0, 0.0};
+            size_t index = 0;
+            for(; index + 4 <= blockSize; index += 4){
+                for(size_t lane = 0; lane < 4; ++lane){
+                    const double deviation = block[index + lane] - centre;
+                    const double weightedDeviation = counts[index + lane]*deviation;
+                    partialDeviationSums[lane] += weightedDeviation;
+                    partialSquaredDeviationSums[lane] += weightedDeviation*deviation;
+                }
+            }
+            for(; index < blockSize; ++index){
+                const double deviation = block[index] - centre;
+                const double weightedDeviation = counts[index]*deviation;
+                partialDeviationSums[0] += weightedDeviation;
+                partialSquaredDeviationSums[0] += weightedDeviation*deviation;
+            }
+            deviationSum += (partialDeviationSums[0] + partialDeviationSums[1])
+                + (partialDeviationSums[2] + partialDeviationSums[3]);
+            squaredDeviationSum += (partialSquaredDeviationSums[0] + partialSquaredDeviationSums[1])
+                + (partialSquaredDeviationSums[2] + partialSquaredDeviationSums[3]);
+        }
+        const double meanOffset = deviationSum/count;
+        const double variance = squaredDeviationSum/count - meanOffset*meanOffset;
+        means[resample] = centre + meanOffset;
+        standardDeviations[resample] = variance > 0.0 ? std::sqrt(variance) : 0.0;
+    }
+}
+
+/** Summarizes the distribution of a statistic over the resamples.
+ *
+ * \param replicates - The value of the statistic for each resample. The vector
+ * is sorted.
+ * \param confidenceLevel - The confidence level.
+ * \param lower - Receives the lower end of the percentile interval.
+ * \param upper - Receives the upper end of the percentile interval.
+ * \param standardError - Receives the standard deviation of the replicates
+ * (with the divisor one less than their number), which is the bootstrap
+ * estimate of the standard error of the statistic.
+ */
+static void summarizeReplicates(std::vector<double> & replicates, double confidenceLevel,
+                                double & lower, double & upper, double & standardError){
+    const size_t count = replicates.size();
+    double mean = 0.0;
+    double sumOfSquaredDeviations = 0.0;
+    for(size_t index = 0; index < count; ++index){
+        const double delta = replicates[index] - mean;
+        mean += delta/(index + 1);
+        sumOfSquaredDeviations += delta*(replicates[index] - mean);
+    }
+    standardError = count > 1 ? std::sqrt(sumOfSquaredDeviations/(count - 1)) : 0.0;
+
+    // The ends of the interval are quantiles, interpolated as by StatsCalculator::getQuantile().
+    std::sort(replicates.begin(), replicates.end());
+    const double tail = (1.0 - confidenceLevel)/2.0;
+    const double probabilities[2] = {tail, 1.0 - tail};
+    double * ends[2] = {&lower, &upper};
+    for(int end = 0; end < 2; ++end){
+        const double position = probabilities[end]*(count - 1);
+        const size_t below = static_cast<size_t>(position);
+        const double fraction = position - below;
+        *ends[end] = below + 1 < count ?
+            replicates[below] + fraction*(replicates[below + 1] - replicates[below]) : replicates[count - 1];
+    }
+}
+
+// METHODS OF STATSBOOTSTRAP
+
+/** Constructor for the StatsBootstrap class. Invalid options are replaced by
+ * the defaults.
+ *
+ * \param resampleCount - The number of resamples, which must not be zero.
+ * \param confidenceLevel - The confidence level, between zero and one.
+ * \param seed - The seed of the random number generator.
+ */
+StatsBootstrap::StatsBootstrap(unsigned resampleCount, double confidenceLevel, std::uint64_t seed) :
+resampleCount(resampleCount > 0 ? resampleCount : 2000),
+confidenceLevel(confidenceLevel > 0.0 && confidenceLevel < 1.0 ? confidenceLevel : 0.95),
+seed(seed),
+threadCount(0)
+{}
+
+/** Public method that sets the number of resamples. The Monte Carlo error of
+ * the ends of a 95% interval is roughly proportional to one over the square
+ * root of the number; a few thousand resamples are usually enough.
+ *
+ * \param resampleCount - The number of resamples.
+ *
+ * \return True on success, or false if resampleCount is zero.
+ */
+bool StatsBootstrap::setResampleCount(unsigned resampleCount){
+    if(resampleCount == 0){
+        return false;
+    }
+    this->resampleCount = resampleCount;
+    return true;
+}
+
+/** Public method that returns the number of resamples.
+ */
+unsigned StatsBootstrap::getResampleCount() const{
+    return resampleCount;
+}
+
+/** Public method that sets the confidence level.
+ *
+ * \param confidenceLevel - The probability that an interval covers the statistic.
+ *
+ * \return True on success, or false if the level is not strictly between zero and one.
+ */
+bool StatsBootstrap::setConfidenceLevel(double confidenceLevel){
+    if(!(confidenceLevel > 0.0 && confidenceLevel < 1.0)){
+        return false;
+    }
+    this->confidenceLevel = confidenceLevel;
+    return true;
+}
+
+/** Public method that returns the confidence level.
+ */
+double StatsBootstrap::getConfidenceLevel() const{
+    return confidenceLevel;
+}
+
+/** Public method that sets the seed of the random number generator. The same
+ * seed, options and values always give the same intervals.
+ */
+void StatsBootstrap::setSeed(std::uint64_t seed){
+    this->seed = seed;
+}
+
+/** Public method that returns the seed of the random number generator.
+ */
+std::uint64_t StatsBootstrap::getSeed() const{
+    return seed;
+}
+
+/** Public method that sets the maximum number of threads that may share the
+ * resamples.
+ *
+ * \param threads - The number of threads, including the calling thread. Zero
+ * uses one per thread of StatsCalculatorWorkerPool::shared().
+ */
+void StatsBootstrap::setThreadCount(unsigned threads){
+    threadCount = threads;
+}
+
+/** Public method that computes the mean and the standard deviation of every
+ * resample.
+ *
+ * The resamples are divided into tasks of "resamplesPerTask", each of which
+ * has its own scratch array of counts. Unless only one thread is allowed (or
+ * there is only one task), the tasks are shared between this thread and the
+ * threads of StatsCalculatorWorkerPool::shared() using parallelFor(). Every
+ * resample writes only its own elements of the output arrays.
+ *
+ * \param values - A pointer to the first of the values, which must be finite.
+ * \param count - The number of values, which must not be zero.
+ * \param means - Space for "resampleCount" means.
+ * \param standardDeviations - Space for "resampleCount" standard deviations.
+ */
+void StatsBootstrap::resample(const double * values, size_t count, double * means,
+                              double * standardDeviations) const{
+    double centre = 0.0;
+    for(size_t index = 0; index < count; ++index){
+        centre += values[index];
+    }
+    centre /= count;
+
+    const size_t countsSize = count < blockValues ? count : blockValues;
+    const unsigned resamples = resampleCount;
+    const std::uint64_t streamSeed = seed;
+    const size_t taskCount = (resamples + resamplesPerTask - 1)/resamplesPerTask;
+    std::function<void(size_t)> task = [=](size_t taskIndex){
+        std::vector<std::uint32_t> counts(countsSize);
+        const unsigned first = static_cast<unsigned>(taskIndex*resamplesPerTask);
+        const unsigned last = resamples - first < resamplesPerTask ? resamples : first + resamplesPerTask;
+        resampleRange(values, count, centre, streamSeed, first, last, means, standardDeviations, &counts[0]);
+    };
+    if(threadCount == 1 || taskCount == 1){
+        for(size_t taskIndex = 0; taskIndex < taskCount; ++taskIndex){
+            task(taskIndex);
+        }
+    }
+    else{
+        StatsCalculatorWorkerPool::shared().parallelFor(taskCount, task, threadCount);
+    }
+}
+
+/** Public method that computes percentile confidence intervals and standard
+ * errors for the mean and the (population) standard deviation. The ends of
+ * each interval are the quantiles of the statistic over the resamples at
+ * (1 - confidenceLevel)/2 and (1 + confidenceLevel)/2.
+ *
+ * \param values - A pointer to the first of the values, which must be finite.
+ * \param count - The number of values.
+ * \param result - A StatsBootstrapResult structure that is filled with the intervals.
+ */
+void StatsBootstrap::computeIntervals(const double * values, size_t count, StatsBootstrapResult & result) const{
+    result.count = static_cast<long long>(count);
+    result.resampleCount = resampleCount;
+    result.confidenceLevel = confidenceLevel;
+    if(count == 0){
+        result.meanLower = 0.0;
+        result.meanUpper = 0.0;
+        result.meanStandardError = 0.0;
+        result.standardDeviationLower = 0.0;
+        result.standardDeviationUpper = 0.0;
+        result.standardDeviationStandardError = 0.0;
+        return;
+    }
+    std::vector<double> means(resampleCount);
+    std::vector<double> standardDeviations(resampleCount);
+    resample(values, count, &means[0], &standardDeviations[0]);
+    summarizeReplicates(means, confidenceLevel, result.meanLower, result.meanUpper, result.meanStandardError);
+    summarizeReplicates(standardDeviations, confidenceLevel, result.standardDeviationLower,
+                        result.standardDeviationUpper, result.standardDeviationStandardError);
+}
@@ -2,12 +2,26 @@
 
 // STL HEADER FILES
 
+// The <algorithm> header is included to provide the std::sort(...), std::nth_element(...) and std::merge(...) functions.
+#include <algorithm>
 // The <cmath> header is included to provide the std::sqrt(...) function.
 #include <cmath>
+// The <cstdint> header is included to provide the std::uint64_t type.
+#include <cstdint>
+// The <cstdlib> header is included to provide the std::strtod(...) function.
+#include <cstdlib>
+// The <cstring> header is included to provide the std::memcpy(...) and std::memmove(...) functions.
+#include <cstring>
+// The <limits> header is included to provide std::numeric_limits<double>::quiet_NaN().
+#include <limits>
 // The <fstream> header is included to enable input from and output to files.
 #include <fstream>
 // The <iostream> header is included to enable textual terminal output.
 #include <iostream>
+// The <utility> header is included to provide the std::pair type.
+#include <utility>
+// The <thread> header is included to provide the std::this_thread::yield(...) function.
+#include <thread>
 
 // LOCAL HEADER FILES
 
@@ -19,238 +33,4888 @@
  */
 #include "StatsCalculator.h"
 
-// PUBLIC METHODS OF STATSCALCULATOR
+/* The "StatsCalculatorWorkerPool.h" header file provides the pool of worker threads that
+ * share the passes of the radix sort.
+ */
+#include "StatsCalculatorWorkerPool.h"
 
-/** Private method that actually computes the sum of the stored numeric
- * values.
+/* The "StatsBootstrap.h" header file provides the engine that resamples the values
+ * to compute bootstrap confidence intervals.
+ */
+#include "StatsBootstrap.h"
+
+/* The "StatsAutocorrelation.h" header file provides the engine that computes the
+ * autocorrelations and the integrated autocorrelation time.
+ */
+#include "StatsAutocorrelation.h"
+
+/* The "StatsObserver.h" header file provides the background thread that delivers
+ * snapshots of the statistics to a subscriber.
+ */
+#include "StatsObserver.h"
+
+// METHODS OF RUNNINGSTATISTICS
+
+/** Default constructor for the RunningStatistics structure, which creates an
+ * empty accumulator.
+ */
+RunningStatistics::RunningStatistics() :
+count(0),
+sum(0.0),
+mean(0.0),
+sumOfSquaredDeviations(0.0),
+minimum(0.0),
+maximum(0.0){
+}
+
+/** Accumulates a single value using Welford's update, which avoids the loss of
+ * precision that accumulating a sum of squares would suffer.
  *
- * \return The computed sum is returned as a double-precision value.
+ * \f[ \bar{x}_{n} = \bar{x}_{n-1} + \frac{x_{n}-\bar{x}_{n-1}}{n} \f]
+ * \f[ M_{2,n} = M_{2,n-1} + (x_{n}-\bar{x}_{n-1})(x_{n}-\bar{x}_{n}) \f]
+ *
+ * \param value - The value to accumulate.
  */
-double StatsCalculator::computeSum(){
+void RunningStatistics::add(double value){
+    if(count == 0){
+        minimum = value;
+        maximum = value;
+    }
+    else{
+        minimum = value < minimum ? value : minimum;
+        maximum = value > maximum ? value : maximum;
+    }
+    ++count;
+    sum += value;
+    const double delta = value - mean;
+    mean += delta/count;
+    sumOfSquaredDeviations += delta*(value - mean);
     
-    // If any numeric values were successfully parsed from the input file...
-    if(numericValues.size() > 0){
-        
-        /* Declare and zero-initialize a double precision variable with
-         * identifier "sum" store the computed sum
-         */
-        double sum(0.0);
-        
-        /* Use the range-based for-loop syntax to iterate over all elements
-         * of the "numericValues" member datum.
-         *
-         * The value of the current element of "numericValues" will be
-         * accessible within the for-loop body using the identifier
-         * "numericValue".
-         */
-        for(double numericValue : numericValues){
-            /* Update the value of "sum" by adding the value of the current
-             * element of "numericValues"
-             */
-            sum += numericValue;
+    /* Once an infinity has been accumulated the update computes inf - inf = NaN
+     * for every later value, whereas the sum keeps the infinity. A mean that is
+     * no longer finite is therefore recovered from the sum.
+     */
+    if(!(std::fabs(mean) <= std::numeric_limits<double>::max())){
+        mean = sum/count;
+    }
+}
+
+/** Accumulates every value summarized by another accumulator using Chan's
+ * pairwise formula. If the accumulators contain \f$n_a\f$ and \f$n_b\f$ values
+ * and their means differ by \f$\delta\f$:
+ *
+ * \f[ M_{2} = M_{2,a} + M_{2,b} + \delta^{2}\frac{n_{a}n_{b}}{n_{a}+n_{b}} \f]
+ *
+ * \param other - The accumulator to merge into this one.
+ */
+void RunningStatistics::merge(const RunningStatistics & other){
+    if(other.count == 0){
+        return;
+    }
+    if(count == 0){
+        *this = other;
+        return;
+    }
+    const double totalCount = static_cast<double>(count + other.count);
+    const double delta = other.mean - mean;
+    mean += delta*(other.count/totalCount);
+    sumOfSquaredDeviations += other.sumOfSquaredDeviations
+    + delta*delta*(static_cast<double>(count)*other.count/totalCount);
+    sum += other.sum;
+    count += other.count;
+    minimum = other.minimum < minimum ? other.minimum : minimum;
+    maximum = other.maximum > maximum ? other.maximum : maximum;
+    
+    // Recover a mean that is no longer finite from the sum, as add() does.
+    if(!(std::fabs(mean) <= std::numeric_limits<double>::max())){
+        mean = sum/count;
+    }
+}
+
+/** Accumulates every value summarized by a StatsResult. The StatsResult is
+ * first converted into an equivalent accumulator; the sum of squared deviations
+ * is recovered from the (population) standard deviation.
+ *
+ * \param other - The statistics to merge into this accumulator.
+ */
+void RunningStatistics::merge(const StatsResult & other){
+    RunningStatistics converted;
+    converted.count = other.count;
+    converted.sum = other.sum;
+    converted.mean = other.mean;
+    converted.sumOfSquaredDeviations = other.standardDeviation*other.standardDeviation*other.count;
+    converted.minimum = other.minimum;
+    converted.maximum = other.maximum;
+    merge(converted);
+}
+
+/** Fills a StatsResult with the statistics of the accumulated values. If no
+ * values have been accumulated, every statistic is zero.
+ *
+ * \param result - The structure to fill.
+ */
+void RunningStatistics::fill(StatsResult & result) const{
+    result.count = count;
+    result.sum = sum;
+    result.mean = mean;
+    result.standardDeviation = count > 0 ? std::sqrt(sumOfSquaredDeviations/count) : 0.0;
+    result.minimum = minimum;
+    result.maximum = maximum;
+}
+
+// METHODS OF WEIGHTEDRUNNINGSTATISTICS
+
+/** Default constructor for the WeightedRunningStatistics structure, which creates
+ * an empty accumulator.
+ */
+WeightedRunningStatistics::WeightedRunningStatistics() :
+count(0),
+sumOfWeights(0.0),
+sumOfSquaredWeights(0.0),
+weightedSum(0.0),
+mean(0.0),
+sumOfSquaredDeviations(0.0){
+}
+
+/** Returns true if a weight can be used, i.e. it is positive and finite. Zero,
+ * negative, infinite and NaN weights are all rejected.
+ *
+ * \param weight - The weight to test.
+ */
+bool WeightedRunningStatistics::isUsableWeight(double weight){
+    return weight > 0.0 && weight <= std::numeric_limits<double>::max();
+}
+
+/** Accumulates a single weighted value using West's weighted generalization of
+ * Welford's update. With \f$W_{n} = W_{n-1} + w_{n}\f$:
+ *
+ * \f[ \bar{x}_{n} = \bar{x}_{n-1} + \frac{w_{n}}{W_{n}}(x_{n}-\bar{x}_{n-1}) \f]
+ * \f[ M_{2,n} = M_{2,n-1} + w_{n}(x_{n}-\bar{x}_{n-1})(x_{n}-\bar{x}_{n}) \f]
+ *
+ * \param value - The value to accumulate.
+ * \param weight - Its weight. A value whose weight is not usable is ignored.
+ */
+void WeightedRunningStatistics::add(double value, double weight){
+    if(!isUsableWeight(weight)){
+        return;
+    }
+    ++count;
+    sumOfWeights += weight;
+    sumOfSquaredWeights += weight*weight;
+    weightedSum += weight*value;
+    const double delta = value - mean;
+    mean += delta*(weight/sumOfWeights);
+    sumOfSquaredDeviations += weight*delta*(value - mean);
+    
+    /* Once an infinity has been accumulated the update computes inf - inf = NaN
+     * for every later value, whereas the weighted sum keeps the infinity. A mean
+     * that is no longer finite is therefore recovered from the weighted sum.
+     */
+    if(!(std::fabs(mean) <= std::numeric_limits<double>::max())){
+        mean = weightedSum/sumOfWeights;
+    }
+}
+
+/** Accumulates every weighted value summarized by another accumulator using the
+ * weighted form of Chan's pairwise formula:
+ *
+ * \f[ M_{2} = M_{2,a} + M_{2,b} + \delta^{2}\frac{W_{a}W_{b}}{W_{a}+W_{b}} \f]
+ *
+ * \param other - The accumulator to merge into this one.
+ */
+void WeightedRunningStatistics::merge(const WeightedRunningStatistics & other){
+    if(other.count == 0){
+        return;
+    }
+    if(count == 0){
+        *this = other;
+        return;
+    }
+    const double totalWeight = sumOfWeights + other.sumOfWeights;
+    const double delta = other.mean - mean;
+    mean += delta*(other.sumOfWeights/totalWeight);
+    sumOfSquaredDeviations += other.sumOfSquaredDeviations
+    + delta*delta*(sumOfWeights*other.sumOfWeights/totalWeight);
+    count += other.count;
+    sumOfWeights = totalWeight;
+    sumOfSquaredWeights += other.sumOfSquaredWeights;
+    weightedSum += other.weightedSum;
+    
+    // Recover a mean that is no longer finite from the weighted sum, as add() does.
+    if(!(std::fabs(mean) <= std::numeric_limits<double>::max())){
+        mean = weightedSum/sumOfWeights;
+    }
+}
+
+/** Fills a StatsWeightedResult with the statistics of the accumulated values. If
+ * no values have been accumulated, every statistic is zero. A variance whose
+ * normalization would not be positive (e.g. the frequency-weighted variance of
+ * a total weight no greater than one) is also zero.
+ *
+ * \param result - The structure to fill.
+ */
+void WeightedRunningStatistics::fill(StatsWeightedResult & result) const{
+    result.count = count;
+    result.sumOfWeights = sumOfWeights;
+    result.weightedSum = weightedSum;
+    result.weightedMean = mean;
+    result.populationVariance = sumOfWeights > 0.0 ? sumOfSquaredDeviations/sumOfWeights : 0.0;
+    result.frequencyVariance = sumOfWeights > 1.0 ? sumOfSquaredDeviations/(sumOfWeights - 1.0) : 0.0;
+    const double reliabilityNormalization = sumOfWeights > 0.0 ? sumOfWeights - sumOfSquaredWeights/sumOfWeights : 0.0;
+    result.reliabilityVariance = reliabilityNormalization > 0.0 ? sumOfSquaredDeviations/reliabilityNormalization : 0.0;
+}
+
+// METHODS OF BIVARIATERUNNINGSTATISTICS
+
+/** Default constructor for the BivariateRunningStatistics structure, which creates
+ * an empty accumulator.
+ */
+BivariateRunningStatistics::BivariateRunningStatistics() :
+count(0),
+meanX(0.0),
+meanY(0.0),
+sumOfSquaredDeviationsX(0.0),
+sumOfSquaredDeviationsY(0.0),
+coMoment(0.0){
+}
+
+/** Accumulates a single pair of values using the bivariate form of Welford's
+ * update. The co-moment is updated using the deviation of x from the OLD mean
+ * of x and the deviation of y from the NEW mean of y:
+ *
+ * \f[ C_{n} = C_{n-1} + (x_{n}-\bar{x}_{n-1})(y_{n}-\bar{y}_{n}) \f]
+ *
+ * \param x - The value from the first channel.
+ * \param y - The value from the second channel.
+ */
+void BivariateRunningStatistics::add(double x, double y){
+    ++count;
+    const double deltaX = x - meanX;
+    const double deltaY = y - meanY;
+    const double previousMeanX = meanX;
+    const double previousMeanY = meanY;
+    meanX += deltaX/count;
+    meanY += deltaY/count;
+    sumOfSquaredDeviationsX += deltaX*(x - meanX);
+    sumOfSquaredDeviationsY += deltaY*(y - meanY);
+    coMoment += deltaX*(y - meanY);
+    
+    /* Once an infinity has been accumulated the update computes inf - inf = NaN
+     * for every later value. No sums are kept, but a mean that is no longer
+     * finite is the sum of the previous mean and the new value, which keeps an
+     * infinity and gives NaN only for infinities of opposite sign (or a NaN),
+     * exactly as the sum of the values would.
+     */
+    if(!(std::fabs(meanX) <= std::numeric_limits<double>::max())){
+        meanX = previousMeanX + x;
+    }
+    if(!(std::fabs(meanY) <= std::numeric_limits<double>::max())){
+        meanY = previousMeanY + y;
+    }
+}
+
+/** Accumulates every pair summarized by another accumulator using the
+ * bivariate form of Chan's pairwise formula:
+ *
+ * \f[ C = C_{a} + C_{b} + \delta_{x}\delta_{y}\frac{n_{a}n_{b}}{n_{a}+n_{b}} \f]
+ *
+ * \param other - The accumulator to merge into this one.
+ */
+void BivariateRunningStatistics::merge(const BivariateRunningStatistics & other){
+    if(other.count == 0){
+        return;
+    }
+    if(count == 0){
+        *this = other;
+        return;
+    }
+    const double totalCount = static_cast<double>(count + other.count);
+    const double deltaX = other.meanX - meanX;
+    const double deltaY = other.meanY - meanY;
+    const double factor = static_cast<double>(count)*other.count/totalCount;
+    const double previousMeanX = meanX;
+    const double previousMeanY = meanY;
+    meanX += deltaX*(other.count/totalCount);
+    meanY += deltaY*(other.count/totalCount);
+    sumOfSquaredDeviationsX += other.sumOfSquaredDeviationsX + deltaX*deltaX*factor;
+    sumOfSquaredDeviationsY += other.sumOfSquaredDeviationsY + deltaY*deltaY*factor;
+    coMoment += other.coMoment + deltaX*deltaY*factor;
+    count += other.count;
+    
+    // Recover a mean that is no longer finite in the same way as add().
+    if(!(std::fabs(meanX) <= std::numeric_limits<double>::max())){
+        meanX = previousMeanX + other.meanX;
+    }
+    if(!(std::fabs(meanY) <= std::numeric_limits<double>::max())){
+        meanY = previousMeanY + other.meanY;
+    }
+}
+
+/** Fills a StatsBivariateResult with the statistics of the accumulated pairs.
+ * Statistics that are undefined (e.g. the correlation when either channel is
+ * constant, or the sample covariance of a single pair) are zero.
+ *
+ * \param result - The structure to fill.
+ */
+void BivariateRunningStatistics::fill(StatsBivariateResult & result) const{
+    result.count = count;
+    result.meanX = meanX;
+    result.meanY = meanY;
+    result.standardDeviationX = count > 0 ? std::sqrt(sumOfSquaredDeviationsX/count) : 0.0;
+    result.standardDeviationY = count > 0 ? std::sqrt(sumOfSquaredDeviationsY/count) : 0.0;
+    result.covariance = count > 0 ? coMoment/count : 0.0;
+    result.sampleCovariance = count > 1 ? coMoment/(count - 1) : 0.0;
+    const double normalization = std::sqrt(sumOfSquaredDeviationsX*sumOfSquaredDeviationsY);
+    result.correlation = normalization > 0.0 ? coMoment/normalization : 0.0;
+    result.slope = sumOfSquaredDeviationsX > 0.0 ? coMoment/sumOfSquaredDeviationsX : 0.0;
+    result.intercept = meanY - result.slope*meanX;
+}
+
+// METHODS OF QUANTILESKETCH
+
+/** The ratio of the circumference of a circle to its diameter, which appears in
+ * the scale function of QuantileSketch.
+ */
+static const double sketchPi = 3.14159265358979323846;
+
+/** The scale function of the t-digest, which maps a quantile q onto a scale on
+ * which every centroid may span at most one unit:
+ *
+ * \f[ k(q) = \frac{\delta}{2\pi}\sin^{-1}(2q - 1) \f]
+ *
+ * The function is steepest near q = 0 and q = 1, so centroids in the tails of
+ * the distribution must be small, while those near the median may be large.
+ *
+ * \param quantile - The quantile, between zero and one.
+ * \param compression - The compression, \f$\delta\f$, of the sketch.
+ *
+ * \return The scale, between \f$-\delta/4\f$ and \f$\delta/4\f$.
+ */
+static double sketchScale(double quantile, double compression){
+    return compression/(2.0*sketchPi)*std::asin(2.0*quantile - 1.0);
+}
+
+/** The inverse of sketchScale().
+ *
+ * \param scale - The scale, which is clamped to at most \f$\delta/4\f$.
+ * \param compression - The compression, \f$\delta\f$, of the sketch.
+ *
+ * \return The quantile, between zero and one.
+ */
+static double sketchInverseScale(double scale, double compression){
+    if(scale >= compression/4.0){
+        return 1.0;
+    }
+    return (std::sin(scale*2.0*sketchPi/compression) + 1.0)/2.0;
+}
+
+/** Orders centroids by their means, for use with std::sort() and std::merge().
+ */
+static bool compareCentroidMeans(const QuantileSketchCentroid & first, const QuantileSketchCentroid & second){
+    return first.mean < second.mean;
+}
+
+/** Merges one centroid into another using Chan's pairwise formula, so that the
+ * sum of squared deviations remains exact.
+ *
+ * \param centroid - The centroid that absorbs the other.
+ * \param other - The centroid that is absorbed.
+ */
+static void mergeCentroid(QuantileSketchCentroid & centroid, const QuantileSketchCentroid & other){
+    const double totalWeight = centroid.weight + other.weight;
+    const double delta = other.mean - centroid.mean;
+    centroid.sumOfSquaredDeviations += other.sumOfSquaredDeviations
+    + delta*delta*centroid.weight*other.weight/totalWeight;
+    centroid.mean += delta*other.weight/totalWeight;
+    centroid.weight = totalWeight;
+}
+
+/** Describes the distribution summarized by a (compressed) sketch as a piecewise
+ * linear function that maps RANKS onto values. Each centroid contributes a knot
+ * at the middle of the range of ranks that its values occupy, where the value is
+ * the centroid's mean, and knots at the ends pin the smallest and largest ranks to
+ * the exact minimum and maximum. A centroid that holds a single value therefore
+ * reproduces that value exactly.
+ *
+ * \param sketch - The sketch, which must have been compressed.
+ * \param ranks - Filled with the rank of each knot, in ascending order.
+ * \param values - Filled with the value of each knot, in ascending order.
+ */
+static void sketchKnots(const QuantileSketch & sketch, std::vector<double> & ranks, std::vector<double> & values){
+    ranks.clear();
+    values.clear();
+    ranks.push_back(0.0);
+    values.push_back(sketch.minimum);
+    double cumulativeWeight = 0.0;
+    for(size_t index = 0; index < sketch.centroids.size(); ++index){
+        ranks.push_back(cumulativeWeight + sketch.centroids[index].weight/2.0);
+        values.push_back(sketch.centroids[index].mean);
+        cumulativeWeight += sketch.centroids[index].weight;
+    }
+    ranks.push_back(cumulativeWeight);
+    values.push_back(sketch.maximum);
+}
+
+/** Interpolates linearly between the knots of one piecewise linear function to
+ * evaluate it, or (exchanging the arguments) its inverse.
+ *
+ * \param from - The knot coordinates in the domain, in ascending order.
+ * \param to - The knot coordinates in the range, in ascending order.
+ * \param position - The point in the domain at which to evaluate the function.
+ *
+ * \return The value of the function, which is constant beyond the end knots.
+ */
+static double interpolateKnots(const std::vector<double> & from, const std::vector<double> & to, double position){
+    const size_t upper = std::upper_bound(from.begin(), from.end(), position) - from.begin();
+    if(upper == 0){
+        return to.front();
+    }
+    if(upper == from.size()){
+        return to.back();
+    }
+    const double span = from[upper] - from[upper - 1];
+    const double fraction = span > 0.0 ? (position - from[upper - 1])/span : 0.0;
+    return to[upper - 1] + fraction*(to[upper] - to[upper - 1]);
+}
+
+/** Constructor for the QuantileSketch structure, which creates an empty sketch.
+ *
+ * \param compression - Determines the precision of the sketch. The sketch holds
+ * at most about "compression" centroids, and the error in the estimated
+ * quantiles is roughly inversely proportional to it.
+ */
+QuantileSketch::QuantileSketch(double compression) :
+compression(compression),
+minimum(0.0),
+maximum(0.0){
+}
+
+/** Accumulates a single value. The value is placed in "unmerged", and the
+ * unmerged values are clustered into the centroids once there are many of them,
+ * so that the cost of sorting them is shared between many values.
+ *
+ * \param value - The value to accumulate. NaN and infinite values are ignored.
+ */
+void QuantileSketch::add(double value){
+    // NaN fails the comparison, and infinity exceeds the largest finite double.
+    if(!(std::fabs(value) <= std::numeric_limits<double>::max())){
+        return;
+    }
+    if(centroids.empty() && unmerged.empty()){
+        minimum = value;
+        maximum = value;
+    }
+    else{
+        minimum = value < minimum ? value : minimum;
+        maximum = value > maximum ? value : maximum;
+    }
+    QuantileSketchCentroid centroid;
+    centroid.mean = value;
+    centroid.weight = 1.0;
+    centroid.sumOfSquaredDeviations = 0.0;
+    unmerged.push_back(centroid);
+    if(unmerged.size() >= static_cast<size_t>(16.0*compression)){
+        compress();
+    }
+}
+
+/** Accumulates every element of an array of values.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array.
+ */
+void QuantileSketch::add(const double * values, size_t count){
+    for(size_t index = 0; index < count; ++index){
+        add(values[index]);
+    }
+}
+
+/** Accumulates every value summarized by another sketch. Its centroids are
+ * treated like unmerged values, and are clustered with the centroids of this
+ * sketch.
+ *
+ * \param other - The sketch to merge into this one.
+ */
+void QuantileSketch::merge(const QuantileSketch & other){
+    if(other.centroids.empty() && other.unmerged.empty()){
+        return;
+    }
+    if(centroids.empty() && unmerged.empty()){
+        minimum = other.minimum;
+        maximum = other.maximum;
+    }
+    else{
+        minimum = other.minimum < minimum ? other.minimum : minimum;
+        maximum = other.maximum > maximum ? other.maximum : maximum;
+    }
+    unmerged.insert(unmerged.end(), other.centroids.begin(), other.centroids.end());
+    unmerged.insert(unmerged.end(), other.unmerged.begin(), other.unmerged.end());
+    compress();
+}
+
+/** Clusters the unmerged values into the centroids.
+ *
+ * The unmerged values are sorted and merged with the (already sorted)
+ * centroids. The combined sequence is then swept in ascending order, and each
+ * entry is absorbed into the current centroid for as long as the quantiles
+ * that the centroid spans differ by at most one unit of sketchScale(). Since
+ * every centroid spans one unit (apart from, at most, the last) and the scale
+ * runs from \f$-\delta/4\f$ to \f$\delta/4\f$, about \f$\delta/2\f$ centroids
+ * remain.
+ */
+void QuantileSketch::compress(){
+    if(unmerged.empty()){
+        return;
+    }
+    std::sort(unmerged.begin(), unmerged.end(), compareCentroidMeans);
+    std::vector<QuantileSketchCentroid> sorted(centroids.size() + unmerged.size());
+    std::merge(centroids.begin(), centroids.end(), unmerged.begin(), unmerged.end(),
+               sorted.begin(), compareCentroidMeans);
+    unmerged.clear();
+    centroids.clear();
+    
+    double totalWeight = 0.0;
+    for(size_t index = 0; index < sorted.size(); ++index){
+        totalWeight += sorted[index].weight;
+    }
+    
+    QuantileSketchCentroid current = sorted[0];
+    double weightSoFar = 0.0;
+    double weightLimit = totalWeight*sketchInverseScale(sketchScale(0.0, compression) + 1.0, compression);
+    for(size_t index = 1; index < sorted.size(); ++index){
+        if(weightSoFar + current.weight + sorted[index].weight <= weightLimit){
+            mergeCentroid(current, sorted[index]);
         }
-        // return the computed sum of all elements of "numericValues"
-        return sum;
+        else{
+            weightSoFar += current.weight;
+            centroids.push_back(current);
+            weightLimit = totalWeight*sketchInverseScale(sketchScale(weightSoFar/totalWeight, compression) + 1.0,
+                                                         compression);
+            current = sorted[index];
+        }
+    }
+    centroids.push_back(current);
+}
+
+/** Returns the number of values that have been accumulated.
+ */
+long long QuantileSketch::getCount() const{
+    double totalWeight = 0.0;
+    for(size_t index = 0; index < centroids.size(); ++index){
+        totalWeight += centroids[index].weight;
+    }
+    for(size_t index = 0; index < unmerged.size(); ++index){
+        totalWeight += unmerged[index].weight;
     }
-    else{ // No numeric values were successfully parsed from the input file
+    return static_cast<long long>(totalWeight + 0.5);
+}
+
+/** Returns an estimate of a quantile. The sketch is compressed first. As in
+ * StatsCalculator::getQuantile(), the quantile with probability p of n values is
+ * the value of rank \f$p(n-1)\f$ (counting from zero); here the rank is looked up
+ * in the piecewise linear function described by sketchKnots().
+ *
+ * \param probability - The probability, between zero and one.
+ *
+ * \return The estimated quantile, or zero if the sketch is empty.
+ */
+double QuantileSketch::quantile(double probability){
+    compress();
+    if(centroids.empty()){
         return 0.0;
     }
+    std::vector<double> ranks;
+    std::vector<double> values;
+    sketchKnots(*this, ranks, values);
+    // A value's rank refers to the middle of the unit range of ranks it occupies.
+    return interpolateKnots(ranks, values, probability*(getCount() - 1) + 0.5);
+}
+
+/** Fills a StatsRobustResult with estimates of the robust statistics of the
+ * accumulated values. The sketch is compressed first.
+ *
+ * The median and the values at which the distribution is trimmed are found
+ * in the same way as quantile(). The trimmed sums are found by adding up the
+ * parts of the centroids that lie between the trimmed ranks, assuming that the
+ * values of a partly trimmed centroid are trimmed in proportion. The median
+ * absolute deviation is the distance d from the median m for which half of the
+ * values lie in [m - d, m + d], which is found by bisection using the inverse of
+ * the piecewise linear function.
+ *
+ * \param result - The structure to fill. Its "approximate" member is set.
+ * \param trimFraction - The fraction of the values to trim from each end, which
+ * is clamped to the range [0, 0.5].
+ */
+void QuantileSketch::fill(StatsRobustResult & result, double trimFraction){
+    compress();
+    trimFraction = trimFraction > 0.0 ? (trimFraction < 0.5 ? trimFraction : 0.5) : 0.0;
+    result.count = getCount();
+    result.trimFraction = trimFraction;
+    result.approximate = 1;
+    if(result.count == 0){
+        result.median = 0.0;
+        result.medianAbsoluteDeviation = 0.0;
+        result.trimmedMean = 0.0;
+        result.winsorizedMean = 0.0;
+        result.winsorizedVariance = 0.0;
+        return;
+    }
+    const double totalWeight = static_cast<double>(result.count);
+    double trimmedWeight = std::floor(trimFraction*totalWeight);
+    if(2.0*trimmedWeight >= totalWeight){
+        trimmedWeight = std::floor((totalWeight - 1.0)/2.0);
+    }
+    
+    std::vector<double> ranks;
+    std::vector<double> values;
+    sketchKnots(*this, ranks, values);
+    result.median = interpolateKnots(ranks, values, (totalWeight - 1.0)/2.0 + 0.5);
+    const double lowest = interpolateKnots(ranks, values, trimmedWeight + 0.5);
+    const double highest = interpolateKnots(ranks, values, totalWeight - trimmedWeight - 0.5);
+    
+    // The weight of each centroid that lies between the trimmed ranks.
+    std::vector<double> keptWeights(centroids.size());
+    double keptSum = 0.0;
+    double cumulativeWeight = 0.0;
+    for(size_t index = 0; index < centroids.size(); ++index){
+        const double start = cumulativeWeight > trimmedWeight ? cumulativeWeight : trimmedWeight;
+        cumulativeWeight += centroids[index].weight;
+        const double end = cumulativeWeight < totalWeight - trimmedWeight ? cumulativeWeight : totalWeight - trimmedWeight;
+        keptWeights[index] = end > start ? end - start : 0.0;
+        keptSum += keptWeights[index]*centroids[index].mean;
+    }
+    result.trimmedMean = keptSum/(totalWeight - 2.0*trimmedWeight);
+    result.winsorizedMean = (keptSum + trimmedWeight*(lowest + highest))/totalWeight;
+    
+    double sumOfSquaredDeviations = trimmedWeight*((lowest - result.winsorizedMean)*(lowest - result.winsorizedMean)
+                                                   + (highest - result.winsorizedMean)*(highest - result.winsorizedMean));
+    for(size_t index = 0; index < centroids.size(); ++index){
+        if(keptWeights[index] > 0.0){
+            const double deviation = centroids[index].mean - result.winsorizedMean;
+            sumOfSquaredDeviations += keptWeights[index]*deviation*deviation
+            + centroids[index].sumOfSquaredDeviations*keptWeights[index]/centroids[index].weight;
+        }
+    }
+    result.winsorizedVariance = sumOfSquaredDeviations/totalWeight;
     
+    double lower = 0.0;
+    double upper = maximum - result.median > result.median - minimum ? maximum - result.median : result.median - minimum;
+    for(int iteration = 0; iteration < 64; ++iteration){
+        const double distance = (lower + upper)/2.0;
+        const double enclosed = interpolateKnots(values, ranks, result.median + distance)
+        - interpolateKnots(values, ranks, result.median - distance);
+        if(enclosed < totalWeight/2.0){
+            lower = distance;
+        }
+        else{
+            upper = distance;
+        }
+    }
+    result.medianAbsoluteDeviation = (lower + upper)/2.0;
 }
 
-/** Private method that actually computes the mean of the stored numeric
- * values.
+/** Discards every value, keeping the compression.
+ */
+void QuantileSketch::reset(){
+    centroids.clear();
+    unmerged.clear();
+    minimum = 0.0;
+    maximum = 0.0;
+}
+
+// SKETCH HASHING HELPERS
+
+/** Returns true if a value is finite, and so may be accumulated by the
+ * DistinctCountSketch and FrequencySketch.
  *
- * \return The computed mean is returned as a double-precision value.
+ * \param value - The value to test.
+ */
+static bool isSketchable(double value){
+    // NaN fails the comparison, and infinity exceeds the largest finite double.
+    return std::fabs(value) <= std::numeric_limits<double>::max();
+}
+
+/** Hashes a finite value for the DistinctCountSketch and FrequencySketch. The
+ * bits of the value are scrambled by the finalizer of the "SplitMix64"
+ * generator, so every bit of the hash depends on every bit of the value and
+ * values that differ in a single bit (e.g. neighbouring ADC codes) have
+ * unrelated hashes. The hash does not depend on the instance, so sketches that
+ * are built separately can be merged.
  *
- * The mean of a sequence of numbers is equal to their sum divided
- * by their multiplicity.
+ * \param value - The value, which must be finite.
  *
- * \note Computation of the required sum can be delegated
- * to the computeSum() method of StatsCalculator, while the
- * number of elements in the sequence is provided by the size() method
- * of the std::vector<double>-type member datum "numericValues".
+ * \return The 64-bit hash.
  */
-double StatsCalculator::computeMean(){
-    
-    // If any numeric values were successfully parsed from the input file...
-    if(numericValues.size() > 0){
-        
-        // compute and return the mean of the elements of "numericValues"
-        return computeSum()/numericValues.size();
+static std::uint64_t sketchHash(double value){
+    // Zero and negative zero are the same value, so they must have the same hash.
+    if(value == 0.0){
+        value = 0.0;
+    }
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits += 0x9e3779b97f4a7c15ULL;
+    bits = (bits ^ (bits >> 30))*0xbf58476d1ce4e5b9ULL;
+    bits = (bits ^ (bits >> 27))*0x94d049bb133111ebULL;
+    return bits ^ (bits >> 31);
+}
+
+// METHODS OF DISTINCTCOUNTSKETCH
+
+/** Accumulates a single value. The leading "precision" bits of its hash select
+ * a register, and the register is raised to the RANK of the remaining q = 64 -
+ * precision bits: one more than the number of zeros that precede the first one
+ * (or q + 1 if they are all zero).
+ *
+ * The rank is found without a loop, whose number of iterations would vary
+ * unpredictably from value to value. The remaining bits, read as an integer,
+ * are converted exactly to a double (q is at most 53), and the exponent of the
+ * double is the position of their leading one.
+ *
+ * \param value - The value to accumulate. NaN and infinite values are ignored.
+ */
+void DistinctCountSketch::add(double value){
+    if(!isSketchable(value)){
+        return;
+    }
+    if(registers.empty()){
+        registers.assign(static_cast<size_t>(1) << precision, 0);
+    }
+    const std::uint64_t hash = sketchHash(value);
+    const size_t index = static_cast<size_t>(hash >> (64 - precision));
+    const unsigned remainingBits = 64 - precision;
+    const std::uint64_t remaining = hash & ((static_cast<std::uint64_t>(1) << remainingBits) - 1);
+    const double converted = static_cast<double>(static_cast<std::int64_t>(remaining));
+    std::uint64_t bits;
+    std::memcpy(&bits, &converted, sizeof(bits));
+    // The biased exponent of zero is zero, which gives a rank larger than q + 1.
+    const long long leadingOne = static_cast<long long>(bits >> 52) - 1023;
+    const long long rank = static_cast<long long>(remainingBits) - leadingOne;
+    const unsigned char clamped = static_cast<unsigned char>(rank < remainingBits + 1 ? rank : remainingBits + 1);
+    registers[index] = registers[index] > clamped ? registers[index] : clamped;
+}
+
+/** Accumulates every element of an array of values.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array.
+ */
+void DistinctCountSketch::add(const double * values, size_t count){
+    for(size_t index = 0; index < count; ++index){
+        add(values[index]);
+    }
+}
+
+/** Accumulates every value summarized by another sketch. A register records the
+ * largest rank of the values that it has seen, so the merged register is the
+ * larger of the two, and the merged sketch is exactly the sketch of the union of
+ * the two streams.
+ *
+ * \param other - The sketch to merge into this one.
+ */
+void DistinctCountSketch::merge(const DistinctCountSketch & other){
+    if(other.registers.empty()){
+        return;
+    }
+    if(registers.empty()){
+        registers = other.registers;
+        return;
+    }
+    for(size_t index = 0; index < registers.size(); ++index){
+        if(other.registers[index] > registers[index]){
+            registers[index] = other.registers[index];
+        }
+    }
+}
+
+/** Returns an estimate of the number of distinct values that have been
+ * accumulated, using the "improved raw estimator" of Ertl ("New cardinality
+ * estimation algorithms for HyperLogLog sketches", 2017). It depends only on
+ * the number of registers, \f$C_k\f$, that hold each rank k:
+ *
+ * \f[ \hat{n} = \frac{m^2/(2\ln 2)}{m\sigma(C_0/m) + \sum_{k=1}^{q} C_k 2^{-k}
+ *     + m\tau(1 - C_{q+1}/m)2^{-q}} \f]
+ *
+ * where m is the number of registers and q = 64 - precision. The functions
+ * \f$\sigma\f$ and \f$\tau\f$ correct for the registers that are still empty
+ * and for those that are saturated, so unlike the original estimator of
+ * Flajolet et al. it needs no separate "linear counting" for small numbers of
+ * values and no empirical bias corrections.
+ *
+ * \return The estimate, which is zero if no value has been accumulated.
+ */
+double DistinctCountSketch::estimate() const{
+    if(registers.empty()){
+        return 0.0;
+    }
+    const unsigned q = 64 - precision;
+    const double m = static_cast<double>(registers.size());
+    std::vector<double> rankCounts(q + 2, 0.0);
+    for(size_t index = 0; index < registers.size(); ++index){
+        rankCounts[registers[index]] += 1.0;
     }
-    else{ // No numeric values were successfully parsed from the input file
+    if(rankCounts[0] == m){
         return 0.0;
     }
+    
+    // tau(x) = (1 - x - sum_{k>=1} (1 - x^(2^-k))^2 2^-k)/3, for the saturated registers.
+    double x = 1.0 - rankCounts[q + 1]/m;
+    double tau = 0.0;
+    if(x > 0.0 && x < 1.0){
+        double y = 1.0;
+        double previous;
+        tau = 1.0 - x;
+        do{
+            x = std::sqrt(x);
+            previous = tau;
+            y *= 0.5;
+            tau -= (1.0 - x)*(1.0 - x)*y;
+        } while(tau != previous);
+        tau /= 3.0;
+    }
+    double denominator = m*tau;
+    for(unsigned rank = q; rank >= 1; --rank){
+        denominator = 0.5*(denominator + rankCounts[rank]);
+    }
+    
+    // sigma(x) = x + sum_{k>=1} x^(2^k) 2^(k-1), for the empty registers.
+    x = rankCounts[0]/m;
+    double sigma = x;
+    if(x > 0.0){
+        double y = 1.0;
+        double previous;
+        do{
+            x *= x;
+            previous = sigma;
+            sigma += x*y;
+            y += y;
+        } while(sigma != previous);
+    }
+    denominator += m*sigma;
+    
+    return m*m/(2.0*std::log(2.0)*denominator);
+}
+
+/** Discards every value, releasing the registers.
+ */
+void DistinctCountSketch::reset(){
+    std::vector<unsigned char>().swap(registers);
+}
+
+// METHODS OF FREQUENCYSKETCH
+
+/** Returns the column of the Count-Min counter that a hash selects in one row.
+ * The columns of the rows are derived from the two halves of the hash by
+ * "double hashing" (Kirsch and Mitzenmacher), which is as good as using an
+ * independent hash for each row.
+ *
+ * \param hash - The hash of the value.
+ * \param row - The row.
+ */
+static size_t countMinColumn(std::uint64_t hash, unsigned row){
+    const std::uint64_t first = hash & 0xffffffffULL;
+    const std::uint64_t second = (hash >> 32) | 1;
+    return static_cast<size_t>((first + row*second) & (FrequencySketch::width - 1));
+}
+
+/** Returns the smallest of the Count-Min counters of a value, which is an upper
+ * bound on the number of times it has been accumulated.
+ *
+ * \param sketch - The sketch, whose counters must have been allocated.
+ * \param hash - The hash of the value.
+ */
+static long long countMinEstimate(const FrequencySketch & sketch, std::uint64_t hash){
+    long long smallest = sketch.counters[countMinColumn(hash, 0)];
+    for(unsigned row = 1; row < FrequencySketch::depth; ++row){
+        const long long counter = sketch.counters[row*FrequencySketch::width + countMinColumn(hash, row)];
+        if(counter < smallest){
+            smallest = counter;
+        }
+    }
+    return smallest;
+}
+
+/** Returns the slot of the hash table of monitored values that a hash selects.
+ *
+ * \param hash - The hash of the value.
+ */
+static size_t monitoredHomeSlot(std::uint64_t hash){
+    return static_cast<size_t>(hash >> 57) & (FrequencySketch::slotCount - 1);
+}
+
+/** Searches the hash table of a sketch for a value. The table uses LINEAR
+ * PROBING: a value occupies the first free slot at or after the slot selected
+ * by its hash, so the search ends at the value or at a free slot.
+ *
+ * \param sketch - The sketch, whose table must have been allocated.
+ * \param value - The value.
+ * \param hash - The hash of the value.
+ *
+ * \return The slot that refers to the value, or the free slot that would.
+ */
+static size_t findMonitoredSlot(const FrequencySketch & sketch, double value, std::uint64_t hash){
+    size_t slot = monitoredHomeSlot(hash);
+    while(sketch.slots[slot] != 0 && !(sketch.monitored[sketch.slots[slot] - 1].value == value)){
+        slot = (slot + 1) & (FrequencySketch::slotCount - 1);
+    }
+    return slot;
+}
+
+/** Frees a slot of the hash table of a sketch. Simply emptying it would end the
+ * searches for values that were placed beyond it, so each such value that could
+ * occupy the freed slot is moved back into it ("backward-shift deletion") and
+ * the slot that it vacated is freed in turn.
+ *
+ * \param sketch - The sketch.
+ * \param slot - The slot to free.
+ */
+static void freeMonitoredSlot(FrequencySketch & sketch, size_t slot){
+    const size_t mask = FrequencySketch::slotCount - 1;
+    sketch.slots[slot] = 0;
+    for(size_t next = (slot + 1) & mask; sketch.slots[next] != 0; next = (next + 1) & mask){
+        const size_t position = sketch.slots[next] - 1;
+        const size_t home = monitoredHomeSlot(sketchHash(sketch.monitored[position].value));
+        // The value may move back unless its home slot lies cyclically after the free slot.
+        if(((next - home) & mask) >= ((next - slot) & mask)){
+            sketch.slots[slot] = sketch.slots[next];
+            sketch.monitoredSlots[position] = static_cast<unsigned char>(slot);
+            sketch.slots[next] = 0;
+            slot = next;
+        }
+    }
+}
+
+/** Exchanges two of the monitored values of a sketch, updating the slots of the
+ * hash table that refer to them.
+ *
+ * \param sketch - The sketch.
+ * \param first - The position of one value.
+ * \param second - The position of the other.
+ */
+static void swapMonitored(FrequencySketch & sketch, size_t first, size_t second){
+    std::swap(sketch.monitored[first], sketch.monitored[second]);
+    std::swap(sketch.monitoredSlots[first], sketch.monitoredSlots[second]);
+    sketch.slots[sketch.monitoredSlots[first]] = static_cast<unsigned char>(first + 1);
+    sketch.slots[sketch.monitoredSlots[second]] = static_cast<unsigned char>(second + 1);
+}
+
+/** Returns true if a monitored value has a larger count than a given count, for
+ * use with std::lower_bound() on monitored values in descending order of count.
+ */
+static bool exceedsCount(const StatsHeavyHitter & hitter, long long count){
+    return hitter.count > count;
+}
+
+/** Increments the count of one of the monitored values of a sketch, keeping
+ * them in descending order of count. Counts only ever grow by one, so the value
+ * need only be exchanged with the FIRST value that has the same count (found by
+ * binary search), whereupon it precedes every value with the old count and
+ * follows every value with a larger one. This is the array form of the "Stream-
+ * Summary" structure of Metwally et al., and costs at most one exchange.
+ *
+ * \param sketch - The sketch.
+ * \param position - The position of the value.
+ */
+static void incrementMonitored(FrequencySketch & sketch, size_t position){
+    const long long count = sketch.monitored[position].count;
+    if(position > 0 && sketch.monitored[position - 1].count == count){
+        const size_t first = std::lower_bound(sketch.monitored.begin(), sketch.monitored.begin() + position,
+                                              count, exceedsCount) - sketch.monitored.begin();
+        swapMonitored(sketch, first, position);
+        position = first;
+    }
+    ++sketch.monitored[position].count;
+}
+
+/** Returns the count that any value that a sketch does not monitor may have
+ * occurred: zero while fewer than "capacity" values are monitored (because
+ * every value is then monitored), and otherwise the smallest monitored count.
+ *
+ * \param sketch - The sketch.
+ */
+static long long unmonitoredBound(const FrequencySketch & sketch){
+    return sketch.monitored.size() < FrequencySketch::capacity ? 0 : sketch.monitored.back().count;
+}
+
+/** Orders heavy hitters by descending count, and those with equal counts by
+ * ascending value, for use with std::sort().
+ */
+static bool compareHeavyHitters(const StatsHeavyHitter & first, const StatsHeavyHitter & second){
+    if(first.count != second.count){
+        return first.count > second.count;
+    }
+    return first.value < second.value;
+}
+
+/** Default constructor for the FrequencySketch structure, which creates an empty
+ * sketch without allocating any storage.
+ */
+FrequencySketch::FrequencySketch() :
+total(0){
+}
+
+/** Accumulates a single value into both the Count-Min counters and the
+ * monitored values. A value that is not yet monitored takes the last position,
+ * either by being appended with a count of zero or by replacing the value with
+ * the smallest count, and every case then increments the count at a position.
+ *
+ * Replacement is FILTERED by the Count-Min counters (as in the "Filtered
+ * Space-Saving" of Homem and Carvalho): a value only replaces another if its
+ * Count-Min estimate exceeds the smallest monitored count. Otherwise it cannot
+ * have occurred more often than any monitored value, and is left unmonitored.
+ * When the values are numerous and similarly frequent, this avoids replacing
+ * a monitored value at almost every step, which is slow and inflates the counts.
+ *
+ * \param value - The value to accumulate. NaN and infinite values are ignored.
+ */
+void FrequencySketch::add(double value){
+    if(!isSketchable(value)){
+        return;
+    }
+    if(counters.empty()){
+        counters.assign(depth*width, 0);
+        monitored.reserve(capacity);
+        monitoredSlots.reserve(capacity);
+        slots.assign(slotCount, 0);
+    }
+    const std::uint64_t hash = sketchHash(value);
+    ++total;
+    
+    // Increment only the counters that hold the smallest count (the conservative update).
+    const long long smallest = countMinEstimate(*this, hash);
+    const long long countMin = smallest + 1;
+    for(unsigned row = 0; row < depth; ++row){
+        long long & counter = counters[row*width + countMinColumn(hash, row)];
+        if(counter == smallest){
+            ++counter;
+        }
+    }
+    
+    size_t slot = findMonitoredSlot(*this, value, hash);
+    if(slots[slot] != 0){
+        // The value is monitored.
+        incrementMonitored(*this, slots[slot] - 1);
+    }
+    else if(monitored.size() < capacity){
+        // There is room to monitor the value, which has not occurred before.
+        StatsHeavyHitter hitter = {value, 0, 0};
+        monitored.push_back(hitter);
+        monitoredSlots.push_back(static_cast<unsigned char>(slot));
+        slots[slot] = static_cast<unsigned char>(monitored.size());
+        incrementMonitored(*this, monitored.size() - 1);
+    }
+    else if(countMin > monitored.back().count){
+        // The value replaces the monitored value with the smallest count.
+        const size_t last = monitored.size() - 1;
+        freeMonitoredSlot(*this, monitoredSlots[last]);
+        slot = findMonitoredSlot(*this, value, hash);
+        monitored[last].value = value;
+        monitored[last].error = monitored[last].count;
+        monitoredSlots[last] = static_cast<unsigned char>(slot);
+        slots[slot] = static_cast<unsigned char>(last + 1);
+        incrementMonitored(*this, last);
+    }
+}
+
+/** Accumulates every element of an array of values.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array.
+ */
+void FrequencySketch::add(const double * values, size_t count){
+    for(size_t index = 0; index < count; ++index){
+        add(values[index]);
+    }
+}
+
+/** Accumulates every value summarized by another sketch.
+ *
+ * The Count-Min counters are simply added. The monitored values are merged as
+ * described by Agarwal et al. ("Mergeable summaries", 2012): the count (and
+ * possible overestimate) of a value is the sum of its counts in the two
+ * sketches, where a sketch that does not monitor it contributes the bound of
+ * unmonitoredBound(). Every count then remains an upper bound, and the values
+ * with the "capacity" largest counts are kept.
+ *
+ * \param other - The sketch to merge into this one.
+ */
+void FrequencySketch::merge(const FrequencySketch & other){
+    if(other.total == 0){
+        return;
+    }
+    if(total == 0){
+        *this = other;
+        return;
+    }
+    for(size_t index = 0; index < counters.size(); ++index){
+        counters[index] += other.counters[index];
+    }
+    total += other.total;
+    
+    const long long thisBound = unmonitoredBound(*this);
+    const long long otherBound = unmonitoredBound(other);
+    std::vector<StatsHeavyHitter> combined;
+    combined.reserve(monitored.size() + other.monitored.size());
+    for(size_t position = 0; position < monitored.size(); ++position){
+        StatsHeavyHitter hitter = monitored[position];
+        const size_t slot = findMonitoredSlot(other, hitter.value, sketchHash(hitter.value));
+        if(other.slots[slot] != 0){
+            hitter.count += other.monitored[other.slots[slot] - 1].count;
+            hitter.error += other.monitored[other.slots[slot] - 1].error;
+        }
+        else{
+            hitter.count += otherBound;
+            hitter.error += otherBound;
+        }
+        combined.push_back(hitter);
+    }
+    for(size_t position = 0; position < other.monitored.size(); ++position){
+        StatsHeavyHitter hitter = other.monitored[position];
+        if(slots[findMonitoredSlot(*this, hitter.value, sketchHash(hitter.value))] == 0){
+            hitter.count += thisBound;
+            hitter.error += thisBound;
+            combined.push_back(hitter);
+        }
+    }
+    std::sort(combined.begin(), combined.end(), compareHeavyHitters);
+    if(combined.size() > capacity){
+        combined.resize(capacity);
+    }
+    
+    // The merged values are already in descending order of count, so only the hash table is rebuilt.
+    monitored.swap(combined);
+    monitoredSlots.clear();
+    slots.assign(slotCount, 0);
+    for(size_t position = 0; position < monitored.size(); ++position){
+        const size_t slot = findMonitoredSlot(*this, monitored[position].value, sketchHash(monitored[position].value));
+        monitoredSlots.push_back(static_cast<unsigned char>(slot));
+        slots[slot] = static_cast<unsigned char>(position + 1);
+    }
+}
+
+/** Returns an upper bound on the number of times a value has been accumulated:
+ * the smaller of its Count-Min estimate and its SpaceSaving count (or, if it
+ * is not monitored, the bound of unmonitoredBound()).
+ *
+ * \param value - The value.
+ */
+long long FrequencySketch::estimate(double value) const{
+    if(total == 0 || !isSketchable(value)){
+        return 0;
+    }
+    const std::uint64_t hash = sketchHash(value);
+    const long long countMin = countMinEstimate(*this, hash);
+    const size_t slot = findMonitoredSlot(*this, value, hash);
+    const long long spaceSaving = slots[slot] != 0 ? monitored[slots[slot] - 1].count : unmonitoredBound(*this);
+    return countMin < spaceSaving ? countMin : spaceSaving;
+}
+
+/** Fills a vector with the most frequent values. Both sketches bound each count
+ * from above, so the smaller bound is reported, while SpaceSaving's count less
+ * its possible overestimate remains the lower bound.
+ *
+ * \param count - The largest number of values to return.
+ * \param hitters - Filled with the values, in descending order of their counts.
+ */
+void FrequencySketch::getHeavyHitters(size_t count, std::vector<StatsHeavyHitter> & hitters) const{
+    hitters = monitored;
+    for(size_t index = 0; index < hitters.size(); ++index){
+        const long long lowerBound = hitters[index].count - hitters[index].error;
+        const long long countMin = countMinEstimate(*this, sketchHash(hitters[index].value));
+        if(countMin < hitters[index].count){
+            hitters[index].count = countMin;
+        }
+        hitters[index].error = hitters[index].count - lowerBound;
+    }
+    std::sort(hitters.begin(), hitters.end(), compareHeavyHitters);
+    if(hitters.size() > count){
+        hitters.resize(count);
+    }
+}
+
+/** Discards every value, releasing the storage.
+ */
+void FrequencySketch::reset(){
+    total = 0;
+    std::vector<long long>().swap(counters);
+    std::vector<StatsHeavyHitter>().swap(monitored);
+    std::vector<unsigned char>().swap(monitoredSlots);
+    std::vector<unsigned char>().swap(slots);
+}
+
+// METHODS OF RESERVOIRSAMPLE
+
+/** Default constructor for the ReservoirSample structure, which creates a
+ * reservoir of size zero: values that are added to it are ignored.
+ */
+ReservoirSample::ReservoirSample() :
+size(0),
+seed(0),
+blocks(0),
+count(0),
+threshold(1.0),
+skip(0){
+}
+
+/** Discards every value and sets the size of the sample and the seed of the
+ * random numbers. The random numbers start again from the first block.
+ *
+ * \param sampleSize - The largest number of values in the sample, or zero to
+ * ignore every value.
+ * \param sampleSeed - The seed of the random numbers.
+ */
+void ReservoirSample::configure(size_t sampleSize, unsigned long long sampleSeed){
+    size = sampleSize;
+    seed = sampleSeed;
+    reset();
+    std::vector<double>().swap(values);
+}
+
+/** Adds a single value. Until the sample is full every value enters it. Once it
+ * is full, the values that do not enter it (almost all of them) only decrement
+ * "skip". When "skip" reaches zero the value replaces a randomly chosen member of
+ * the sample, the threshold falls by the factor \f$u^{1/size}\f$ (the largest
+ * of "size" uniform variates) and the next skip is drawn.
+ *
+ * \param value - The value to add.
+ */
+void ReservoirSample::add(double value){
+    if(skip > 0){
+        --skip;
+        ++count;
+        return;
+    }
+    if(size == 0){
+        return;
+    }
+    ++count;
+    if(values.size() < size){
+        values.push_back(value);
+        if(values.size() == size){
+            // The largest of "size" uniform keys.
+            threshold = std::exp(std::log(nextUniform())/static_cast<double>(size));
+            drawSkip();
+        }
+        return;
+    }
+    const size_t slot = static_cast<size_t>(nextUniform()*static_cast<double>(size));
+    values[slot < size ? slot : size - 1] = value;
+    threshold *= std::exp(std::log(nextUniform())/static_cast<double>(size));
+    drawSkip();
+}
+
+/** Adds every element of an array of values. Whole runs of values that are to
+ * be skipped are passed over with a single subtraction, so the cost is
+ * proportional to the number of values that enter the sample rather than to
+ * the length of the array.
+ *
+ * \param newValues - A pointer to the first element of the array.
+ * \param newCount - The number of elements in the array.
+ */
+void ReservoirSample::add(const double * newValues, size_t newCount){
+    if(size == 0){
+        return;
+    }
+    size_t index = 0;
+    while(index < newCount){
+        const long long remaining = static_cast<long long>(newCount - index);
+        if(skip >= remaining){
+            skip -= remaining;
+            count += remaining;
+            return;
+        }
+        // Pass over the skipped values; the next value then enters the sample.
+        index += static_cast<size_t>(skip);
+        count += skip;
+        skip = 0;
+        add(newValues[index]);
+        ++index;
+    }
+}
+
+/** Adds every value sampled by another reservoir, so that the sample becomes a
+ * uniform sample of the values added to both.
+ *
+ * The keys of the values in each reservoir are drawn afresh. If a reservoir is
+ * not yet full, every value it has seen is in it and their keys are uniform in
+ * (0, 1). Otherwise one of its values has the key "threshold" and the keys of
+ * the others are uniform below it. The values with the "size" smallest keys of
+ * both are kept, and the largest of their keys becomes the threshold.
+ *
+ * \param other - The other reservoir, which should have been seeded differently.
+ *
+ * \return True on success, or false (and no change) if this reservoir has size
+ * zero, or if the other is full and smaller than this one (in which case it has
+ * already discarded values that the merged sample might need).
+ */
+bool ReservoirSample::merge(const ReservoirSample & other){
+    if(size == 0 || (other.values.size() == other.size && other.size < size && other.count > 0)){
+        return false;
+    }
+    if(other.count == 0){
+        return true;
+    }
+    std::vector<std::pair<double, double> > keyed;
+    keyed.reserve(values.size() + other.values.size());
+    const ReservoirSample * reservoirs[2] = {this, &other};
+    for(unsigned reservoir = 0; reservoir < 2; ++reservoir){
+        const std::vector<double> & sampled = reservoirs[reservoir]->values;
+        if(sampled.empty()){
+            continue;
+        }
+        const bool full = sampled.size() == reservoirs[reservoir]->size;
+        const double bound = full ? reservoirs[reservoir]->threshold : 1.0;
+        size_t largest = sampled.size();
+        if(full){
+            largest = static_cast<size_t>(nextUniform()*static_cast<double>(sampled.size()));
+            largest = largest < sampled.size() ? largest : sampled.size() - 1;
+        }
+        for(size_t index = 0; index < sampled.size(); ++index){
+            keyed.push_back(std::make_pair(index == largest ? bound : bound*nextUniform(), sampled[index]));
+        }
+    }
+    count += other.count;
+    if(keyed.size() > size){
+        std::nth_element(keyed.begin(), keyed.begin() + (size - 1), keyed.end());
+        keyed.resize(size);
+    }
+    values.clear();
+    threshold = 0.0;
+    for(size_t index = 0; index < keyed.size(); ++index){
+        values.push_back(keyed[index].second);
+        threshold = keyed[index].first > threshold ? keyed[index].first : threshold;
+    }
+    skip = 0;
+    if(values.size() == size){
+        drawSkip();
+    }
+    else{
+        threshold = 1.0;
+    }
+    return true;
+}
+
+/** Discards every value, keeping the size of the sample and the seed, and
+ * keeping the memory that held the values. The random numbers continue from
+ * where they were, so a reset reservoir draws a different sample.
+ */
+void ReservoirSample::reset(){
+    count = 0;
+    threshold = 1.0;
+    skip = 0;
+    values.clear();
+}
+
+/** Returns a random number uniformly distributed in (0, 1), excluding both zero
+ * (whose logarithm is infinite) and one. Random numbers are drawn so rarely that
+ * each is computed from a block of its own, numbered by "blocks".
+ */
+double ReservoirSample::nextUniform(){
+    const std::uint32_t counter[4] = {static_cast<std::uint32_t>(blocks),
+        static_cast<std::uint32_t>(blocks >> 32), 0, 0};
+    const std::uint32_t key[2] = {static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+    std::uint32_t outputs[4];
+    StatsPhiloxGenerator::generateBlock(counter, key, outputs);
+    ++blocks;
+    const std::uint64_t bits = (static_cast<std::uint64_t>(outputs[0]) << 32) | outputs[1];
+    return (static_cast<double>(bits >> 11) + 0.5)*(1.0/9007199254740992.0);
+}
+
+/** Draws the number of values that are skipped before the next one enters the
+ * sample. Each value would enter it with probability "threshold" (the chance
+ * that its key is below the largest key in the sample), so the number skipped
+ * is geometrically distributed, and is drawn by inversion:
+ * \f$\lfloor \log u/\log(1 - threshold) \rfloor\f$.
+ */
+void ReservoirSample::drawSkip(){
+    const double gap = std::floor(std::log(nextUniform())/std::log1p(-threshold));
+    skip = gap < 9.0e18 ? static_cast<long long>(gap) : 9000000000000000000LL;
+}
+
+// TIME ROLLUP HELPERS
+
+/** Divides one integer by another, rounding towards minus infinity (the built-in
+ * division rounds towards zero), so that the buckets before time zero nest
+ * inside the coarser buckets just as those after it do.
+ *
+ * \param dividend - The dividend.
+ * \param divisor - The divisor, which must be positive.
+ */
+static long long floorDivide(long long dividend, long long divisor){
+    const long long quotient = dividend/divisor;
+    return quotient*divisor > dividend ? quotient - 1 : quotient;
+}
+
+// METHODS OF TIMEROLLUP
+
+/** Default constructor for the TimeRollup structure, which creates a rollup
+ * with no resolutions: values that are added to it are ignored.
+ */
+TimeRollup::TimeRollup() :
+openStart(0.0),
+openEnd(0.0),
+started(false),
+lateValues(0){
+}
+
+/** Discards every bucket and sets the widths of the buckets. The ratio of each
+ * width to the one before it must be a whole number of at least two (to within
+ * a relative tolerance of 10^-9, so that e.g. 0.1 and 0.3 are accepted).
+ *
+ * \param bucketWidths - The widths, in ascending order, or an empty vector to
+ * disable the rollup.
+ *
+ * \return True on success, or false (and no change) if a width is not positive
+ * and finite or the widths do not form a cascade.
+ */
+bool TimeRollup::configure(const std::vector<double> & bucketWidths){
+    std::vector<long long> bucketMultiples(bucketWidths.size(), 1);
+    for(size_t level = 0; level < bucketWidths.size(); ++level){
+        if(!(bucketWidths[level] > 0.0 && bucketWidths[level] <= std::numeric_limits<double>::max())){
+            return false;
+        }
+        if(level > 0){
+            const double ratio = bucketWidths[level]/bucketWidths[level - 1];
+            const double multiple = std::floor(ratio + 0.5);
+            if(!(multiple >= 2.0 && multiple < 9.0e18) || std::fabs(ratio - multiple) > 1e-9*multiple){
+                return false;
+            }
+            bucketMultiples[level] = static_cast<long long>(multiple);
+        }
+    }
+    widths = bucketWidths;
+    multiples = bucketMultiples;
+    openBuckets.assign(widths.size(), 0);
+    open.assign(widths.size(), RunningStatistics());
+    completed.assign(widths.size(), std::vector<StatsTimeBucket>());
+    started = false;
+    lateValues = 0;
+    return true;
+}
+
+/** Adds a single value with its timestamp.
+ *
+ * If the timestamp is within the open bucket of the finest resolution, the value
+ * is accumulated into it straight away. Otherwise the bucket number at each
+ * resolution is found: the timestamp is divided by the finest width, and the
+ * result is divided by each multiple in turn, so that the buckets nest exactly
+ * however the timestamps round. If the value belongs after the open buckets,
+ * those that it does not fall within are completed (finest first) and new ones
+ * are opened.
+ *
+ * \param time - The timestamp.
+ * \param value - The value.
+ */
+void TimeRollup::add(double time, double value){
+    if(started && time >= openStart && time < openEnd){
+        open[0].add(value);
+        return;
+    }
+    if(widths.empty()){
+        return;
+    }
+    const double scaled = std::floor(time/widths[0]);
+    if(!(std::fabs(scaled) < 9.0e18)){
+        // The timestamp is not finite, or too large to number its bucket.
+        ++lateValues;
+        return;
+    }
+    const long long bucket = static_cast<long long>(scaled);
+    if(started && bucket <= openBuckets[0]){
+        // The value is late (or on the rounded edge of the open bucket): add it to the finest open bucket it falls within.
+        long long levelBucket = bucket;
+        for(size_t level = 0; level < widths.size(); ++level){
+            levelBucket = level > 0 ? floorDivide(levelBucket, multiples[level]) : levelBucket;
+            if(levelBucket == openBuckets[level]){
+                open[level].add(value);
+                return;
+            }
+        }
+        ++lateValues;
+        return;
+    }
+    // Complete the open buckets that the value does not fall within, and open new ones.
+    size_t levels = widths.size();
+    if(started){
+        levels = 0;
+        long long levelBucket = bucket;
+        while(levels < widths.size() && levelBucket != openBuckets[levels]){
+            ++levels;
+            levelBucket = levels < widths.size() ? floorDivide(levelBucket, multiples[levels]) : levelBucket;
+        }
+        complete(levels);
+    }
+    long long levelBucket = bucket;
+    for(size_t level = 0; level < levels; ++level){
+        levelBucket = level > 0 ? floorDivide(levelBucket, multiples[level]) : levelBucket;
+        openBuckets[level] = levelBucket;
+    }
+    started = true;
+    openStart = static_cast<double>(bucket)*widths[0];
+    openEnd = openStart + widths[0];
+    open[0].add(value);
+}
+
+/** Returns the number of leading elements of an array of timestamps that fall
+ * within the open bucket of the finest resolution, so that their values can be
+ * accumulated into it together.
+ *
+ * \param times - A pointer to the first element of the array of timestamps.
+ * \param count - The number of elements in the array.
+ */
+size_t TimeRollup::openRun(const double * times, size_t count) const{
+    if(!started){
+        return 0;
+    }
+    size_t index = 0;
+    while(index < count && times[index] >= openStart && times[index] < openEnd){
+        ++index;
+    }
+    return index;
+}
+
+/** Completes the open buckets of the finest resolutions, finest first. The
+ * record of each is emitted (unless it is empty), and its accumulator is merged
+ * into the open bucket of the next resolution, which is completed in turn if it
+ * is among those to be completed.
+ *
+ * \param levels - The number of resolutions whose open buckets are completed.
+ */
+void TimeRollup::complete(size_t levels){
+    for(size_t level = 0; level < levels && level < widths.size(); ++level){
+        if(open[level].count > 0){
+            StatsTimeBucket bucket;
+            bucket.start = static_cast<double>(openBuckets[level])*widths[level];
+            bucket.width = widths[level];
+            open[level].fill(bucket.statistics);
+            completed[level].push_back(bucket);
+            if(level + 1 < widths.size()){
+                open[level + 1].merge(open[level]);
+            }
+        }
+        open[level] = RunningStatistics();
+    }
+}
+
+/** Completes every open bucket. Values that are added afterwards open new
+ * buckets, even if their timestamps fall within the buckets that were completed.
+ */
+void TimeRollup::flush(){
+    if(started){
+        complete(widths.size());
+        started = false;
+    }
+}
+
+/** Discards every bucket (completed or open), keeping the widths.
+ */
+void TimeRollup::reset(){
+    open.assign(widths.size(), RunningStatistics());
+    completed.assign(widths.size(), std::vector<StatsTimeBucket>());
+    started = false;
+    lateValues = 0;
+}
+
+// CHANGE DETECTION HELPERS
+
+/** Updates the two cumulative sums of a change detector with one standardized
+ * value: \f$g^+ \leftarrow \max(0, g^+ + z - k)\f$ and
+ * \f$g^- \leftarrow \max(0, g^- - z - k)\f$. For each sum, the position of
+ * the first value since it was last zero, and the number and sum of the values
+ * since then, are updated too. The updates are written as selections, which
+ * compile to conditional moves rather than unpredictable branches.
+ *
+ * \param standardized - The standardized value, z.
+ * \param value - The value itself.
+ * \param drift - The drift, k.
+ * \param threshold - The threshold, h.
+ * \param position - The position of the value.
+ * \param sums - The two cumulative sums.
+ * \param starts - The positions at which the sums last became positive.
+ * \param runCounts - The numbers of values since the sums were last zero.
+ * \param runSums - The sums of the values since the sums were last zero.
+ *
+ * \return 0 if the sum that looks for an increase exceeds the threshold, 1 if
+ * the sum that looks for a decrease does, otherwise -1.
+ */
+static inline int stepCumulativeSums(double standardized, double value, double drift, double threshold,
+                                     long long position, double * sums, long long * starts,
+                                     long long * runCounts, double * runSums){
+    const double steps[2] = {standardized - drift, -standardized - drift};
+    for(unsigned side = 0; side < 2; ++side){
+        const double updated = sums[side] + steps[side];
+        const bool positive = updated > 0.0;
+        starts[side] = positive && runCounts[side] == 0 ? position : starts[side];
+        sums[side] = positive ? updated : 0.0;
+        runCounts[side] = positive ? runCounts[side] + 1 : 0;
+        runSums[side] = positive ? runSums[side] + value : 0.0;
+    }
+    return sums[0] > threshold ? 0 : (sums[1] > threshold ? 1 : -1);
+}
+
+// METHODS OF CHANGEDETECTOR
+
+/** Default constructor for the ChangeDetector structure, which creates a
+ * disabled detector with the usual parameters of the CUSUM test.
+ */
+ChangeDetector::ChangeDetector() :
+method(STATSCALC_CHANGE_NONE),
+threshold(5.0),
+drift(0.5),
+warmupCount(100),
+examined(0),
+center(0.0),
+inverseScale(1.0),
+detections(0),
+pending(false),
+callback(0),
+userData(0){
+    std::memset(&lastChange, 0, sizeof(lastChange));
+    restart();
+}
+
+/** Sets the method and its parameters, and resets the detector.
+ *
+ * \param changeMethod - One of the StatsCalcChangeMethod values.
+ * \param changeThreshold - The threshold h, which must be positive.
+ * \param changeDrift - The drift k, which must not be negative.
+ * \param changeWarmupCount - The number of warm-up values, at least two.
+ *
+ * \return True on success, or false (and no change) if a parameter is out of range.
+ */
+bool ChangeDetector::configure(StatsCalcChangeMethod changeMethod, double changeThreshold, double changeDrift,
+                               long long changeWarmupCount){
+    if(changeMethod != STATSCALC_CHANGE_NONE && changeMethod != STATSCALC_CHANGE_CUSUM
+       && changeMethod != STATSCALC_CHANGE_PAGE_HINKLEY){
+        return false;
+    }
+    if(!(changeThreshold > 0.0 && changeThreshold <= std::numeric_limits<double>::max())
+       || !(changeDrift >= 0.0 && changeDrift <= std::numeric_limits<double>::max()) || changeWarmupCount < 2){
+        return false;
+    }
+    method = changeMethod;
+    threshold = changeThreshold;
+    drift = changeDrift;
+    warmupCount = changeWarmupCount;
+    reset();
+    return true;
+}
+
+/** Examines a single value.
+ *
+ * During the warm-up the value is only accumulated. At the end of the warm-up
+ * the centre and scale are fixed; if the warm-up values were all equal the scale
+ * is one, so the threshold and drift are then in the units of the values. After
+ * the warm-up both cumulative sums are updated by stepCumulativeSums(), and a
+ * change is recorded by detect() if either exceeds the threshold.
+ *
+ * \param value - The value.
+ *
+ * \return True if a change was detected at this value, otherwise false.
+ */
+bool ChangeDetector::add(double value){
+    if(method == STATSCALC_CHANGE_NONE || !(std::fabs(value) <= std::numeric_limits<double>::max())){
+        return false;
+    }
+    ++examined;
+    ++count;
+    sum += value;
+    if(count <= warmupCount){
+        reference.add(value);
+        if(count == warmupCount){
+            center = reference.mean;
+            const double deviation = std::sqrt(reference.sumOfSquaredDeviations/static_cast<double>(reference.count));
+            inverseScale = deviation > 0.0 ? 1.0/deviation : 1.0;
+        }
+        return false;
+    }
+    const double standardized = (value - (method == STATSCALC_CHANGE_CUSUM ? center : sum/count))*inverseScale;
+    const int side = stepCumulativeSums(standardized, value, drift, threshold, examined, sums, starts, runCounts,
+                                        runSums);
+    if(side < 0){
+        return false;
+    }
+    detect(side);
+    return true;
+}
+
+/** Examines every element of an array of values. Values in the warm-up are
+ * examined one at a time by add(). After the warm-up, the state of the cumulative
+ * sums is copied into local variables, which the compiler can keep in registers
+ * (the members cannot be, since the values might alias them), until the end of
+ * the array or the next detection.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param valueCount - The number of elements in the array.
+ */
+void ChangeDetector::add(const double * values, size_t valueCount){
+    size_t index = 0;
+    while(index < valueCount && method != STATSCALC_CHANGE_NONE){
+        if(count < warmupCount){
+            add(values[index++]);
+            continue;
+        }
+        long long localExamined = examined;
+        long long localCount = count;
+        double localSum = sum;
+        double localSums[2] = {sums[0], sums[1]};
+        long long localStarts[2] = {starts[0], starts[1]};
+        long long localRunCounts[2] = {runCounts[0], runCounts[1]};
+        double localRunSums[2] = {runSums[0], runSums[1]};
+        const bool fixedCenter = method == STATSCALC_CHANGE_CUSUM;
+        int side = -1;
+        for(; index < valueCount && side < 0; ++index){
+            const double value = values[index];
+            if(!(std::fabs(value) <= std::numeric_limits<double>::max())){
+                continue;
+            }
+            ++localExamined;
+            ++localCount;
+            localSum += value;
+            const double standardized = (value - (fixedCenter ? center : localSum/localCount))*inverseScale;
+            side = stepCumulativeSums(standardized, value, drift, threshold, localExamined, localSums, localStarts,
+                                      localRunCounts, localRunSums);
+        }
+        examined = localExamined;
+        count = localCount;
+        sum = localSum;
+        for(unsigned copied = 0; copied < 2; ++copied){
+            sums[copied] = localSums[copied];
+            starts[copied] = localStarts[copied];
+            runCounts[copied] = localRunCounts[copied];
+            runSums[copied] = localRunSums[copied];
+        }
+        if(side >= 0){
+            detect(side);
+        }
+    }
+}
+
+/** Records a detected change, described by the values since the cumulative sum
+ * that detected it was last zero, and restarts the detector. The callback (if
+ * any) is called last, so that it sees the detector in a consistent state.
+ *
+ * \param side - 0 if the sum that looks for an increase detected the change, 1
+ * if the sum that looks for a decrease did.
+ */
+void ChangeDetector::detect(int side){
+    lastChange.detectedAt = examined;
+    lastChange.changedAt = starts[side];
+    lastChange.direction = side == 0 ? 1 : -1;
+    const long long beforeCount = count - runCounts[side];
+    lastChange.meanBefore = beforeCount > 0 ? (sum - runSums[side])/static_cast<double>(beforeCount) : 0.0;
+    lastChange.meanAfter = runSums[side]/static_cast<double>(runCounts[side]);
+    ++detections;
+    pending = true;
+    restart();
+    if(callback != 0){
+        callback(&lastChange, userData);
+    }
+}
+
+/** Forgets the values examined since the last detection, so that the centre and
+ * scale are learned again from the next warm-up values.
+ */
+void ChangeDetector::restart(){
+    reference = RunningStatistics();
+    count = 0;
+    sum = 0.0;
+    for(unsigned side = 0; side < 2; ++side){
+        sums[side] = 0.0;
+        starts[side] = 0;
+        runCounts[side] = 0;
+        runSums[side] = 0.0;
+    }
+}
+
+/** Restarts the detector and forgets every detection, so that positions are
+ * counted from one again.
+ */
+void ChangeDetector::reset(){
+    restart();
+    examined = 0;
+    detections = 0;
+    pending = false;
+}
+
+// METHODS OF STATSLIVESTATISTICS
+
+/** Default constructor for the StatsLiveStatistics structure, which publishes an
+ * empty accumulator with a tag of -1.
+ */
+StatsLiveStatistics::StatsLiveStatistics() :
+sequence(0),
+count(0),
+sum(0.0),
+mean(0.0),
+sumOfSquaredDeviations(0.0),
+minimum(0.0),
+maximum(0.0),
+tag(-1){
+}
+
+/** Copy constructor for the StatsLiveStatistics structure. Atomic members
+ * cannot be copied, so the accumulator that the other instance holds is read
+ * and then published. The tag identifies the other instance's owner, so it is
+ * not copied, and the copy's tag is -1.
+ *
+ * \param other - The instance to copy.
+ */
+StatsLiveStatistics::StatsLiveStatistics(const StatsLiveStatistics & other) :
+sequence(0),
+count(0),
+sum(0.0),
+mean(0.0),
+sumOfSquaredDeviations(0.0),
+minimum(0.0),
+maximum(0.0),
+tag(-1){
+    RunningStatistics statistics;
+    other.read(statistics);
+    write(statistics);
+}
+
+/** Copy assignment operator for the StatsLiveStatistics structure, which reads
+ * the accumulator that the other instance holds and publishes it. This
+ * instance keeps its own tag.
+ *
+ * \param other - The instance to copy.
+ *
+ * \return A reference to this instance.
+ */
+StatsLiveStatistics & StatsLiveStatistics::operator=(const StatsLiveStatistics & other){
+    if(this != &other){
+        RunningStatistics statistics;
+        other.read(statistics);
+        write(statistics);
+    }
+    return *this;
+}
+
+/** Publishes an accumulator.
+ *
+ * The sequence is made odd before the accumulator is stored and even again
+ * afterwards. The release fence keeps the stores of the accumulator from
+ * becoming visible before the odd sequence, and the release store of the even
+ * sequence keeps them from becoming visible after it. On x86 processors all of
+ * these are ordinary stores.
+ *
+ * \param statistics - The accumulator to publish.
+ */
+void StatsLiveStatistics::write(const RunningStatistics & statistics){
+    const unsigned long long start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    count.store(statistics.count, std::memory_order_relaxed);
+    sum.store(statistics.sum, std::memory_order_relaxed);
+    mean.store(statistics.mean, std::memory_order_relaxed);
+    sumOfSquaredDeviations.store(statistics.sumOfSquaredDeviations, std::memory_order_relaxed);
+    minimum.store(statistics.minimum, std::memory_order_relaxed);
+    maximum.store(statistics.maximum, std::memory_order_relaxed);
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+/** Publishes a new tag in the same way as write() publishes an accumulator, so
+ * that a reader sees the tag and the accumulator change together.
+ *
+ * \param newTag - The tag.
+ */
+void StatsLiveStatistics::setTag(int newTag){
+    const unsigned long long start = sequence.load(std::memory_order_relaxed);
+    sequence.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    tag.store(newTag, std::memory_order_relaxed);
+    sequence.store(start + 2, std::memory_order_release);
+}
+
+/** Makes a single attempt to read a consistent accumulator.
+ *
+ * The acquire load of the sequence keeps the loads of the accumulator from
+ * being performed before it, and the acquire fence keeps them from being
+ * performed after the second load of the sequence. If the sequence was odd, or
+ * changed in between, a write overlapped the read and the values are discarded.
+ *
+ * \param statistics - An accumulator that receives the published one.
+ * \param readTag - An optional pointer to an integer that receives the tag that
+ * was published with it.
+ *
+ * \return True on success, false if a write overlapped the read.
+ */
+bool StatsLiveStatistics::tryRead(RunningStatistics & statistics, int * readTag) const{
+    const unsigned long long start = sequence.load(std::memory_order_acquire);
+    if((start & 1) != 0){
+        return false;
+    }
+    RunningStatistics copy;
+    copy.count = count.load(std::memory_order_relaxed);
+    copy.sum = sum.load(std::memory_order_relaxed);
+    copy.mean = mean.load(std::memory_order_relaxed);
+    copy.sumOfSquaredDeviations = sumOfSquaredDeviations.load(std::memory_order_relaxed);
+    copy.minimum = minimum.load(std::memory_order_relaxed);
+    copy.maximum = maximum.load(std::memory_order_relaxed);
+    const int copiedTag = tag.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if(sequence.load(std::memory_order_relaxed) != start){
+        return false;
+    }
+    statistics = copy;
+    if(readTag != 0){
+        *readTag = copiedTag;
+    }
+    return true;
+}
+
+/** Reads a consistent accumulator. A write takes a few nanoseconds, so an
+ * overlapping write is simply retried. If many attempts fail (e.g. because the
+ * writer was descheduled in the middle of a write) the reader yields its
+ * processor between attempts, so that the writer can finish.
+ *
+ * \param statistics - An accumulator that receives the published one.
+ * \param readTag - An optional pointer to an integer that receives the tag that
+ * was published with it.
+ */
+void StatsLiveStatistics::read(RunningStatistics & statistics, int * readTag) const{
+    for(unsigned attempt = 0; !tryRead(statistics, readTag); ++attempt){
+        if(attempt >= 64){
+            std::this_thread::yield();
+        }
+    }
+}
+
+/** Returns the number of writes that have completed. A reader can compare it
+ * with the number it obtained previously to tell whether anything has changed
+ * without reading the accumulator.
+ */
+unsigned long long StatsLiveStatistics::getVersion() const{
+    return sequence.load(std::memory_order_acquire)/2;
+}
+
+// FILE PARSING HELPER FUNCTIONS
+
+/** Returns true if a character separates tokens in an input file. These are the
+ * same characters that the stream input operator (">>") treats as whitespace.
+ */
+static inline bool isSeparator(char character){
+    return character == ' ' || character == '\n' || character == '\t'
+    || character == '\r' || character == '\v' || character == '\f';
+}
+
+/** Exact powers of ten from 10^0 to 10^22. Every one of these can be represented
+ * exactly by a double precision value.
+ */
+static const double exactPowersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** Parses a token as a decimal number, i.e. an optional sign, a sequence of digits
+ * with an optional decimal point (containing at least one digit) and an optional
+ * exponent. These are the tokens that the stream input operator (">>") accepts
+ * as a whole.
+ *
+ * Most tokens are converted by a FAST PATH: if the digits, read as an integer,
+ * are no larger than 2^53 and the power of ten that scales them is no larger than
+ * 10^22, then both are represented exactly by doubles, so a single multiplication
+ * or division gives the correctly rounded result. Any other well-formed token is
+ * converted by std::strtod(), which is slower but always correctly rounded. The
+ * result is therefore identical to that of std::strtod() in every case.
+ *
+ * \param begin - A pointer to the first character of the token.
+ * \param end - A pointer to the character following the token.
+ * \param value - Receives the value of the token if it is well formed.
+ *
+ * \return True if the token is a well-formed decimal number, otherwise false.
+ */
+static bool parseDecimal(const char * begin, const char * end, double & value){
+    const char * cursor = begin;
+    bool negative = false;
+    if(cursor != end && (*cursor == '+' || *cursor == '-')){
+        negative = *cursor == '-';
+        ++cursor;
+    }
+    
+    // Accumulate up to 19 significant digits, which always fit in 64 bits.
+    unsigned long long mantissa = 0;
+    int significantDigits = 0;
+    int digitCount = 0;
+    int exponent = 0;
+    bool truncated = false;
+    for(; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor, ++digitCount){
+        if(significantDigits < 19){
+            mantissa = mantissa*10 + static_cast<unsigned>(*cursor - '0');
+            significantDigits += mantissa != 0;
+        }
+        else{
+            ++exponent;
+            truncated = true;
+        }
+    }
+    if(cursor != end && *cursor == '.'){
+        for(++cursor; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor, ++digitCount){
+            if(significantDigits < 19){
+                mantissa = mantissa*10 + static_cast<unsigned>(*cursor - '0');
+                significantDigits += mantissa != 0;
+                --exponent;
+            }
+            else{
+                truncated = true;
+            }
+        }
+    }
+    if(digitCount == 0){
+        return false;
+    }
+    if(cursor != end && (*cursor == 'e' || *cursor == 'E')){
+        ++cursor;
+        bool negativeExponent = false;
+        if(cursor != end && (*cursor == '+' || *cursor == '-')){
+            negativeExponent = *cursor == '-';
+            ++cursor;
+        }
+        if(cursor == end || *cursor < '0' || *cursor > '9'){
+            return false;
+        }
+        int exponentDigits = 0;
+        for(; cursor != end && *cursor >= '0' && *cursor <= '9'; ++cursor){
+            // Limit the exponent to a value that cannot overflow an int.
+            exponentDigits = exponentDigits < 100000 ? exponentDigits*10 + (*cursor - '0') : exponentDigits;
+        }
+        exponent += negativeExponent ? -exponentDigits : exponentDigits;
+    }
+    if(cursor != end){
+        return false;
+    }
+    
+    // The fast path, which applies whenever the conversion is exact.
+    if(!truncated && mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22){
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result/exactPowersOfTen[-exponent] : result*exactPowersOfTen[exponent];
+        value = negative ? -result : result;
+        return true;
+    }
+    
+    /* The slow path. std::strtod() requires a null-terminated string, so the token is
+     * copied first. Short tokens are copied onto the stack.
+     */
+    const size_t length = static_cast<size_t>(end - begin);
+    char shortCopy[64];
+    std::string longCopy;
+    const char * terminated = shortCopy;
+    if(length < sizeof(shortCopy)){
+        std::memcpy(shortCopy, begin, length);
+        shortCopy[length] = '\0';
+    }
+    else{
+        longCopy.assign(begin, end);
+        terminated = longCopy.c_str();
+    }
+    value = std::strtod(terminated, 0);
+    return true;
+}
+
+/** Records the position of a malformed token in a parse report.
+ *
+ * \param report - The report, whose count of malformed tokens is incremented.
+ * \param errors - The list of recorded positions, which is extended unless it
+ * already holds StatsCalculator::maxRecordedParseErrors positions.
+ * \param line - The line on which the token appeared.
+ * \param offset - The offset of the token from the start of the file.
+ */
+static void recordMalformedToken(StatsParseReport & report, std::vector<ParseErrorLocation> & errors,
+                                 long long line, long long offset){
+    if(report.malformedTokens == 0){
+        report.firstErrorLine = line;
+        report.firstErrorOffset = offset;
+    }
+    ++report.malformedTokens;
+    if(errors.size() < StatsCalculator::maxRecordedParseErrors){
+        ParseErrorLocation location = { line, offset };
+        errors.push_back(location);
+    }
+}
+
+/** \struct TokenScanner
+ * Reads a file in blocks and splits each block into whitespace-separated tokens,
+ * which are passed to a handler. Tokens that span the end of a block are moved
+ * to the start of the buffer before the next block is read.
+ *
+ * Each call to scanBlock() reads and scans ONE block, and the position reached is
+ * kept in the scanner, so a parse can be suspended between blocks and resumed
+ * later (see StatsCalculator::resumeIngest()). scanTokens() simply scans every
+ * block in turn.
+ *
+ * The handler must provide four methods, which are called for every token, for
+ * every token that is too long to fit in the buffer, at the end of every line (and
+ * at the end of the file) and at the end of every block respectively:
+ *
+ *     bool token(const char * begin, const char * end, long long line, long long offset);
+ *     bool oversizedToken(long long line, long long offset);
+ *     bool endLine();
+ *     void endBlock();
+ *
+ * A token that fills the whole buffer cannot be passed to token() in one piece, and
+ * splitting it would turn one token into several. It is therefore reported ONCE with
+ * oversizedToken(), which should treat it as malformed, and the rest of it is
+ * skipped, however many blocks it spans. So that the outcome does not depend on the
+ * size of the buffer, every token longer than StatsCalculator::maxTokenBytes is
+ * reported in the same way, and the buffer must be longer than that.
+ *
+ * If a handler method returns false, scanning stops after endBlock() has been
+ * called. Since the handler is a template parameter, these calls are inlined, so
+ * there is no per-token function call overhead.
+ */
+struct TokenScanner {
+    /// The buffer into which blocks are read. Its size is the size of a block.
+    std::vector<char> buffer;
+    /// The number of bytes of an incomplete token that were carried over from the previous block.
+    size_t carriedBytes;
+    /// The offset within the file of the first byte in the buffer.
+    long long bufferOffset;
+    /// The line on which the next character in the buffer appears.
+    long long line;
+    /// True while the rest of a token that was reported with oversizedToken() is being skipped.
+    bool skippingToken;
+    /// True once the end of the file has been scanned or the handler has stopped the scan.
+    bool finished;
+    
+    /// Constructor, which allocates a buffer of the given size.
+    explicit TokenScanner(size_t blockBytes) :
+    buffer(blockBytes),
+    carriedBytes(0),
+    bufferOffset(0),
+    line(1),
+    skippingToken(false),
+    finished(false){
+    }
+    
+    /** Reads and scans the next block.
+     *
+     * \param inputFile - The open file, which should be in binary mode so that
+     * the byte offsets of the tokens are exact.
+     * \param progress - An optional pointer to an IngestProgress structure that
+     * is updated after the block.
+     * \param handler - The handler.
+     *
+     * \return True if the scan has finished, otherwise false.
+     */
+    template <class TokenHandler>
+    bool scanBlock(std::istream & inputFile, IngestProgress * progress, TokenHandler & handler){
+        const size_t blockBytes = buffer.size();
+        
+        // Fill the rest of the buffer from the file.
+        inputFile.read(&buffer[carriedBytes], static_cast<std::streamsize>(blockBytes - carriedBytes));
+        const size_t bytesRead = static_cast<size_t>(inputFile.gcount());
+        const size_t filledBytes = carriedBytes + bytesRead;
+        const bool lastBlock = filledBytes < blockBytes;
+        
+        // Skip the rest of an oversized token. It contains no newline, since that is a separator.
+        size_t parseBegin = 0;
+        if(skippingToken){
+            while(parseBegin < filledBytes && !isSeparator(buffer[parseBegin])){
+                ++parseBegin;
+            }
+            skippingToken = parseBegin == filledBytes && !lastBlock;
+        }
+        
+        /* Unless this is the last block, a token that reaches the end of the buffer
+         * may continue in the next block, so it is not parsed yet. A token that
+         * fills the WHOLE buffer is reported as oversized and skipped.
+         */
+        bool stopped = false;
+        size_t parseEnd = filledBytes;
+        if(!lastBlock && !skippingToken){
+            while(parseEnd > parseBegin && !isSeparator(buffer[parseEnd - 1])){
+                --parseEnd;
+            }
+            if(parseEnd == 0){
+                stopped = !handler.oversizedToken(line, bufferOffset);
+                skippingToken = true;
+                parseEnd = filledBytes;
+                parseBegin = filledBytes;
+            }
+        }
+        
+        // Split the complete part of the buffer into tokens.
+        const char * cursor = &buffer[0] + parseBegin;
+        const char * end = &buffer[0] + parseEnd;
+        while(cursor != end && !stopped){
+            if(isSeparator(*cursor)){
+                if(*cursor == '\n'){
+                    ++line;
+                    stopped = !handler.endLine();
+                }
+                ++cursor;
+                continue;
+            }
+            const char * tokenBegin = cursor;
+            while(cursor != end && !isSeparator(*cursor)){
+                ++cursor;
+            }
+            const long long tokenOffset = bufferOffset + (tokenBegin - &buffer[0]);
+            if(static_cast<size_t>(cursor - tokenBegin) > StatsCalculator::maxTokenBytes){
+                stopped = !handler.oversizedToken(line, tokenOffset);
+            }
+            else{
+                stopped = !handler.token(tokenBegin, cursor, line, tokenOffset);
+            }
+        }
+        // The last line of a file need not end with a newline.
+        if(lastBlock && !stopped){
+            handler.endLine();
+        }
+        handler.endBlock();
+        
+        // Report how far through the file the parse has reached.
+        bufferOffset += static_cast<long long>(parseEnd);
+        if(progress != 0){
+            progress->bytesConsumed = bufferOffset;
+        }
+        if(lastBlock || stopped){
+            finished = true;
+            return true;
+        }
+        
+        // Move the incomplete token to the start of the buffer.
+        carriedBytes = filledBytes - parseEnd;
+        std::memmove(&buffer[0], &buffer[parseEnd], carriedBytes);
+        return false;
+    }
+};
+
+/** Reads a whole file in large blocks, passing its tokens to a handler (see
+ * TokenScanner).
+ *
+ * \param inputFile - The open file, which should be in binary mode so that the
+ * byte offsets of the tokens are exact.
+ * \param progress - An optional pointer to an IngestProgress structure that is
+ * updated after every block.
+ * \param handler - The handler.
+ */
+template <class TokenHandler>
+static void scanTokens(std::istream & inputFile, IngestProgress * progress, TokenHandler & handler){
+    // The size of the blocks in which the file is read.
+    TokenScanner scanner(1 << 20);
+    while(!scanner.scanBlock(inputFile, progress, handler)){
+    }
+}
+
+/** \struct ValueTokenHandler
+ * A handler for scanTokens() that treats every token as a value, applies a parse
+ * policy to malformed tokens, and appends the values of each block to a
+ * StatsCalculator together.
+ */
+struct ValueTokenHandler {
+    /// The instance to which values are appended.
+    StatsCalculator & calculator;
+    /// The policy that is applied to malformed tokens.
+    StatsCalcParsePolicy policy;
+    /// The report that is updated as tokens are parsed.
+    StatsParseReport & report;
+    /// The positions of malformed tokens.
+    std::vector<ParseErrorLocation> & errors;
+    /// The values parsed from the current block.
+    std::vector<double> values;
+    /// The number of elements of "values" that were recorded as NaN in place of malformed tokens.
+    size_t recordedNaNs;
+    
+    /// Constructor.
+    ValueTokenHandler(StatsCalculator & calculator, StatsCalcParsePolicy policy,
+                      StatsParseReport & report, std::vector<ParseErrorLocation> & errors) :
+    calculator(calculator),
+    policy(policy),
+    report(report),
+    errors(errors),
+    recordedNaNs(0){
+    }
+    
+    /// Parses one token, returning false if parsing should stop.
+    bool token(const char * begin, const char * end, long long line, long long offset){
+        double value;
+        if(parseDecimal(begin, end, value)){
+            values.push_back(value);
+            return true;
+        }
+        return malformedToken(line, offset);
+    }
+    
+    /// Treats a token that is too long to fit in a block as malformed.
+    bool oversizedToken(long long line, long long offset){
+        return malformedToken(line, offset);
+    }
+    
+    /// Records a malformed token and applies the policy, returning false if parsing should stop.
+    bool malformedToken(long long line, long long offset){
+        // The token is malformed, so record where it is and apply the policy.
+        recordMalformedToken(report, errors, line, offset);
+        if(policy == STATSCALC_PARSE_NAN){
+            values.push_back(std::numeric_limits<double>::quiet_NaN());
+            ++recordedNaNs;
+        }
+        else if(policy == STATSCALC_PARSE_STOP){
+            report.stoppedEarly = 1;
+            return false;
+        }
+        return true;
+    }
+    
+    /// Values are not grouped into lines, so the end of a line is ignored.
+    bool endLine(){
+        return true;
+    }
+    
+    /// Appends the values of the block. Values that were recorded as NaN are not counted as parsed.
+    void endBlock(){
+        if(!values.empty()){
+            calculator.appendValues(&values[0], values.size());
+        }
+        report.valuesParsed += static_cast<long long>(values.size() - recordedNaNs);
+        values.clear();
+        recordedNaNs = 0;
+    }
+};
+
+/** \brief The ways in which TwoColumnRecordHandler can use the records it parses.
+ */
+enum TwoColumnRecordUse {
+    /// Each record is a value and its weight.
+    RECORDS_ARE_WEIGHTED_VALUES,
+    /// Each record is a value and its uncertainty, whose inverse square is its weight.
+    RECORDS_ARE_VALUES_WITH_UNCERTAINTIES,
+    /// Each record is a pair of values from two channels.
+    RECORDS_ARE_PAIRS,
+    /// Each record is a timestamp and a value.
+    RECORDS_ARE_TIMED_VALUES
+};
+
+/** \struct TwoColumnRecordHandler
+ * A handler for scanTokens() that treats every non-blank line as a RECORD of two
+ * tokens: a value and its weight or uncertainty, a pair of values, or a timestamp
+ * and a value. A record
+ * whose tokens are not both decimal numbers, or that does not have exactly two
+ * tokens, is malformed, and the parse policy is applied to the whole record.
+ * The records of each block are appended to a StatsCalculator together.
+ */
+struct TwoColumnRecordHandler {
+    /// The instance to which the records are appended.
+    StatsCalculator & calculator;
+    /// The policy that is applied to malformed records.
+    StatsCalcParsePolicy policy;
+    /// What the records hold.
+    TwoColumnRecordUse use;
+    /// The report that is updated as records are parsed.
+    StatsParseReport & report;
+    /// The positions of malformed records.
+    std::vector<ParseErrorLocation> & errors;
+    /// The first columns of the records parsed from the current block.
+    std::vector<double> firstColumn;
+    /// The second columns of the records parsed from the current block (converted into weights if necessary).
+    std::vector<double> secondColumn;
+    /// The number of records in the current block that were recorded as NaN in place of malformed records.
+    size_t recordedNaNs;
+    /// The tokens of the current line that have been parsed.
+    double fields[2];
+    /// The number of tokens on the current line so far.
+    int fieldCount;
+    /// The position (line and offset) of the first token of the current line.
+    long long lineStart[2];
+    /// The position (line and offset) of the first malformed token of the current line, if "lineMalformed" is true.
+    long long malformedAt[2];
+    /// True if the current line is malformed.
+    bool lineMalformed;
+    
+    /// Constructor.
+    TwoColumnRecordHandler(StatsCalculator & calculator, StatsCalcParsePolicy policy, TwoColumnRecordUse use,
+                           StatsParseReport & report, std::vector<ParseErrorLocation> & errors) :
+    calculator(calculator),
+    policy(policy),
+    use(use),
+    report(report),
+    errors(errors),
+    recordedNaNs(0),
+    fieldCount(0),
+    lineMalformed(false){
+    }
+    
+    /// Parses one token of the current record.
+    bool token(const char * begin, const char * end, long long line, long long offset){
+        if(fieldCount == 0){
+            lineStart[0] = line;
+            lineStart[1] = offset;
+        }
+        if(!lineMalformed && (fieldCount >= 2 || !parseDecimal(begin, end, fields[fieldCount]))){
+            lineMalformed = true;
+            malformedAt[0] = line;
+            malformedAt[1] = offset;
+        }
+        ++fieldCount;
+        return true;
+    }
+    
+    /// Counts a token that is too long to fit in a block as a malformed token of the current record.
+    bool oversizedToken(long long line, long long offset){
+        if(fieldCount == 0){
+            lineStart[0] = line;
+            lineStart[1] = offset;
+        }
+        if(!lineMalformed){
+            lineMalformed = true;
+            malformedAt[0] = line;
+            malformedAt[1] = offset;
+        }
+        ++fieldCount;
+        return true;
+    }
+    
+    /// Completes the current record, returning false if parsing should stop.
+    bool endLine(){
+        if(fieldCount == 0){
+            // Blank lines are ignored.
+            return true;
+        }
+        bool keepGoing = true;
+        if(!lineMalformed && fieldCount == 2){
+            firstColumn.push_back(fields[0]);
+            secondColumn.push_back(use == RECORDS_ARE_VALUES_WITH_UNCERTAINTIES ? 1.0/(fields[1]*fields[1]) : fields[1]);
+        }
+        else{
+            // A record with a single (valid) token is reported at the start of its line.
+            if(!lineMalformed){
+                malformedAt[0] = lineStart[0];
+                malformedAt[1] = lineStart[1];
+            }
+            recordMalformedToken(report, errors, malformedAt[0], malformedAt[1]);
+            if(policy == STATSCALC_PARSE_NAN){
+                // A weighted value is recorded as NaN with unit weight; a pair or a timed value as two NaNs.
+                firstColumn.push_back(std::numeric_limits<double>::quiet_NaN());
+                secondColumn.push_back(use == RECORDS_ARE_PAIRS || use == RECORDS_ARE_TIMED_VALUES
+                                       ? std::numeric_limits<double>::quiet_NaN() : 1.0);
+                ++recordedNaNs;
+            }
+            else if(policy == STATSCALC_PARSE_STOP){
+                report.stoppedEarly = 1;
+                keepGoing = false;
+            }
+        }
+        fieldCount = 0;
+        lineMalformed = false;
+        return keepGoing;
+    }
+    
+    /// Appends the records of the block. Records that were recorded as NaN are not counted as parsed.
+    void endBlock(){
+        if(!firstColumn.empty()){
+            if(use == RECORDS_ARE_PAIRS){
+                calculator.appendPairs(&firstColumn[0], &secondColumn[0], firstColumn.size());
+            }
+            else if(use == RECORDS_ARE_TIMED_VALUES){
+                calculator.appendTimedValues(&firstColumn[0], &secondColumn[0], firstColumn.size());
+            }
+            else{
+                calculator.appendWeightedValues(&firstColumn[0], &secondColumn[0], firstColumn.size());
+            }
+        }
+        report.valuesParsed += static_cast<long long>(firstColumn.size() - recordedNaNs);
+        firstColumn.clear();
+        secondColumn.clear();
+        recordedNaNs = 0;
+    }
+};
+
+/** \struct IncrementalIngest
+ * The state of an ingest that StatsCalculator performs one CHUNK at a time (see
+ * StatsCalculator::beginIngest() and StatsCalculator::resumeIngest()). The
+ * values come either from a file, which is scanned one block at a time by a
+ * TokenScanner, or from a caller-owned array, which is appended a chunk at a
+ * time. Everything needed to resume the ingest is held here, so that no thread
+ * is occupied between chunks.
+ */
+struct IncrementalIngest {
+    /// True if the values come from "inputFile", false if they come from "values".
+    bool readingFile;
+    /// The file, if the values come from a file.
+    std::ifstream inputFile;
+    /// The position that the scan of "inputFile" has reached.
+    TokenScanner scanner;
+    /// The handler that parses the tokens of "inputFile" and appends their values.
+    ValueTokenHandler handler;
+    /// An optional pointer to an IngestProgress structure that is updated after every chunk.
+    IngestProgress * progress;
+    /// The caller-owned array, if the values come from an array.
+    const double * values;
+    /// The number of elements of "values".
+    size_t valueCount;
+    /// The index of the first element of "values" that has not yet been appended.
+    size_t nextValue;
+    
+    /// Constructor, whose first parameters are those of ValueTokenHandler, followed by the size of the scanner's blocks.
+    IncrementalIngest(StatsCalculator & calculator, StatsCalcParsePolicy policy, StatsParseReport & report,
+                      std::vector<ParseErrorLocation> & errors, size_t blockBytes) :
+    readingFile(false),
+    scanner(blockBytes),
+    handler(calculator, policy, report, errors),
+    progress(0),
+    values(0),
+    valueCount(0),
+    nextValue(0){
+    }
+};
+
+// STATISTICS KERNEL HELPERS
+
+/** \struct KeepAllValues
+ * A value filter for accumulateStatistics() that keeps every value, so that a
+ * single NaN makes the sum, mean and standard deviation NaN.
+ */
+struct KeepAllValues {
+    static bool keep(double){ return true; }
+};
+
+/** \struct KeepNonNaNValues
+ * A value filter for accumulateStatistics() that discards NaN values. A NaN is
+ * the only value that does not compare equal to itself.
+ */
+struct KeepNonNaNValues {
+    static bool keep(double value){ return value == value; }
+};
+
+/** \struct KeepFiniteValues
+ * A value filter for accumulateStatistics() that discards NaN and infinite
+ * values. Neither satisfies the comparison, since NaN compares false with
+ * everything and infinity exceeds the largest finite double.
+ */
+struct KeepFiniteValues {
+    static bool keep(double value){ return std::fabs(value) <= std::numeric_limits<double>::max(); }
+};
+
+/** Chooses the shift that the accumulation kernels subtract from every value:
+ * the first finite value at or after an index, or zero if there is none.
+ *
+ * Subtracting any constant leaves the statistics unchanged, so the shift only
+ * needs to be close to the data. It must however be finite: an infinite shift
+ * would turn every later value into inf - inf = NaN, even though the sum and
+ * mean of values that include an infinity are themselves infinite.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param first - The index at which to start searching.
+ * \param count - The number of elements in the array.
+ * \return The first finite value, or zero.
+ */
+static double chooseShift(const double * values, size_t first, size_t count){
+    for(size_t index = first; index < count; ++index){
+        if(KeepFiniteValues::keep(values[index])){
+            return values[index];
+        }
+    }
+    return 0.0;
+}
+
+/** Computes every statistic of the values in an array that a filter keeps, in a
+ * single pass over the array.
+ *
+ * The standard deviation of a sequence of numbers can be computed as the square
+ * root of the difference between the mean of the squares of the numbers and the
+ * square of the mean of the numbers.
+ *
+ * \f[ \sigma = \sqrt{\langle X^{2} \rangle - \langle X \rangle^{2}} \f]
+ *
+ * Evaluated naively this formula subtracts two large, nearly equal quantities
+ * whenever the mean is large compared with the spread of the values. To avoid
+ * this, every value is first SHIFTED by subtracting the first finite value, K,
+ * which leaves the standard deviation unchanged (see chooseShift()):
+ *
+ * \f[ \sigma^{2} = \frac{1}{N}\left(\sum (x-K)^{2} - \frac{\left(\sum (x-K)\right)^{2}}{N}\right) \f]
+ *
+ * \note The loop body accumulates into four independent sets of partial sums.
+ * This breaks the dependency of each addition on the previous one so that the
+ * processor (and an auto-vectorizing compiler) can perform several additions
+ * at once. The partial sums are combined after the loop.
+ *
+ * \note Discarded values are MASKED rather than branched around: each one
+ * contributes zero to the sums and nothing to the count, minimum or maximum.
+ * The loop therefore has no data-dependent branches, which lets the compiler
+ * turn the conditional expressions into vector blend instructions, and the
+ * valid values are counted in the same pass. For KeepAllValues the mask is
+ * always true and the compiler removes it entirely.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array.
+ * \param result - A StatsResult structure that is filled with the statistics.
+ * Its count is the number of values that were kept. If no values were kept,
+ * every statistic is zero.
+ */
+template <class ValueFilter>
+static void accumulateStatistics(const double * values, size_t count, StatsResult & result){
+    
+    // Find the first value that is kept.
+    size_t first = 0;
+    while(first < count && !ValueFilter::keep(values[first])){
+        ++first;
+    }
+    
+    // If no values were kept...
+    if(first == count){
+        result.count = 0;
+        result.sum = 0.0;
+        result.mean = 0.0;
+        result.standardDeviation = 0.0;
+        result.minimum = 0.0;
+        result.maximum = 0.0;
+        return;
+    }
+    
+    // The shift that is subtracted from every value, and the first kept value.
+    const double shift = chooseShift(values, first, count);
+    const double start = values[first];
+    
+    /* Four independent counts and partial sums of shifted values, squares, minima and
+     * maxima. The counts are kept as doubles, so that every partial result has the same
+     * type and can share vector registers; they are exact up to 2^53 values per lane.
+     */
+    double kept[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumOfSquares[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double minimum[4] = { start, start, start, start };
+    double maximum[4] = { start, start, start, start };
+    
+    // Process the values in blocks of four...
+    size_t index = first;
+    for(; index + 4 <= count; index += 4){
+        for(int lane = 0; lane < 4; ++lane){
+            const double value = values[index + lane];
+            const bool keep = ValueFilter::keep(value);
+            const double shifted = keep ? value - shift : 0.0;
+            kept[lane] += keep ? 1.0 : 0.0;
+            sum[lane] += shifted;
+            sumOfSquares[lane] += shifted*shifted;
+            minimum[lane] = keep && value < minimum[lane] ? value : minimum[lane];
+            maximum[lane] = keep && value > maximum[lane] ? value : maximum[lane];
+        }
+    }
+    // ...then process any remaining values using the first lane.
+    for(; index < count; ++index){
+        const double value = values[index];
+        const bool keep = ValueFilter::keep(value);
+        const double shifted = keep ? value - shift : 0.0;
+        kept[0] += keep ? 1.0 : 0.0;
+        sum[0] += shifted;
+        sumOfSquares[0] += shifted*shifted;
+        minimum[0] = keep && value < minimum[0] ? value : minimum[0];
+        maximum[0] = keep && value > maximum[0] ? value : maximum[0];
+    }
+    
+    // Combine the partial results of the four lanes.
+    const long long keptCount = static_cast<long long>((kept[0] + kept[1]) + (kept[2] + kept[3]));
+    const double shiftedSum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    const double shiftedSumOfSquares = (sumOfSquares[0] + sumOfSquares[1]) + (sumOfSquares[2] + sumOfSquares[3]);
+    result.minimum = minimum[0];
+    result.maximum = maximum[0];
+    for(int lane = 1; lane < 4; ++lane){
+        result.minimum = minimum[lane] < result.minimum ? minimum[lane] : result.minimum;
+        result.maximum = maximum[lane] > result.maximum ? maximum[lane] : result.maximum;
+    }
+    
+    // Undo the shift to recover the sum and the mean.
+    result.count = keptCount;
+    const double n = static_cast<double>(keptCount);
+    result.sum = shiftedSum + n*shift;
+    result.mean = shift + shiftedSum/n;
+    
+    /* Compute the variance of the shifted values. Rounding can make a tiny
+     * variance very slightly negative, so it is clamped to zero before the
+     * STL function std::sqrt provided by the <cmath> header file is used to
+     * compute the square root. A NaN variance (which only KeepAllValues can
+     * produce) is passed through.
+     */
+    double variance = (shiftedSumOfSquares - shiftedSum*shiftedSum/n)/n;
+    result.standardDeviation = variance > 0.0 || variance != variance ? std::sqrt(variance) : 0.0;
+}
+
+/** Computes the weighted statistics of the values in an array that a filter keeps
+ * and whose weights are usable, in a single pass over the array and its weights.
+ *
+ * The method mirrors accumulateStatistics(). Every value is shifted by the first
+ * finite value, K (see chooseShift()), and four independent lanes accumulate the count, the
+ * sum of the weights, the sum of the squared weights, and the weighted sums of
+ * the shifted values and of their squares. From these:
+ *
+ * \f[ \bar{x} = K + \frac{\sum w(x-K)}{W} \f]
+ * \f[ M_{2} = \sum w(x-K)^{2} - \frac{\left(\sum w(x-K)\right)^{2}}{W} \f]
+ *
+ * Discarded values are masked, so the loop has no data-dependent branches.
+ *
+ * \param values - A pointer to the first element of the array of values.
+ * \param weights - A pointer to the first element of the array of weights.
+ * \param count - The number of elements in each array.
+ * \param result - An accumulator that is set to summarize the kept values.
+ */
+template <class ValueFilter>
+static void accumulateWeightedStatistics(const double * values, const double * weights, size_t count,
+                                         WeightedRunningStatistics & result){
+    result = WeightedRunningStatistics();
+    
+    // Find the first value that is kept, and the shift.
+    size_t first = 0;
+    while(first < count && !(ValueFilter::keep(values[first]) && WeightedRunningStatistics::isUsableWeight(weights[first]))){
+        ++first;
+    }
+    if(first == count){
+        return;
+    }
+    const double shift = chooseShift(values, first, count);
+    
+    // Four independent lanes of counts and weighted partial sums.
+    double kept[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumOfWeights[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumOfSquaredWeights[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sum[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumOfSquares[4] = { 0.0, 0.0, 0.0, 0.0 };
+    
+    // Process the values in blocks of four...
+    size_t index = first;
+    for(; index + 4 <= count; index += 4){
+        for(int lane = 0; lane < 4; ++lane){
+            const double value = values[index + lane];
+            const double weight = weights[index + lane];
+            const bool keep = ValueFilter::keep(value) && WeightedRunningStatistics::isUsableWeight(weight);
+            const double maskedWeight = keep ? weight : 0.0;
+            const double shifted = keep ? value - shift : 0.0;
+            kept[lane] += keep ? 1.0 : 0.0;
+            sumOfWeights[lane] += maskedWeight;
+            sumOfSquaredWeights[lane] += maskedWeight*maskedWeight;
+            sum[lane] += maskedWeight*shifted;
+            sumOfSquares[lane] += maskedWeight*shifted*shifted;
+        }
+    }
+    // ...then process any remaining values using the first lane.
+    for(; index < count; ++index){
+        const double value = values[index];
+        const double weight = weights[index];
+        const bool keep = ValueFilter::keep(value) && WeightedRunningStatistics::isUsableWeight(weight);
+        const double maskedWeight = keep ? weight : 0.0;
+        const double shifted = keep ? value - shift : 0.0;
+        kept[0] += keep ? 1.0 : 0.0;
+        sumOfWeights[0] += maskedWeight;
+        sumOfSquaredWeights[0] += maskedWeight*maskedWeight;
+        sum[0] += maskedWeight*shifted;
+        sumOfSquares[0] += maskedWeight*shifted*shifted;
+    }
+    
+    // Combine the partial results of the four lanes and undo the shift.
+    const double totalWeight = (sumOfWeights[0] + sumOfWeights[1]) + (sumOfWeights[2] + sumOfWeights[3]);
+    const double shiftedSum = (sum[0] + sum[1]) + (sum[2] + sum[3]);
+    const double shiftedSumOfSquares = (sumOfSquares[0] + sumOfSquares[1]) + (sumOfSquares[2] + sumOfSquares[3]);
+    result.count = static_cast<long long>((kept[0] + kept[1]) + (kept[2] + kept[3]));
+    result.sumOfWeights = totalWeight;
+    result.sumOfSquaredWeights = (sumOfSquaredWeights[0] + sumOfSquaredWeights[1]) + (sumOfSquaredWeights[2] + sumOfSquaredWeights[3]);
+    result.weightedSum = shift*totalWeight + shiftedSum;
+    result.mean = shift + shiftedSum/totalWeight;
+    const double sumOfSquaredDeviations = shiftedSumOfSquares - shiftedSum*shiftedSum/totalWeight;
+    result.sumOfSquaredDeviations = sumOfSquaredDeviations > 0.0 || sumOfSquaredDeviations != sumOfSquaredDeviations
+    ? sumOfSquaredDeviations : 0.0;
+}
+
+/** Computes the bivariate statistics of the pairs of values in two parallel arrays
+ * that a filter keeps (both values of a pair must be kept), in a single pass.
+ *
+ * The method mirrors accumulateStatistics(). Each channel is shifted by its first
+ * finite value, \f$K_{x}\f$ and \f$K_{y}\f$ (see chooseShift()), and four independent lanes
+ * accumulate the count, the sums of the shifted values, of their squares and of
+ * their products. From these, for example:
+ *
+ * \f[ C = \sum (x-K_{x})(y-K_{y}) - \frac{\sum (x-K_{x}) \sum (y-K_{y})}{n} \f]
+ *
+ * Discarded pairs are masked, so the loop has no data-dependent branches.
+ *
+ * \param x - A pointer to the first element of the first channel.
+ * \param y - A pointer to the first element of the second channel.
+ * \param count - The number of elements in each array.
+ * \param result - An accumulator that is set to summarize the kept pairs.
+ */
+template <class ValueFilter>
+static void accumulateBivariateStatistics(const double * x, const double * y, size_t count,
+                                          BivariateRunningStatistics & result){
+    result = BivariateRunningStatistics();
+    
+    // Find the first pair that is kept, and the shift of each channel.
+    size_t first = 0;
+    while(first < count && !(ValueFilter::keep(x[first]) && ValueFilter::keep(y[first]))){
+        ++first;
+    }
+    if(first == count){
+        return;
+    }
+    const double shiftX = chooseShift(x, first, count);
+    const double shiftY = chooseShift(y, first, count);
+    
+    // Four independent lanes of counts and partial sums.
+    double kept[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumX[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumY[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumXX[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumYY[4] = { 0.0, 0.0, 0.0, 0.0 };
+    double sumXY[4] = { 0.0, 0.0, 0.0, 0.0 };
+    
+    // Process the pairs in blocks of four...
+    size_t index = first;
+    for(; index + 4 <= count; index += 4){
+        for(int lane = 0; lane < 4; ++lane){
+            const bool keep = ValueFilter::keep(x[index + lane]) && ValueFilter::keep(y[index + lane]);
+            const double shiftedX = keep ? x[index + lane] - shiftX : 0.0;
+            const double shiftedY = keep ? y[index + lane] - shiftY : 0.0;
+            kept[lane] += keep ? 1.0 : 0.0;
+            sumX[lane] += shiftedX;
+            sumY[lane] += shiftedY;
+            sumXX[lane] += shiftedX*shiftedX;
+            sumYY[lane] += shiftedY*shiftedY;
+            sumXY[lane] += shiftedX*shiftedY;
+        }
+    }
+    // ...then process any remaining pairs using the first lane.
+    for(; index < count; ++index){
+        const bool keep = ValueFilter::keep(x[index]) && ValueFilter::keep(y[index]);
+        const double shiftedX = keep ? x[index] - shiftX : 0.0;
+        const double shiftedY = keep ? y[index] - shiftY : 0.0;
+        kept[0] += keep ? 1.0 : 0.0;
+        sumX[0] += shiftedX;
+        sumY[0] += shiftedY;
+        sumXX[0] += shiftedX*shiftedX;
+        sumYY[0] += shiftedY*shiftedY;
+        sumXY[0] += shiftedX*shiftedY;
+    }
+    
+    // Combine the partial results of the four lanes and undo the shifts.
+    const double n = (kept[0] + kept[1]) + (kept[2] + kept[3]);
+    const double totalX = (sumX[0] + sumX[1]) + (sumX[2] + sumX[3]);
+    const double totalY = (sumY[0] + sumY[1]) + (sumY[2] + sumY[3]);
+    const double totalXX = (sumXX[0] + sumXX[1]) + (sumXX[2] + sumXX[3]);
+    const double totalYY = (sumYY[0] + sumYY[1]) + (sumYY[2] + sumYY[3]);
+    const double totalXY = (sumXY[0] + sumXY[1]) + (sumXY[2] + sumXY[3]);
+    result.count = static_cast<long long>(n);
+    result.meanX = shiftX + totalX/n;
+    result.meanY = shiftY + totalY/n;
+    const double deviationsX = totalXX - totalX*totalX/n;
+    const double deviationsY = totalYY - totalY*totalY/n;
+    result.sumOfSquaredDeviationsX = deviationsX > 0.0 || deviationsX != deviationsX ? deviationsX : 0.0;
+    result.sumOfSquaredDeviationsY = deviationsY > 0.0 || deviationsY != deviationsY ? deviationsY : 0.0;
+    result.coMoment = totalXY - totalX*totalY/n;
+}
+
+// SORTING HELPERS
+
+/** The number of bits of the sort key that each pass of the radix sort orders
+ * by. Eleven bits (2048 buckets) need six passes over 64-bit keys; the bucket
+ * counters of one chunk still fit comfortably in the processor cache.
+ */
+static const unsigned radixDigitBits = 11;
+
+/** The number of buckets into which each pass of the radix sort distributes the
+ * values.
+ */
+static const size_t radixBucketCount = static_cast<size_t>(1) << radixDigitBits;
+
+/** The number of passes needed to order the values by every bit of their keys.
+ */
+static const unsigned radixPassCount = (64 + radixDigitBits - 1)/radixDigitBits;
+
+/** Arrays with fewer values than this are sorted with std::sort(), which is
+ * faster than a radix sort for small arrays, and each chunk of a larger array
+ * holds at least this many values.
+ */
+static const size_t radixMinimumCount = 8192;
+
+/** Computes the sort key of a double precision value. The key is an unsigned
+ * integer whose order is the same as the numerical order of the values.
+ *
+ * The IEEE 754 bit pattern of a positive value, read as an unsigned integer,
+ * already increases with the value, so the sign bit is simply set to place the
+ * positive values above the negative ones. The bit pattern of a negative value
+ * increases with its MAGNITUDE, so every bit is inverted to reverse the order.
+ * Negative zero sorts immediately before positive zero. NaN values must be
+ * removed before sorting, since they have no place in the numerical order.
+ *
+ * \param value - A double precision value that is not NaN.
+ *
+ * \return The sort key.
+ */
+static inline std::uint64_t radixKey(double value){
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint64_t signBit = static_cast<std::uint64_t>(1) << 63;
+    return (bits & signBit) != 0 ? ~bits : (bits | signBit);
+}
+
+/** Extracts the digit of a value's sort key that a pass of the radix sort
+ * orders by.
+ *
+ * \param value - A double precision value that is not NaN.
+ * \param pass - The number of the pass, starting from the least significant digit.
+ *
+ * \return The digit, which is the index of the value's bucket in the pass.
+ */
+static inline size_t radixDigit(double value, unsigned pass){
+    return static_cast<size_t>(radixKey(value) >> (pass*radixDigitBits)) & (radixBucketCount - 1);
+}
+
+/** Sorts an array of double precision values (that are not NaN) into ascending
+ * order with a least significant digit (LSD) radix sort, which takes a time
+ * proportional to the number of values rather than to n log(n).
+ *
+ * Each pass distributes the values into buckets by one digit of their sort keys,
+ * preserving the order of values that share a digit, so that after the final
+ * pass the values are ordered by every digit. A pass is shared between threads
+ * by dividing the array into equal chunks. First the values in each chunk are
+ * counted by bucket; the counts then give every chunk a separate range of each
+ * bucket to write into, so the chunks are distributed concurrently without any
+ * synchronization, and the result is the same as a sequential pass.
+ *
+ * Before the passes begin, the whole array is counted once for every pass.
+ * Passes in which every value has the same digit (typically the most
+ * significant digit, which holds the sign and the high bits of the exponent)
+ * would not change the order, so they are skipped.
+ *
+ * \param values - The array of values, which is sorted in place.
+ */
+static void radixSortValues(std::vector<double> & values){
+    const size_t count = values.size();
+    if(count < radixMinimumCount){
+        std::sort(values.begin(), values.end());
+        return;
+    }
+    StatsCalculatorWorkerPool & pool = StatsCalculatorWorkerPool::shared();
+    size_t chunkCount = pool.size();
+    if(chunkCount > count/radixMinimumCount){
+        chunkCount = count/radixMinimumCount;
+    }
+    const size_t chunkSize = (count + chunkCount - 1)/chunkCount;
+    
+    // Count the digits of every pass for each chunk, then total the counts.
+    std::vector<size_t> chunkCounts(chunkCount*radixPassCount*radixBucketCount, 0);
+    pool.parallelFor(chunkCount, [&](size_t chunk){
+        size_t * counts = &chunkCounts[chunk*radixPassCount*radixBucketCount];
+        const size_t end = (chunk + 1)*chunkSize < count ? (chunk + 1)*chunkSize : count;
+        for(size_t index = chunk*chunkSize; index < end; ++index){
+            const std::uint64_t key = radixKey(values[index]);
+            for(unsigned pass = 0; pass < radixPassCount; ++pass){
+                ++counts[pass*radixBucketCount + (static_cast<size_t>(key >> (pass*radixDigitBits)) & (radixBucketCount - 1))];
+            }
+        }
+    });
+    
+    std::vector<double> scratch(count);
+    double * source = &values[0];
+    double * destination = &scratch[0];
+    std::vector<size_t> offsets(chunkCount*radixBucketCount);
+    bool firstPass = true;
+    for(unsigned pass = 0; pass < radixPassCount; ++pass){
+        size_t totalForFirstDigit = 0;
+        for(size_t chunk = 0; chunk < chunkCount; ++chunk){
+            totalForFirstDigit += chunkCounts[(chunk*radixPassCount + pass)*radixBucketCount + radixDigit(source[0], pass)];
+        }
+        if(totalForFirstDigit == count){
+            continue;
+        }
+        
+        /* The counts made before the first pass still describe the chunks until a
+         * pass has moved the values between them. After that, the chunks are
+         * counted again for this pass only.
+         */
+        if(!firstPass){
+            pool.parallelFor(chunkCount, [&](size_t chunk){
+                size_t * counts = &chunkCounts[(chunk*radixPassCount + pass)*radixBucketCount];
+                std::fill(counts, counts + radixBucketCount, static_cast<size_t>(0));
+                const size_t end = (chunk + 1)*chunkSize < count ? (chunk + 1)*chunkSize : count;
+                for(size_t index = chunk*chunkSize; index < end; ++index){
+                    ++counts[radixDigit(source[index], pass)];
+                }
+            });
+        }
+        firstPass = false;
+        
+        // Bucket by bucket, give each chunk the next range of the output.
+        size_t offset = 0;
+        for(size_t bucket = 0; bucket < radixBucketCount; ++bucket){
+            for(size_t chunk = 0; chunk < chunkCount; ++chunk){
+                offsets[chunk*radixBucketCount + bucket] = offset;
+                offset += chunkCounts[(chunk*radixPassCount + pass)*radixBucketCount + bucket];
+            }
+        }
+        
+        pool.parallelFor(chunkCount, [&](size_t chunk){
+            size_t * chunkOffsets = &offsets[chunk*radixBucketCount];
+            const size_t end = (chunk + 1)*chunkSize < count ? (chunk + 1)*chunkSize : count;
+            for(size_t index = chunk*chunkSize; index < end; ++index){
+                const double value = source[index];
+                destination[chunkOffsets[radixDigit(value, pass)]++] = value;
+            }
+        });
+        std::swap(source, destination);
+    }
+    
+    // After an odd number of passes the sorted values are in the scratch array.
+    if(source != &values[0]){
+        values.swap(scratch);
+    }
+}
+
+// ROBUST STATISTICS HELPERS
+
+/** Finds the median of an array of values by selection, reordering the array.
+ * std::nth_element() places the lower middle value in its sorted position, with
+ * no larger value before it, in a time proportional to the number of values. If
+ * the number of values is even, the upper middle value is then the smallest of
+ * the values after it.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array, which must not be zero.
+ *
+ * \return The median.
+ */
+static double selectMedian(double * values, size_t count){
+    double * middle = values + (count - 1)/2;
+    std::nth_element(values, middle, values + count);
+    if(count % 2 == 1){
+        return *middle;
+    }
+    return (*middle + *std::min_element(middle + 1, values + count))/2.0;
+}
+
+/** Computes the robust statistics of an array of values exactly, by selection
+ * rather than by sorting.
+ *
+ * Two passes of std::nth_element() move the k smallest values to the front of
+ * the array and the k largest to the back, leaving the values that survive
+ * trimming in between, with the values at which the array is trimmed at either
+ * end of them. The trimmed and winsorized statistics are computed from the
+ * middle values, and the median is selected from among them (trimming the same
+ * number of values from each end does not change the median). Finally the
+ * array is overwritten with the absolute deviations from the median, whose
+ * median is selected in turn.
+ *
+ * \param values - The values, which must not include NaN. The vector is
+ * overwritten.
+ * \param trimFraction - The fraction of the values to trim from each end, which
+ * is clamped to the range [0, 0.5].
+ * \param result - A StatsRobustResult structure that is filled with the
+ * statistics. If there are no values, every statistic is zero.
+ */
+static void computeRobustStatistics(std::vector<double> & values, double trimFraction, StatsRobustResult & result){
+    trimFraction = trimFraction > 0.0 ? (trimFraction < 0.5 ? trimFraction : 0.5) : 0.0;
+    const size_t count = values.size();
+    result.count = static_cast<long long>(count);
+    result.trimFraction = trimFraction;
+    result.approximate = 0;
+    if(count == 0){
+        result.median = 0.0;
+        result.medianAbsoluteDeviation = 0.0;
+        result.trimmedMean = 0.0;
+        result.winsorizedMean = 0.0;
+        result.winsorizedVariance = 0.0;
+        return;
+    }
+    // At least one value (or two, if the number is even) must survive trimming.
+    size_t trimmed = static_cast<size_t>(trimFraction*count);
+    if(2*trimmed >= count){
+        trimmed = (count - 1)/2;
+    }
+    
+    double * first = &values[0];
+    double * last = first + count;
+    std::nth_element(first, first + trimmed, last);
+    // The second pass reorders the values from "trimmed" onwards, so read the lowest first.
+    const double lowest = first[trimmed];
+    std::nth_element(first + trimmed, last - 1 - trimmed, last);
+    const double highest = *(last - 1 - trimmed);
+    
+    double keptSum = 0.0;
+    for(const double * value = first + trimmed; value < last - trimmed; ++value){
+        keptSum += *value;
+    }
+    result.trimmedMean = keptSum/(count - 2*trimmed);
+    result.winsorizedMean = (keptSum + trimmed*(lowest + highest))/count;
+    double sumOfSquaredDeviations = trimmed*((lowest - result.winsorizedMean)*(lowest - result.winsorizedMean)
+                                             + (highest - result.winsorizedMean)*(highest - result.winsorizedMean));
+    for(const double * value = first + trimmed; value < last - trimmed; ++value){
+        sumOfSquaredDeviations += (*value - result.winsorizedMean)*(*value - result.winsorizedMean);
+    }
+    result.winsorizedVariance = sumOfSquaredDeviations/count;
+    
+    result.median = selectMedian(first + trimmed, count - 2*trimmed);
+    for(double * value = first; value < last; ++value){
+        *value = std::fabs(*value - result.median);
+    }
+    result.medianAbsoluteDeviation = selectMedian(first, count);
+}
+
+// PRIVATE METHODS OF STATSCALCULATOR
+
+/** Private static method that actually computes every statistic of an array
+ * of numeric values in a single pass over them. The work is done by the
+ * accumulateStatistics() function template, instantiated with the value filter
+ * that corresponds to the requested mode.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array.
+ * \param result - A StatsResult structure that is filled with the statistics.
+ * If there are no values, every statistic is zero.
+ * \param mode - Determines whether NaN and infinite values are included.
+ */
+void StatsCalculator::computeStatistics(const double * values, size_t count, StatsResult & result,
+                                        StatsCalcNonFiniteMode mode){
+    switch(mode){
+        case STATSCALC_NONFINITE_SKIP_NAN:
+            accumulateStatistics<KeepNonNaNValues>(values, count, result);
+            break;
+        case STATSCALC_NONFINITE_SKIP_ALL:
+            accumulateStatistics<KeepFiniteValues>(values, count, result);
+            break;
+        default:
+            accumulateStatistics<KeepAllValues>(values, count, result);
+            break;
+    }
+}
+
+/** Private static method that computes the weighted statistics of an array of
+ * values and a parallel array of weights in a single pass over them, using the
+ * accumulateWeightedStatistics() function template.
+ *
+ * \param values - A pointer to the first element of the array of values.
+ * \param weights - A pointer to the first element of the array of weights.
+ * \param count - The number of elements in each array.
+ * \param result - An accumulator that is set to summarize the weighted values.
+ * \param mode - Determines whether NaN and infinite values are included.
+ */
+void StatsCalculator::computeWeightedStatistics(const double * values, const double * weights, size_t count,
+                                                WeightedRunningStatistics & result, StatsCalcNonFiniteMode mode){
+    switch(mode){
+        case STATSCALC_NONFINITE_SKIP_NAN:
+            accumulateWeightedStatistics<KeepNonNaNValues>(values, weights, count, result);
+            break;
+        case STATSCALC_NONFINITE_SKIP_ALL:
+            accumulateWeightedStatistics<KeepFiniteValues>(values, weights, count, result);
+            break;
+        default:
+            accumulateWeightedStatistics<KeepAllValues>(values, weights, count, result);
+            break;
+    }
+}
+
+/** Private static method that computes the bivariate statistics of two parallel
+ * arrays of values in a single pass over them, using the
+ * accumulateBivariateStatistics() function template.
+ *
+ * \param x - A pointer to the first element of the first channel.
+ * \param y - A pointer to the first element of the second channel.
+ * \param count - The number of elements in each array.
+ * \param result - An accumulator that is set to summarize the pairs.
+ * \param mode - Determines whether pairs containing NaN or infinite values are included.
+ */
+void StatsCalculator::computeBivariateStatistics(const double * x, const double * y, size_t count,
+                                                 BivariateRunningStatistics & result, StatsCalcNonFiniteMode mode){
+    switch(mode){
+        case STATSCALC_NONFINITE_SKIP_NAN:
+            accumulateBivariateStatistics<KeepNonNaNValues>(x, y, count, result);
+            break;
+        case STATSCALC_NONFINITE_SKIP_ALL:
+            accumulateBivariateStatistics<KeepFiniteValues>(x, y, count, result);
+            break;
+        default:
+            accumulateBivariateStatistics<KeepAllValues>(x, y, count, result);
+            break;
+    }
+}
+
+/** Private method that returns true if the non-finite mode discards a value.
+ *
+ * \param value - The value to test.
+ */
+bool StatsCalculator::isExcluded(double value) const{
+    switch(nonFiniteMode){
+        case STATSCALC_NONFINITE_SKIP_NAN:
+            return !KeepNonNaNValues::keep(value);
+        case STATSCALC_NONFINITE_SKIP_ALL:
+            return !KeepFiniteValues::keep(value);
+        default:
+            return false;
+    }
+}
+
+/** Private method that selects the stored values that the non-finite mode does
+ * not discard. The stored values are used directly unless some are discarded,
+ * in which case the remaining values are copied.
+ *
+ * \param selected - Receives the copy, if one is needed.
+ * \param values - Receives a pointer to the first selected value.
+ * \param count - Receives the number of selected values.
+ *
+ * \return True if any of the selected values is NaN or infinite.
+ */
+bool StatsCalculator::selectValues(std::vector<double> & selected, const double * & values, size_t & count) const{
+    values = valuesData();
+    count = valuesCount();
+    size_t excludedCount = 0;
+    bool nonFinite = false;
+    for(size_t index = 0; index < count; ++index){
+        if(isExcluded(values[index])){
+            ++excludedCount;
+        }
+        else if(!(std::fabs(values[index]) <= std::numeric_limits<double>::max())){
+            nonFinite = true;
+        }
+    }
+    if(excludedCount > 0){
+        selected.reserve(count - excludedCount);
+        for(size_t index = 0; index < count; ++index){
+            if(!isExcluded(values[index])){
+                selected.push_back(values[index]);
+            }
+        }
+        values = selected.empty() ? 0 : &selected[0];
+        count = selected.size();
+    }
+    return nonFinite;
+}
+
+/** Private method that adds a single parsed or appended value. If streaming is
+ * enabled the value is accumulated into "streamedStatistics", otherwise it is
+ * appended to the "numericValues" member datum. Either way, it is also
+ * accumulated into the frequency sketches if they are enabled, and offered to
+ * the reservoir sample and the change detector (which ignore it if they are
+ * disabled).
+ *
+ * \param value - The value to add.
+ */
+void StatsCalculator::consumeValue(double value){
+    if(frequencySketchesEnabled){
+        distinctSketch.add(value);
+        frequencySketch.add(value);
+    }
+    reservoir.add(value);
+    changeDetector.add(value);
+    if(streaming){
+        // Values are not stored, so any that the non-finite mode discards are discarded now.
+        if(!isExcluded(value)){
+            streamedStatistics.add(value);
+            if(sketchEnabled){
+                streamedSketch.add(value);
+            }
+        }
+    }
+    else{
+        numericValues.push_back(value);
+    }
+}
+
+/** Private method that forgets the values summarized by "observedStatistics", so
+ * that the next snapshot summarizes the stored values afresh. It is called when
+ * stored values are removed or the non-finite mode changes, but not when values
+ * are appended.
+ */
+void StatsCalculator::forgetObservedValues(){
+    observedStatistics = RunningStatistics();
+    observedCount = 0;
+}
+
+/** Private method that summarizes every value.
+ *
+ * The values that were stored since the previous call are summarized and merged
+ * into "observedStatistics", so that the cost is proportional to the number of
+ * new values rather than to the number of stored values. A single new value is
+ * added by Welford's update, and several by computeStatistics(). The streamed
+ * values are then merged in, as they are by getStatistics(). A view (which may
+ * be updated by its owner) is summarized in full.
+ *
+ * \param summary - An accumulator that receives the summary.
+ */
+void StatsCalculator::summarizeValues(RunningStatistics & summary){
+    if(isView()){
+        summary = RunningStatistics();
+        summary.merge(getStatistics());
+        return;
+    }
+    const size_t newCount = numericValues.size() - observedCount;
+    if(newCount == 1){
+        if(!isExcluded(numericValues[observedCount])){
+            observedStatistics.add(numericValues[observedCount]);
+        }
+    }
+    else if(newCount > 1){
+        StatsResult added;
+        computeStatistics(&numericValues[observedCount], newCount, added, nonFiniteMode);
+        observedStatistics.merge(added);
+    }
+    observedCount = numericValues.size();
+    summary = streamedStatistics;
+    summary.merge(observedStatistics);
+}
+
+/** Private method that is called whenever the values change. If live statistics
+ * are enabled, every value is summarized and the summary is published. Values
+ * that were appended are counted and, if the observer says that a snapshot is
+ * due, one is posted. Without live statistics or a subscription this costs two
+ * well-predicted branches.
+ *
+ * \param count - The number of values that have been appended.
+ */
+void StatsCalculator::publishUpdates(size_t count){
+    if(liveStatisticsEnabled){
+        RunningStatistics summary;
+        summarizeValues(summary);
+        liveStatistics.write(summary);
+    }
+    if(observer){
+        unpublishedCount += static_cast<long long>(count);
+        if(observer->isDue(unpublishedCount)){
+            publishStatistics();
+        }
+    }
+}
+
+/** Private method that discards every cached result: the statistics, the sorted
+ * view, the robust statistics, the bootstrap intervals and the autocorrelation statistics. It is
+ * called whenever the values that they
+ * describe (or the non-finite mode that selects those values) change.
+ */
+void StatsCalculator::discardCachedResults(){
+    cachedStatisticsValid = false;
+    sortedValuesValid = false;
+    cachedRobustStatisticsValid = false;
+    cachedBootstrapResultValid = false;
+    cachedAutocorrelationResultValid = false;
+}
+
+/** Private method that resets "parseReport" and "parseErrors" to describe a parse
+ * that encountered no tokens at all.
+ */
+void StatsCalculator::clearParseReport(){
+    parseReport.valuesParsed = 0;
+    parseReport.malformedTokens = 0;
+    parseReport.firstErrorLine = 0;
+    parseReport.firstErrorOffset = -1;
+    parseReport.stoppedEarly = 0;
+    parseErrors.clear();
+}
+
+/** Private method that returns a pointer to the first of the values that the
+ * statistics should be computed over.
+ *
+ * \return The first element of the caller-owned view if this instance is a
+ * view, otherwise the first element of the "numericValues" member datum (or
+ * null if "numericValues" is empty).
+ */
+const double * StatsCalculator::valuesData() const{
+    if(externalValues != 0){
+        return externalValues;
+    }
+    return numericValues.empty() ? 0 : &numericValues[0];
+}
+
+/** Private method that returns the number of values that the statistics
+ * should be computed over.
+ *
+ * \return The length of the caller-owned view if this instance is a view,
+ * otherwise the size of the "numericValues" member datum.
+ */
+size_t StatsCalculator::valuesCount() const{
+    return externalValues != 0 ? externalCount : numericValues.size();
+}
+
+/** Private method that converts a view into an ordinary instance by copying
+ * the viewed values into the "numericValues" member datum. After this method
+ * returns the caller-owned array is no longer referenced.
+ *
+ * If this instance is not a view, the method is a no-op.
+ */
+void StatsCalculator::detachView(){
+    if(externalValues != 0){
+        numericValues.assign(externalValues, externalValues + externalCount);
+        externalValues = 0;
+        externalCount = 0;
+    }
+}
+
+// STATIC DATA MEMBERS OF STATSCALCULATOR
+
+/* The constants are initialized in the class definition. These definitions give
+ * them storage, which is needed whenever one is bound to a reference (as by
+ * std::make_shared() or std::min()) rather than used only for its value.
+ */
+const size_t StatsCalculator::maxRecordedParseErrors;
+const size_t StatsCalculator::ingestChunkBytes;
+const size_t StatsCalculator::maxTokenBytes;
+const size_t StatsCalculator::ingestChunkValues;
+
+// PUBLIC METHODS OF STATSCALCULATOR
+
+/** Default constructor for the StatsCalculator class, which is not
+ * required to perform any operations.
+ *
+ * \note Technically an identical definition would be provided by the
+ * C++ compiler if its delcaration were also omitted from the class
+ * definition in the StatsCalculator.h header file.
+ *
+ * \note The explicit declaration and (no-operation) definition are
+ * provided for clarity.
+ */
+StatsCalculator::StatsCalculator() :
+externalValues(0),
+externalCount(0),
+cachedStatisticsValid(false),
+sortedValuesValid(false),
+cachedRobustStatisticsValid(false),
+cachedBootstrapResultValid(false),
+bootstrapEnabled(false),
+bootstrapResampleCount(2000),
+bootstrapConfidenceLevel(0.95),
+bootstrapSeed(0),
+cachedAutocorrelationResultValid(false),
+autocorrelationEnabled(false),
+streaming(false),
+sketchEnabled(false),
+frequencySketchesEnabled(false),
+unpublishedCount(0),
+observedCount(0),
+liveStatisticsEnabled(false),
+nonFiniteMode(STATSCALC_NONFINITE_INCLUDE),
+parsePolicy(STATSCALC_PARSE_SKIP){
+    // The parse report describes an empty parse until a file is read.
+    clearParseReport();
+}
+
+/** View constructor for the StatsCalculator class. The instance stores only
+ * the pointer and length it is given; no values are copied.
+ *
+ * \param values - A pointer to the first element of a caller-owned array of
+ * double precision values. The array must remain valid for as long as the
+ * instance views it.
+ * \param count - The number of elements in the array.
+ */
+StatsCalculator::StatsCalculator(const double * values, size_t count) :
+externalValues(values),
+externalCount(count),
+cachedStatisticsValid(false),
+sortedValuesValid(false),
+cachedRobustStatisticsValid(false),
+cachedBootstrapResultValid(false),
+bootstrapEnabled(false),
+bootstrapResampleCount(2000),
+bootstrapConfidenceLevel(0.95),
+bootstrapSeed(0),
+cachedAutocorrelationResultValid(false),
+autocorrelationEnabled(false),
+streaming(false),
+sketchEnabled(false),
+frequencySketchesEnabled(false),
+unpublishedCount(0),
+observedCount(0),
+liveStatisticsEnabled(false),
+nonFiniteMode(STATSCALC_NONFINITE_INCLUDE),
+parsePolicy(STATSCALC_PARSE_SKIP){
+    // The parse report describes an empty parse until a file is read.
+    clearParseReport();
+}
+
+/** Copy constructor for the StatsCalculator class. Every member is copied except
+ * "incrementalIngest" and "observer", which belong to the instance rather than to
+ * its values:
+ *
+ * - The state of an incremental ingest refers to the instance that began it, so a
+ *   copy that shared it would append the rest of the ingest to the ORIGINAL
+ *   instance (or to a destroyed one). The copy starts with no ingest.
+ * - A subscriber asked for the snapshots of ONE instance. A copy that shared the
+ *   observer would deliver snapshots of its own values to that subscriber,
+ *   interleaved with the original's. The copy starts unsubscribed.
+ *
+ * \param other - The instance to copy.
+ */
+StatsCalculator::StatsCalculator(const StatsCalculator & other) :
+numericValues(other.numericValues),
+externalValues(other.externalValues),
+externalCount(other.externalCount),
+cachedStatistics(other.cachedStatistics),
+cachedStatisticsValid(other.cachedStatisticsValid),
+sortedValues(other.sortedValues),
+sortedValuesValid(other.sortedValuesValid),
+cachedRobustStatistics(other.cachedRobustStatistics),
+cachedRobustStatisticsValid(other.cachedRobustStatisticsValid),
+cachedBootstrapResult(other.cachedBootstrapResult),
+cachedBootstrapResultValid(other.cachedBootstrapResultValid),
+bootstrapEnabled(other.bootstrapEnabled),
+bootstrapResampleCount(other.bootstrapResampleCount),
+bootstrapConfidenceLevel(other.bootstrapConfidenceLevel),
+bootstrapSeed(other.bootstrapSeed),
+cachedAutocorrelationResult(other.cachedAutocorrelationResult),
+cachedAutocorrelationResultValid(other.cachedAutocorrelationResultValid),
+autocorrelationEnabled(other.autocorrelationEnabled),
+streaming(other.streaming),
+streamedStatistics(other.streamedStatistics),
+sketchEnabled(other.sketchEnabled),
+streamedSketch(other.streamedSketch),
+frequencySketchesEnabled(other.frequencySketchesEnabled),
+distinctSketch(other.distinctSketch),
+frequencySketch(other.frequencySketch),
+reservoir(other.reservoir),
+timeRollup(other.timeRollup),
+changeDetector(other.changeDetector),
+observer(),
+unpublishedCount(0),
+observedStatistics(other.observedStatistics),
+observedCount(other.observedCount),
+liveStatisticsEnabled(other.liveStatisticsEnabled),
+liveStatistics(other.liveStatistics),
+weightedStatistics(other.weightedStatistics),
+bivariateStatistics(other.bivariateStatistics),
+nonFiniteMode(other.nonFiniteMode),
+parsePolicy(other.parsePolicy),
+parseReport(other.parseReport),
+parseErrors(other.parseErrors){
+}
+
+/** Copy assignment operator for the StatsCalculator class. Every member is copied
+ * except "incrementalIngest" and "observer", for the reasons given for the copy
+ * constructor. An incremental ingest that this instance had begun is abandoned,
+ * since the values it was appending to have been replaced. A subscription to this
+ * instance is kept, together with its count of unpublished values, and goes on to
+ * report the values that were copied.
+ *
+ * \param other - The instance to copy.
+ *
+ * \return A reference to this instance.
+ */
+StatsCalculator & StatsCalculator::operator=(const StatsCalculator & other){
+    if(this == &other){
+        return *this;
+    }
+    incrementalIngest.reset();
+    numericValues = other.numericValues;
+    externalValues = other.externalValues;
+    externalCount = other.externalCount;
+    cachedStatistics = other.cachedStatistics;
+    cachedStatisticsValid = other.cachedStatisticsValid;
+    sortedValues = other.sortedValues;
+    sortedValuesValid = other.sortedValuesValid;
+    cachedRobustStatistics = other.cachedRobustStatistics;
+    cachedRobustStatisticsValid = other.cachedRobustStatisticsValid;
+    cachedBootstrapResult = other.cachedBootstrapResult;
+    cachedBootstrapResultValid = other.cachedBootstrapResultValid;
+    bootstrapEnabled = other.bootstrapEnabled;
+    bootstrapResampleCount = other.bootstrapResampleCount;
+    bootstrapConfidenceLevel = other.bootstrapConfidenceLevel;
+    bootstrapSeed = other.bootstrapSeed;
+    cachedAutocorrelationResult = other.cachedAutocorrelationResult;
+    cachedAutocorrelationResultValid = other.cachedAutocorrelationResultValid;
+    autocorrelationEnabled = other.autocorrelationEnabled;
+    streaming = other.streaming;
+    streamedStatistics = other.streamedStatistics;
+    sketchEnabled = other.sketchEnabled;
+    streamedSketch = other.streamedSketch;
+    frequencySketchesEnabled = other.frequencySketchesEnabled;
+    distinctSketch = other.distinctSketch;
+    frequencySketch = other.frequencySketch;
+    reservoir = other.reservoir;
+    timeRollup = other.timeRollup;
+    changeDetector = other.changeDetector;
+    observedStatistics = other.observedStatistics;
+    observedCount = other.observedCount;
+    liveStatisticsEnabled = other.liveStatisticsEnabled;
+    liveStatistics = other.liveStatistics;
+    weightedStatistics = other.weightedStatistics;
+    bivariateStatistics = other.bivariateStatistics;
+    nonFiniteMode = other.nonFiniteMode;
+    parsePolicy = other.parsePolicy;
+    parseReport = other.parseReport;
+    parseErrors = other.parseErrors;
+    return *this;
+}
+
+/** Destructor for the StatsCalculator class.
+ *
+ * The members release their own resources. In particular, if the instance is
+ * subscribed, destroying "observer" delivers any snapshot that is still waiting
+ * and JOINS the delivery thread, so the destructor may wait for the subscriber's
+ * callback to return. It must therefore not be called from that callback.
+ */
+StatsCalculator::~StatsCalculator(){
+    // The members' own destructors release everything, including the observer's thread.
+}
+
+/** Public method returns every statistic of the internally stored numeric
+ * values.
+ *
+ * The statistics of the stored (or viewed) values are computed by the private
+ * computeStatistics() method. If any values were added while streaming was
+ * enabled, their accumulated statistics are then merged in. The result is
+ * cached, so that repeated calls (e.g. the three getters below, or repeated
+ * polling through the C API) do not repeat the pass over the data. The cache is
+ * discarded whenever values are appended or read. The statistics of a view are
+ * never cached because the caller may update the viewed array.
+ *
+ * \return An immutable reference to the cached statistics, which remains valid
+ * until the next non-const method call on this instance.
+ */
+const StatsResult & StatsCalculator::getStatistics(){
+    if(!cachedStatisticsValid){
+        computeStatistics(valuesData(), valuesCount(), cachedStatistics, nonFiniteMode);
+        if(streamedStatistics.count > 0){
+            RunningStatistics combined(streamedStatistics);
+            combined.merge(cachedStatistics);
+            combined.fill(cachedStatistics);
+        }
+        cachedStatisticsValid = !isView();
+    }
+    return cachedStatistics;
+}
+
+/** Public method returns the sum of the internally stored numeric values.
+ *
+ * \note The method delegates the computation of the required sum to the
+ * getStatistics() method.
+ *
+ * \return The computed sum is returned as a double-precision value.
+ */
+double StatsCalculator::getSum(){
+    return getStatistics().sum;
+}
+
+
+/** Public method returns the mean of the internally stored numeric values.
+ *
+ * \note The method delegates the computation of the required mean to the
+ * getStatistics() method.
+ *
+ * \return The computed mean is returned as a double-precision value.
+ */
+double StatsCalculator::getMean(){
+    return getStatistics().mean;
+}
+
+
+/** Public method returns the standard deviation of the internally stored
+ * numeric values.
+ *
+ * \note The method delegates the computation of the required standard deviation
+ * to the getStatistics() method.
+ *
+ * \return The computed standard deviation is returned as a double-precision value.
+ */
+double StatsCalculator::getStandardDeviation(){
+    return getStatistics().standardDeviation;
+}
+
+/** Public method that returns the values that contribute to the statistics,
+ * sorted into ascending order.
+ *
+ * The stored (or viewed) values are copied, discarding any that the non-finite
+ * mode excludes, and the copy is sorted by radixSortValues(). NaN values have
+ * no place in the numerical order, so they are set aside before sorting and
+ * appended (as quiet NaNs) afterwards. The sorted view is cached until the
+ * stored values or the non-finite mode change, in the same way as the
+ * statistics; the sorted view of a caller-owned array is never cached.
+ *
+ * \note Values that were added while streaming was enabled are not stored, so
+ * they are not included.
+ *
+ * \return An immutable reference to the sorted values, which remains valid
+ * until the next non-const method call on this instance.
+ */
+const std::vector<double> & StatsCalculator::getSortedValues(){
+    if(!sortedValuesValid){
+        const double * values = valuesData();
+        const size_t count = valuesCount();
+        sortedValues.clear();
+        sortedValues.reserve(count);
+        size_t nanCount = 0;
+        for(size_t index = 0; index < count; ++index){
+            const double value = values[index];
+            if(isExcluded(value)){
+                continue;
+            }
+            if(value != value){
+                ++nanCount;
+                continue;
+            }
+            sortedValues.push_back(value);
+        }
+        radixSortValues(sortedValues);
+        sortedValues.insert(sortedValues.end(), nanCount, std::numeric_limits<double>::quiet_NaN());
+        sortedValuesValid = !isView();
+    }
+    return sortedValues;
+}
+
+/** Public method that returns an exact quantile of the values in the sorted
+ * view.
+ *
+ * The quantile is found by linear interpolation between the two closest values
+ * of the sorted view (the definition used by default in R, NumPy and
+ * spreadsheet software). For n values \f$x_{(0)} \le \ldots \le x_{(n-1)}\f$
+ * and a probability p, the position \f$h = p(n-1)\f$ is computed and the
+ * result is \f$x_{(\lfloor h \rfloor)} + (h - \lfloor h \rfloor)(x_{(\lfloor h \rfloor + 1)} - x_{(\lfloor h \rfloor)})\f$.
+ *
+ * \param probability - The probability, between zero and one. For example, 0.5
+ * gives the median.
+ *
+ * \return The quantile. If there are no values it is zero, and if the
+ * probability is outside [0, 1] or the sorted view contains a NaN it is NaN.
+ */
+double StatsCalculator::getQuantile(double probability){
+    const std::vector<double> & sorted = getSortedValues();
+    if(!(probability >= 0.0 && probability <= 1.0)){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if(sorted.empty()){
+        return 0.0;
+    }
+    if(sorted.back() != sorted.back()){
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double position = probability*(sorted.size() - 1);
+    const size_t lower = static_cast<size_t>(position);
+    if(lower + 1 >= sorted.size()){
+        return sorted[lower];
+    }
+    return sorted[lower] + (position - lower)*(sorted[lower + 1] - sorted[lower]);
+}
+
+/** Public method that returns statistics that are insensitive to outliers.
+ *
+ * If the quantile sketch is enabled and values have been streamed into it, the
+ * statistics are estimated from a copy of the sketch into which any stored
+ * values are also added (see QuantileSketch::fill()). Otherwise they are
+ * computed exactly from the stored (or viewed) values by
+ * computeRobustStatistics(), which selects the values it needs rather than
+ * sorting them all. Values that the non-finite mode excludes are discarded
+ * first; if any NaN values remain, every statistic is NaN, just as the mean is.
+ *
+ * The result is cached, like that of getStatistics(), together with the trim
+ * fraction it was computed for.
+ *
+ * \note Values that were streamed while the sketch was disabled are not
+ * stored, so they are not included. The "count" member reports how many
+ * values the statistics describe.
+ *
+ * \param trimFraction - The fraction of the values to trim (or winsorize) from
+ * EACH end, which is clamped to the range [0, 0.5].
+ *
+ * \return An immutable reference to the cached statistics, which remains valid
+ * until the next non-const method call on this instance.
+ */
+const StatsRobustResult & StatsCalculator::getRobustStatistics(double trimFraction){
+    trimFraction = trimFraction > 0.0 ? (trimFraction < 0.5 ? trimFraction : 0.5) : 0.0;
+    if(!cachedRobustStatisticsValid || cachedRobustStatistics.trimFraction != trimFraction){
+        const double * values = valuesData();
+        const size_t count = valuesCount();
+        if(sketchEnabled && streamedSketch.getCount() > 0){
+            QuantileSketch combined(streamedSketch);
+            for(size_t index = 0; index < count; ++index){
+                if(!isExcluded(values[index])){
+                    combined.add(values[index]);
+                }
+            }
+            combined.fill(cachedRobustStatistics, trimFraction);
+        }
+        else{
+            std::vector<double> selected;
+            selected.reserve(count);
+            long long nanCount = 0;
+            for(size_t index = 0; index < count; ++index){
+                const double value = values[index];
+                if(isExcluded(value)){
+                    continue;
+                }
+                if(value != value){
+                    ++nanCount;
+                    continue;
+                }
+                selected.push_back(value);
+            }
+            computeRobustStatistics(selected, trimFraction, cachedRobustStatistics);
+            if(nanCount > 0){
+                const double nan = std::numeric_limits<double>::quiet_NaN();
+                cachedRobustStatistics.count += nanCount;
+                cachedRobustStatistics.median = nan;
+                cachedRobustStatistics.medianAbsoluteDeviation = nan;
+                cachedRobustStatistics.trimmedMean = nan;
+                cachedRobustStatistics.winsorizedMean = nan;
+                cachedRobustStatistics.winsorizedVariance = nan;
+            }
+        }
+        cachedRobustStatisticsValid = !isView();
+    }
+    return cachedRobustStatistics;
+}
+
+/** Public method returns the median of the internally stored numeric values.
+ *
+ * \note The method delegates the computation to the getRobustStatistics() method.
+ *
+ * \return The median is returned as a double-precision value.
+ */
+double StatsCalculator::getMedian(){
+    return getRobustStatistics().median;
+}
+
+/** Public method returns the median absolute deviation of the internally stored
+ * numeric values from their median. For normally distributed values, multiplying
+ * it by 1.4826 gives an estimate of the standard deviation.
+ *
+ * \note The method delegates the computation to the getRobustStatistics() method.
+ *
+ * \return The median absolute deviation is returned as a double-precision value.
+ */
+double StatsCalculator::getMedianAbsoluteDeviation(){
+    return getRobustStatistics().medianAbsoluteDeviation;
+}
+
+/** Public method returns the trimmed mean of the internally stored numeric values.
+ *
+ * \note The method delegates the computation to the getRobustStatistics() method.
+ *
+ * \param trimFraction - The fraction of the values to discard from each end.
+ *
+ * \return The trimmed mean is returned as a double-precision value.
+ */
+double StatsCalculator::getTrimmedMean(double trimFraction){
+    return getRobustStatistics(trimFraction).trimmedMean;
+}
+
+/** Public method returns the winsorized mean of the internally stored numeric
+ * values.
+ *
+ * \note The method delegates the computation to the getRobustStatistics() method.
+ *
+ * \param trimFraction - The fraction of the values at each end to replace by the
+ * nearest remaining value.
+ *
+ * \return The winsorized mean is returned as a double-precision value.
+ */
+double StatsCalculator::getWinsorizedMean(double trimFraction){
+    return getRobustStatistics(trimFraction).winsorizedMean;
+}
+
+/** Public method returns the (population) variance of the winsorized internally
+ * stored numeric values.
+ *
+ * \note The method delegates the computation to the getRobustStatistics() method.
+ *
+ * \param trimFraction - The fraction of the values at each end to replace by the
+ * nearest remaining value.
+ *
+ * \return The winsorized variance is returned as a double-precision value.
+ */
+double StatsCalculator::getWinsorizedVariance(double trimFraction){
+    return getRobustStatistics(trimFraction).winsorizedVariance;
+}
+
+/** Public method returns bootstrap confidence intervals for the mean and the
+ * standard deviation of the internally stored numeric values.
+ *
+ * The values that the non-finite mode discards are removed first by
+ * selectValues(), and the remaining values are resampled by a
+ * StatsBootstrap configured with the options from setBootstrapOptions(). If
+ * any of the remaining values is NaN or infinite, so are the mean and standard
+ * deviation of almost every resample, and every interval is reported as NaN
+ * without resampling. The result is cached like the other statistics.
+ *
+ * \return An immutable reference to the cached intervals, which remains valid
+ * until the next non-const method call on this instance.
+ */
+const StatsBootstrapResult & StatsCalculator::getBootstrapIntervals(){
+    if(!cachedBootstrapResultValid){
+        std::vector<double> selected;
+        const double * values;
+        size_t count;
+        if(selectValues(selected, values, count)){
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            cachedBootstrapResult.count = static_cast<long long>(count);
+            cachedBootstrapResult.resampleCount = bootstrapResampleCount;
+            cachedBootstrapResult.confidenceLevel = bootstrapConfidenceLevel;
+            cachedBootstrapResult.meanLower = nan;
+            cachedBootstrapResult.meanUpper = nan;
+            cachedBootstrapResult.meanStandardError = nan;
+            cachedBootstrapResult.standardDeviationLower = nan;
+            cachedBootstrapResult.standardDeviationUpper = nan;
+            cachedBootstrapResult.standardDeviationStandardError = nan;
+        }
+        else{
+            StatsBootstrap bootstrap(bootstrapResampleCount, bootstrapConfidenceLevel, bootstrapSeed);
+            bootstrap.computeIntervals(values, count, cachedBootstrapResult);
+        }
+        cachedBootstrapResultValid = !isView();
+    }
+    return cachedBootstrapResult;
+}
+
+/** Public method returns the autocorrelation statistics of the internally stored
+ * numeric values, in the order in which they were appended.
+ *
+ * The values that the non-finite mode discards are removed first by
+ * selectValues(), and the remaining values are analysed by a
+ * StatsAutocorrelation. If any of the remaining values is NaN or infinite,
+ * every statistic except the count is reported as NaN without analysing them.
+ * The result is cached like the other statistics.
+ *
+ * \return An immutable reference to the cached statistics, which remains valid
+ * until the next non-const method call on this instance.
+ */
+const StatsAutocorrelationResult & StatsCalculator::getAutocorrelationStatistics(){
+    if(!cachedAutocorrelationResultValid){
+        std::vector<double> selected;
+        const double * values;
+        size_t count;
+        if(selectValues(selected, values, count)){
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            cachedAutocorrelationResult.count = static_cast<long long>(count);
+            cachedAutocorrelationResult.mean = nan;
+            cachedAutocorrelationResult.variance = nan;
+            cachedAutocorrelationResult.integratedAutocorrelationTime = nan;
+            cachedAutocorrelationResult.window = 0;
+            cachedAutocorrelationResult.windowConverged = 0;
+            cachedAutocorrelationResult.effectiveSampleSize = nan;
+            cachedAutocorrelationResult.naiveStandardError = nan;
+            cachedAutocorrelationResult.standardErrorOfMean = nan;
+            cachedAutocorrelationResult.blockingStandardError = nan;
+            cachedAutocorrelationResult.blockingLevel = 0;
+            cachedAutocorrelationResult.blockingConverged = 0;
+        }
+        else{
+            StatsAutocorrelation autocorrelation;
+            autocorrelation.analyze(values, count, cachedAutocorrelationResult);
+        }
+        cachedAutocorrelationResultValid = !isView();
+    }
+    return cachedAutocorrelationResult;
+}
+
+/** Public method returns the integrated autocorrelation time of the internally
+ * stored numeric values, \f$\tau = 1 + 2\sum_{t=1}^{W} \rho(t)\f$.
+ *
+ * \return The integrated autocorrelation time is returned as a double-precision value.
+ */
+double StatsCalculator::getIntegratedAutocorrelationTime(){
+    return getAutocorrelationStatistics().integratedAutocorrelationTime;
+}
+
+/** Public method returns the number of independent values that the internally
+ * stored numeric values are worth: their number divided by the integrated
+ * autocorrelation time.
+ *
+ * \return The effective sample size is returned as a double-precision value.
+ */
+double StatsCalculator::getEffectiveSampleSize(){
+    return getAutocorrelationStatistics().effectiveSampleSize;
+}
+
+/** Public method that returns the autocorrelations of the internally stored
+ * numeric values at lags 0 to lagCount - 1. The values are selected as for
+ * getAutocorrelationStatistics(), but the autocorrelations are not cached,
+ * because each call may ask for a different number of lags.
+ *
+ * \param lagCount - The number of lags.
+ *
+ * \return The autocorrelations.
+ */
+std::vector<double> StatsCalculator::getAutocorrelations(size_t lagCount){
+    std::vector<double> autocorrelations(lagCount, 0.0);
+    std::vector<double> selected;
+    const double * values;
+    size_t count;
+    if(selectValues(selected, values, count)){
+        std::fill(autocorrelations.begin(), autocorrelations.end(), std::numeric_limits<double>::quiet_NaN());
+    }
+    else if(count > 0 && lagCount > 0){
+        StatsAutocorrelation autocorrelation;
+        autocorrelation.computeAutocorrelations(values, count, lagCount, &autocorrelations[0]);
+    }
+    return autocorrelations;
+}
+
+/** Public method returns an estimate of the number of distinct finite values
+ * that were accumulated while the frequency sketches were enabled (see
+ * DistinctCountSketch::estimate()). Its relative standard error is about 2%.
+ *
+ * \return The estimate is returned as a double-precision value.
+ */
+double StatsCalculator::getDistinctCount() const{
+    return distinctSketch.estimate();
+}
+
+/** Public method that returns an upper bound on the number of times a value was
+ * accumulated while the frequency sketches were enabled (see
+ * FrequencySketch::estimate()).
+ *
+ * \param value - The value.
+ */
+long long StatsCalculator::estimateFrequency(double value) const{
+    return frequencySketch.estimate(value);
+}
+
+/** Public method that returns the most frequent of the values that were
+ * accumulated while the frequency sketches were enabled (see
+ * FrequencySketch::getHeavyHitters()).
+ *
+ * \param count - The largest number of values to return.
+ *
+ * \return The values, in descending order of their estimated counts.
+ */
+std::vector<StatsHeavyHitter> StatsCalculator::getHeavyHitters(size_t count) const{
+    std::vector<StatsHeavyHitter> hitters;
+    frequencySketch.getHeavyHitters(count, hitters);
+    return hitters;
+}
+
+/** Public method that returns the sketch that estimates the number of distinct
+ * values. Sketches from several instances (e.g. one per thread or shard) can be
+ * combined with DistinctCountSketch::merge() or mergeFrequencySketches().
+ */
+const DistinctCountSketch & StatsCalculator::getDistinctCountSketch() const{
+    return distinctSketch;
+}
+
+/** Public method that returns the sketch that estimates the most frequent values.
+ * Sketches from several instances can be combined with FrequencySketch::merge()
+ * or mergeFrequencySketches().
+ */
+const FrequencySketch & StatsCalculator::getFrequencySketch() const{
+    return frequencySketch;
+}
+
+/** Public method that returns the reservoir sample: a uniformly random sample of
+ * the values that were appended, parsed or streamed while sampling was enabled.
+ * Its "values" member holds the sampled values and its "count" member the
+ * number of values they were sampled from. Reservoirs from several instances
+ * can be combined with mergeReservoirSample().
+ */
+const ReservoirSample & StatsCalculator::getReservoirSample() const{
+    return reservoir;
+}
+
+/** Public method that makes this instance a view over a caller-owned array,
+ * discarding any values it currently stores.
+ *
+ * \param values - A pointer to the first element of a caller-owned array of
+ * double precision values. The array must remain valid for as long as the
+ * instance views it.
+ * \param count - The number of elements in the array.
+ */
+void StatsCalculator::wrapValues(const double * values, size_t count){
+    // Discard the stored values, releasing the memory that held them.
+    reset(true);
+    externalValues = values;
+    externalCount = count;
+    if(frequencySketchesEnabled){
+        distinctSketch.add(values, count);
+        frequencySketch.add(values, count);
+    }
+    reservoir.add(values, count);
+    publishUpdates(0);
+}
+
+/** Public method that returns true if this instance is currently a view
+ * over a caller-owned array.
+ */
+bool StatsCalculator::isView() const{
+    return externalValues != 0;
+}
+
+/** Public method that discards all stored values (and any view), returning the
+ * instance to the state of a newly constructed one.
+ *
+ * The clear() method of std::vector destroys the elements but keeps the memory
+ * that held them (the vector's CAPACITY), so subsequent calls to appendValue()
+ * or readFile() do not need to allocate until that capacity is exhausted.
+ *
+ * \note The streaming setting, the quantile sketch setting, the size and seed of
+ * the reservoir sample, the resolutions of the time buckets, the method, parameters
+ * and callback of the change detector, the subscription to snapshots, whether live
+ * statistics are published, the parse policy and the non-finite mode are not
+ * changed. If live statistics are published, the empty statistics are published.
+ * An incremental ingest that is in progress is abandoned.
+ *
+ * \param releaseMemory - If true, the memory that held the values (and the
+ * sorted view of them) is released too. This is done by swapping "numericValues"
+ * with an empty temporary vector, whose destructor then frees the memory.
+ */
+void StatsCalculator::reset(bool releaseMemory){
+    if(releaseMemory){
+        std::vector<double>().swap(numericValues);
+        std::vector<double>().swap(sortedValues);
+    }
+    else{
+        numericValues.clear();
+        sortedValues.clear();
+    }
+    externalValues = 0;
+    externalCount = 0;
+    streamedStatistics = RunningStatistics();
+    weightedStatistics = WeightedRunningStatistics();
+    bivariateStatistics = BivariateRunningStatistics();
+    streamedSketch.reset();
+    distinctSketch.reset();
+    frequencySketch.reset();
+    reservoir.reset();
+    timeRollup.reset();
+    changeDetector.reset();
+    forgetObservedValues();
+    unpublishedCount = 0;
+    incrementalIngest.reset();
+    discardCachedResults();
+    clearParseReport();
+    publishUpdates(0);
+}
+
+
+/**  Public method that accepts a appends a new double precision value to
+ * the "numericValues" member datum.
+ *
+ * \param value - A double precision value to append to the "numericValues" member
+ * datum.
+ *
+ * \note If this instance is a view, the viewed values are first copied into
+ * "numericValues".
+ */
+void StatsCalculator::appendValue(double value){
+    // A view cannot be appended to, so first take a copy of the viewed values.
+    detachView();
+    consumeValue(value);
+    // The cached statistics no longer describe the stored values.
+    discardCachedResults();
+    publishUpdates(1);
+}
+
+/** Public method that appends every element of an array of double precision
+ * values.
+ *
+ * If streaming is enabled, the statistics of the whole array are computed with
+ * a single call to computeStatistics() and then merged into "streamedStatistics",
+ * which is considerably faster than accumulating the values one at a time.
+ * Otherwise the array is copied onto the end of "numericValues" with a single
+ * call to the insert() method of std::vector.
+ *
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array.
+ */
+void StatsCalculator::appendValues(const double * values, size_t count){
+    if(count == 0){
+        return;
+    }
+    detachView();
+    if(frequencySketchesEnabled){
+        distinctSketch.add(values, count);
+        frequencySketch.add(values, count);
+    }
+    reservoir.add(values, count);
+    changeDetector.add(values, count);
+    if(streaming){
+        StatsResult batch;
+        computeStatistics(values, count, batch, nonFiniteMode);
+        streamedStatistics.merge(batch);
+        if(sketchEnabled){
+            streamedSketch.add(values, count);
+        }
+    }
+    else{
+        numericValues.insert(numericValues.end(), values, values + count);
+    }
+    discardCachedResults();
+    publishUpdates(count);
+}
+
+/** Public method that appends a single value together with its weight.
+ *
+ * \param value - The value, which is appended (or streamed) like any other.
+ * \param weight - Its weight, which is accumulated into "weightedStatistics".
+ */
+void StatsCalculator::appendWeightedValue(double value, double weight){
+    appendValue(value);
+    if(!isExcluded(value)){
+        weightedStatistics.add(value, weight);
+    }
+}
+
+/** Public method that appends every element of an array of values together with
+ * the corresponding element of an array of weights.
+ *
+ * The values are appended (or streamed) by appendValues(), so they contribute to
+ * the unweighted statistics like any other. The weighted statistics of the batch
+ * are computed in a single vectorizable pass by computeWeightedStatistics() and
+ * merged into "weightedStatistics". The weights themselves are not stored.
+ *
+ * \param values - A pointer to the first element of the array of values.
+ * \param weights - A pointer to the first element of the array of weights. Values
+ * whose weights are not positive and finite only contribute to the unweighted
+ * statistics.
+ * \param count - The number of elements in each array.
+ */
+void StatsCalculator::appendWeightedValues(const double * values, const double * weights, size_t count){
+    if(count == 0){
+        return;
+    }
+    appendValues(values, count);
+    WeightedRunningStatistics batch;
+    computeWeightedStatistics(values, weights, count, batch, nonFiniteMode);
+    weightedStatistics.merge(batch);
+}
+
+/** Public method that returns the weighted statistics of every value that was
+ * appended with a weight (by appendWeightedValue(), appendWeightedValues() or
+ * ingestWeightedFile()).
+ */
+StatsWeightedResult StatsCalculator::getWeightedStatistics() const{
+    StatsWeightedResult result;
+    weightedStatistics.fill(result);
+    return result;
+}
+
+/** Public method that accumulates a single pair of values from two channels into
+ * "bivariateStatistics". Pairs are not stored and do not contribute to the
+ * (univariate) statistics of the stored values.
+ *
+ * \param x - The value from the first channel.
+ * \param y - The value from the second channel.
+ */
+void StatsCalculator::appendPair(double x, double y){
+    if(!isExcluded(x) && !isExcluded(y)){
+        bivariateStatistics.add(x, y);
+    }
+}
+
+/** Public method that accumulates the pairs of values in two parallel arrays. The
+ * statistics of the batch are computed in a single vectorizable pass by
+ * computeBivariateStatistics() and merged into "bivariateStatistics".
+ *
+ * \param x - A pointer to the first element of the first channel.
+ * \param y - A pointer to the first element of the second channel.
+ * \param count - The number of elements in each array.
+ */
+void StatsCalculator::appendPairs(const double * x, const double * y, size_t count){
+    if(count == 0){
+        return;
+    }
+    BivariateRunningStatistics batch;
+    computeBivariateStatistics(x, y, count, batch, nonFiniteMode);
+    bivariateStatistics.merge(batch);
+}
+
+/** Public method that returns the accumulator that summarizes every pair that has
+ * been appended. Accumulators from several instances (e.g. one per thread) can be
+ * combined with BivariateRunningStatistics::merge().
+ */
+const BivariateRunningStatistics & StatsCalculator::getBivariateAccumulator() const{
+    return bivariateStatistics;
+}
+
+/** Public method that returns the covariance, correlation and least-squares line
+ * of every pair that has been appended.
+ */
+StatsBivariateResult StatsCalculator::getBivariateStatistics() const{
+    StatsBivariateResult result;
+    bivariateStatistics.fill(result);
+    return result;
+}
+
+/** Public method that sets the resolutions of the buckets of time into which
+ * timestamped values are divided (see TimeRollup::configure()). Any buckets that
+ * have been recorded are discarded.
+ *
+ * \param widths - The widths of the buckets, in ascending order, or an empty
+ * vector to disable the buckets.
+ *
+ * \return True on success, or false (and no change) if the widths do not form a
+ * cascade.
+ */
+bool StatsCalculator::setTimeResolutions(const std::vector<double> & widths){
+    return timeRollup.configure(widths);
+}
+
+/** Public method that appends a single value together with its timestamp. The
+ * value is appended (or streamed) like any other and, unless the non-finite mode
+ * excludes it, added to the buckets of time.
+ *
+ * \param time - The timestamp.
+ * \param value - The value.
+ */
+void StatsCalculator::appendTimedValue(double time, double value){
+    appendValue(value);
+    if(!isExcluded(value)){
+        timeRollup.add(time, value);
+    }
+}
+
+/** Public method that appends the values in an array, together with the
+ * timestamps in a parallel array. The values are appended (or streamed)
+ * together by appendValues(), and then added to the buckets of time. Each run
+ * of consecutive values whose timestamps fall within the open bucket of the
+ * finest resolution is summarized by computeStatistics() and merged into it, so
+ * the work per value is a pair of comparisons and a share of a vectorized pass.
+ *
+ * \param times - A pointer to the first element of the array of timestamps.
+ * \param values - A pointer to the first element of the array of values.
+ * \param count - The number of elements in each array.
+ */
+void StatsCalculator::appendTimedValues(const double * times, const double * values, size_t count){
+    if(count == 0){
+        return;
+    }
+    appendValues(values, count);
+    if(timeRollup.widths.empty()){
+        return;
+    }
+    size_t index = 0;
+    while(index < count){
+        // Consecutive values in the open bucket are summarized together by the vectorizable kernel.
+        const size_t run = timeRollup.openRun(times + index, count - index);
+        if(run > 0){
+            StatsResult batch;
+            computeStatistics(values + index, run, batch, nonFiniteMode);
+            timeRollup.open[0].merge(batch);
+            index += run;
+            continue;
+        }
+        if(!isExcluded(values[index])){
+            timeRollup.add(times[index], values[index]);
+        }
+        ++index;
+    }
+}
+
+/** Public method that completes every open bucket of time (see TimeRollup::flush()).
+ */
+void StatsCalculator::flushTimeBuckets(){
+    timeRollup.flush();
+}
+
+/** Public method that returns the accumulator that divides timestamped values into
+ * buckets of time.
+ */
+const TimeRollup & StatsCalculator::getTimeRollup() const{
+    return timeRollup;
+}
+
+/** Public method that removes and returns the oldest of the completed buckets at
+ * one resolution. The remaining buckets are moved to the front of the vector
+ * that holds them, which costs little when (as usual) every bucket is taken.
+ *
+ * \param resolution - The index of the resolution.
+ * \param maxCount - The largest number of buckets to return.
+ *
+ * \return The buckets, oldest first.
+ */
+std::vector<StatsTimeBucket> StatsCalculator::takeTimeBuckets(size_t resolution, size_t maxCount){
+    std::vector<StatsTimeBucket> buckets;
+    if(resolution < timeRollup.completed.size()){
+        std::vector<StatsTimeBucket> & completed = timeRollup.completed[resolution];
+        const size_t taken = completed.size() < maxCount ? completed.size() : maxCount;
+        buckets.assign(completed.begin(), completed.begin() + taken);
+        completed.erase(completed.begin(), completed.begin() + taken);
+    }
+    return buckets;
+}
+
+/** Public method that writes the records of the completed buckets of time to a
+ * text file. Each resolution is introduced by a comment line (starting with '#')
+ * that names the columns, followed by one line per bucket, oldest first:
+ *
+ *     width start count mean standardDeviation minimum maximum
+ *
+ * so the file can be plotted directly (e.g. by gnuplot, which skips the comment
+ * lines). The values are written with 17 significant digits, so they can be read
+ * back exactly.
+ *
+ * \param outfileName - A string specifying the path of the output file. If the
+ * file exists it is overwritten.
+ *
+ * \return True if the file was opened successfully, otherwise false.
+ */
+bool StatsCalculator::writeTimeBuckets(const std::string & outfileName) const{
+    std::ofstream outputFile(outfileName.c_str());
+    if(!(outputFile.is_open() && outputFile.good())){
+        return false;
+    }
+    outputFile.precision(17);
+    for(size_t resolution = 0; resolution < timeRollup.completed.size(); ++resolution){
+        const std::vector<StatsTimeBucket> & buckets = timeRollup.completed[resolution];
+        outputFile << "# width start count mean standardDeviation minimum maximum ("
+        << buckets.size() << " buckets of width " << timeRollup.widths[resolution] << ")\n";
+        for(size_t index = 0; index < buckets.size(); ++index){
+            const StatsResult & statistics = buckets[index].statistics;
+            outputFile << buckets[index].width << ' ' << buckets[index].start << ' ' << statistics.count << ' '
+            << statistics.mean << ' ' << statistics.standardDeviation << ' ' << statistics.minimum << ' '
+            << statistics.maximum << '\n';
+        }
+    }
+    outputFile.close();
+    return true;
+}
+
+/** Public method that enables or disables change detection (see
+ * ChangeDetector::configure()). Any earlier detections are forgotten.
+ *
+ * \param method - One of the StatsCalcChangeMethod values.
+ * \param threshold - The threshold h, in standard deviations.
+ * \param drift - The drift k, in standard deviations.
+ * \param warmupCount - The number of warm-up values.
+ *
+ * \return True on success, or false (and no change) if a parameter is out of range.
+ */
+bool StatsCalculator::setChangeDetection(StatsCalcChangeMethod method, double threshold, double drift,
+                                         long long warmupCount){
+    return changeDetector.configure(method, threshold, drift, warmupCount);
+}
+
+/** Public method that registers a function to be called whenever a change is
+ * detected. The function must not use this instance: it is called while a value
+ * is being appended to it.
+ *
+ * \param callback - The function, or null to call none.
+ * \param userData - A pointer that is passed to the function.
+ */
+void StatsCalculator::setChangeCallback(StatsCalcChangeCallback callback, void * userData){
+    changeDetector.callback = callback;
+    changeDetector.userData = userData;
+}
+
+/** Public method that returns the most recently detected change, if one has been
+ * detected since the previous call. If several changes were detected in the
+ * meantime, only the last is returned; getChangeCount() counts them all.
+ *
+ * \param change - A StatsChangePoint structure that receives the change.
+ *
+ * \return True if a change was taken, otherwise false.
+ */
+bool StatsCalculator::takeChangePoint(StatsChangePoint & change){
+    if(!changeDetector.pending){
+        return false;
+    }
+    change = changeDetector.lastChange;
+    changeDetector.pending = false;
+    return true;
+}
+
+/** Public method that returns the number of changes that have been detected since
+ * change detection was configured (or the instance was reset).
+ */
+long long StatsCalculator::getChangeCount() const{
+    return changeDetector.detections;
+}
+
+/** Public method that subscribes a function to snapshots of the statistics.
+ *
+ * Any previous subscription is cancelled first, which delivers its last snapshot
+ * and stops its thread, so the previous function is never called after this
+ * method returns. A new StatsObserver then starts the thread of the subscription.
+ *
+ * \param callback - The function.
+ * \param userData - A pointer that is passed to the function.
+ * \param everySamples - The number of values after which a snapshot is posted,
+ * or zero.
+ * \param everyMilliseconds - The period, in milliseconds, with which snapshots
+ * are posted, or zero.
+ *
+ * \return True on success, or false (and no change) if a parameter is out of
+ * range.
+ */
+bool StatsCalculator::subscribe(StatsCalcSnapshotCallback callback, void * userData, long long everySamples,
+                                unsigned everyMilliseconds){
+    if(callback == 0 || everySamples < 0 || (everySamples == 0 && everyMilliseconds == 0)){
+        return false;
+    }
+    observer.reset();
+    observer.reset(new StatsObserver(callback, userData, everySamples, everyMilliseconds));
+    unpublishedCount = 0;
+    return true;
+}
+
+/** Public method that cancels the subscription, if any. Releasing the
+ * StatsObserver delivers its last snapshot and stops its thread, so the function
+ * is never called after this method returns.
+ */
+void StatsCalculator::unsubscribe(){
+    observer.reset();
+}
+
+/** Public method that returns true if a function is subscribed to snapshots of
+ * the statistics.
+ */
+bool StatsCalculator::isSubscribed() const{
+    return static_cast<bool>(observer);
+}
+
+/** Public method that posts a snapshot of the current statistics to the
+ * subscribed function, if any.
+ *
+ * Snapshots are taken far more often than the statistics are otherwise needed,
+ * so a snapshot does not repeat the pass over every stored value that
+ * getStatistics() makes. Instead, summarizeValues() only summarizes the values
+ * that were stored since the previous snapshot.
+ */
+void StatsCalculator::publishStatistics(){
+    if(!observer){
+        return;
+    }
+    RunningStatistics summary;
+    summarizeValues(summary);
+    StatsResult snapshot;
+    summary.fill(snapshot);
+    observer->publish(snapshot);
+    unpublishedCount = 0;
+}
+
+/** Public method that enables or disables the publication of live statistics.
+ * When they are enabled, the current statistics are published immediately.
+ * When they are disabled, the statistics that were last published remain
+ * readable, but are no longer updated.
+ *
+ * \param enabled - True to publish the statistics, false to stop.
+ */
+void StatsCalculator::setLiveStatisticsEnabled(bool enabled){
+    liveStatisticsEnabled = enabled;
+    publishUpdates(0);
+}
+
+/** Public method that returns true if live statistics are published.
+ */
+bool StatsCalculator::isLiveStatisticsEnabled() const{
+    return liveStatisticsEnabled;
+}
+
+/** Public method that returns the structure to which the live statistics are
+ * published. It is a member of this instance, so it never moves while the
+ * instance exists.
+ */
+const StatsLiveStatistics & StatsCalculator::getLiveStatistics() const{
+    return liveStatistics;
+}
+
+/** Public method that publishes a tag with the live statistics, using
+ * StatsLiveStatistics::setTag(). It must be called by the thread that appends
+ * values, since the structure only has one writer at a time.
+ *
+ * \param tag - The tag, or -1 to clear it.
+ */
+void StatsCalculator::setLiveStatisticsTag(int tag){
+    liveStatistics.setTag(tag);
+}
+
+/** Public method that enables or disables streaming.
+ *
+ * When streaming is enabled, any values that are currently stored (or viewed)
+ * are accumulated into "streamedStatistics" and the memory that held them is
+ * released, so that memory use no longer depends on the number of values.
+ * Disabling streaming only affects values that are added subsequently.
+ *
+ * \param enabled - True to enable streaming, false to resume storing values.
+ */
+void StatsCalculator::setStreaming(bool enabled){
+    if(enabled && !streaming){
+        StatsResult stored;
+        computeStatistics(valuesData(), valuesCount(), stored, nonFiniteMode);
+        streamedStatistics.merge(stored);
+        if(sketchEnabled){
+            streamedSketch.add(valuesData(), valuesCount());
+        }
+        std::vector<double>().swap(numericValues);
+        externalValues = 0;
+        externalCount = 0;
+        forgetObservedValues();
+        discardCachedResults();
+    }
+    streaming = enabled;
+    publishUpdates(0);
+}
+
+/** Public method that returns true if streaming is enabled.
+ */
+bool StatsCalculator::isStreaming() const{
+    return streaming;
+}
+
+/** Public method that enables or disables the quantile sketch.
+ *
+ * Values that were streamed before the sketch was enabled have already been
+ * summarized, so they cannot be added to it. Disabling the sketch discards it,
+ * and the robust statistics then describe only the stored values.
+ *
+ * \param enabled - True to enable the sketch, false to disable it.
+ */
+void StatsCalculator::setQuantileSketchEnabled(bool enabled){
+    if(!enabled){
+        streamedSketch.reset();
+    }
+    sketchEnabled = enabled;
+    cachedRobustStatisticsValid = false;
+}
+
+/** Public method that returns true if the quantile sketch is enabled.
+ */
+bool StatsCalculator::isQuantileSketchEnabled() const{
+    return sketchEnabled;
+}
+
+/** Public method that enables or disables the frequency sketches.
+ *
+ * The values that are currently stored (or viewed) are added when the sketches
+ * are enabled. Values that were streamed before then have already been
+ * summarized, so they cannot be added. Disabling the sketches discards them,
+ * releasing their memory.
+ *
+ * \param enabled - True to enable the sketches, false to disable them.
+ */
+void StatsCalculator::setFrequencySketchesEnabled(bool enabled){
+    if(enabled && !frequencySketchesEnabled){
+        distinctSketch.add(valuesData(), valuesCount());
+        frequencySketch.add(valuesData(), valuesCount());
+    }
+    else if(!enabled){
+        distinctSketch.reset();
+        frequencySketch.reset();
+    }
+    frequencySketchesEnabled = enabled;
+}
+
+/** Public method that returns true if the frequency sketches are enabled.
+ */
+bool StatsCalculator::areFrequencySketchesEnabled() const{
+    return frequencySketchesEnabled;
 }
 
-/** Private method that actually computes the standard deviation of the
- * stored numeric values.
- *
- * \return The computed standard deviation is returned as a double-precision value.
+/** Public method that merges the frequency sketches of another instance into
+ * those of this instance (see DistinctCountSketch::merge() and
+ * FrequencySketch::merge()). Only the sketches change: the merged values are
+ * not added to the stored values or to any other statistic.
  *
- * The standard deviation of a sequence of numbers is can be computed
- * as the square root of the difference between the mean of the squares
- * of the numbers and the square of the mean of the numbers.
+ * \param distinct - The other instance's DistinctCountSketch.
+ * \param frequency - The other instance's FrequencySketch.
  *
- * \f[ \sigma = \sqrt{\langle X^{2} \rangle - \langle X \rangle^{2}} \f]
+ * \return True on success, or false (and no change) if the frequency sketches
+ * of this instance are disabled.
  */
-double StatsCalculator::computeStandardDeviation(){
-    
-    // If any numeric values were successfully parsed from the input file...
-    if(numericValues.size() > 0){
-        
-        /* Declare and zero-initialize a double precision variable with
-         * identifier "meanOfSquaredValues" that will ultimately contain
-         * the mean of the squares of the elements of the "numericValues"
-         * member datum.
-         */
-        double meanOfSquaredValues(0.0);
-        
-        /* Use the range-based for-loop syntax to iterate over all elements
-         * of the "numericValues" member datum.
-         *
-         * The value of the current element of "numericValues" will be
-         * accessible within the for-loop body using the identifier
-         * "numericValue".
-         */
-        for(double numericValue : numericValues){
-            /* Update the value of "meanOfSquaredValues" by adding the square
-             * of the value of the current element of "numericValues"
-             */
-            meanOfSquaredValues += numericValue*numericValue;
-        }
-        
-        /* The current value of "meanOfSquaredValues" corresponds to the SUM
-         * of the squares of the elements of "numericValues". The required mean
-         * can be obtained by dividing by the number of elements comprising
-         * numericValues. This number is returned by the  size() method
-         * of the std::vector<double>-type member datum "numericValues".
-         */
-        meanOfSquaredValues /= numericValues.size();
-        
-        /* Compute and return the required standard deviation. The square
-         * of the mean of the elements of "numericValues" is computed
-         * by delegating computation of the mean to getMean() and squaring
-         * the result.
-         *
-         * Technical note: It would be more efficient to call getMean() once,
-         * then store and square the result. In reality, almost all modern
-         * optimizing compilers will recognize this and produce equivalent
-         * machine code from the subsequent statement.
-         *
-         * The STL function std::sqrt provided by the <cmath> header file is
-         * used to compute the square root.
-         */
-        return std::sqrt(meanOfSquaredValues - getMean()*getMean());
-    }
-    else{ // No numeric values were successfully parsed from the input file
-        return 0.0;
+bool StatsCalculator::mergeFrequencySketches(const DistinctCountSketch & distinct, const FrequencySketch & frequency){
+    if(!frequencySketchesEnabled){
+        return false;
     }
+    distinctSketch.merge(distinct);
+    frequencySketch.merge(frequency);
+    return true;
 }
 
+/** Public method that enables, resizes or disables RESERVOIR SAMPLING (see
+ * ReservoirSample). Any current sample is discarded. If the size is not zero,
+ * the values that are currently stored (or viewed) are then added, so the
+ * sample is drawn from them and from every value that follows. Values that were
+ * streamed before then have already been summarized, so they cannot be added.
+ *
+ * \param size - The largest number of values in the sample, or zero to disable
+ * sampling and release the sample's memory.
+ * \param seed - The seed of the random numbers. Instances whose samples are to
+ * be merged must be given different seeds.
+ */
+void StatsCalculator::setReservoirSampling(size_t size, unsigned long long seed){
+    reservoir.configure(size, seed);
+    reservoir.add(valuesData(), valuesCount());
+}
 
-// PUBLIC METHODS OF STATSCALCULATOR
+/** Public method that returns the largest number of values in the reservoir
+ * sample, which is zero if sampling is disabled.
+ */
+size_t StatsCalculator::getReservoirSize() const{
+    return reservoir.size;
+}
 
-/** Default constructor for the StatsCalculator class, which is not
- * required to perform any operations.
+/** Public method that merges the reservoir sample of another instance into that
+ * of this instance (see ReservoirSample::merge()). Only the sample changes: the
+ * merged values are not added to the stored values or to any other statistic.
  *
- * \note Technically an identical definition would be provided by the
- * C++ compiler if its delcaration were also omitted from the class
- * definition in the StatsCalculator.h header file.
+ * \param other - The other instance's ReservoirSample.
  *
- * \note The explicit declaration and (no-operation) definition are
- * provided for clarity.
+ * \return True on success, or false (and no change) if sampling is disabled in
+ * this instance or the other sample is full and smaller than this one.
  */
-StatsCalculator::StatsCalculator(){
-    // No initialization operations are required.
+bool StatsCalculator::mergeReservoirSample(const ReservoirSample & other){
+    return reservoir.merge(other);
 }
 
-/** Destructor for the StatsCalculator class, which is not
- * required to perform any operations.
- *
- * \note Technically an identical definition would be provided by the
- * C++ compiler if its delcaration were also omitted from the class
- * definition in the StatsCalculator.h header file.
+/** Public method that determines whether printStats() and writeStats() report
+ * bootstrap confidence intervals. The intervals can be obtained from
+ * getBootstrapIntervals() whether or not they are reported.
  *
- * \note The explicit declaration and (no-operation) definition are
- * provided for clarity.
+ * \param enabled - True to report the intervals, false to omit them.
  */
-StatsCalculator::~StatsCalculator(){
-    // No deallocation operations are required.
+void StatsCalculator::setBootstrapEnabled(bool enabled){
+    bootstrapEnabled = enabled;
 }
 
-/** Public method returns the sum of the internally stored numeric values.
- *
- * \note The method delegates the computation of the required sum to the private
- * computeSum() method.
+/** Public method that returns true if bootstrap confidence intervals are reported.
+ */
+bool StatsCalculator::isBootstrapEnabled() const{
+    return bootstrapEnabled;
+}
+
+/** Public method that determines whether printStats() and writeStats() report
+ * the autocorrelation statistics. The statistics can be obtained from
+ * getAutocorrelationStatistics() whether or not they are reported.
  *
- * \return The computed sum is returned as a double-precision value.
+ * \param enabled - True to report the statistics, false to omit them.
  */
-double StatsCalculator::getSum(){
-    return computeSum();
+void StatsCalculator::setAutocorrelationEnabled(bool enabled){
+    autocorrelationEnabled = enabled;
 }
 
+/** Public method that returns true if the autocorrelation statistics are reported.
+ */
+bool StatsCalculator::isAutocorrelationEnabled() const{
+    return autocorrelationEnabled;
+}
 
-/** Public method returns the mean of the internally stored numeric values.
+/** Public method that sets the options of the bootstrap, discarding any cached
+ * intervals that were computed with different options.
  *
- * \note The method delegates the computation of the required mean to the private
- * computeMean() method.
+ * \param resampleCount - The number of resamples, which must not be zero.
+ * \param confidenceLevel - The confidence level, strictly between zero and one.
+ * \param seed - The seed of the random number generator.
  *
- * \return The computed mean is returned as a double-precision value.
+ * \return True on success, or false (and no change) if an option is out of range.
  */
-double StatsCalculator::getMean(){
-    return computeMean();
+bool StatsCalculator::setBootstrapOptions(unsigned resampleCount, double confidenceLevel,
+                                          unsigned long long seed){
+    if(resampleCount == 0 || !(confidenceLevel > 0.0 && confidenceLevel < 1.0)){
+        return false;
+    }
+    if(resampleCount != bootstrapResampleCount || confidenceLevel != bootstrapConfidenceLevel
+       || seed != bootstrapSeed){
+        bootstrapResampleCount = resampleCount;
+        bootstrapConfidenceLevel = confidenceLevel;
+        bootstrapSeed = seed;
+        cachedBootstrapResultValid = false;
+    }
+    return true;
 }
 
-
-/** Public method returns the standard deviation of the internally stored
- * numeric values.
+/** Public method that determines whether NaN and infinite values contribute to
+ * the statistics.
  *
- * \note The method delegates the computation of the required standard deviation
- * to the private computeSum() method.
+ * The stored values are never modified. Instead, the statistics are computed
+ * by a kernel that discards the excluded values as it goes (see
+ * computeStatistics()), so changing the mode only discards the cached
+ * statistics. Values that were streamed have already been summarized, so the
+ * new mode only applies to values that are streamed subsequently.
  *
- * \return The computed standard deviation is returned as a double-precision value.
+ * \param mode - One of the StatsCalcNonFiniteMode values.
  */
-double StatsCalculator::getStandardDeviation(){
-    return computeStandardDeviation();
+void StatsCalculator::setNonFiniteMode(StatsCalcNonFiniteMode mode){
+    if(mode != nonFiniteMode){
+        nonFiniteMode = mode;
+        forgetObservedValues();
+        discardCachedResults();
+        publishUpdates(0);
+    }
 }
 
-
-/**  Public method that accepts a appends a new double precision value to
- * the "numericValues" member datum.
- *
- * \param value - A double precision value to append to the "numericValues" member
- * datum.
+/** Public method that returns the mode that determines whether NaN and infinite
+ * values contribute to the statistics.
  */
-void StatsCalculator::appendValue(double value){
-    numericValues.push_back(value);
+StatsCalcNonFiniteMode StatsCalculator::getNonFiniteMode() const{
+    return nonFiniteMode;
 }
 
 /** Public method that reads a list of whitespace-separated numeric
  * values from a text file. It appends those values to the "numericValues"
  * member datum.
+ *
+ * \note The file is parsed by the ingestFile() method. This method adds
+ * informative terminal output before and after parsing.
  */
 void StatsCalculator::readFile(const std::string & infileName){
     
     // Print an informative message to inform the caller of progress.
     std::cout << "Reading data from:\n\n" << infileName << std::endl;
     
-    /* Declare and zero-initialize a double precision variable with
-     * identifier "numericValue" to provide temporary storage for
-     * numeric values that are parsed from the input text file.
-     */
-    double numericValue(0.0);
+    // Delegate the actual parsing of the file to ingestFile().
+    ingestFile(infileName);
+    
+    // Warn the caller if any of the tokens in the file were not numbers.
+    if(parseReport.malformedTokens > 0){
+        if(parseReport.stoppedEarly){
+            std::cout << "Warning: parsing stopped at a malformed token on line "
+            << parseReport.firstErrorLine << "." << std::endl;
+        }
+        else{
+            std::cout << "Warning: " << parseReport.malformedTokens << " malformed token(s) were "
+            << (parsePolicy == STATSCALC_PARSE_NAN ? "recorded as NaN" : "skipped")
+            << "; the first is on line " << parseReport.firstErrorLine << "." << std::endl;
+        }
+    }
+    
+    // If any numeric values were successfully parsed from the input file...
+    if(numericValues.size() > 0){
+        /* Print a summary of the extracted data to the terminal in the format
+         * "Data = [ value1, value2, ..., valueN ]".
+         */
+        
+        // Output some preamble
+        std::cout << "Data = [ ";
+        // Loop over all but the last element of the "numericValues" member datum
+        for(std::vector<double>::iterator numValIt = numericValues.begin();
+            numValIt != --numericValues.end();
+            ++numValIt){
+            /* Output the value of the current element of "numericValues", followed
+             * by a comma.
+             */
+            std::cout << *numValIt << ", ";
+        }
+        /* Output the value of the final element of "numericValues", followed
+         * by a square bracket and two newlines. Flush the output buffer.
+         */
+        std::cout << *(--numericValues.end())
+        << " ]\n" << std::endl;
+    }
+}
+
+/** Public method that reads a list of whitespace-separated numeric
+ * values from a text file and appends them to the "numericValues" member
+ * datum, without printing anything to the terminal.
+ *
+ * Tokens that are not decimal numbers (e.g. column headers or the string
+ * "nan") are MALFORMED. They are counted, the positions of the first
+ * "maxRecordedParseErrors" of them are recorded, and they are then skipped,
+ * recorded as NaN or made to end the parse, according to the parse policy
+ * (see setParsePolicy()). The outcome is available from getParseReport()
+ * and getParseErrors() after the method returns.
+ *
+ * \note Earlier versions of this method extracted each value with the stream
+ * input operator (">>") in a loop that tested eof() BEFORE each extraction.
+ * That loop appended the previous value a second time whenever an extraction
+ * failed, which happened at the end of every file that ended with whitespace
+ * and at every malformed token, where parsing also stopped.
+ *
+ * The file is now read in large blocks by scanTokens(), which splits each
+ * block into tokens in place. Each token is parsed by parseDecimal(), and the
+ * values parsed from each block are appended together using appendValues().
+ *
+ * \param infileName - A string specifying to the path of a text file containing
+ *    a whitespace-separated list of numeric values.
+ * \param progress - An optional pointer to an IngestProgress structure that is
+ *    updated as the file is parsed, so that another thread can monitor the parse.
+ *
+ * \return True if the file was opened successfully, otherwise false.
+ */
+bool StatsCalculator::ingestFile(const std::string & infileName, IngestProgress * progress){
+    
+    // A view cannot be appended to, so first take a copy of the viewed values.
+    detachView();
+    // The cached statistics will no longer describe the stored values.
+    discardCachedResults();
+    // The parse report will describe this parse only.
+    clearParseReport();
     
     /* Instantiate a std::ifstream object that will be appropriately
      * configured to read data from a file at the path specified by
-     * the method argument "infileName".
+     * the method argument "infileName". The file is opened in binary
+     * mode, so that the byte offsets of malformed tokens are exact.
      *
      * Note that the constructor requires a C-String as its argument
      * and the c_str() method of std::string must be called to extract
      * the required type from the std::string instance.
      */
-    std::ifstream inputFile(infileName.c_str());
+    std::ifstream inputFile(infileName.c_str(), std::ios::in | std::ios::binary);
     
     /* The following if clause ensures that the input file was
      * successfully opened AND that the file is in a good state
@@ -269,58 +4933,311 @@ void StatsCalculator::readFile(const std::string & infileName){
      * This means that if the file is NOT open, then no attempt will
      * be made to assess its readability state.
      */
-    if(inputFile.is_open() && inputFile.good()){
-        /* Begin a while loop that will iterate until the end of the
-         * file is reached (inputFile.eof() == true) or the file
-         * becomes unreadable (inputFile.good() == false). Note the
-         * use of the "!" operator to invert the return value of
-         * inputFile.eof().
-         */
-        while(!inputFile.eof() && inputFile.good()){
-            /* The stream input operator (">>") extracts a whitespace-
-             * separated token (character sequence) from the input file
-             * and attempts to interpret the sequence as a double
-             * precision value. If successful, it assigns the interpretted
-             * value to the "numericValue" variable
-             */
-            inputFile >> numericValue;
-            /* The push_back() method provided by std::vector<double> is
-             * invoked to append the extracted numeric value to the end of
-             * the numericValues member datum.
-             */
-            numericValues.push_back(numericValue);
-        }
-        /* Explicitly close the input file, freeing any resources it acquired
-         * when it was constructed or during its operation.
-         */
-        inputFile.close();
+    if(!(inputFile.is_open() && inputFile.good())){
+        // The file could not be opened.
+        return false;
     }
     
-    // If any numeric values were successfully parsed from the input file...
-    if(numericValues.size() > 0){
-        /* Print a summary of the extracted data to the terminal in the format
-         * "Data = [ value1, value2, ..., valueN ]".
-         */
-        
-        // Output some preamble
-        std::cout << "Data = [ ";
-        // Loop over all but the last element of the "numericValues" member datum
-        for(std::vector<double>::iterator numValIt = numericValues.begin();
-            numValIt != --numericValues.end();
-            ++numValIt){
-            /* Output the value of the current element of "numericValues", followed
-             * by a comma.
-             */
-            std::cout << *numValIt << ", ";
+    /* If the caller wants progress reports, determine the size of the file
+     * by seeking to its end, then return to its beginning.
+     */
+    if(progress != 0){
+        inputFile.seekg(0, std::ios::end);
+        progress->bytesTotal = static_cast<long long>(inputFile.tellg());
+        inputFile.seekg(0, std::ios::beg);
+    }
+    
+    // Split the file into tokens, parse them and append their values.
+    ValueTokenHandler handler(*this, parsePolicy, parseReport, parseErrors);
+    scanTokens(inputFile, progress, handler);
+    
+    // The whole file has been consumed.
+    if(progress != 0){
+        progress->bytesConsumed = progress->bytesTotal.load();
+    }
+    /* Explicitly close the input file, freeing any resources it acquired
+     * when it was constructed or during its operation.
+     */
+    inputFile.close();
+    
+    return true;
+}
+
+/** Public method that begins to ingest a file INCREMENTALLY. The file is opened
+ * and the parse report is reset, exactly as by ingestFile(), but nothing is
+ * parsed until resumeIngest() is called.
+ *
+ * \param infileName - A string specifying to the path of a text file containing
+ *    a whitespace-separated list of numeric values.
+ * \param progress - An optional pointer to an IngestProgress structure that is
+ *    updated after every chunk.
+ *
+ * \return True if the file was opened successfully, or false if it could not be
+ * opened or another incremental ingest is already in progress.
+ */
+bool StatsCalculator::beginIngest(const std::string & infileName, IngestProgress * progress){
+    if(incrementalIngest){
+        return false;
+    }
+    detachView();
+    discardCachedResults();
+    clearParseReport();
+    
+    std::shared_ptr<IncrementalIngest> ingest =
+    std::make_shared<IncrementalIngest>(*this, parsePolicy, parseReport, parseErrors, ingestChunkBytes);
+    ingest->inputFile.open(infileName.c_str(), std::ios::in | std::ios::binary);
+    if(!(ingest->inputFile.is_open() && ingest->inputFile.good())){
+        return false;
+    }
+    if(progress != 0){
+        ingest->inputFile.seekg(0, std::ios::end);
+        progress->bytesTotal = static_cast<long long>(ingest->inputFile.tellg());
+        ingest->inputFile.seekg(0, std::ios::beg);
+    }
+    ingest->readingFile = true;
+    ingest->progress = progress;
+    incrementalIngest = ingest;
+    return true;
+}
+
+/** Public method that begins to append an array of values INCREMENTALLY. Nothing
+ * is appended until resumeIngest() is called.
+ *
+ * \param values - A pointer to the first element of the array, which must remain
+ * valid until the ingest has finished.
+ * \param count - The number of elements in the array.
+ *
+ * \return True on success, or false if another incremental ingest is already in
+ * progress.
+ */
+bool StatsCalculator::beginAppend(const double * values, size_t count){
+    if(incrementalIngest){
+        return false;
+    }
+    // No file is scanned, so the scanner needs no buffer.
+    std::shared_ptr<IncrementalIngest> ingest =
+    std::make_shared<IncrementalIngest>(*this, parsePolicy, parseReport, parseErrors, 0);
+    ingest->values = values;
+    ingest->valueCount = count;
+    incrementalIngest = ingest;
+    return true;
+}
+
+/** Public method that performs the next chunk of the incremental ingest that was
+ * begun by beginIngest() or beginAppend(), and then returns, so that the caller
+ * (e.g. a coroutine, or StatsIngestScheduler) can do other work before resuming.
+ *
+ * A chunk of a file is one block of "ingestChunkBytes" bytes, which TokenScanner
+ * reads and scans and whose values ValueTokenHandler appends, just as a block of
+ * ingestFile() is handled. A chunk of an array is "ingestChunkValues" values,
+ * which are appended by appendValues(). Once the last chunk has been ingested the
+ * file is closed, and the statistics are the same as if ingestFile() or
+ * appendValues() had been called.
+ *
+ * \return True if the ingest has finished (or none was in progress), otherwise false.
+ */
+bool StatsCalculator::resumeIngest(){
+    if(!incrementalIngest){
+        return true;
+    }
+    IncrementalIngest & ingest = *incrementalIngest;
+    bool finished;
+    if(ingest.readingFile){
+        finished = ingest.scanner.scanBlock(ingest.inputFile, ingest.progress, ingest.handler);
+        if(finished && ingest.progress != 0){
+            ingest.progress->bytesConsumed = ingest.progress->bytesTotal.load();
         }
-        /* Output the value of the final element of "numericValues", followed
-         * by a square bracket and two newlines. Flush the output buffer.
-         */
-        std::cout << *(--numericValues.end())
-        << " ]\n" << std::endl;
     }
+    else{
+        const size_t remaining = ingest.valueCount - ingest.nextValue;
+        size_t count = ingestChunkValues;
+        if(remaining < count){
+            count = remaining;
+        }
+        appendValues(ingest.values + ingest.nextValue, count);
+        ingest.nextValue += count;
+        finished = ingest.nextValue == ingest.valueCount;
+    }
+    if(finished){
+        // Releasing the state closes the file.
+        incrementalIngest.reset();
+    }
+    return finished;
+}
+
+/** Public method that returns true if an incremental ingest has begun but not
+ * yet finished.
+ */
+bool StatsCalculator::isIngestPending() const{
+    return static_cast<bool>(incrementalIngest);
+}
+
+/** Public method that reads a two-column text file in which each line holds a
+ * value followed by its weight (or its uncertainty), and appends the weighted
+ * values (see appendWeightedValues()).
+ *
+ * Blank lines are ignored. A line that does not hold exactly two decimal numbers
+ * (e.g. a line of column headers) is a malformed record, to which the parse policy
+ * is applied as a whole. With the STATSCALC_PARSE_NAN policy, a malformed record
+ * is recorded as a NaN value of unit weight. The outcome is available from
+ * getParseReport() and getParseErrors(), in which the "values" are records.
+ *
+ * \param infileName - A string specifying to the path of the text file.
+ * \param column - Determines whether the second column holds weights or
+ *    uncertainties. An uncertainty \f$\sigma\f$ is converted into the weight
+ *    \f$1/\sigma^{2}\f$.
+ * \param progress - An optional pointer to an IngestProgress structure that is
+ *    updated as the file is parsed.
+ *
+ * \return True if the file was opened successfully, otherwise false.
+ */
+bool StatsCalculator::ingestWeightedFile(const std::string & infileName, StatsCalcWeightColumn column,
+                                         IngestProgress * progress){
+    detachView();
+    discardCachedResults();
+    clearParseReport();
+    
+    // Open the file in binary mode, so that the byte offsets of malformed records are exact.
+    std::ifstream inputFile(infileName.c_str(), std::ios::in | std::ios::binary);
+    if(!(inputFile.is_open() && inputFile.good())){
+        return false;
+    }
+    if(progress != 0){
+        inputFile.seekg(0, std::ios::end);
+        progress->bytesTotal = static_cast<long long>(inputFile.tellg());
+        inputFile.seekg(0, std::ios::beg);
+    }
+    
+    // Split the file into records, parse them and append their weighted values.
+    TwoColumnRecordHandler handler(*this, parsePolicy,
+                                   column == STATSCALC_WEIGHT_COLUMN_UNCERTAINTIES
+                                   ? RECORDS_ARE_VALUES_WITH_UNCERTAINTIES : RECORDS_ARE_WEIGHTED_VALUES,
+                                   parseReport, parseErrors);
+    scanTokens(inputFile, progress, handler);
+    
+    if(progress != 0){
+        progress->bytesConsumed = progress->bytesTotal.load();
+    }
+    inputFile.close();
+    return true;
+}
+
+/** Public method that reads a two-column text file in which each line holds a
+ * pair of values from two channels, and accumulates the pairs (see appendPairs()).
+ *
+ * Blank lines are ignored. A line that does not hold exactly two decimal numbers
+ * is a malformed record, to which the parse policy is applied as a whole. With the
+ * STATSCALC_PARSE_NAN policy, a malformed record is recorded as a pair of NaNs.
+ *
+ * \param infileName - A string specifying to the path of the text file.
+ * \param progress - An optional pointer to an IngestProgress structure that is
+ *    updated as the file is parsed.
+ *
+ * \return True if the file was opened successfully, otherwise false.
+ */
+bool StatsCalculator::ingestPairsFile(const std::string & infileName, IngestProgress * progress){
+    clearParseReport();
+    
+    // Open the file in binary mode, so that the byte offsets of malformed records are exact.
+    std::ifstream inputFile(infileName.c_str(), std::ios::in | std::ios::binary);
+    if(!(inputFile.is_open() && inputFile.good())){
+        return false;
+    }
+    if(progress != 0){
+        inputFile.seekg(0, std::ios::end);
+        progress->bytesTotal = static_cast<long long>(inputFile.tellg());
+        inputFile.seekg(0, std::ios::beg);
+    }
+    
+    // Split the file into records, parse them and accumulate the pairs.
+    TwoColumnRecordHandler handler(*this, parsePolicy, RECORDS_ARE_PAIRS, parseReport, parseErrors);
+    scanTokens(inputFile, progress, handler);
+    
+    if(progress != 0){
+        progress->bytesConsumed = progress->bytesTotal.load();
+    }
+    inputFile.close();
+    return true;
+}
+
+/** Public method that reads a two-column text file in which each line holds a
+ * timestamp followed by a value, and appends the timed values (see
+ * appendTimedValues()).
+ *
+ * Blank lines are ignored. A line that does not hold exactly two decimal numbers
+ * is a malformed record, to which the parse policy is applied as a whole. With the
+ * STATSCALC_PARSE_NAN policy, a malformed record is recorded as a NaN value with
+ * a NaN timestamp, so it contributes to the other statistics but to no bucket.
+ *
+ * \param infileName - A string specifying to the path of the text file.
+ * \param progress - An optional pointer to an IngestProgress structure that is
+ *    updated as the file is parsed.
+ *
+ * \return True if the file was opened successfully, otherwise false.
+ */
+bool StatsCalculator::ingestTimedFile(const std::string & infileName, IngestProgress * progress){
+    detachView();
+    discardCachedResults();
+    clearParseReport();
+    
+    // Open the file in binary mode, so that the byte offsets of malformed records are exact.
+    std::ifstream inputFile(infileName.c_str(), std::ios::in | std::ios::binary);
+    if(!(inputFile.is_open() && inputFile.good())){
+        return false;
+    }
+    if(progress != 0){
+        inputFile.seekg(0, std::ios::end);
+        progress->bytesTotal = static_cast<long long>(inputFile.tellg());
+        inputFile.seekg(0, std::ios::beg);
+    }
+    
+    // Split the file into records, parse them and append the timed values.
+    TwoColumnRecordHandler handler(*this, parsePolicy, RECORDS_ARE_TIMED_VALUES, parseReport, parseErrors);
+    scanTokens(inputFile, progress, handler);
+    
+    if(progress != 0){
+        progress->bytesConsumed = progress->bytesTotal.load();
+    }
+    inputFile.close();
+    return true;
+}
+
+/** Public method that sets the policy that ingestFile() (and readFile()) apply to
+ * tokens that are not decimal numbers.
+ *
+ * \param policy - One of the StatsCalcParsePolicy values.
+ */
+void StatsCalculator::setParsePolicy(StatsCalcParsePolicy policy){
+    parsePolicy = policy;
+}
+
+/** Public method that returns the policy that ingestFile() applies to tokens that
+ * are not decimal numbers.
+ */
+StatsCalcParsePolicy StatsCalculator::getParsePolicy() const{
+    return parsePolicy;
+}
+
+/** Public method that returns a summary of the outcome of the most recent call to
+ * ingestFile() (or readFile()).
+ */
+const StatsParseReport & StatsCalculator::getParseReport() const{
+    return parseReport;
+}
+
+/** Public method that returns the positions of the malformed tokens that the most
+ * recent call to ingestFile() (or readFile()) encountered, up to a maximum of
+ * "maxRecordedParseErrors".
+ */
+const std::vector<ParseErrorLocation> & StatsCalculator::getParseErrors() const{
+    return parseErrors;
 }
 
+/** The number of the most frequent values that printStats() and writeStats()
+ * report when the frequency sketches are enabled.
+ */
+static const size_t reportedHeavyHitters = 5;
+
 /** Public method that prints a summary of the statistical properties that this
  * class computes to the terminal.
  */
@@ -330,14 +5247,96 @@ void StatsCalculator::printStats(){
      * values of the statistical quantities that are computed by the class
      * using the format: "Statistic_Name = Statistic_Value"
      *
-     * The required statistical values are obtained using the public getter
-     * methods: getSum(), getMean() and getStandardDeviation()
+     * The required statistical values are obtained together using the public
+     * getStatistics() method.
      */
+    const StatsResult & statistics = getStatistics();
     std::cout << "Simple statistical analysis of numeric data:\n\n"
-    << "Sum =  " << getSum() << "\n"
-    << "Mean = " << getMean() << "\n"
-    << "Standard Deviation = " << getStandardDeviation()
+    << "Sum =  " << statistics.sum << "\n"
+    << "Mean = " << statistics.mean << "\n"
+    << "Standard Deviation = " << statistics.standardDeviation
     << "\n" << std::endl;
+    
+    // Summarize the robust statistics, which are insensitive to outliers, too.
+    const StatsRobustResult & robust = getRobustStatistics();
+    if(robust.count > 0){
+        std::cout << "Robust statistics" << (robust.approximate ? " (estimated from a quantile sketch)" : "")
+        << ":\n\n"
+        << "Median = " << robust.median << "\n"
+        << "Median Absolute Deviation = " << robust.medianAbsoluteDeviation << "\n"
+        << "Trimmed Mean (" << 100.0*robust.trimFraction << "% from each end) = " << robust.trimmedMean << "\n"
+        << "Winsorized Mean = " << robust.winsorizedMean << "\n"
+        << "Winsorized Variance = " << robust.winsorizedVariance
+        << "\n" << std::endl;
+    }
+    
+    // If bootstrap intervals are enabled, report the uncertainty of the mean and standard deviation.
+    if(bootstrapEnabled){
+        const StatsBootstrapResult & bootstrap = getBootstrapIntervals();
+        if(bootstrap.count > 0){
+            std::cout << 100.0*bootstrap.confidenceLevel << "% bootstrap confidence intervals ("
+            << bootstrap.resampleCount << " resamples of " << bootstrap.count << " stored values):\n\n"
+            << "Mean: [" << bootstrap.meanLower << ", " << bootstrap.meanUpper << "], standard error = "
+            << bootstrap.meanStandardError << "\n"
+            << "Standard Deviation: [" << bootstrap.standardDeviationLower << ", "
+            << bootstrap.standardDeviationUpper << "], standard error = " << bootstrap.standardDeviationStandardError
+            << "\n" << std::endl;
+        }
+    }
+    
+    // If autocorrelation statistics are enabled, report the uncertainty of the mean of correlated values.
+    if(autocorrelationEnabled){
+        const StatsAutocorrelationResult & autocorrelation = getAutocorrelationStatistics();
+        if(autocorrelation.count > 0){
+            std::cout << "Autocorrelation analysis of " << autocorrelation.count << " stored values:\n\n"
+            << "Integrated Autocorrelation Time = " << autocorrelation.integratedAutocorrelationTime
+            << " (window of " << autocorrelation.window << " lags"
+            << (autocorrelation.windowConverged ? "" : ", not converged") << ")\n"
+            << "Effective Sample Size = " << autocorrelation.effectiveSampleSize << "\n"
+            << "Standard Error of the Mean (independent values) = " << autocorrelation.naiveStandardError << "\n"
+            << "Standard Error of the Mean (autocorrelation) = " << autocorrelation.standardErrorOfMean << "\n"
+            << "Standard Error of the Mean (blocks of " << (1LL << autocorrelation.blockingLevel) << " values"
+            << (autocorrelation.blockingConverged ? "" : ", not converged") << ") = "
+            << autocorrelation.blockingStandardError
+            << "\n" << std::endl;
+        }
+    }
+    
+    // If the frequency sketches are enabled, report the distinct and most frequent values.
+    if(frequencySketchesEnabled && frequencySketch.total > 0){
+        std::vector<StatsHeavyHitter> hitters = getHeavyHitters(reportedHeavyHitters);
+        std::cout << "Frequency sketches of " << frequencySketch.total << " values:\n\n"
+        << "Distinct Values (estimated) = " << getDistinctCount() << "\n"
+        << "Most Frequent Values:\n";
+        for(size_t index = 0; index < hitters.size(); ++index){
+            std::cout << hitters[index].value << " occurred " << hitters[index].count << " times";
+            if(hitters[index].error > 0){
+                std::cout << " or fewer (at least " << hitters[index].count - hitters[index].error << ")";
+            }
+            std::cout << "\n";
+        }
+        std::cout << std::endl;
+    }
+    
+    // If any values were appended with weights, summarize their weighted statistics too.
+    if(weightedStatistics.count > 0){
+        StatsWeightedResult weighted = getWeightedStatistics();
+        std::cout << "Weighted statistics of " << weighted.count << " weighted values:\n\n"
+        << "Weighted Mean = " << weighted.weightedMean << "\n"
+        << "Weighted Variance (frequency weights) = " << weighted.frequencyVariance << "\n"
+        << "Weighted Variance (reliability weights) = " << weighted.reliabilityVariance
+        << "\n" << std::endl;
+    }
+    
+    // If any pairs of values were appended, summarize their bivariate statistics too.
+    if(bivariateStatistics.count > 0){
+        StatsBivariateResult bivariate = getBivariateStatistics();
+        std::cout << "Bivariate statistics of " << bivariate.count << " pairs of values:\n\n"
+        << "Covariance = " << bivariate.covariance << "\n"
+        << "Correlation = " << bivariate.correlation << "\n"
+        << "Least-Squares Line: y = " << bivariate.slope << " x + " << bivariate.intercept
+        << "\n" << std::endl;
+    }
 }
 
 /** Public method that writes a summary of the statistical properties that this
@@ -372,15 +5371,97 @@ void StatsCalculator::writeStats(const std::string & outfileName){
          * output annotated values of the statistical quantities that are computed
          * by the class using the format: "Statistic_Name = Statistic_Value"
          *
-         * The required statistical values are obtained using the public getter
-         * methods: getSum(), getMean() and getStandardDeviation()
+         * The required statistical values are obtained together using the public
+         * getStatistics() method.
          */
+        const StatsResult & statistics = getStatistics();
         outputFile << "Simple statistical analysis of numeric data:\n\n"
-        << "Sum =  " << getSum() << "\n"
-        << "Mean = " << getMean() << "\n"
-        << "Standard Deviation = " << getStandardDeviation()
+        << "Sum =  " << statistics.sum << "\n"
+        << "Mean = " << statistics.mean << "\n"
+        << "Standard Deviation = " << statistics.standardDeviation
         << "\n" << std::endl;
         
+        // Summarize the robust statistics, which are insensitive to outliers, too.
+        const StatsRobustResult & robust = getRobustStatistics();
+        if(robust.count > 0){
+            outputFile << "Robust statistics" << (robust.approximate ? " (estimated from a quantile sketch)" : "")
+            << ":\n\n"
+            << "Median = " << robust.median << "\n"
+            << "Median Absolute Deviation = " << robust.medianAbsoluteDeviation << "\n"
+            << "Trimmed Mean (" << 100.0*robust.trimFraction << "% from each end) = " << robust.trimmedMean << "\n"
+            << "Winsorized Mean = " << robust.winsorizedMean << "\n"
+            << "Winsorized Variance = " << robust.winsorizedVariance
+            << "\n" << std::endl;
+        }
+        
+        // If bootstrap intervals are enabled, report the uncertainty of the mean and standard deviation.
+        if(bootstrapEnabled){
+            const StatsBootstrapResult & bootstrap = getBootstrapIntervals();
+            if(bootstrap.count > 0){
+                outputFile << 100.0*bootstrap.confidenceLevel << "% bootstrap confidence intervals ("
+                << bootstrap.resampleCount << " resamples of " << bootstrap.count << " stored values):\n\n"
+                << "Mean: [" << bootstrap.meanLower << ", " << bootstrap.meanUpper << "], standard error = "
+                << bootstrap.meanStandardError << "\n"
+                << "Standard Deviation: [" << bootstrap.standardDeviationLower << ", "
+                << bootstrap.standardDeviationUpper << "], standard error = " << bootstrap.standardDeviationStandardError
+                << "\n" << std::endl;
+            }
+        }
+        
+        // If autocorrelation statistics are enabled, report the uncertainty of the mean of correlated values.
+        if(autocorrelationEnabled){
+            const StatsAutocorrelationResult & autocorrelation = getAutocorrelationStatistics();
+            if(autocorrelation.count > 0){
+                outputFile << "Autocorrelation analysis of " << autocorrelation.count << " stored values:\n\n"
+                << "Integrated Autocorrelation Time = " << autocorrelation.integratedAutocorrelationTime
+                << " (window of " << autocorrelation.window << " lags"
+                << (autocorrelation.windowConverged ? "" : ", not converged") << ")\n"
+                << "Effective Sample Size = " << autocorrelation.effectiveSampleSize << "\n"
+                << "Standard Error of the Mean (independent values) = " << autocorrelation.naiveStandardError << "\n"
+                << "Standard Error of the Mean (autocorrelation) = " << autocorrelation.standardErrorOfMean << "\n"
+                << "Standard Error of the Mean (blocks of " << (1LL << autocorrelation.blockingLevel) << " values"
+                << (autocorrelation.blockingConverged ? "" : ", not converged") << ") = "
+                << autocorrelation.blockingStandardError
+                << "\n" << std::endl;
+            }
+        }
+        
+        // If the frequency sketches are enabled, report the distinct and most frequent values.
+        if(frequencySketchesEnabled && frequencySketch.total > 0){
+            std::vector<StatsHeavyHitter> hitters = getHeavyHitters(reportedHeavyHitters);
+            outputFile << "Frequency sketches of " << frequencySketch.total << " values:\n\n"
+            << "Distinct Values (estimated) = " << getDistinctCount() << "\n"
+            << "Most Frequent Values:\n";
+            for(size_t index = 0; index < hitters.size(); ++index){
+                outputFile << hitters[index].value << " occurred " << hitters[index].count << " times";
+                if(hitters[index].error > 0){
+                    outputFile << " or fewer (at least " << hitters[index].count - hitters[index].error << ")";
+                }
+                outputFile << "\n";
+            }
+            outputFile << std::endl;
+        }
+        
+        // If any values were appended with weights, summarize their weighted statistics too.
+        if(weightedStatistics.count > 0){
+            StatsWeightedResult weighted = getWeightedStatistics();
+            outputFile << "Weighted statistics of " << weighted.count << " weighted values:\n\n"
+            << "Weighted Mean = " << weighted.weightedMean << "\n"
+            << "Weighted Variance (frequency weights) = " << weighted.frequencyVariance << "\n"
+            << "Weighted Variance (reliability weights) = " << weighted.reliabilityVariance
+            << "\n" << std::endl;
+        }
+        
+        // If any pairs of values were appended, summarize their bivariate statistics too.
+        if(bivariateStatistics.count > 0){
+            StatsBivariateResult bivariate = getBivariateStatistics();
+            outputFile << "Bivariate statistics of " << bivariate.count << " pairs of values:\n\n"
+            << "Covariance = " << bivariate.covariance << "\n"
+            << "Correlation = " << bivariate.correlation << "\n"
+            << "Least-Squares Line: y = " << bivariate.slope << " x + " << bivariate.intercept
+            << "\n" << std::endl;
+        }
+        
         /* Explicitly close the input file, freeing any resources it acquired
          * when it was constructed or during its operation.
          *
@@ -0,0 +1,1010 @@
+/// \file StatsCalculatorBenchmark.cpp Performance measurements for StatsCalculator and its C API
+
+// The <algorithm> header is included to provide the std::sort(...) and std::inplace_merge(...) functions.
+#include <algorithm>
+// The <atomic> header is included to count the snapshots delivered to a subscriber.
+#include <atomic>
+// The <chrono> header is included to provide a high resolution clock for timing.
+#include <chrono>
+// The <cmath> header is included to provide the std::fabs(...) function.
+#include <cmath>
+// The <cstdio> header is included to provide the std::remove(...) function.
+#include <cstdio>
+// The <fstream> header is included to write the input files that are parsed.
+#include <fstream>
+// The <iostream> header is included to enable textual terminal output.
+#include <iostream>
+// The <mutex> header is included to provide the std::mutex type, against which the live statistics are compared.
+#include <mutex>
+// The <cstdlib> header is included to provide the std::atoll(...) function.
+#include <cstdlib>
+// The <random> header is included to provide the std::mt19937_64 generator for the naive bootstrap.
+#include <random>
+// The <string> header is included to provide the STL std::string type.
+#include <string>
+// The <thread> header is included to run producers and consumers concurrently.
+#include <thread>
+// The <unordered_map> header is included to count the values exactly, for comparison with the sketches.
+#include <unordered_map>
+// The <vector> header is included to provide the STL std::vector type.
+#include <vector>
+
+/* Include StatsCalculator.h to provide class definition of
+ * StatsCalculator and the declarations of the C API functions.
+ */
+#include "StatsCalculator.h"
+
+/* Include StatsCovarianceMatrix.h to provide the class definition of
+ * StatsCovarianceMatrix.
+ */
+#include "StatsCovarianceMatrix.h"
+
+/* Include StatsBootstrap.h to provide the class definition of StatsBootstrap.
+ */
+#include "StatsBootstrap.h"
+
+/* Include StatsAutocorrelation.h to provide the class definition of
+ * StatsAutocorrelation.
+ */
+#include "StatsAutocorrelation.h"
+
+/* Include StatsCalculatorWorkerPool.h to provide the class definition of
+ * StatsCalculatorWorkerPool, which runs the parallel comparison sort.
+ */
+#include "StatsCalculatorWorkerPool.h"
+
+/* Include StatsIngestScheduler.h to provide the class definition of
+ * StatsIngestScheduler, which multiplexes many file ingests on the worker pool.
+ */
+#include "StatsIngestScheduler.h"
+
+/* Include StatsSharedRing.h to provide the class definition of
+ * StatsSharedRing, which is only available on POSIX systems.
+ */
+#include "StatsSharedRing.h"
+
+/** The type of clock that is used for all timing measurements. The steady clock
+ * is guaranteed never to be adjusted while the program runs.
+ */
+typedef std::chrono::steady_clock BenchmarkClock;
+
+/** Computes the number of nanoseconds that elapsed between two time points,
+ * divided by a number of repetitions.
+ *
+ * \param start - The time point at which the measurement started.
+ * \param stop - The time point at which the measurement stopped.
+ * \param repetitions - The number of operations that were performed between
+ * start and stop.
+ *
+ * \return The mean duration of one operation in nanoseconds.
+ */
+static double nanosecondsPerOperation(BenchmarkClock::time_point start,
+                                      BenchmarkClock::time_point stop,
+                                      long long repetitions){
+    return std::chrono::duration<double, std::nano>(stop - start).count()/repetitions;
+}
+
+/** Measures the latency of C API calls that are given a valid handle and calls
+ * that are given an invalid handle.
+ *
+ * A small number of values are appended so that the statistics are cached and
+ * the measurement is dominated by the cost of validating the handle.
+ *
+ * \param repetitions - The number of calls to time for each case.
+ */
+static void benchmarkHandleLookup(long long repetitions){
+    // Create a handful of instances so that the lookup is not trivially short.
+    const int instanceCount = 16;
+    int handles[instanceCount];
+    for(int instance = 0; instance < instanceCount; ++instance){
+        handles[instance] = statsCalcCreate();
+        statsCalcAppendValue(handles[instance], instance);
+    }
+    const int validHandle = handles[instanceCount/2];
+    const int invalidHandle = -12345;
+
+    /* Accumulate the returned values so that the optimizer cannot discard
+     * the calls whose results would otherwise be unused.
+     */
+    double checksum(0.0);
+
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    for(long long repetition = 0; repetition < repetitions; ++repetition){
+        checksum += statsCalcGetMean(validHandle);
+    }
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    std::cout << "statsCalcGetMean(valid handle)       : "
+    << nanosecondsPerOperation(start, stop, repetitions) << " ns/call\n";
+
+    start = BenchmarkClock::now();
+    for(long long repetition = 0; repetition < repetitions; ++repetition){
+        checksum += statsCalcGetMean(invalidHandle);
+    }
+    stop = BenchmarkClock::now();
+    std::cout << "statsCalcGetMean(invalid handle)     : "
+    << nanosecondsPerOperation(start, stop, repetitions) << " ns/call\n";
+
+    start = BenchmarkClock::now();
+    for(long long repetition = 0; repetition < repetitions; ++repetition){
+        checksum += statsCalcAppendValue(invalidHandle, 1.0);
+    }
+    stop = BenchmarkClock::now();
+    std::cout << "statsCalcAppendValue(invalid handle) : "
+    << nanosecondsPerOperation(start, stop, repetitions) << " ns/call\n";
+
+    std::cout << "(checksum " << checksum << ")\n" << std::endl;
+
+    // Destroy the instances that were created.
+    for(int instance = 0; instance < instanceCount; ++instance){
+        statsCalcDestroy(handles[instance]);
+    }
+}
+
+/** Measures the cost of creating and immediately destroying a StatsCalculator
+ * instance through the C API, as happens once per acquisition burst.
+ *
+ * \param repetitions - The number of create/destroy pairs to time.
+ */
+static void benchmarkCreateDestroy(long long repetitions){
+    /* Keep some instances alive throughout, so that the handle table is not
+     * trivially small.
+     */
+    const int instanceCount = 16;
+    int handles[instanceCount];
+    for(int instance = 0; instance < instanceCount; ++instance){
+        handles[instance] = statsCalcCreate();
+    }
+    
+    long long checksum(0);
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    for(long long repetition = 0; repetition < repetitions; ++repetition){
+        int handle = statsCalcCreate();
+        checksum += handle;
+        statsCalcDestroy(handle);
+    }
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    std::cout << "statsCalcCreate() + statsCalcDestroy() : "
+    << nanosecondsPerOperation(start, stop, repetitions) << " ns/pair\n"
+    << "(checksum " << checksum << ")\n" << std::endl;
+    
+    for(int instance = 0; instance < instanceCount; ++instance){
+        statsCalcDestroy(handles[instance]);
+    }
+}
+
+/** Measures the throughput with which StatsCalculator::ingestFile() parses a text
+ * file, with and without malformed tokens. A file of values is written to the
+ * working directory, parsed, and then removed. For comparison, the same file is
+ * parsed with the stream input operator (">>"), as earlier versions of
+ * ingestFile() did.
+ *
+ * \param valueCount - The number of values in the file.
+ */
+static void benchmarkFileParse(long long valueCount){
+    const std::string fileName = "statsCalculatorBenchmarkInput.txt";
+    const std::string malformedFileName = "statsCalculatorBenchmarkMalformed.txt";
+    {
+        std::ofstream outputFile(fileName.c_str());
+        std::ofstream malformedFile(malformedFileName.c_str());
+        outputFile.precision(17);
+        malformedFile.precision(17);
+        malformedFile << "time value\n";
+        for(long long index = 0; index < valueCount; ++index){
+            const double value = (index % 1000)*0.001 - 0.5;
+            outputFile << value << "\n";
+            // One value in a hundred is replaced by the string "nan".
+            if(index % 100 == 99){
+                malformedFile << "nan\n";
+            }
+            else{
+                malformedFile << value << "\n";
+            }
+        }
+    }
+
+    StatsCalculator statsCalculator;
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    statsCalculator.ingestFile(fileName);
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    std::cout << "ingestFile() (" << valueCount << " values)           : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value\n";
+
+    statsCalculator.reset();
+    start = BenchmarkClock::now();
+    statsCalculator.ingestFile(malformedFileName);
+    stop = BenchmarkClock::now();
+    std::cout << "ingestFile() with 1% malformed tokens : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value ("
+    << statsCalculator.getParseReport().malformedTokens << " skipped)\n";
+
+    std::vector<double> values;
+    start = BenchmarkClock::now();
+    std::ifstream inputFile(fileName.c_str());
+    double value;
+    while(inputFile >> value){
+        values.push_back(value);
+    }
+    stop = BenchmarkClock::now();
+    std::cout << "operator>> loop for comparison        : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value\n" << std::endl;
+
+    std::remove(fileName.c_str());
+    std::remove(malformedFileName.c_str());
+}
+
+/** Measures the number of rows per second that StatsCovarianceMatrix folds into
+ * its covariance matrix, for several numbers of channels. Each measurement is
+ * repeated with the update restricted to the calling thread and with it shared
+ * between the threads of the worker pool. For comparison, the same rows are
+ * also folded in one at a time with a per-row outer product (Welford's update
+ * generalized to many channels), which reads and writes the whole matrix for
+ * every row.
+ *
+ * \param repetitions - Scales the number of rows; fewer rows are used for
+ * larger numbers of channels so that each measurement takes a similar time.
+ */
+static void benchmarkCovarianceMatrix(long long repetitions){
+    const size_t channelCounts[] = {64, 256, 1024};
+    std::cout << "Covariance matrix      channels   per-row (rows/s)   blocked 1 thread   blocked pool" << std::endl;
+    for(size_t countIndex = 0; countIndex < sizeof(channelCounts)/sizeof(channelCounts[0]); ++countIndex){
+        const size_t channelCount = channelCounts[countIndex];
+        long long rowCount = repetitions*100/static_cast<long long>(channelCount*channelCount);
+        if(rowCount < 1024){
+            rowCount = 1024;
+        }
+
+        // The rows are filled with correlated, deterministic values.
+        const size_t distinctRows = 1024;
+        std::vector<double> rows(distinctRows*channelCount);
+        for(size_t row = 0; row < distinctRows; ++row){
+            for(size_t channel = 0; channel < channelCount; ++channel){
+                rows[row*channelCount + channel] = static_cast<double>((row*7 + channel*13) % 101) + 0.5*(row % 17);
+            }
+        }
+
+        // The per-row update is much slower, so it is timed on fewer rows.
+        const long long perRowCount = rowCount/8 > 64 ? rowCount/8 : 64;
+        std::vector<double> means(channelCount, 0.0);
+        std::vector<double> coMoments(channelCount*channelCount, 0.0);
+        std::vector<double> deviations(channelCount);
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        for(long long row = 0; row < perRowCount; ++row){
+            const double * values = &rows[(row % distinctRows)*channelCount];
+            for(size_t channel = 0; channel < channelCount; ++channel){
+                deviations[channel] = values[channel] - means[channel];
+                means[channel] += deviations[channel]/(row + 1);
+            }
+            for(size_t first = 0; first < channelCount; ++first){
+                double * coMomentRow = &coMoments[first*channelCount];
+                for(size_t second = first; second < channelCount; ++second){
+                    coMomentRow[second] += deviations[first]*(values[second] - means[second]);
+                }
+            }
+        }
+        BenchmarkClock::time_point stop = BenchmarkClock::now();
+        const double perRowRate = perRowCount/std::chrono::duration<double>(stop - start).count();
+
+        double blockedRates[2];
+        double checksum(coMoments[channelCount - 1]);
+        for(int pass = 0; pass < 2; ++pass){
+            StatsCovarianceMatrix covarianceMatrix(channelCount);
+            covarianceMatrix.setThreadCount(pass == 0 ? 1 : 0);
+            start = BenchmarkClock::now();
+            for(long long row = 0; row < rowCount; row += distinctRows){
+                const long long remaining = rowCount - row;
+                covarianceMatrix.appendRows(&rows[0], remaining < static_cast<long long>(distinctRows) ?
+                                            static_cast<size_t>(remaining) : distinctRows);
+            }
+            checksum += covarianceMatrix.getCovariance(0, channelCount - 1);
+            stop = BenchmarkClock::now();
+            blockedRates[pass] = rowCount/std::chrono::duration<double>(stop - start).count();
+        }
+
+        std::cout << "                       " << channelCount << "\t     " << perRowRate << "\t\t"
+        << blockedRates[0] << "\t   " << blockedRates[1] << std::endl;
+        std::cout << "(checksum " << checksum << ")" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+/** Measures the time taken by StatsCalculator::getSortedValues() (a parallel
+ * radix sort) to sort an array of values, and compares it with std::sort() and
+ * with a parallel comparison sort. The parallel comparison sort sorts one chunk
+ * per worker thread with std::sort() and then merges neighbouring chunks in
+ * rounds with std::inplace_merge(), which is how parallel std::sort() is
+ * usually implemented.
+ *
+ * \param valueCount - The number of values to sort.
+ */
+static void benchmarkSort(long long valueCount){
+    // Pseudo-random values of both signs, spanning many orders of magnitude.
+    std::vector<double> values(static_cast<size_t>(valueCount));
+    unsigned long long state = 12345;
+    for(size_t index = 0; index < values.size(); ++index){
+        state = state*6364136223846793005ULL + 1442695040888963407ULL;
+        values[index] = (static_cast<double>(state >> 11) - 4503599627370496.0)*1e-6;
+    }
+
+    StatsCalculator statsCalculator;
+    statsCalculator.appendValues(&values[0], values.size());
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    const std::vector<double> & sortedValues = statsCalculator.getSortedValues();
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    std::cout << "getSortedValues() (" << valueCount << " values) : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value\n";
+
+    std::vector<double> copy(values);
+    start = BenchmarkClock::now();
+    std::sort(copy.begin(), copy.end());
+    stop = BenchmarkClock::now();
+    std::cout << "std::sort()                           : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value\n";
+    const bool sameAsSort = copy == sortedValues;
+
+    copy = values;
+    StatsCalculatorWorkerPool & pool = StatsCalculatorWorkerPool::shared();
+    const size_t chunkCount = pool.size();
+    const size_t chunkSize = (copy.size() + chunkCount - 1)/chunkCount;
+    start = BenchmarkClock::now();
+    pool.parallelFor(chunkCount, [&copy, chunkSize](size_t chunk){
+        const size_t begin = std::min(chunk*chunkSize, copy.size());
+        const size_t end = std::min(begin + chunkSize, copy.size());
+        std::sort(copy.begin() + begin, copy.begin() + end);
+    });
+    for(size_t width = chunkSize; width < copy.size(); width *= 2){
+        const size_t mergeCount = (copy.size() + 2*width - 1)/(2*width);
+        pool.parallelFor(mergeCount, [&copy, width](size_t merge){
+            const size_t begin = merge*2*width;
+            const size_t middle = std::min(begin + width, copy.size());
+            const size_t end = std::min(begin + 2*width, copy.size());
+            std::inplace_merge(copy.begin() + begin, copy.begin() + middle, copy.begin() + end);
+        });
+    }
+    stop = BenchmarkClock::now();
+    std::cout << "parallel std::sort() (" << chunkCount << " threads)     : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value\n"
+    << "(results " << (sameAsSort && copy == sortedValues ? "agree" : "DISAGREE") << ")\n" << std::endl;
+}
+
+/** Measures the time taken to compute bootstrap confidence intervals for the
+ * mean and standard deviation of an array of values. The naive method, which
+ * is how a bootstrap is usually written, materializes each resample by drawing
+ * random indices with std::mt19937_64 and then computes its statistics. It is
+ * compared with StatsBootstrap, which draws multinomial counts block by block
+ * with a counter-based generator, on one thread and on the shared worker pool.
+ *
+ * \param valueCount - The number of values to resample.
+ */
+static void benchmarkBootstrap(long long valueCount){
+    const unsigned resampleCount = 1000;
+    std::vector<double> values(static_cast<size_t>(valueCount));
+    StatsPhiloxGenerator generator(2024, 0);
+    for(size_t index = 0; index < values.size(); ++index){
+        values[index] = 100.0 + 10.0*generator.nextDouble();
+    }
+
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    std::mt19937_64 engine(2024);
+    std::uniform_int_distribution<size_t> pick(0, values.size() - 1);
+    std::vector<double> resample(values.size());
+    std::vector<double> means(resampleCount);
+    for(unsigned replicate = 0; replicate < resampleCount; ++replicate){
+        for(size_t index = 0; index < resample.size(); ++index){
+            resample[index] = values[pick(engine)];
+        }
+        StatsCalculator statsCalculator(&resample[0], resample.size());
+        means[replicate] = statsCalculator.getMean();
+    }
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    const long long draws = valueCount*resampleCount;
+    std::cout << "Bootstrap (" << resampleCount << " resamples of " << valueCount << " values)\n"
+    << "materialized resamples           : " << nanosecondsPerOperation(start, stop, draws) << " ns/draw\n";
+
+    StatsBootstrap bootstrap(resampleCount, 0.95, 2024);
+    StatsBootstrapResult serial;
+    bootstrap.setThreadCount(1);
+    start = BenchmarkClock::now();
+    bootstrap.computeIntervals(&values[0], values.size(), serial);
+    stop = BenchmarkClock::now();
+    std::cout << "StatsBootstrap 1 thread          : " << nanosecondsPerOperation(start, stop, draws) << " ns/draw\n";
+
+    StatsBootstrapResult parallel;
+    bootstrap.setThreadCount(0);
+    start = BenchmarkClock::now();
+    bootstrap.computeIntervals(&values[0], values.size(), parallel);
+    stop = BenchmarkClock::now();
+    std::cout << "StatsBootstrap pool (" << StatsCalculatorWorkerPool::shared().size() << " threads)  : "
+    << nanosecondsPerOperation(start, stop, draws) << " ns/draw\n"
+    << "(mean interval [" << parallel.meanLower << ", " << parallel.meanUpper << "], "
+    << (serial.meanLower == parallel.meanLower && serial.meanUpper == parallel.meanUpper ?
+        "reproducible" : "NOT REPRODUCIBLE") << ")\n" << std::endl;
+}
+
+/** Measures the time taken to compute the autocorrelations of a correlated
+ * series (a first-order autoregressive process with coefficient 0.9, whose
+ * integrated autocorrelation time is 19). The direct sum over every pair of
+ * values separated by less than the maximum lag is compared with
+ * StatsAutocorrelation, which computes the same sums through fast Fourier
+ * transforms, and the complete analysis is then timed on one thread and on the
+ * shared worker pool.
+ *
+ * \param valueCount - The number of values in the series.
+ */
+static void benchmarkAutocorrelation(long long valueCount){
+    const size_t lagCount = 1024;
+    std::vector<double> values(static_cast<size_t>(valueCount));
+    StatsPhiloxGenerator generator(2024, 0);
+    double previous = 0.0;
+    for(size_t index = 0; index < values.size(); ++index){
+        previous = 0.9*previous + generator.nextDouble() - 0.5;
+        values[index] = previous;
+    }
+
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    double mean = 0.0;
+    for(size_t index = 0; index < values.size(); ++index){
+        mean += values[index];
+    }
+    mean /= values.size();
+    std::vector<double> direct(lagCount, 0.0);
+    for(size_t lag = 0; lag < lagCount && lag < values.size(); ++lag){
+        double sum = 0.0;
+        for(size_t index = 0; index + lag < values.size(); ++index){
+            sum += (values[index] - mean)*(values[index + lag] - mean);
+        }
+        direct[lag] = sum;
+    }
+    const double variance = direct[0];
+    for(size_t lag = 0; lag < lagCount; ++lag){
+        direct[lag] /= variance;
+    }
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    std::cout << "Autocorrelation (" << lagCount << " lags of " << valueCount << " values)\n"
+    << "direct sums                      : " << nanosecondsPerOperation(start, stop, valueCount) << " ns/value\n";
+
+    StatsAutocorrelation autocorrelation;
+    autocorrelation.setThreadCount(1);
+    std::vector<double> transformed(lagCount);
+    start = BenchmarkClock::now();
+    autocorrelation.computeAutocorrelations(&values[0], values.size(), lagCount, &transformed[0]);
+    stop = BenchmarkClock::now();
+    double largestDifference = 0.0;
+    for(size_t lag = 0; lag < lagCount; ++lag){
+        largestDifference = std::max(largestDifference, std::fabs(transformed[lag] - direct[lag]));
+    }
+    std::cout << "StatsAutocorrelation 1 thread    : " << nanosecondsPerOperation(start, stop, valueCount)
+    << " ns/value (largest difference " << largestDifference << ")\n";
+
+    StatsAutocorrelationResult serial;
+    start = BenchmarkClock::now();
+    autocorrelation.analyze(&values[0], values.size(), serial);
+    stop = BenchmarkClock::now();
+    std::cout << "analyze() 1 thread               : " << nanosecondsPerOperation(start, stop, valueCount)
+    << " ns/value\n";
+
+    StatsAutocorrelationResult parallel;
+    autocorrelation.setThreadCount(0);
+    start = BenchmarkClock::now();
+    autocorrelation.analyze(&values[0], values.size(), parallel);
+    stop = BenchmarkClock::now();
+    std::cout << "analyze() pool (" << StatsCalculatorWorkerPool::shared().size() << " threads)       : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value\n"
+    << "(integrated autocorrelation time " << parallel.integratedAutocorrelationTime << ", "
+    << (serial.integratedAutocorrelationTime == parallel.integratedAutocorrelationTime ?
+        "reproducible" : "NOT REPRODUCIBLE") << ")\n" << std::endl;
+}
+
+/** Measures the time taken to count the distinct values and find the most
+ * frequent value in a stream of simulated 12-bit ADC codes: nine in ten are
+ * the noisy pedestal of the ADC (the sum of four uniform variates, scaled and
+ * quantized), and the rest are pulses, uniformly distributed over every code.
+ * Exact counting with a
+ * std::unordered_map, whose memory grows with the number of distinct values,
+ * is compared with a DistinctCountSketch and a FrequencySketch, which together
+ * occupy a few kilobytes, and with the sketches of four shards merged.
+ *
+ * \param valueCount - The number of values in the stream.
+ */
+static void benchmarkFrequencySketches(long long valueCount){
+    std::vector<double> codes(static_cast<size_t>(valueCount));
+    StatsPhiloxGenerator generator(2024, 0);
+    for(size_t index = 0; index < codes.size(); ++index){
+        if(generator.nextBelow(10) == 0){
+            codes[index] = static_cast<double>(generator.nextBelow(4096));
+        }
+        else{
+            const double noise = generator.nextDouble() + generator.nextDouble() + generator.nextDouble()
+            + generator.nextDouble() - 2.0;
+            codes[index] = static_cast<double>(static_cast<long long>(512.0 + 8.0*noise));
+        }
+    }
+
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    std::unordered_map<double, long long> exactCounts;
+    for(size_t index = 0; index < codes.size(); ++index){
+        ++exactCounts[codes[index]];
+    }
+    double exactMode = 0.0;
+    long long exactModeCount = 0;
+    for(std::unordered_map<double, long long>::const_iterator count = exactCounts.begin();
+        count != exactCounts.end(); ++count){
+        if(count->second > exactModeCount || (count->second == exactModeCount && count->first < exactMode)){
+            exactMode = count->first;
+            exactModeCount = count->second;
+        }
+    }
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    std::cout << "Frequency sketches (" << valueCount << " ADC codes)\n"
+    << "std::unordered_map               : " << nanosecondsPerOperation(start, stop, valueCount) << " ns/value ("
+    << exactCounts.size() << " distinct, mode " << exactMode << " x " << exactModeCount << ")\n";
+
+    DistinctCountSketch distinct;
+    FrequencySketch frequency;
+    start = BenchmarkClock::now();
+    distinct.add(&codes[0], codes.size());
+    frequency.add(&codes[0], codes.size());
+    stop = BenchmarkClock::now();
+    std::vector<StatsHeavyHitter> hitters;
+    frequency.getHeavyHitters(1, hitters);
+    const size_t sketchBytes = distinct.registers.size() + frequency.counters.size()*sizeof(long long)
+    + frequency.monitored.capacity()*sizeof(StatsHeavyHitter) + frequency.monitoredSlots.capacity()
+    + frequency.slots.size();
+    std::cout << "sketches                         : " << nanosecondsPerOperation(start, stop, valueCount)
+    << " ns/value (" << distinct.estimate() << " distinct, mode " << hitters[0].value << " x "
+    << hitters[0].count << ", " << sketchBytes << " bytes)\n";
+
+    const size_t shardCount = 4;
+    DistinctCountSketch mergedDistinct;
+    FrequencySketch mergedFrequency;
+    for(size_t shard = 0; shard < shardCount; ++shard){
+        const size_t begin = shard*codes.size()/shardCount;
+        const size_t end = (shard + 1)*codes.size()/shardCount;
+        DistinctCountSketch shardDistinct;
+        FrequencySketch shardFrequency;
+        shardDistinct.add(&codes[begin], end - begin);
+        shardFrequency.add(&codes[begin], end - begin);
+        mergedDistinct.merge(shardDistinct);
+        mergedFrequency.merge(shardFrequency);
+    }
+    mergedFrequency.getHeavyHitters(1, hitters);
+    std::cout << "(" << shardCount << " merged shards: " << mergedDistinct.estimate() << " distinct, mode "
+    << hitters[0].value << " x " << hitters[0].count << ")\n" << std::endl;
+}
+
+/** Measures the cost of reservoir sampling in a streaming StatsCalculator, by
+ * appending values one at a time with sampling disabled and with a sample of
+ * 1000 values, and in blocks of 4096 values. The mean of a sample merged from
+ * four shards is compared with the mean of every value, as a check that the
+ * sample is representative.
+ *
+ * \param valueCount - The number of values to stream.
+ */
+static void benchmarkReservoirSampling(long long valueCount){
+    std::vector<double> values(static_cast<size_t>(valueCount));
+    StatsPhiloxGenerator generator(2024, 1);
+    for(size_t index = 0; index < values.size(); ++index){
+        values[index] = generator.nextDouble();
+    }
+    const size_t sampleSize = 1000;
+    const size_t blockSize = 4096;
+
+    double rates[3];
+    for(unsigned pass = 0; pass < 3; ++pass){
+        StatsCalculator statsCalculator;
+        statsCalculator.setStreaming(true);
+        statsCalculator.setReservoirSampling(pass == 0 ? 0 : sampleSize, 1);
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        if(pass < 2){
+            for(size_t index = 0; index < values.size(); ++index){
+                statsCalculator.appendValue(values[index]);
+            }
+        }
+        else{
+            for(size_t begin = 0; begin < values.size(); begin += blockSize){
+                statsCalculator.appendValues(&values[begin], std::min(blockSize, values.size() - begin));
+            }
+        }
+        BenchmarkClock::time_point stop = BenchmarkClock::now();
+        rates[pass] = nanosecondsPerOperation(start, stop, valueCount);
+    }
+    std::cout << "Reservoir sampling (" << valueCount << " streamed values, sample of " << sampleSize << ")\n"
+    << "appendValue(), no sample         : " << rates[0] << " ns/value\n"
+    << "appendValue(), sampled           : " << rates[1] << " ns/value\n"
+    << "appendValues(), sampled          : " << rates[2] << " ns/value\n";
+
+    const size_t shardCount = 4;
+    ReservoirSample merged;
+    merged.configure(sampleSize, 0);
+    for(size_t shard = 0; shard < shardCount; ++shard){
+        const size_t begin = shard*values.size()/shardCount;
+        const size_t end = (shard + 1)*values.size()/shardCount;
+        ReservoirSample shardSample;
+        shardSample.configure(sampleSize, shard + 1);
+        shardSample.add(&values[begin], end - begin);
+        merged.merge(shardSample);
+    }
+    StatsCalculator everyValue(&values[0], values.size());
+    StatsCalculator sampledValues(merged.values.empty() ? 0 : &merged.values[0], merged.values.size());
+    std::cout << "(" << shardCount << " merged shards: mean of sample " << sampledValues.getMean()
+    << ", of every value " << everyValue.getMean() << ")\n" << std::endl;
+}
+
+/** Measures the cost of dividing a stream of timestamped values into buckets of
+ * one second, one minute and one hour, by comparing appendTimedValues() with
+ * appendValues() in a streaming StatsCalculator. The values are sampled at
+ * 1 kHz, in blocks of 4096.
+ *
+ * \param valueCount - The number of values to stream.
+ */
+static void benchmarkTimeBuckets(long long valueCount){
+    std::vector<double> times(static_cast<size_t>(valueCount));
+    std::vector<double> values(static_cast<size_t>(valueCount));
+    StatsPhiloxGenerator generator(2024, 2);
+    for(size_t index = 0; index < values.size(); ++index){
+        times[index] = 1.7e9 + 1e-3*static_cast<double>(index);
+        values[index] = generator.nextDouble();
+    }
+    std::vector<double> widths;
+    widths.push_back(1.0);
+    widths.push_back(60.0);
+    widths.push_back(3600.0);
+    const size_t blockSize = 4096;
+
+    double rates[2];
+    for(unsigned pass = 0; pass < 2; ++pass){
+        StatsCalculator statsCalculator;
+        statsCalculator.setStreaming(true);
+        statsCalculator.setTimeResolutions(widths);
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        for(size_t begin = 0; begin < values.size(); begin += blockSize){
+            const size_t count = std::min(blockSize, values.size() - begin);
+            if(pass == 0){
+                statsCalculator.appendValues(&values[begin], count);
+            }
+            else{
+                statsCalculator.appendTimedValues(&times[begin], &values[begin], count);
+            }
+        }
+        statsCalculator.flushTimeBuckets();
+        BenchmarkClock::time_point stop = BenchmarkClock::now();
+        rates[pass] = nanosecondsPerOperation(start, stop, valueCount);
+        if(pass == 1){
+            const TimeRollup & rollup = statsCalculator.getTimeRollup();
+            std::cout << "Time buckets (" << valueCount << " values at 1 kHz; " << rollup.completed[0].size()
+            << " seconds, " << rollup.completed[1].size() << " minutes, " << rollup.completed[2].size()
+            << " hours)\n";
+        }
+    }
+    std::cout << "appendValues()                   : " << rates[0] << " ns/value\n"
+    << "appendTimedValues()              : " << rates[1] << " ns/value\n" << std::endl;
+}
+
+#ifndef _WIN32
+/** Counts the snapshots delivered to benchmarkSubscription() and keeps the
+ * count of values in the most recent one.
+ */
+struct SnapshotTally {
+    /// The number of snapshots delivered.
+    std::atomic<long long> snapshots;
+    /// The number of values described by the most recent snapshot.
+    std::atomic<long long> lastCount;
+};
+
+/** The function that benchmarkSubscription() subscribes to snapshots.
+ *
+ * \param snapshot - The snapshot.
+ * \param userData - A pointer to a SnapshotTally.
+ */
+static void tallySnapshot(const StatsSnapshot * snapshot, void * userData){
+    SnapshotTally * tally = static_cast<SnapshotTally *>(userData);
+    tally->snapshots.fetch_add(1);
+    tally->lastCount.store(snapshot->statistics.count);
+}
+
+/** Compares two ways for a consumer to keep up with the statistics of values
+ * that are being appended in blocks and stored. In the first, the statistics are
+ * read after every block with getStatistics(), which repeats the pass over every
+ * stored value. In the second, a subscription posts a snapshot after every block,
+ * which only summarizes the new values, and delivers it from a background thread.
+ * Plain appends are timed for reference.
+ *
+ * \param valueCount - The number of values to append.
+ */
+static void benchmarkSubscription(long long valueCount){
+    std::vector<double> values(static_cast<size_t>(valueCount));
+    StatsPhiloxGenerator generator(2024, 3);
+    for(size_t index = 0; index < values.size(); ++index){
+        values[index] = generator.nextDouble();
+    }
+    const size_t blockSize = 4096;
+    
+    const char * labels[3] = {"appendValues() only             : ",
+                              "appendValues() + getStatistics(): ",
+                              "appendValues() + subscription   : "};
+    double checksum = 0.0;
+    // Values are appended once before timing, so that reset() leaves every pass the same capacity.
+    StatsCalculator statsCalculator;
+    statsCalculator.appendValues(&values[0], values.size());
+    std::cout << "Subscription (" << valueCount << " stored values, one update per " << blockSize << ")\n";
+    for(unsigned pass = 0; pass < 3; ++pass){
+        SnapshotTally tally;
+        tally.snapshots = 0;
+        tally.lastCount = 0;
+        statsCalculator.reset();
+        if(pass == 2){
+            statsCalculator.subscribe(tallySnapshot, &tally, static_cast<long long>(blockSize));
+        }
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        for(size_t begin = 0; begin < values.size(); begin += blockSize){
+            const size_t count = std::min(blockSize, values.size() - begin);
+            statsCalculator.appendValues(&values[begin], count);
+            if(pass == 1){
+                checksum += statsCalculator.getStatistics().mean;
+            }
+        }
+        statsCalculator.publishStatistics();
+        statsCalculator.unsubscribe();
+        BenchmarkClock::time_point stop = BenchmarkClock::now();
+        std::cout << labels[pass] << nanosecondsPerOperation(start, stop, valueCount) << " ns/value";
+        if(pass == 2){
+            std::cout << " (" << tally.snapshots << " snapshots delivered, the last of "
+            << tally.lastCount << " values)";
+        }
+        std::cout << "\n";
+    }
+    std::cout << "(checksum " << checksum << ")\n" << std::endl;
+}
+
+/** Appends values one at a time to a streaming StatsCalculator while other
+ * threads read its statistics as fast as they can, and times both sides.
+ *
+ * \param valueCount - The number of values to append.
+ * \param readerCount - The number of reading threads.
+ * \param useMutex - If true, the writer and the readers share a std::mutex and
+ * the readers call getStatistics(). Otherwise the readers read the live
+ * statistics, which are protected by a seqlock, and the writer takes no lock.
+ * \param writerNanoseconds - Receives the mean time taken by one append.
+ * \param readsPerSecond - Receives the total rate at which the readers read.
+ */
+static void measureLiveStatistics(long long valueCount, unsigned readerCount, bool useMutex,
+                                  double & writerNanoseconds, double & readsPerSecond){
+    StatsCalculator statsCalculator;
+    statsCalculator.setStreaming(true);
+    statsCalculator.setLiveStatisticsEnabled(!useMutex);
+    const StatsLiveStatistics & live = statsCalculator.getLiveStatistics();
+    std::mutex calculatorMutex;
+    std::atomic<bool> finished(false);
+    std::atomic<long long> reads(0);
+
+    std::vector<std::thread> readers;
+    for(unsigned reader = 0; reader < readerCount; ++reader){
+        readers.push_back(std::thread([&](){
+            long long localReads = 0;
+            while(!finished.load(std::memory_order_relaxed)){
+                if(useMutex){
+                    std::lock_guard<std::mutex> lock(calculatorMutex);
+                    statsCalculator.getStatistics();
+                }
+                else{
+                    RunningStatistics statistics;
+                    live.read(statistics);
+                }
+                ++localReads;
+            }
+            reads.fetch_add(localReads);
+        }));
+    }
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    for(long long index = 0; index < valueCount; ++index){
+        const double value = static_cast<double>(index % 1000);
+        if(useMutex){
+            std::lock_guard<std::mutex> lock(calculatorMutex);
+            statsCalculator.appendValue(value);
+        }
+        else{
+            statsCalculator.appendValue(value);
+        }
+    }
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+    finished.store(true);
+    for(size_t reader = 0; reader < readers.size(); ++reader){
+        readers[reader].join();
+    }
+
+    writerNanoseconds = nanosecondsPerOperation(start, stop, valueCount);
+    readsPerSecond = static_cast<double>(reads.load())/std::chrono::duration<double>(stop - start).count();
+}
+
+/** Measures the cost of letting other threads read the statistics while values
+ * are appended, with the live statistics (a seqlock that readers never hold) and
+ * with a std::mutex shared by the writer and the readers, for no readers, one
+ * reader and one reader per remaining hardware thread.
+ *
+ * \param valueCount - The number of values to append in each measurement.
+ */
+static void benchmarkLiveStatistics(long long valueCount){
+    std::vector<unsigned> readerCounts;
+    readerCounts.push_back(0);
+    readerCounts.push_back(1);
+    const unsigned hardwareThreads = std::thread::hardware_concurrency();
+    if(hardwareThreads > 2){
+        readerCounts.push_back(hardwareThreads - 1);
+    }
+
+    std::cout << "Live statistics (" << valueCount << " single appends)\n"
+    << "readers   seqlock writer (ns/value)   reads/s\tmutex writer (ns/value)   reads/s" << std::endl;
+    for(size_t row = 0; row < readerCounts.size(); ++row){
+        double seqlockWriter;
+        double seqlockReads;
+        double mutexWriter;
+        double mutexReads;
+        measureLiveStatistics(valueCount, readerCounts[row], false, seqlockWriter, seqlockReads);
+        measureLiveStatistics(valueCount, readerCounts[row], true, mutexWriter, mutexReads);
+        std::cout << "      " << readerCounts[row] << "\t\t" << seqlockWriter << "\t\t" << seqlockReads
+        << "\t" << mutexWriter << "\t\t\t" << mutexReads << "\n";
+    }
+    std::cout << std::endl;
+}
+
+/** Compares three ways of ingesting many files at once: one after another on the
+ * calling thread, one whole file per task with parallelFor(), and a chunk at a
+ * time with a StatsIngestScheduler, which multiplexes every file on the threads
+ * of the shared worker pool. The time at which the first and the last file
+ * finished is reported for each.
+ *
+ * \param valueCount - The total number of values in the files.
+ */
+static void benchmarkConcurrentIngest(long long valueCount){
+    const size_t fileCount = 100;
+    const long long valuesPerFile = valueCount/static_cast<long long>(fileCount);
+    std::vector<std::string> fileNames(fileCount);
+    for(size_t file = 0; file < fileCount; ++file){
+        fileNames[file] = "statsCalculatorBenchmarkInput" + std::to_string(file) + ".txt";
+        std::ofstream outputFile(fileNames[file].c_str());
+        outputFile.precision(17);
+        for(long long index = 0; index < valuesPerFile; ++index){
+            outputFile << (index % 1000)*0.001 - 0.5 + static_cast<double>(file) << "\n";
+        }
+    }
+
+    const char * labels[3] = {"one after another              : ",
+                              "one file per task (parallelFor): ",
+                              "StatsIngestScheduler chunks    : "};
+    std::cout << "Concurrent ingest (" << fileCount << " files of " << valuesPerFile << " values, "
+    << StatsCalculatorWorkerPool::shared().size() << " pool threads)" << std::endl;
+    for(unsigned method = 0; method < 3; ++method){
+        std::vector<StatsCalculator> calculators(fileCount);
+        std::vector<double> finishTimes(fileCount);
+        BenchmarkClock::time_point start = BenchmarkClock::now();
+        if(method == 0){
+            for(size_t file = 0; file < fileCount; ++file){
+                calculators[file].ingestFile(fileNames[file]);
+                finishTimes[file] = std::chrono::duration<double>(BenchmarkClock::now() - start).count();
+            }
+        }
+        else if(method == 1){
+            StatsCalculatorWorkerPool::shared().parallelFor(fileCount, [&](size_t file){
+                calculators[file].ingestFile(fileNames[file]);
+                finishTimes[file] = std::chrono::duration<double>(BenchmarkClock::now() - start).count();
+            });
+        }
+        else{
+            StatsIngestScheduler scheduler;
+            for(size_t file = 0; file < fileCount; ++file){
+                double * finishTime = &finishTimes[file];
+                scheduler.ingestFile(calculators[file], fileNames[file], [finishTime, start](StatsCalculator &){
+                    *finishTime = std::chrono::duration<double>(BenchmarkClock::now() - start).count();
+                });
+            }
+            scheduler.wait();
+        }
+        BenchmarkClock::time_point stop = BenchmarkClock::now();
+        double checksum = 0.0;
+        for(size_t file = 0; file < fileCount; ++file){
+            checksum += calculators[file].getMean();
+        }
+        std::cout << labels[method] << nanosecondsPerOperation(start, stop, valuesPerFile*fileCount)
+        << " ns/value, first file done after " << 1e3*(*std::min_element(finishTimes.begin(), finishTimes.end()))
+        << " ms, last after " << 1e3*(*std::max_element(finishTimes.begin(), finishTimes.end()))
+        << " ms (checksum " << checksum << ")\n";
+    }
+    std::cout << std::endl;
+
+    for(size_t file = 0; file < fileCount; ++file){
+        std::remove(fileNames[file].c_str());
+    }
+}
+
+/** Measures the throughput of the shared memory ring buffer. A producer thread
+ * writes values in blocks while the calling thread consumes them into a
+ * streaming StatsCalculator. Both sides spin rather than sleep when the ring is
+ * full or empty, so the measurement reflects the fast path.
+ *
+ * \param valueCount - The number of values to pass through the ring.
+ */
+static void benchmarkSharedRing(long long valueCount){
+    std::string ringName = "/statsCalculatorBenchmark";
+    StatsSharedRing consumerRing;
+    // The name is private to the benchmark, so a segment left behind by an interrupted run is replaced.
+    if(!consumerRing.create(ringName, 1 << 16, true)){
+        std::cout << "Shared memory ring: could not create " << ringName << "\n" << std::endl;
+        return;
+    }
+    StatsCalculator statsCalculator;
+    statsCalculator.setStreaming(true);
+
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    std::thread producer([&ringName, valueCount](){
+        StatsSharedRing producerRing;
+        producerRing.open(ringName);
+        std::vector<double> block(1024);
+        long long written = 0;
+        while(written < valueCount){
+            size_t blockSize = block.size();
+            if(valueCount - written < static_cast<long long>(blockSize)){
+                blockSize = static_cast<size_t>(valueCount - written);
+            }
+            for(size_t index = 0; index < blockSize; ++index){
+                block[index] = static_cast<double>((written + index) % 1000);
+            }
+            size_t blockWritten = 0;
+            while(blockWritten < blockSize){
+                blockWritten += producerRing.write(&block[blockWritten], blockSize - blockWritten);
+            }
+            written += blockSize;
+        }
+        producerRing.closeProducer();
+    });
+    while(!consumerRing.finished()){
+        consumerRing.consumeInto(statsCalculator);
+    }
+    producer.join();
+    BenchmarkClock::time_point stop = BenchmarkClock::now();
+
+    std::cout << "Shared memory ring (" << valueCount << " values)   : "
+    << nanosecondsPerOperation(start, stop, valueCount) << " ns/value, mean = "
+    << statsCalculator.getMean() << "\n" << std::endl;
+}
+#endif // _WIN32 was not defined
+
+/** The main function is the entry point for the benchmark program. It runs each
+ * benchmark in turn and prints the measured timings to the terminal.
+ *
+ * \param argc - The number of command line tokens including the executable name
+ * and command line arguments.
+ *
+ * \param argv - An optional \b first command line argument, available as argv[1],
+ * specifies the number of repetitions for each measurement. The default is
+ * ten million.
+ *
+ * \return The program returns zero on success.
+ */
+int main(int argc, char * argv[]){
+
+    // Use the number of repetitions that was requested, if any.
+    long long repetitions = 10000000;
+    if(argc > 1){
+        repetitions = std::atoll(argv[1]);
+    }
+
+    std::cout << "StatsCalculator benchmarks (" << repetitions << " repetitions)\n" << std::endl;
+
+    benchmarkHandleLookup(repetitions);
+    benchmarkCreateDestroy(repetitions);
+    benchmarkFileParse(repetitions/10);
+    benchmarkCovarianceMatrix(repetitions);
+    benchmarkSort(repetitions);
+    benchmarkBootstrap(repetitions/100);
+    benchmarkAutocorrelation(repetitions/10);
+    benchmarkFrequencySketches(repetitions);
+    benchmarkReservoirSampling(repetitions);
+    benchmarkTimeBuckets(repetitions);
+    benchmarkSubscription(repetitions/10);
+    benchmarkLiveStatistics(repetitions);
+    benchmarkConcurrentIngest(repetitions/2);
+#ifndef _WIN32
+    benchmarkSharedRing(repetitions);
+#endif // _WIN32 was not defined
+
+    return 0;
+}
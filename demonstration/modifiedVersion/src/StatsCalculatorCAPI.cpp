@@ -14,119 +14,1231 @@
 // Include the stdafx.h header to satisfy Windows requirements
 #include "stdafx.h"
 
+/* The "StatsCalculatorWorkerPool.h" header file provides the pool of worker threads that
+ * performs asynchronous file loads.
+ */
+#include "StatsCalculatorWorkerPool.h"
+
 // STL HEADER3
-// The <map> header provides the std::map ASSOCIATIVE container type
-#include <map>
+// The <algorithm> header provides the std::copy(...) function
+#include <algorithm>
+// The <deque> header provides the std::deque SEQUENCE container type
+#include <deque>
+// The <memory> header provides the std::shared_ptr smart pointer type
+#include <memory>
+
+/** \struct AsyncIngest
+ * The state of an asynchronous file load that was started by statsCalcReadFileAsync().
+ * It is shared (using std::shared_ptr) between the C API and the worker thread that
+ * performs the load, so it remains valid until both have finished with it.
+ */
+struct AsyncIngest {
+    /// Progress counters that are updated by StatsCalculator::ingestFile().
+    IngestProgress progress;
+    /// Mutex that protects "finished" and "fileOpened".
+    std::mutex mutex;
+    /// Condition variable that is notified when the load finishes.
+    std::condition_variable finishedCondition;
+    /// True once the worker thread has finished the load.
+    bool finished;
+    /// True if the worker thread was able to open the file.
+    bool fileOpened;
+    
+    /// Default constructor.
+    AsyncIngest() : finished(false), fileOpened(false) {}
+};
+
+/** \struct CalculatorEntry
+ * An element of the global "statsCalculators" table. It holds a StatsCalculator
+ * instance together with the state of any asynchronous load into that instance, and
+ * the bookkeeping that allows the element to be recycled.
+ */
+struct CalculatorEntry {
+    /// The StatsCalculator instance to which a handle refers.
+    StatsCalculator calculator;
+    /// The asynchronous load into "calculator" that is in progress (or whose outcome has not been collected), if any.
+    std::shared_ptr<AsyncIngest> pendingIngest;
+    /// The outcome of a finished load that has not yet been returned by statsCalcWait() or statsCalcPoll().
+    int ingestStatus;
+    /// Incremented every time the element is released, so that stale handles can be recognized.
+    int generation;
+    /// The index of the next element of the free list, or -1. Only meaningful while the element is free.
+    int nextFree;
+    /// True while the element is in use (between statsCalcCreate() and statsCalcDestroy()).
+    bool live;
+    
+    /// Default constructor creates a free element.
+    CalculatorEntry() : ingestStatus(STATSCALC_OK), generation(0), nextFree(-1), live(false) {}
+};
+
+/** The number of low-order bits of a handle that hold the index of an element of
+ * "statsCalculators". The remaining bits (excluding the sign bit) hold the generation of
+ * the element at the time the handle was issued.
+ */
+static const int handleIndexBits = 20;
+
+/// A mask that extracts the index from a handle.
+static const int handleIndexMask = (1 << handleIndexBits) - 1;
+
+/// A mask that keeps generations within the bits of a handle that are available to them.
+static const int handleGenerationMask = (1 << (31 - handleIndexBits)) - 1;
+
+/** Declare a "global" table that associates integer "handles" with instances of StatsCalculator
+ * This will permit C code to instantiate and access StatsCalulator objects without
+ * having to directly reference them.
+ *
+ * Each handle combines the INDEX of an element of the table with the GENERATION of that
+ * element. Elements are never removed from the table. Instead, statsCalcDestroy() pushes the
+ * element onto a singly-linked FREE LIST (threaded through the "nextFree" members and headed
+ * by "firstFreeEntry") and increments its generation, and statsCalcCreate() pops the most
+ * recently freed element. Creating and destroying instances therefore takes constant time, and
+ * once the table has grown to the peak number of live instances it no longer allocates memory.
+ * Handles to destroyed instances are recognized because their generation no longer matches.
+ *
+ * A std::deque is used because, unlike std::vector, growing it never moves existing elements.
+ *
+ * \note The C API functions must not be called concurrently from several threads. Worker
+ * threads that perform asynchronous loads only access the StatsCalculator instance they are
+ * loading, and elements of the table never move in memory, so the C API remains safe to use
+ * from the calling thread while loads are in progress.
+ */
+std::deque<CalculatorEntry> statsCalculators;
+
+/// The index of the first element of the free list, or -1 if the free list is empty.
+static int firstFreeEntry = -1;
+
+/** Searches the global "statsCalculators" for the element that corresponds to an integer
+ * handle, without waiting for any asynchronous load into it to complete.
+ *
+ * The index is extracted from the handle and checked against the size of the table, and the
+ * generation of the element is compared with the generation encoded in the handle. The lookup
+ * therefore takes constant time and involves no searching.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate().
+ *
+ * \return A pointer to the corresponding element, or null if the handle is not valid.
+ */
+static CalculatorEntry * findEntry(int handle){
+    if(handle < 0){
+        return 0;
+    }
+    size_t index = static_cast<size_t>(handle & handleIndexMask);
+    if(index >= statsCalculators.size()){
+        return 0;
+    }
+    CalculatorEntry & entry = statsCalculators[index];
+    if(!entry.live || entry.generation != (handle >> handleIndexBits)){
+        return 0;
+    }
+    return &entry;
+}
+
+/** Takes an element from the free list (or appends a new element to "statsCalculators" if
+ * the free list is empty), marks it as live and returns the handle that refers to it.
+ *
+ * \param calculator - The StatsCalculator instance that the element should hold.
+ *
+ * \return The handle of the element, or -1 if the table already holds the maximum number of
+ * elements that a handle can address.
+ */
+static int acquireEntry(const StatsCalculator & calculator){
+    int index;
+    if(firstFreeEntry >= 0){
+        index = firstFreeEntry;
+        firstFreeEntry = statsCalculators[index].nextFree;
+    }
+    else{
+        if(statsCalculators.size() > static_cast<size_t>(handleIndexMask)){
+            return -1;
+        }
+        index = static_cast<int>(statsCalculators.size());
+        statsCalculators.push_back(CalculatorEntry());
+    }
+    CalculatorEntry & entry = statsCalculators[index];
+    entry.calculator = calculator;
+    entry.ingestStatus = STATSCALC_OK;
+    entry.live = true;
+    int handle = (entry.generation << handleIndexBits) | index;
+    // Readers of the live statistics check this tag, which changes whenever the element is reused.
+    entry.calculator.setLiveStatisticsTag(handle);
+    return handle;
+}
+
+/** Returns an element of "statsCalculators" to the free list. The generation of the element is
+ * incremented so that any remaining copies of its handle become invalid.
+ *
+ * \param handle - a handle for which findEntry() returned a non-null pointer.
+ */
+static void releaseEntry(int handle){
+    int index = handle & handleIndexMask;
+    CalculatorEntry & entry = statsCalculators[index];
+    // From now on, readers that kept a pointer to the live statistics are told the handle is invalid.
+    entry.calculator.setLiveStatisticsTag(-1);
+    // Discard the stored values and release the memory that held them.
+    entry.calculator.reset(true);
+    // Stop delivering snapshots to the subscriber, if any, before the element is reused.
+    entry.calculator.unsubscribe();
+    entry.live = false;
+    entry.generation = (entry.generation + 1) & handleGenerationMask;
+    entry.nextFree = firstFreeEntry;
+    firstFreeEntry = index;
+}
+
+/** Blocks until the asynchronous load into an element of "statsCalculators" has completed,
+ * then forgets it. Its outcome is NOT returned but kept in the "ingestStatus" member of the
+ * element, so that a failure is still reported by the next call to statsCalcWait() or
+ * statsCalcPoll() when some other C API function had to wait for the load first. A failure
+ * is kept until it has been reported, even if a later load succeeds.
+ *
+ * \param entry - The element whose load should be waited for.
+ */
+static void finishIngest(CalculatorEntry & entry){
+    if(!entry.pendingIngest){
+        return;
+    }
+    std::shared_ptr<AsyncIngest> ingest;
+    ingest.swap(entry.pendingIngest);
+    std::unique_lock<std::mutex> lock(ingest->mutex);
+    while(!ingest->finished){
+        ingest->finishedCondition.wait(lock);
+    }
+    if(!ingest->fileOpened){
+        entry.ingestStatus = STATSCALC_FILE_ERROR;
+    }
+}
+
+/** Blocks until the asynchronous load into an element of "statsCalculators" has completed,
+ * then returns the outcome of every load that has not yet been reported and forgets it.
+ *
+ * \param entry - The element whose load should be waited for.
+ *
+ * \return STATSCALC_OK if there was no load or the loads succeeded, or STATSCALC_FILE_ERROR
+ * if a file could not be opened.
+ */
+static int completeIngest(CalculatorEntry & entry){
+    finishIngest(entry);
+    int status = entry.ingestStatus;
+    entry.ingestStatus = STATSCALC_OK;
+    return status;
+}
+
+/** Searches the global "statsCalculators" for the StatsCalculator instance that corresponds to
+ * an integer handle.
+ *
+ * The search uses findEntry(), which reports an invalid handle by returning null rather than by
+ * raising an exception. Every C API function therefore validates its handle with a few cheap
+ * comparisons, and the C API can be compiled without exception support.
+ *
+ * The function is declared "static" so that it is only visible within this file and does not
+ * become part of the C API.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate().
+ *
+ * If an asynchronous load into the instance is in progress, the function waits for it to
+ * complete, so that the caller never accesses an instance that a worker thread is modifying.
+ * The outcome of the load is kept for statsCalcWait() and statsCalcPoll() to report.
+ *
+ * \return A pointer to the corresponding StatsCalculator instance, or null if the handle is not
+ * valid.
+ */
+static StatsCalculator * findCalculator(int handle){
+    CalculatorEntry * entry = findEntry(handle);
+    if(entry == 0){
+        return 0;
+    }
+    /* If an asynchronous load is in progress, wait for it to complete before the instance
+     * is used. This test is a single, well-predicted branch when no load is pending.
+     */
+    if(entry->pendingIngest){
+        finishIngest(*entry);
+    }
+    return &entry->calculator;
+}
+
+/* The subsequent code provides the DEFINITIONS of the C API functions. The definitions include
+ * C++-only language constructs and must be compiled with a C++ compiler. However, mangling of
+ * the function identifiers must be suppressed by prepending them with the 'extern "C"' token pair.
+ */
+
+/** Instantiates a StatsCalculator object and stores it in the global "statsCalculators" table,
+ * reusing the most recently released element if there is one.
+ *
+ * \return An integer "handle" that uniquely refers to the instantiated
+ * StatsCalculator object, or -1 if the maximum number of simultaneously live
+ * instances has been reached.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcCreate(){
+    return acquireEntry(StatsCalculator());
+}
+
+/** Instantiates a StatsCalculator object that VIEWS a caller-owned array and stores it in the
+ * global "statsCalculators" table, in the same way as statsCalcCreate().
+ *
+ * Only the pointer and length are stored, so no copy of the array is made and no memory
+ * proportional to its length is allocated. The caller retains ownership of the array and
+ * must keep it valid until statsCalcDestroy() is called for the returned handle.
+ *
+ * \param values - A pointer to the first element of the caller-owned array.
+ * \param count - The number of elements in the array.
+ *
+ * \return An integer "handle" that uniquely refers to the instantiated
+ * StatsCalculator object, or -1 if values is null and count is non-zero or if the
+ * maximum number of simultaneously live instances has been reached.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcCreateView(const double * values, size_t count){
+    // Refuse to view a null array that claims to contain values.
+    if(values == 0 && count > 0){
+        return -1;
+    }
+    return acquireEntry(StatsCalculator(values, count));
+}
+
+/** Searches the global "statsCalculators" for an element corresponding to the integer
+ * handle that is provided as the function argument. If the corresponding element is
+ * found, its instance is destroyed and the element is returned to the free list. Otherwise this function is a no-op. If an asynchronous load
+ * into the instance is in progress, the function waits for it to complete first.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should
+ * be destroyed.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcDestroy(int handle){
+    CalculatorEntry * entry = findEntry(handle);
+    if(entry == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    // A worker thread may still be loading into the instance, so let it finish first.
+    finishIngest(*entry);
+    releaseEntry(handle);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the StatsCalculator::reset() method is invoked on the retrieved
+ * instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should
+ * be reset.
+ * \param releaseMemory - If non-zero, the memory that held the values is released.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcReset(int handle, int releaseMemory){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->reset(releaseMemory != 0);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the StatsCalculator::appendValue() method is then invoked on the
+ * retrieved StatsCalculator instance, passing "value" argument.
+ * 
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should
+ * append "value" to its "numericValues" member datum.
+ * \param value - A double precision value to append to the "numericValues"
+ * member datum of the StatsCalculator instance to which handle refers.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcAppendValue(int handle, double value){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->appendValue(value);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the StatsCalculator::appendValues() method is invoked on the
+ * retrieved instance, so that a whole array is appended with a single C API call.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should
+ * append the values.
+ * \param values - A pointer to the first element of an array of values.
+ * \param count - The number of elements in the array.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if values is null and count is non-zero.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcAppendValues(int handle, const double * values, size_t count){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(values == 0 && count > 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    calculator->appendValues(values, count);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the StatsCalculator::setStreaming() method is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should
+ * start or stop streaming.
+ * \param enabled - Non-zero to enable streaming, zero to disable it.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetStreaming(int handle, int enabled){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->setStreaming(enabled != 0);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::appendWeightedValues() is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should append the values.
+ * \param values - A pointer to the first element of an array of values.
+ * \param weights - A pointer to the first element of an array of weights.
+ * \param count - The number of elements in each array.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if values or weights is null and count is non-zero.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcAppendWeightedValues(int handle, const double * values,
+                                                              const double * weights, size_t count){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if((values == 0 || weights == 0) && count > 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    calculator->appendWeightedValues(values, weights, count);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::ingestWeightedFile() is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should parse the file.
+ * \param fileName - A C-string specifying the path of the file to be opened and parsed.
+ * \param column - One of the StatsCalcWeightColumn values.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid,
+ * STATSCALC_NULL_ARGUMENT if fileName is null, STATSCALC_INVALID_ARGUMENT if column is
+ * not one of the StatsCalcWeightColumn values or STATSCALC_FILE_ERROR if the file could
+ * not be opened.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcReadWeightedFile(int handle, const char * fileName, int column){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(fileName == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    if(column != STATSCALC_WEIGHT_COLUMN_WEIGHTS && column != STATSCALC_WEIGHT_COLUMN_UNCERTAINTIES){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    if(!calculator->ingestWeightedFile(fileName, static_cast<StatsCalcWeightColumn>(column))){
+        return STATSCALC_FILE_ERROR;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::getWeightedStatistics() is
+ * copied into the caller's structure.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose weighted statistics are
+ * required.
+ * \param result - A pointer to a caller-allocated StatsWeightedResult structure.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no values with usable weights
+ * have been appended, STATSCALC_INVALID_HANDLE if the handle is not valid or
+ * STATSCALC_NULL_ARGUMENT if result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetWeighted(int handle, StatsWeightedResult * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *result = calculator->getWeightedStatistics();
+    return result->count > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::appendPairs() is invoked on the retrieved
+ * instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should accumulate the pairs.
+ * \param x - A pointer to the first element of the first channel.
+ * \param y - A pointer to the first element of the second channel.
+ * \param count - The number of elements in each array.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if x or y is null and count is non-zero.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcAppendPairs(int handle, const double * x, const double * y, size_t count){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if((x == 0 || y == 0) && count > 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    calculator->appendPairs(x, y, count);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::ingestPairsFile() is invoked on the retrieved
+ * instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should parse the file.
+ * \param fileName - A C-string specifying the path of the file to be opened and parsed.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid,
+ * STATSCALC_NULL_ARGUMENT if fileName is null or STATSCALC_FILE_ERROR if the file could
+ * not be opened.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcReadPairsFile(int handle, const char * fileName){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(fileName == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    if(!calculator->ingestPairsFile(fileName)){
+        return STATSCALC_FILE_ERROR;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::getBivariateStatistics() is
+ * copied into the caller's structure.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose bivariate statistics are
+ * required.
+ * \param result - A pointer to a caller-allocated StatsBivariateResult structure.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no pairs have been appended,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if
+ * result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetBivariate(int handle, StatsBivariateResult * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *result = calculator->getBivariateStatistics();
+    return result->count > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::setTimeResolutions() is invoked on the
+ * retrieved instance with a copy of the caller's array of widths.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should be configured.
+ * \param widths - A pointer to the first element of the array of widths.
+ * \param count - The number of elements in the array.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid,
+ * STATSCALC_NULL_ARGUMENT if widths is null and count is non-zero or
+ * STATSCALC_INVALID_ARGUMENT if the widths do not form a cascade.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetTimeResolutions(int handle, const double * widths, size_t count){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(widths == 0 && count > 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    if(!calculator->setTimeResolutions(std::vector<double>(widths, widths + count))){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::appendTimedValues() is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should append the values.
+ * \param times - A pointer to the first element of the array of timestamps.
+ * \param values - A pointer to the first element of the array of values.
+ * \param count - The number of elements in each array.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if times or values is null and count is non-zero.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcAppendTimedValues(int handle, const double * times, const double * values,
+                                                           size_t count){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if((times == 0 || values == 0) && count > 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    calculator->appendTimedValues(times, values, count);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::ingestTimedFile() is invoked on the retrieved
+ * instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should parse the file.
+ * \param fileName - A C-string specifying the path of the file to be opened and parsed.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid,
+ * STATSCALC_NULL_ARGUMENT if fileName is null or STATSCALC_FILE_ERROR if the file could
+ * not be opened.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcReadTimedFile(int handle, const char * fileName){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(fileName == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    if(!calculator->ingestTimedFile(fileName)){
+        return STATSCALC_FILE_ERROR;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::flushTimeBuckets() is invoked on the retrieved
+ * instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose open buckets should be completed.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcFlushTimeBuckets(int handle){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->flushTimeBuckets();
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid and the resolution exists, at most "capacity" of the oldest
+ * completed buckets are removed by StatsCalculator::takeTimeBuckets() and copied into
+ * the caller's array.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose buckets are required.
+ * \param resolution - The index of the resolution.
+ * \param buckets - A pointer to a caller-allocated array of "capacity" StatsTimeBucket structures.
+ * \param capacity - The number of elements in the array.
+ * \param count - A pointer to a caller-allocated size_t that receives the number of elements filled.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if there were no completed buckets,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid, STATSCALC_NULL_ARGUMENT if count
+ * is null (or buckets is null and capacity is non-zero) or STATSCALC_INVALID_ARGUMENT if
+ * the resolution does not exist.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcTakeTimeBuckets(int handle, size_t resolution, StatsTimeBucket * buckets,
+                                                         size_t capacity, size_t * count){
+    if(count == 0 || (buckets == 0 && capacity > 0)){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(resolution >= calculator->getTimeRollup().widths.size()){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    const std::vector<StatsTimeBucket> taken = calculator->takeTimeBuckets(resolution, capacity);
+    std::copy(taken.begin(), taken.end(), buckets);
+    *count = taken.size();
+    return taken.empty() ? STATSCALC_NO_DATA : STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::writeTimeBuckets() is invoked on the retrieved
+ * instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose buckets should be written.
+ * \param fileName - A C-string specifying the path of the file to be written.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid,
+ * STATSCALC_NULL_ARGUMENT if fileName is null or STATSCALC_FILE_ERROR if the file could
+ * not be opened.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcWriteTimeBuckets(int handle, const char * fileName){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(fileName == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    if(!calculator->writeTimeBuckets(fileName)){
+        return STATSCALC_FILE_ERROR;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::setChangeDetection() is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should be configured.
+ * \param method - One of the StatsCalcChangeMethod values.
+ * \param threshold - The threshold, in standard deviations.
+ * \param drift - The drift, in standard deviations.
+ * \param warmupCount - The number of warm-up values.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_INVALID_ARGUMENT if a parameter is out of range.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetChangeDetection(int handle, int method, double threshold, double drift,
+                                                            long long warmupCount){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(method != STATSCALC_CHANGE_NONE && method != STATSCALC_CHANGE_CUSUM && method != STATSCALC_CHANGE_PAGE_HINKLEY){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    if(!calculator->setChangeDetection(static_cast<StatsCalcChangeMethod>(method), threshold, drift, warmupCount)){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::setChangeCallback() is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose detections should be signalled.
+ * \param callback - The function to call, or null.
+ * \param userData - A pointer that is passed to the function.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetChangeCallback(int handle, StatsCalcChangeCallback callback,
+                                                           void * userData){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->setChangeCallback(callback, userData);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid and a change has been detected since the previous call, it is
+ * taken by StatsCalculator::takeChangePoint() and copied into the caller's structure.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose change is required.
+ * \param change - A pointer to a caller-allocated StatsChangePoint structure.
+ *
+ * \return STATSCALC_OK if a change was taken, STATSCALC_NO_DATA if none was pending,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if
+ * change is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcTakeChangePoint(int handle, StatsChangePoint * change){
+    if(change == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    return calculator->takeChangePoint(*change) ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::getChangeCount() is copied into
+ * the caller's long long.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose detections are counted.
+ * \param result - A pointer to a caller-allocated long long.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetChangeCount(int handle, long long * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *result = calculator->getChangeCount();
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the function is subscribed to snapshots of the statistics by
+ * StatsCalculator::subscribe().
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose statistics should be delivered.
+ * \param callback - The function that receives the snapshots.
+ * \param userData - A pointer that is passed to the function.
+ * \param everySamples - The number of values after which a snapshot is delivered, or zero.
+ * \param everyMilliseconds - The period, in milliseconds, with which snapshots are
+ * delivered, or zero.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid,
+ * STATSCALC_NULL_ARGUMENT if callback is null or STATSCALC_INVALID_ARGUMENT if the intervals
+ * are out of range.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSubscribe(int handle, StatsCalcSnapshotCallback callback, void * userData,
+                                                   long long everySamples, unsigned everyMilliseconds){
+    if(callback == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(!calculator->subscribe(callback, userData, everySamples, everyMilliseconds)){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, its subscription is cancelled by StatsCalculator::unsubscribe().
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose subscription should be cancelled.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcUnsubscribe(int handle){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->unsubscribe();
+    return STATSCALC_OK;
+}
 
-/** Declare a "global" std::map that associates integer "handles" with instances of StatsCalculator
- * This will permit C code to instantiate and access StatsCalulator objects without
- * having to directly reference them.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, a snapshot of its statistics is posted to its subscriber (if any)
+ * by StatsCalculator::publishStatistics().
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose statistics should be delivered.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
  */
-std::map<int, StatsCalculator> statsCalculators;
+STATSCALCULATORLABVIEW_CAPI int statsCalcPublishStatistics(int handle){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->publishStatistics();
+    return STATSCALC_OK;
+}
 
-/* The subsequent code provides the DEFINITIONS of the C API functions. The definitions include
- * C++-only language constructs and must be compiled with a C++ compiler. However, mangling of
- * the function identifiers must be suppressed by prepending them with the 'extern "C"' token pair.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the publication of its live statistics is enabled or disabled by
+ * StatsCalculator::setLiveStatisticsEnabled().
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose statistics should be published.
+ * \param enabled - Non-zero to publish the statistics, zero to stop.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
  */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetLiveStatistics(int handle, int enabled){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->setLiveStatisticsEnabled(enabled != 0);
+    return STATSCALC_OK;
+}
 
-/** Instantiates a StatsCalculator object and appends it to the global "statsCalculators" std::map
- * using a new integer key equal to one greater than the highest key value currently stored.
- * The elements of std::maps are std::pair types. A std:pair is a special container with exactly two elements
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
  *
- * The keys of the map are stored as the first element of each pair and the associated values are stored as
- * the second element of the pair.
+ * If the handle is valid, the address of the structure returned by
+ * StatsCalculator::getLiveStatistics() is stored in the caller's pointer. Elements of
+ * "statsCalculators" never move and are never removed, so the address can always be read.
+ * The structure is tagged with the handle by acquireEntry(), and the tag is cleared by
+ * releaseEntry(), so that statsCalcReadLiveStatistics() can tell when the address no longer
+ * describes the instance.
  *
- * The elements of a std::map are stored in key-sorted order, so the largest key will correspond to the
- * last element of the map. If the map is NOT empty, this is obtained by dereferencing the iterator
- * returned by the rbegin() ("reverse begin") method of std::map, and extracting the first element of
- * the std::pair instance that is returned. If the map IS empty, dereferencing the iterator will generate
- * a segmentation fault, so a default zero-valued key is used.
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose statistics should be read.
+ * \param live - A pointer to a caller-allocated pointer that receives the address.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid or
+ * STATSCALC_NULL_ARGUMENT if live is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetLiveStatistics(int handle, const StatsLiveStatistics ** live){
+    if(live == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *live = &calculator->getLiveStatistics();
+    return STATSCALC_OK;
+}
+
+/** Reads the live statistics of a StatsCalculator instance with
+ * StatsLiveStatistics::read() and copies them into the caller's structure. The global
+ * "statsCalculators" table is not accessed, so the function may be called by any thread,
+ * concurrently with the other C API functions.
  *
- * The new element is inserted into the map using the emplace_hint() method provided by std::map,
- * which returns an iterator corresponding to the std::pair that was inserted. The C API function
- * then dereferences the iterator and returns the first element of the std::pair.
+ * The handle is validated by comparing it with the tag that is read together with the
+ * statistics. The generation that is encoded in the handle is part of the tag, so the
+ * statistics of a destroyed instance, or of a later instance that reuses its element, are
+ * never returned.
  *
- * Since the keys of a std::map must be unique, the returned integer provides a unique handle to a
- * particular StatsCalculator instance.
+ * \param live - A pointer that was obtained from statsCalcGetLiveStatistics().
+ * \param handle - The handle that was passed to statsCalcGetLiveStatistics().
+ * \param result - A pointer to a caller-allocated StatsResult structure.
  *
- * \return An integer "handle" that uniquely refers to the instantiated
- * StatsCalculator object.
+ * \return STATSCALC_OK on success, STATSCALC_NULL_ARGUMENT if either pointer is null,
+ * STATSCALC_INVALID_HANDLE if the structure no longer belongs to the handle or
+ * STATSCALC_NO_DATA if no values have been published.
  */
-STATSCALCULATORLABVIEW_CAPI int statsCalcCreate(){
-    // Compute an appropriate key to associate with a new StatsCalculator instance.
-    int key = statsCalculators.empty() ? 0 : statsCalculators.rbegin()->first + 1;
-    /* Construct a new std::pair<int, StatsCalculator> and insert it into the global "statsCalculators"
-     * std::map.
-     *
-     * If the insertion is successful, an immutable iterator corresponding to the inserted element is
-     * returned. Dereferencing this iterator returns an immutable reference to the ELEMENT, which
-     * corresponds to a key-value pair.
-     */
-    const std::pair<int, StatsCalculator> & created = *statsCalculators.emplace_hint(statsCalculators.end(), std::make_pair(key, StatsCalculator()));
-    /* return the first element of the inserted std::pair, which corresponds to a unique integer
-     * key.
-     */
-    return created.first;
+STATSCALCULATORLABVIEW_CAPI int statsCalcReadLiveStatistics(const StatsLiveStatistics * live, int handle,
+                                                            StatsResult * result){
+    if(live == 0 || result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    RunningStatistics statistics;
+    int tag;
+    live->read(statistics, &tag);
+    if(handle < 0 || tag != handle){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    statistics.fill(*result);
+    return statistics.count > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
 }
 
-/** Searches the global "statsCalculators" for an element corresponding to the integer
- * handle that is provided as the function argument. If the corresponding element is
- * found, it is destroyed. Otherwise this function is a no-op.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::setQuantileSketchEnabled() is invoked on the
+ * retrieved instance.
  *
  * \param handle - an integer that was returned by statsCalcCreate() and
- * uniquely references the instance of StatsCalculator that should
- * be destroyed.
+ * uniquely references the instance of StatsCalculator whose sketch should be enabled
+ * or disabled.
+ * \param enabled - Non-zero to enable the sketch, zero to disable it.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
  */
-STATSCALCULATORLABVIEW_CAPI void statsCalcDestroy(int handle){
-    std::map<int, StatsCalculator>::iterator handlePos = statsCalculators.find(handle);
-    if(handlePos != statsCalculators.end()){
-        statsCalculators.erase(handlePos);
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetQuantileSketch(int handle, int enabled){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
     }
+    calculator->setQuantileSketchEnabled(enabled != 0);
+    return STATSCALC_OK;
 }
 
-/** \brief Expose the functionality of StatsCalculator::appendValue() in the
- * C API.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid and the options are in range, StatsCalculator::setBootstrapOptions()
+ * and StatsCalculator::setBootstrapEnabled() are invoked on the retrieved instance.
  *
  * \param handle - an integer that was returned by statsCalcCreate() and
- * uniquely references the instance of StatsCalculator that should
- * be induced to parse the file.
- * \param value - A double precision value to append to the "numericValues"
- * member datum of the StatsCalculator instance to which handle refers.
+ * uniquely references the instance of StatsCalculator whose bootstrap should be configured.
+ * \param enabled - Non-zero to report bootstrap intervals, zero to omit them.
+ * \param resampleCount - The number of resamples.
+ * \param confidenceLevel - The confidence level.
+ * \param seed - The seed of the random number generator.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_INVALID_ARGUMENT if resampleCount or confidenceLevel is out of range.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetBootstrap(int handle, int enabled, unsigned resampleCount,
+                                                      double confidenceLevel, unsigned long long seed){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(!calculator->setBootstrapOptions(resampleCount, confidenceLevel, seed)){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    calculator->setBootstrapEnabled(enabled != 0);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::setAutocorrelationEnabled() is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should be configured.
+ * \param enabled - Non-zero to report the autocorrelation statistics, zero to omit them.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
  */
-;
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetAutocorrelation(int handle, int enabled){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->setAutocorrelationEnabled(enabled != 0);
+    return STATSCALC_OK;
+}
 
-/** Attempts to retrieve a StatsCalculator instance from the global "statsCalculators"
- * that corresponds to  to the integer handle that is provided as the first function
- * argument. If the specified handle is not a key in the map the at() method will
- * raise a std::out_of_range exception. The function catches this exception but (currently)
- * takes no actions to handle it.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::setFrequencySketchesEnabled() is invoked on the
+ * retrieved instance.
  *
- * If the key is valid, the StatsCalculator::appendValue() method is then invoked on the
- * retrieved StatsCalculatorinstance, passing "value" argument.
- * 
  * \param handle - an integer that was returned by statsCalcCreate() and
- * uniquely references the instance of StatsCalculator that should
- * append "value" to its "numericValues" member datum.
- * \param value - A double precision value to append to the "numericValues"
- * member datum of the StatsCalculator instance to which handle refers.
+ * uniquely references the instance of StatsCalculator that should be configured.
+ * \param enabled - Non-zero to enable the frequency sketches, zero to disable them.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
  */
-STATSCALCULATORLABVIEW_CAPI void statsCalcAppendValue(int handle, double value){
-    try{
-        statsCalculators.at(handle).appendValue(value);
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetFrequencySketches(int handle, int enabled){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
     }
-    catch(std::out_of_range & exception){
-        // Intentionally take no action.
-        return;
+    calculator->setFrequencySketchesEnabled(enabled != 0);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instances that correspond to the two integer handles that
+ * are provided as the function arguments using findCalculator(). If either handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If both handles are valid, the frequency sketches of the second instance are merged into
+ * those of the first by StatsCalculator::mergeFrequencySketches().
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose sketches absorb the others.
+ * \param sourceHandle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose sketches are merged.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if either handle is not valid
+ * or STATSCALC_INVALID_ARGUMENT if the frequency sketches of the first instance are disabled.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcMergeFrequencySketches(int handle, int sourceHandle){
+    StatsCalculator * calculator = findCalculator(handle);
+    StatsCalculator * source = findCalculator(sourceHandle);
+    if(calculator == 0 || source == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(!calculator->mergeFrequencySketches(source->getDistinctCountSketch(), source->getFrequencySketch())){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, StatsCalculator::setReservoirSampling() is invoked on the
+ * retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should be configured.
+ * \param size - The largest number of values in the sample, or zero to disable sampling.
+ * \param seed - The seed of the random numbers.
+ *
+ * \return STATSCALC_OK on success or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetReservoirSampling(int handle, size_t size, unsigned long long seed){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    calculator->setReservoirSampling(size, seed);
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instances that correspond to the two integer handles that
+ * are provided as the function arguments using findCalculator(). If either handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If both handles are valid, the reservoir sample of the second instance is merged into
+ * that of the first by StatsCalculator::mergeReservoirSample().
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose sample absorbs the other.
+ * \param sourceHandle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose sample is merged.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if either handle is not valid
+ * or STATSCALC_INVALID_ARGUMENT if the samples cannot be merged.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcMergeReservoirSamples(int handle, int sourceHandle){
+    StatsCalculator * calculator = findCalculator(handle);
+    StatsCalculator * source = findCalculator(sourceHandle);
+    if(calculator == 0 || source == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(!calculator->mergeReservoirSample(source->getReservoirSample())){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid and the mode is one of the StatsCalcNonFiniteMode values, the
+ * StatsCalculator::setNonFiniteMode() method is invoked on the retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose mode should be set.
+ * \param mode - One of the StatsCalcNonFiniteMode values.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_INVALID_ARGUMENT if mode is not one of the StatsCalcNonFiniteMode values.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetNonFiniteMode(int handle, int mode){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(mode != STATSCALC_NONFINITE_INCLUDE && mode != STATSCALC_NONFINITE_SKIP_NAN
+       && mode != STATSCALC_NONFINITE_SKIP_ALL){
+        return STATSCALC_INVALID_ARGUMENT;
     }
+    calculator->setNonFiniteMode(static_cast<StatsCalcNonFiniteMode>(mode));
+    return STATSCALC_OK;
 }
 
-/** Attempts to retrieve a StatsCalculator instance from the global "statsCalculators"
- * that corresponds to  to the integer handle that is provided as the first function
- * argument. If the specified handle is not a key in the map the at() method will
- * raise a std::out_of_range exception. The function catches this exception but (currently)
- * takes no actions to handle it.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
  *
- * If the key is valid, StatsCalculator::readFile() method is invoked on the
+ * If the handle is valid, StatsCalculator::readFile() method is invoked on the
  * retrieved instance, passing the fileName C-string that was provided as the second
  * function argument.
  *
@@ -135,24 +1247,187 @@ STATSCALCULATORLABVIEW_CAPI void statsCalcAppendValue(int handle, double value){
  * be induced to parse the file.
  * \param fileName - A C-string specifying the path of the file to be
  * opened and parsed.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if fileName is null.
  */
-STATSCALCULATORLABVIEW_CAPI void statsCalcReadFile(int handle, const char * fileName){
-    try{
-        statsCalculators.at(handle).readFile(fileName);
+STATSCALCULATORLABVIEW_CAPI int statsCalcReadFile(int handle, const char * fileName){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
     }
-    catch(std::out_of_range & exception){
-        // Intentionally take no action.
-        return;
+    if(fileName == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    calculator->readFile(fileName);
+    return STATSCALC_OK;
+}
+
+/** Starts an asynchronous load of a file into the StatsCalculator instance that corresponds
+ * to the integer handle that is provided as the first function argument.
+ *
+ * A task that calls StatsCalculator::ingestFile() is submitted to the shared
+ * StatsCalculatorWorkerPool and the function returns without waiting for it. The task and
+ * the C API share an AsyncIngest structure, through which the task reports its progress and
+ * its outcome.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should
+ * be induced to parse the file.
+ * \param fileName - A C-string specifying the path of the file to be
+ * opened and parsed.
+ *
+ * \return STATSCALC_OK if the load was scheduled, STATSCALC_BUSY if a previous load into the
+ * same handle has not yet completed, STATSCALC_INVALID_HANDLE if the handle is not valid or
+ * STATSCALC_NULL_ARGUMENT if fileName is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcReadFileAsync(int handle, const char * fileName){
+    CalculatorEntry * entry = findEntry(handle);
+    if(entry == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(fileName == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    if(entry->pendingIngest){
+        return STATSCALC_BUSY;
+    }
+    
+    // Create the state that is shared with the worker thread.
+    std::shared_ptr<AsyncIngest> ingest = std::make_shared<AsyncIngest>();
+    entry->pendingIngest = ingest;
+    
+    /* Submit a task (a lambda expression) that captures copies of everything it needs. The
+     * file name is copied into a std::string because the caller's C-string may not outlive
+     * this call.
+     */
+    StatsCalculator * calculator = &entry->calculator;
+    std::string path(fileName);
+    StatsCalculatorWorkerPool::shared().submit([ingest, calculator, path](){
+        bool fileOpened = calculator->ingestFile(path, &ingest->progress);
+        {
+            std::lock_guard<std::mutex> lock(ingest->mutex);
+            ingest->finished = true;
+            ingest->fileOpened = fileOpened;
+        }
+        ingest->finishedCondition.notify_all();
+    });
+    return STATSCALC_OK;
+}
+
+/** Checks, without blocking, whether the asynchronous load into the StatsCalculator instance
+ * that corresponds to the integer handle has completed. If it has, its outcome is returned
+ * and the load is forgotten.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate().
+ * \param progress - An optional pointer to a double that receives the fraction of the file
+ * that has been parsed.
+ *
+ * \return STATSCALC_BUSY if the load is still in progress, otherwise the outcome of the load
+ * as returned by statsCalcWait(). STATSCALC_INVALID_HANDLE is returned if the handle is not
+ * valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcPoll(int handle, double * progress){
+    CalculatorEntry * entry = findEntry(handle);
+    if(entry == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(entry->pendingIngest){
+        AsyncIngest & ingest = *entry->pendingIngest;
+        bool finished;
+        {
+            std::lock_guard<std::mutex> lock(ingest.mutex);
+            finished = ingest.finished;
+        }
+        if(!finished){
+            if(progress != 0){
+                long long bytesTotal = ingest.progress.bytesTotal;
+                *progress = bytesTotal > 0 ? static_cast<double>(ingest.progress.bytesConsumed)/bytesTotal : 0.0;
+            }
+            return STATSCALC_BUSY;
+        }
+    }
+    if(progress != 0){
+        *progress = 1.0;
+    }
+    // The load (if any) has finished, so collecting its outcome will not block.
+    return completeIngest(*entry);
+}
+
+/** Blocks until the asynchronous load into the StatsCalculator instance that corresponds to
+ * the integer handle has completed, then returns its outcome and forgets it.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate().
+ *
+ * \return STATSCALC_OK if there was no load or the load succeeded, STATSCALC_FILE_ERROR if the
+ * file could not be opened or STATSCALC_INVALID_HANDLE if the handle is not valid.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcWait(int handle){
+    CalculatorEntry * entry = findEntry(handle);
+    if(entry == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    return completeIngest(*entry);
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid and the policy is one of the StatsCalcParsePolicy values, the
+ * StatsCalculator::setParsePolicy() method is invoked on the retrieved instance.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose policy should be set.
+ * \param policy - One of the StatsCalcParsePolicy values.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_INVALID_ARGUMENT if policy is not one of the StatsCalcParsePolicy values.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcSetParsePolicy(int handle, int policy){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(policy != STATSCALC_PARSE_SKIP && policy != STATSCALC_PARSE_NAN && policy != STATSCALC_PARSE_STOP){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    calculator->setParsePolicy(static_cast<StatsCalcParsePolicy>(policy));
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the report returned by StatsCalculator::getParseReport() is
+ * copied into the caller's structure. Since findCalculator() waits for any asynchronous
+ * load to finish, the report of a load started by statsCalcReadFileAsync() is complete.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that parsed the file.
+ * \param report - A pointer to a caller-allocated StatsParseReport structure.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if report is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetParseReport(int handle, StatsParseReport * report){
+    if(report == 0){
+        return STATSCALC_NULL_ARGUMENT;
     }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *report = calculator->getParseReport();
+    return STATSCALC_OK;
 }
 
-/** Attempts to retrieve a StatsCalculator instance from the global "statsCalculators"
- * that corresponds to  to the integer handle that is provided as the first function
- * argument. If the specified handle is not a key in the map the at() method will
- * raise a std::out_of_range exception. The function catches this exception but (currently)
- * takes no actions to handle it.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
  *
- * If the key is valid, StatsCalculator::writeStats() method is invoked on the
+ * If the handle is valid, StatsCalculator::writeStats() method is invoked on the
  * retrieved instance, passing the fileName C-string that was provided as the second
  * function argument.
  *
@@ -161,24 +1436,28 @@ STATSCALCULATORLABVIEW_CAPI void statsCalcReadFile(int handle, const char * file
  * be induced to write its computed statistics to a file.
  * \param fileName - A C-string specifying the path of the file to be
  * written.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if fileName is null.
  */
-STATSCALCULATORLABVIEW_CAPI void statsCalcWriteStats(int handle, const char * fileName){
-    try{
-        statsCalculators.at(handle).writeStats(fileName);
+STATSCALCULATORLABVIEW_CAPI int statsCalcWriteStats(int handle, const char * fileName){
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
     }
-    catch(std::out_of_range & exception){
-        // Intentionally take no action.
-        return;
+    if(fileName == 0){
+        return STATSCALC_NULL_ARGUMENT;
     }
+    calculator->writeStats(fileName);
+    return STATSCALC_OK;
 }
 
-/** Attempts to retrieve a StatsCalculator instance from the global "statsCalculators"
- * that corresponds to  to the integer handle that is provided as the first function
- * argument. If the specified handle is not a key in the map the at() method will
- * raise a std::out_of_range exception. The function catches this exception but (currently)
- * takes no actions to handle it and returns a default zero value.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid a default zero value is returned. Use statsCalcGetAll() to distinguish an invalid
+ * handle from a genuine zero.
  *
- * If the key is valid, StatsCalculator::getSum() method is invoked on the
+ * If the handle is valid, StatsCalculator::getSum() method is invoked on the
  * retrieved instance and its return value is returned by the function.
  *
  * \param handle - an integer that was returned by statsCalcCreate() and
@@ -189,21 +1468,16 @@ STATSCALCULATORLABVIEW_CAPI void statsCalcWriteStats(int handle, const char * fi
  * instance to which handle refers.
  */
 STATSCALCULATORLABVIEW_CAPI double statsCalcGetSum(int handle){
-    try{
-        return statsCalculators.at(handle).getSum();
-    }
-    catch(std::out_of_range & exception){
-        return 0.0;
-    }
+    StatsCalculator * calculator = findCalculator(handle);
+    return calculator != 0 ? calculator->getSum() : 0.0;
 }
 
-/** Attempts to retrieve a StatsCalculator instance from the global "statsCalculators"
- * that corresponds to  to the integer handle that is provided as the first function
- * argument. If the specified handle is not a key in the map the at() method will
- * raise a std::out_of_range exception. The function catches this exception but (currently)
- * takes no actions to handle it and returns a default zero value.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid a default zero value is returned. Use statsCalcGetAll() to distinguish an invalid
+ * handle from a genuine zero.
  *
- * If the key is valid, StatsCalculator::getMean() method is invoked on the
+ * If the handle is valid, StatsCalculator::getMean() method is invoked on the
  * retrieved instance and its return value is returned by the function.
  *
  * \param handle - an integer that was returned by statsCalcCreate() and
@@ -214,21 +1488,16 @@ STATSCALCULATORLABVIEW_CAPI double statsCalcGetSum(int handle){
  * instance to which handle refers.
  */
 STATSCALCULATORLABVIEW_CAPI double statsCalcGetMean(int handle){
-    try{
-        return statsCalculators.at(handle).getMean();
-    }
-    catch(std::out_of_range & exception){
-        return 0.0;
-    }
+    StatsCalculator * calculator = findCalculator(handle);
+    return calculator != 0 ? calculator->getMean() : 0.0;
 }
 
-/** Attempts to retrieve a StatsCalculator instance from the global "statsCalculators"
- * that corresponds to  to the integer handle that is provided as the first function
- * argument. If the specified handle is not a key in the map the at() method will
- * raise a std::out_of_range exception. The function catches this exception but (currently)
- * takes no actions to handle it and returns a default zero value.
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid a default zero value is returned. Use statsCalcGetAll() to distinguish an invalid
+ * handle from a genuine zero.
  *
- * If the key is valid, StatsCalculator::getStandardDeviation() method is invoked on the
+ * If the handle is valid, StatsCalculator::getStandardDeviation() method is invoked on the
  * retrieved instance and its return value is returned by the function.
  *
  * \param handle - an integer that was returned by statsCalcCreate() and
@@ -239,10 +1508,349 @@ STATSCALCULATORLABVIEW_CAPI double statsCalcGetMean(int handle){
  * StatsCalculator instance to which handle refers.
  */
 STATSCALCULATORLABVIEW_CAPI double statsCalcGetStdDev(int handle){
-    try{
-        return statsCalculators.at(handle).getStandardDeviation();
+    StatsCalculator * calculator = findCalculator(handle);
+    return calculator != 0 ? calculator->getStandardDeviation() : 0.0;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid and the trim fraction is in range, the result of
+ * StatsCalculator::getRobustStatistics() is copied into the caller's structure.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose robust statistics are
+ * required.
+ * \param trimFraction - The fraction of the values to trim (or winsorize) from each end.
+ * \param result - A pointer to a caller-allocated StatsRobustResult structure.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance holds no values,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid, STATSCALC_NULL_ARGUMENT if result
+ * is null or STATSCALC_INVALID_ARGUMENT if trimFraction is not at least zero and less
+ * than one half.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetRobust(int handle, double trimFraction, StatsRobustResult * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(!(trimFraction >= 0.0 && trimFraction < 0.5)){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    *result = calculator->getRobustStatistics(trimFraction);
+    return result->count > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::getBootstrapIntervals() is
+ * copied into the caller's structure.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose bootstrap intervals are
+ * required.
+ * \param result - A pointer to a caller-allocated StatsBootstrapResult structure.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance stores no values,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if
+ * result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetBootstrap(int handle, StatsBootstrapResult * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *result = calculator->getBootstrapIntervals();
+    return result->count > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::getAutocorrelationStatistics()
+ * is copied into the caller's structure.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose autocorrelation statistics
+ * are required.
+ * \param result - A pointer to a caller-allocated StatsAutocorrelationResult structure.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no values are stored,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if
+ * result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetAutocorrelationStatistics(int handle,
+                                                                      StatsAutocorrelationResult * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *result = calculator->getAutocorrelationStatistics();
+    return result->count > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::getAutocorrelations() is copied
+ * into the caller's array.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose autocorrelations are required.
+ * \param values - A pointer to a caller-allocated array of at least lagCount doubles.
+ * \param lagCount - The number of lags.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if no values are stored,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if
+ * values is null and lagCount is non-zero.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcCopyAutocorrelations(int handle, double * values, size_t lagCount){
+    if(values == 0 && lagCount > 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    // The autocorrelation at lag zero is one (or NaN) unless there are no values, so at least one lag is computed.
+    const std::vector<double> autocorrelations = calculator->getAutocorrelations(lagCount > 0 ? lagCount : 1);
+    if(lagCount > 0){
+        std::copy(autocorrelations.begin(), autocorrelations.begin() + lagCount, values);
+    }
+    return autocorrelations[0] != 0.0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::getDistinctCount() is copied into
+ * the caller's double.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose distinct values are counted.
+ * \param result - A pointer to a caller-allocated double.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the sketches are empty,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if
+ * result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetDistinctCount(int handle, double * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *result = calculator->getDistinctCount();
+    return calculator->getFrequencySketch().total > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, the result of StatsCalculator::estimateFrequency() is copied into
+ * the caller's long long.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose sketches are queried.
+ * \param value - The value whose occurrences are counted.
+ * \param result - A pointer to a caller-allocated long long.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the sketches are empty,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if
+ * result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcEstimateFrequency(int handle, double value, long long * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    *result = calculator->estimateFrequency(value);
+    return calculator->getFrequencySketch().total > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, at most "capacity" elements of the result of
+ * StatsCalculator::getHeavyHitters() are copied into the caller's array.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose most frequent values are required.
+ * \param hitters - A pointer to a caller-allocated array of "capacity" StatsHeavyHitter structures.
+ * \param capacity - The number of elements in the array.
+ * \param count - A pointer to a caller-allocated size_t that receives the number of elements filled.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the sketches are empty,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if count
+ * is null (or hitters is null and capacity is non-zero).
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetHeavyHitters(int handle, StatsHeavyHitter * hitters, size_t capacity,
+                                                         size_t * count){
+    if(count == 0 || (hitters == 0 && capacity > 0)){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    const std::vector<StatsHeavyHitter> heavyHitters = calculator->getHeavyHitters(capacity);
+    std::copy(heavyHitters.begin(), heavyHitters.end(), hitters);
+    *count = heavyHitters.size();
+    return calculator->getFrequencySketch().total > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, at most "capacity" of the values in the sample returned by
+ * StatsCalculator::getReservoirSample() are copied into the caller's array.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose sample is required.
+ * \param values - A pointer to a caller-allocated array of "capacity" doubles.
+ * \param capacity - The number of elements in the array.
+ * \param count - A pointer to a caller-allocated size_t that receives the number of elements filled.
+ * \param sampledCount - An optional pointer to a caller-allocated long long that receives the
+ * number of values the sample was drawn from.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the sample is empty,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid or STATSCALC_NULL_ARGUMENT if count
+ * is null (or values is null and capacity is non-zero).
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcCopyReservoirSample(int handle, double * values, size_t capacity,
+                                                             size_t * count, long long * sampledCount){
+    if(count == 0 || (values == 0 && capacity > 0)){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    const ReservoirSample & reservoir = calculator->getReservoirSample();
+    *count = reservoir.values.size() < capacity ? reservoir.values.size() : capacity;
+    std::copy(reservoir.values.begin(), reservoir.values.begin() + *count, values);
+    if(sampledCount != 0){
+        *sampledCount = reservoir.count;
+    }
+    return reservoir.values.empty() ? STATSCALC_NO_DATA : STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid and the probability is between zero and one, the result of
+ * StatsCalculator::getQuantile() is copied into the caller's double.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose quantile is required.
+ * \param probability - The probability, between zero and one.
+ * \param result - A pointer to a caller-allocated double.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance holds no values,
+ * STATSCALC_INVALID_HANDLE if the handle is not valid, STATSCALC_NULL_ARGUMENT if result
+ * is null or STATSCALC_INVALID_ARGUMENT if probability is not between zero and one.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetQuantile(int handle, double probability, double * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    if(!(probability >= 0.0 && probability <= 1.0)){
+        return STATSCALC_INVALID_ARGUMENT;
+    }
+    *result = calculator->getQuantile(probability);
+    return calculator->getSortedValues().empty() ? STATSCALC_NO_DATA : STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). If the handle is not
+ * valid, no action is taken and an error status is returned.
+ *
+ * If the handle is valid, as many of the values returned by
+ * StatsCalculator::getSortedValues() as fit are copied into the caller's array, and the
+ * total number of sorted values is reported.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator whose sorted values are required.
+ * \param values - A pointer to a caller-allocated array, or null if capacity is zero.
+ * \param capacity - The number of elements in the array.
+ * \param count - A pointer to a caller-allocated size_t that receives the total number
+ * of sorted values.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_INVALID_HANDLE if the handle is not valid
+ * or STATSCALC_NULL_ARGUMENT if count is null, or values is null and capacity is non-zero.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcCopySortedValues(int handle, double * values, size_t capacity,
+                                                          size_t * count){
+    if(count == 0 || (values == 0 && capacity > 0)){
+        return STATSCALC_NULL_ARGUMENT;
+    }
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
+    }
+    const std::vector<double> & sorted = calculator->getSortedValues();
+    const size_t copied = sorted.size() < capacity ? sorted.size() : capacity;
+    if(copied > 0){
+        std::copy(sorted.begin(), sorted.begin() + copied, values);
+    }
+    *count = sorted.size();
+    return STATSCALC_OK;
+}
+
+/** Retrieves the StatsCalculator instance that corresponds to the integer handle that is
+ * provided as the first function argument using findCalculator(). Unlike the individual
+ * getters, an invalid handle is reported using a status code rather than a silent zero.
+ *
+ * If the key is valid, StatsCalculator::getStatistics() is invoked on the retrieved
+ * instance and the structure it returns is copied into the caller's structure. All the
+ * statistics are therefore computed in a single pass over the stored data.
+ *
+ * \param handle - an integer that was returned by statsCalcCreate() and
+ * uniquely references the instance of StatsCalculator that should
+ * be induced to compute its statistics.
+ * \param result - A pointer to a caller-allocated StatsResult structure that
+ * is filled with the statistics.
+ *
+ * \return STATSCALC_OK on success, STATSCALC_NO_DATA if the instance holds no
+ * values, STATSCALC_INVALID_HANDLE if the handle is not valid or
+ * STATSCALC_NULL_ARGUMENT if result is null.
+ */
+STATSCALCULATORLABVIEW_CAPI int statsCalcGetAll(int handle, StatsResult * result){
+    if(result == 0){
+        return STATSCALC_NULL_ARGUMENT;
     }
-    catch(std::out_of_range & exception){
-        return 0.0;
+    StatsCalculator * calculator = findCalculator(handle);
+    if(calculator == 0){
+        return STATSCALC_INVALID_HANDLE;
     }
+    *result = calculator->getStatistics();
+    return result->count > 0 ? STATSCALC_OK : STATSCALC_NO_DATA;
 }
@@ -3,14 +3,219 @@
 // The <iostream> header is included to enable textual terminal output.
 #include <iostream>
 
+// The <cstring> header is included to provide std::strcmp.
+#include <cstring>
+
+// The <limits> header is included to provide std::numeric_limits.
+#include <limits>
+
 /* Include StatsCalculator.h to provide class definition of
  * StatsCalculator
  */
 #include "StatsCalculator.h"
 
+/** Reports the outcome of a single behavioural check to the terminal.
+ *
+ * \param passed - Whether the check passed.
+ * \param description - A short description of what was checked.
+ *
+ * \return Zero if the check passed and 1 otherwise, so that the return values
+ * of several checks can be added to count the failures.
+ */
+static int reportCheck(bool passed, const char * description){
+    std::cout << (passed ? "PASS: " : "FAIL: ") << description << "\n";
+    return passed ? 0 : 1;
+}
+
+/** Checks that statsCalcGetAll() gives the statistics of non-finite input that
+ * the definitions \f$\sum x\f$ and \f$\sum x/N\f$ imply. An infinity in the
+ * input makes the sum and the mean infinite with the same sign, wherever the
+ * infinity occurs, and a NaN makes them NaN.
+ *
+ * \return The number of checks that failed.
+ */
+static int checkNonFiniteStatistics(){
+    
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double leadingPositive[] = { infinity, 1.0, 2.0 };
+    const double leadingNegative[] = { -infinity, 1.0, 2.0 };
+    const double leadingNaN[] = { std::numeric_limits<double>::quiet_NaN(), 1.0, 2.0 };
+    int failures = 0;
+    StatsResult result;
+    
+    int handle = statsCalcCreate();
+    statsCalcAppendValues(handle, leadingPositive, 3);
+    statsCalcGetAll(handle, &result);
+    failures += reportCheck(result.sum == infinity && result.mean == infinity,
+                            "statsCalcGetAll() with a leading +inf gives an infinite sum and mean");
+    failures += reportCheck(result.minimum == 1.0 && result.maximum == infinity,
+                            "statsCalcGetAll() with a leading +inf gives the right minimum and maximum");
+    statsCalcDestroy(handle);
+    
+    handle = statsCalcCreate();
+    statsCalcAppendValues(handle, leadingNegative, 3);
+    statsCalcGetAll(handle, &result);
+    failures += reportCheck(result.sum == -infinity && result.mean == -infinity,
+                            "statsCalcGetAll() with a leading -inf gives a negative infinite sum and mean");
+    statsCalcDestroy(handle);
+    
+    // Values appended one at a time are stored and summarized in the same way.
+    handle = statsCalcCreate();
+    statsCalcAppendValue(handle, leadingPositive[0]);
+    statsCalcAppendValue(handle, leadingPositive[1]);
+    statsCalcGetAll(handle, &result);
+    failures += reportCheck(result.count == 2 && result.mean == infinity,
+                            "statsCalcGetAll() after statsCalcAppendValue(inf) gives an infinite mean");
+    statsCalcDestroy(handle);
+    
+    // Streamed values are summarized by a running accumulator instead.
+    handle = statsCalcCreate();
+    statsCalcSetStreaming(handle, 1);
+    statsCalcAppendValue(handle, leadingPositive[0]);
+    statsCalcAppendValue(handle, leadingPositive[1]);
+    statsCalcAppendValues(handle, leadingPositive, 3);
+    statsCalcGetAll(handle, &result);
+    failures += reportCheck(result.count == 5 && result.sum == infinity && result.mean == infinity,
+                            "statsCalcGetAll() of streamed values with a leading +inf gives an infinite mean");
+    statsCalcDestroy(handle);
+    
+    // A NaN compares unequal to itself.
+    handle = statsCalcCreate();
+    statsCalcAppendValues(handle, leadingNaN, 3);
+    statsCalcGetAll(handle, &result);
+    failures += reportCheck(result.sum != result.sum && result.mean != result.mean,
+                            "statsCalcGetAll() with a leading NaN gives a NaN sum and mean");
+    statsCalcDestroy(handle);
+    
+    return failures;
+}
+
+/** Checks that statsCalcGetWeighted() gives an infinite weighted sum and mean when
+ * the values include an infinity, both within a single batch and when the
+ * statistics of several batches are merged.
+ *
+ * \return The number of checks that failed.
+ */
+static int checkNonFiniteWeightedStatistics(){
+    
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double values[] = { infinity, 1.0, 2.0, 3.0 };
+    const double weights[] = { 1.0, 1.0, 1.0, 1.0 };
+    int failures = 0;
+    StatsWeightedResult result;
+    
+    int handle = statsCalcCreate();
+    statsCalcAppendWeightedValues(handle, values, weights, 4);
+    statsCalcGetWeighted(handle, &result);
+    failures += reportCheck(result.weightedSum == infinity && result.weightedMean == infinity,
+                            "statsCalcGetWeighted() with a leading +inf gives an infinite sum and mean");
+    
+    // Merge a second batch that also contains an infinity.
+    statsCalcAppendWeightedValues(handle, values, weights, 4);
+    statsCalcGetWeighted(handle, &result);
+    failures += reportCheck(result.count == 8 && result.weightedMean == infinity,
+                            "statsCalcGetWeighted() keeps an infinite mean when batches are merged");
+    statsCalcDestroy(handle);
+    
+    return failures;
+}
+
+/** Checks that statsCalcGetBivariate() gives an infinite mean for a channel whose
+ * values include an infinity, and a finite mean for the other channel, both
+ * within a single batch and when the statistics of several batches are merged.
+ *
+ * \return The number of checks that failed.
+ */
+static int checkNonFiniteBivariateStatistics(){
+    
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double x[] = { infinity, 1.0, 2.0 };
+    const double y[] = { 1.0, 2.0, 3.0 };
+    int failures = 0;
+    StatsBivariateResult result;
+    
+    int handle = statsCalcCreate();
+    statsCalcAppendPairs(handle, x, y, 3);
+    statsCalcGetBivariate(handle, &result);
+    failures += reportCheck(result.meanX == infinity && result.meanY == 2.0,
+                            "statsCalcGetBivariate() with a leading +inf gives an infinite mean of that channel");
+    
+    // Merge a second batch that also contains an infinity.
+    statsCalcAppendPairs(handle, x, y, 3);
+    statsCalcGetBivariate(handle, &result);
+    failures += reportCheck(result.count == 6 && result.meanX == infinity && result.meanY == 2.0,
+                            "statsCalcGetBivariate() keeps an infinite mean when batches are merged");
+    statsCalcDestroy(handle);
+    
+    return failures;
+}
+
+/** Checks that a handle is rejected once statsCalcDestroy() has been called for
+ * it, even after its slot has been reused by a new instance.
+ *
+ * \return The number of checks that failed.
+ */
+static int checkStaleHandles(){
+    
+    int failures = 0;
+    StatsResult result;
+    
+    int staleHandle = statsCalcCreate();
+    failures += reportCheck(statsCalcDestroy(staleHandle) == STATSCALC_OK,
+                            "statsCalcDestroy() accepts a valid handle");
+    failures += reportCheck(statsCalcGetAll(staleHandle, &result) == STATSCALC_INVALID_HANDLE,
+                            "statsCalcGetAll() rejects a destroyed handle");
+    failures += reportCheck(statsCalcDestroy(staleHandle) == STATSCALC_INVALID_HANDLE,
+                            "statsCalcDestroy() rejects a handle that was already destroyed");
+    
+    // The next instance reuses the slot, but must be given a different handle.
+    int newHandle = statsCalcCreate();
+    statsCalcAppendValue(newHandle, 1.0);
+    failures += reportCheck(newHandle != staleHandle && statsCalcAppendValue(staleHandle, 2.0) == STATSCALC_INVALID_HANDLE,
+                            "a destroyed handle is rejected after its slot has been reused");
+    statsCalcGetAll(newHandle, &result);
+    failures += reportCheck(result.count == 1, "the reused slot is unaffected by the destroyed handle");
+    statsCalcDestroy(newHandle);
+    
+    return failures;
+}
+
+/** Checks that an asynchronous load of a file that cannot be opened reports
+ * STATSCALC_FILE_ERROR exactly once, and that the handle remains usable.
+ *
+ * \return The number of checks that failed.
+ */
+static int checkAsyncLoadErrors(){
+    
+    int failures = 0;
+    StatsResult result;
+    
+    int handle = statsCalcCreate();
+    failures += reportCheck(statsCalcReadFileAsync(handle, "/nonexistent/statsCalculatorCheck.txt") == STATSCALC_OK,
+                            "statsCalcReadFileAsync() schedules a load");
+    failures += reportCheck(statsCalcWait(handle) == STATSCALC_FILE_ERROR,
+                            "statsCalcWait() reports that the file could not be opened");
+    failures += reportCheck(statsCalcWait(handle) == STATSCALC_OK,
+                            "statsCalcWait() reports the outcome of a load only once");
+    failures += reportCheck(statsCalcAppendValue(handle, 1.0) == STATSCALC_OK
+                            && statsCalcGetAll(handle, &result) == STATSCALC_OK && result.count == 1,
+                            "the handle remains usable after a failed load");
+    
+    // An error must also survive a call that waits for the load to finish.
+    statsCalcReadFileAsync(handle, "/nonexistent/statsCalculatorCheck.txt");
+    statsCalcGetAll(handle, &result);
+    failures += reportCheck(statsCalcPoll(handle, 0) == STATSCALC_FILE_ERROR,
+                            "statsCalcPoll() reports a failed load after another call waited for it");
+    statsCalcDestroy(handle);
+    
+    return failures;
+}
+
 /** The main function is the entry point for the program. The program is designed
  * to be invoked with two command line arguments and will output an error message
- * if the incorrect number of command line arguments is not supplied.
+ * if the incorrect number of command line arguments is not supplied. If the only
+ * command line argument is --check, the program instead runs a set of behavioural
+ * checks of the C API and reports the outcome of each one.
  *
  * \param argc - The number of command line tokens including the executable name 
  * and command line arguments.
@@ -34,7 +239,7 @@
  * of the numeric values to the user-specified output file.
  *
  * \return The program returns zero on success and 1 if an incorrect number of command line
- * arguments was provided.
+ * arguments was provided or if any behavioural check failed.
  */
 int main(int argc, char * argv[]){
     
@@ -86,19 +291,34 @@ int main(int argc, char * argv[]){
         // return 0 on success
         return 0;
     }
+    else if(argc == 2 && std::strcmp(argv[1], "--check") == 0){
+        
+        // Run every behavioural check and count the failures.
+        int failures = 0;
+        failures += checkNonFiniteStatistics();
+        failures += checkNonFiniteWeightedStatistics();
+        failures += checkNonFiniteBivariateStatistics();
+        failures += checkStaleHandles();
+        failures += checkAsyncLoadErrors();
+        
+        std::cout << failures << " check(s) failed." << std::endl;
+        return failures == 0 ? 0 : 1;
+    }
     else{ // An invalid number of arguments was provided.
         
         /* Output an informative message explaining the required program
          * invocation syntax.
          */
         std::cout << "Required Syntax:\n\n"
-        << "./statsCalculator inputFile outputFile\n\n"
+        << "./statsCalculator inputFile outputFile\n"
+        << "./statsCalculator --check\n\n"
         << "Argument Descriptions:\n\n"
         << "inputFile - The path of a text file containing "
         << "whitespace-separated numeric values.\n\n"
         << "outputFile - A path to which an output text file "
         << "containing a statistical summary of the numeric "
-        << "values should be written."
+        << "values should be written.\n\n"
+        << "--check - Run the behavioural checks of the C API instead."
         << std::endl;
         
         /* There was a problem with execution, so return a 
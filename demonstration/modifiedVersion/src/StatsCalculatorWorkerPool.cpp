@@ -0,0 +1,199 @@
+// IMPLEMENTATION file for StatsCalculatorWorkerPool class
+
+// STL HEADER FILES
+
+// The <atomic> header is included to provide the STL std::atomic type.
+#include <atomic>
+// The <memory> header is included to provide the STL std::shared_ptr type.
+#include <memory>
+
+// LOCAL HEADER FILES
+
+// Include the stdafx.h header to satisfy Windows requirements
+#include "stdafx.h"
+
+/* The "StatsCalculatorWorkerPool.h" header is included to provide a definition
+ * of the StatsCalculatorWorkerPool class.
+ */
+#include "StatsCalculatorWorkerPool.h"
+
+// PARALLEL LOOP HELPERS
+
+/** \struct ParallelForState
+ * Describes the tasks of one call to StatsCalculatorWorkerPool::parallelFor()
+ * and records the progress of the threads that share them. A thread claims the
+ * next task by incrementing "nextTask", so the tasks are shared out dynamically.
+ */
+struct ParallelForState {
+    /// The callable object that executes a task.
+    std::function<void(size_t)> task;
+    /// The number of tasks.
+    size_t taskCount;
+    /// The index of the next task that has not been claimed by any thread.
+    std::atomic<size_t> nextTask;
+    /// The number of tasks that have been completed. Protected by "completedMutex".
+    size_t completedTasks;
+    /// Mutex that protects "completedTasks".
+    std::mutex completedMutex;
+    /// Condition variable that is notified when the last task is completed.
+    std::condition_variable allTasksCompleted;
+};
+
+/** Repeatedly claims and executes tasks until none remain. It is executed by the
+ * thread that called parallelFor() and by the worker threads that help it.
+ *
+ * \param state - The description of the tasks.
+ */
+static void executeParallelForTasks(ParallelForState & state){
+    size_t completed = 0;
+    for(size_t task = state.nextTask.fetch_add(1); task < state.taskCount; task = state.nextTask.fetch_add(1)){
+        state.task(task);
+        ++completed;
+    }
+    if(completed > 0){
+        std::lock_guard<std::mutex> lock(state.completedMutex);
+        state.completedTasks += completed;
+        if(state.completedTasks == state.taskCount){
+            state.allTasksCompleted.notify_all();
+        }
+    }
+}
+
+// PRIVATE METHODS OF STATSCALCULATORWORKERPOOL
+
+/** Private method executed by every worker thread.
+ *
+ * The worker sleeps on the "tasksAvailable" condition variable until there is
+ * a task in the queue or the pool is stopping. It removes the first task from
+ * the queue and executes it WITHOUT holding the mutex, so that other workers
+ * can take tasks at the same time. The worker returns once the pool is
+ * stopping and the queue is empty.
+ */
+void StatsCalculatorWorkerPool::workerLoop(){
+    for(;;){
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(tasksMutex);
+            while(!stopping && tasks.empty()){
+                tasksAvailable.wait(lock);
+            }
+            if(tasks.empty()){
+                // The pool is stopping and there is no more work to do.
+                return;
+            }
+            task.swap(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+// PUBLIC METHODS OF STATSCALCULATORWORKERPOOL
+
+/** Constructor for the StatsCalculatorWorkerPool class, which starts the
+ * worker threads.
+ *
+ * \param threadCount - The number of worker threads to start. If zero, the
+ * value returned by std::thread::hardware_concurrency() is used (or one, if
+ * the number of hardware threads cannot be determined).
+ */
+StatsCalculatorWorkerPool::StatsCalculatorWorkerPool(unsigned threadCount) :
+stopping(false){
+    if(threadCount == 0){
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if(threadCount == 0){
+        threadCount = 1;
+    }
+    workers.reserve(threadCount);
+    for(unsigned worker = 0; worker < threadCount; ++worker){
+        workers.push_back(std::thread(&StatsCalculatorWorkerPool::workerLoop, this));
+    }
+}
+
+/** Destructor for the StatsCalculatorWorkerPool class. It asks the workers to
+ * stop once the queue is empty and waits for each of them to return.
+ */
+StatsCalculatorWorkerPool::~StatsCalculatorWorkerPool(){
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        stopping = true;
+    }
+    tasksAvailable.notify_all();
+    for(size_t worker = 0; worker < workers.size(); ++worker){
+        workers[worker].join();
+    }
+}
+
+/** Public method that queues a task for execution by a worker thread and
+ * wakes one sleeping worker.
+ *
+ * \param task - A callable object that accepts no arguments.
+ */
+void StatsCalculatorWorkerPool::submit(const std::function<void()> & task){
+    {
+        std::lock_guard<std::mutex> lock(tasksMutex);
+        tasks.push_back(task);
+    }
+    tasksAvailable.notify_one();
+}
+
+/** Public method that executes a number of independent tasks, sharing them
+ * between the calling thread and worker threads.
+ *
+ * A "helper" is submitted to the queue for each additional thread that may be
+ * used. Every helper, and the calling thread itself, claims and executes tasks
+ * until none remain. Because the calling thread takes part, the call completes
+ * even if every worker is busy (or if it is made from a worker thread, which
+ * would otherwise wait for itself). Helpers that start after every task has
+ * been claimed return immediately; the description of the tasks is held by a
+ * shared pointer so that it outlives this call for their sake.
+ *
+ * \param taskCount - The number of tasks.
+ * \param task - A callable object that accepts the index of a task. Tasks may
+ * be executed in any order and concurrently with each other.
+ * \param maxThreads - The maximum number of threads (including the calling
+ * thread) that may execute tasks. Zero means one per worker thread.
+ */
+void StatsCalculatorWorkerPool::parallelFor(size_t taskCount, const std::function<void(size_t)> & task,
+                                            unsigned maxThreads){
+    if(taskCount == 0){
+        return;
+    }
+    std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>();
+    state->task = task;
+    state->taskCount = taskCount;
+    state->nextTask = 0;
+    state->completedTasks = 0;
+    
+    size_t helpers = (maxThreads == 0 || maxThreads > size() ? size() : maxThreads) - 1;
+    if(helpers > taskCount - 1){
+        helpers = taskCount - 1;
+    }
+    for(size_t helper = 0; helper < helpers; ++helper){
+        submit([state](){ executeParallelForTasks(*state); });
+    }
+    executeParallelForTasks(*state);
+    
+    std::unique_lock<std::mutex> lock(state->completedMutex);
+    while(state->completedTasks < taskCount){
+        state->allTasksCompleted.wait(lock);
+    }
+}
+
+/** Public method returns the number of worker threads in the pool.
+ */
+unsigned StatsCalculatorWorkerPool::size() const{
+    return static_cast<unsigned>(workers.size());
+}
+
+/** Public static method returns a pool shared by the whole library.
+ *
+ * The pool is a function-local static object, so it is constructed (in a
+ * thread-safe manner) the first time this method is called and destroyed when
+ * the program exits.
+ */
+StatsCalculatorWorkerPool & StatsCalculatorWorkerPool::shared(){
+    static StatsCalculatorWorkerPool pool;
+    return pool;
+}
@@ -0,0 +1,427 @@
+// IMPLEMENTATION file for StatsCovarianceMatrix class
+
+// STL HEADER FILES
+
+// The <algorithm> header is included to provide the std::fill(...) and std::copy(...) functions.
+#include <algorithm>
+// The <cmath> header is included to provide the std::sqrt(...) function.
+#include <cmath>
+// The <utility> header is included to provide the std::swap(...) function.
+#include <utility>
+
+// LOCAL HEADER FILES
+
+// Include the stdafx.h header to satisfy Windows requirements
+#include "stdafx.h"
+
+/* The "StatsCovarianceMatrix.h" header is included to provide a definition of
+ * the StatsCovarianceMatrix class.
+ */
+#include "StatsCovarianceMatrix.h"
+
+/* The "StatsCalculatorWorkerPool.h" header file provides the pool of worker threads that
+ * share the tiles of each update.
+ */
+#include "StatsCalculatorWorkerPool.h"
+
+// RANK-K UPDATE HELPERS
+
+/** \struct CovarianceUpdate
+ * Describes the update of the co-moment matrix with one block of centred rows.
+ * The update is divided into the square tiles of the upper triangle of the
+ * matrix, which are numbered row by row, and no two tiles ever write to the
+ * same elements of the matrix, so they can be updated concurrently.
+ */
+struct CovarianceUpdate {
+    /// The block of rows, each centred on the block mean.
+    const double * centredRows;
+    /// The number of rows in the block.
+    size_t rowCount;
+    /// The number of values in each row.
+    size_t channelCount;
+    /// The difference between the block mean and the mean of the earlier rows, for each channel.
+    const double * meanDifferences;
+    /// The factor by which the outer product of "meanDifferences" is scaled.
+    double mergeFactor;
+    /// The co-moment matrix that is updated.
+    double * coMoments;
+    /// The number of tiles along each side of the matrix.
+    size_t tilesPerSide;
+    /// The number of tiles in the upper triangle of the matrix.
+    size_t tileCount;
+};
+
+/** Adds the contribution of a block of rows to one tile of the co-moment matrix.
+ *
+ * The tile covers matrix rows [rowBegin, rowBegin + tileChannels) and columns
+ * [columnBegin, columnBegin + tileChannels), clipped to the size of the matrix.
+ * Element (i, j) is increased by the sum over the block of the products of the
+ * centred values of channels i and j, plus the "mergeFactor" times the product
+ * of the mean differences of channels i and j.
+ *
+ * Four matrix rows are processed together. For each row of the block, the four
+ * centred values of channels i..i+3 are each multiplied by the same contiguous
+ * run of centred values for the tile's columns, so each run is loaded from the
+ * cache once for four rows of the tile. The products are summed in a local
+ * array (which the compiler knows cannot overlap the input, and so can keep
+ * in vector registers) and are added to the matrix once per block.
+ *
+ * Tiles on the diagonal are computed in full, so some elements below the
+ * diagonal are also written. Their values are correct but they are never read.
+ *
+ * \param update - The description of the update.
+ * \param rowBegin - The first matrix row of the tile.
+ * \param columnBegin - The first matrix column of the tile.
+ */
+static void updateTile(const CovarianceUpdate & update, size_t rowBegin, size_t columnBegin){
+    const size_t channelCount = update.channelCount;
+    const size_t rowEnd = rowBegin + StatsCovarianceMatrix::tileChannels < channelCount ?
+        rowBegin + StatsCovarianceMatrix::tileChannels : channelCount;
+    const size_t columnEnd = columnBegin + StatsCovarianceMatrix::tileChannels < channelCount ?
+        columnBegin + StatsCovarianceMatrix::tileChannels : channelCount;
+    const size_t width = columnEnd - columnBegin;
+    const double * columnDifferences = update.meanDifferences + columnBegin;
+
+    double sums[4][StatsCovarianceMatrix::tileChannels];
+    for(size_t row = rowBegin; row < rowEnd; row += 4){
+        /* Rows beyond the end of the tile (when its height is not a multiple of
+         * four) are given a weight of zero, and are never written back.
+         */
+        const size_t groupRows = rowEnd - row < 4 ? rowEnd - row : 4;
+        double rowDifferences[4];
+        for(size_t group = 0; group < 4; ++group){
+            rowDifferences[group] = group < groupRows ? update.mergeFactor*update.meanDifferences[row + group] : 0.0;
+            for(size_t column = 0; column < width; ++column){
+                sums[group][column] = rowDifferences[group]*columnDifferences[column];
+            }
+        }
+
+        for(size_t blockRow = 0; blockRow < update.rowCount; ++blockRow){
+            const double * centred = update.centredRows + blockRow*channelCount;
+            const double * centredColumns = centred + columnBegin;
+            const double value0 = centred[row];
+            const double value1 = groupRows > 1 ? centred[row + 1] : 0.0;
+            const double value2 = groupRows > 2 ? centred[row + 2] : 0.0;
+            const double value3 = groupRows > 3 ? centred[row + 3] : 0.0;
+            for(size_t column = 0; column < width; ++column){
+                const double columnValue = centredColumns[column];
+                sums[0][column] += value0*columnValue;
+                sums[1][column] += value1*columnValue;
+                sums[2][column] += value2*columnValue;
+                sums[3][column] += value3*columnValue;
+            }
+        }
+
+        for(size_t group = 0; group < groupRows; ++group){
+            double * coMoments = update.coMoments + (row + group)*channelCount + columnBegin;
+            for(size_t column = 0; column < width; ++column){
+                coMoments[column] += sums[group][column];
+            }
+        }
+    }
+}
+
+/** Updates one tile of the co-moment matrix, identified by its number.
+ *
+ * \param update - The description of the update.
+ * \param tile - The number of the tile, counting along each row of tiles in
+ * the upper triangle in turn.
+ */
+static void updateNumberedTile(const CovarianceUpdate & update, size_t tile){
+    // Convert the tile number into its position in the upper triangle.
+    size_t tileRow = 0;
+    while(tile >= update.tilesPerSide - tileRow){
+        tile -= update.tilesPerSide - tileRow;
+        ++tileRow;
+    }
+    const size_t tileColumn = tileRow + tile;
+    updateTile(update, tileRow*StatsCovarianceMatrix::tileChannels, tileColumn*StatsCovarianceMatrix::tileChannels);
+}
+
+// PRIVATE METHODS OF STATSCOVARIANCEMATRIX
+
+/** Private method that folds a block of rows into the means and the co-moment
+ * matrix.
+ *
+ * The mean of each channel over the block is computed first, and a copy of the
+ * block that is centred on those means is made. The co-moment matrix of the
+ * block alone is then the product of the transpose of the centred block with
+ * itself. It is combined with the co-moment matrix of the earlier rows using
+ * the formula of Chan et al.:
+ *
+ * \f$M_{ij} \leftarrow M_{ij} + \sum_k x'_{ki} x'_{kj} + \frac{n_a n_b}{n_a + n_b}\delta_i \delta_j\f$
+ *
+ * in which \f$x'\f$ are the centred values, \f$n_a\f$ and \f$n_b\f$ are the
+ * numbers of earlier rows and rows in the block and \f$\delta\f$ is the
+ * difference between the block means and the earlier means.
+ *
+ * Unless only one thread is allowed, the tiles of the update are shared between
+ * this thread and the threads of StatsCalculatorWorkerPool::shared() using
+ * StatsCalculatorWorkerPool::parallelFor().
+ *
+ * \param rows - A pointer to the first value of the first row.
+ * \param rowCount - The number of rows, which must be between one and "blockRows".
+ */
+void StatsCovarianceMatrix::updateBlock(const double * rows, size_t rowCount){
+    std::fill(blockMeans.begin(), blockMeans.end(), 0.0);
+    for(size_t row = 0; row < rowCount; ++row){
+        const double * values = rows + row*channelCount;
+        for(size_t channel = 0; channel < channelCount; ++channel){
+            blockMeans[channel] += values[channel];
+        }
+    }
+    for(size_t channel = 0; channel < channelCount; ++channel){
+        blockMeans[channel] /= rowCount;
+    }
+    for(size_t row = 0; row < rowCount; ++row){
+        const double * values = rows + row*channelCount;
+        double * centred = &centredRows[row*channelCount];
+        for(size_t channel = 0; channel < channelCount; ++channel){
+            centred[channel] = values[channel] - blockMeans[channel];
+        }
+    }
+
+    /* From here on "blockMeans" holds the difference between the mean of the block
+     * and the mean of the earlier rows.
+     */
+    const double combinedCount = static_cast<double>(count) + rowCount;
+    for(size_t channel = 0; channel < channelCount; ++channel){
+        blockMeans[channel] -= means[channel];
+    }
+
+    CovarianceUpdate update;
+    update.centredRows = &centredRows[0];
+    update.rowCount = rowCount;
+    update.channelCount = channelCount;
+    update.meanDifferences = &blockMeans[0];
+    update.mergeFactor = static_cast<double>(count)*rowCount/combinedCount;
+    update.coMoments = &coMoments[0];
+    update.tilesPerSide = (channelCount + tileChannels - 1)/tileChannels;
+    update.tileCount = update.tilesPerSide*(update.tilesPerSide + 1)/2;
+
+    if(threadCount == 1 || update.tileCount == 1){
+        for(size_t tile = 0; tile < update.tileCount; ++tile){
+            updateNumberedTile(update, tile);
+        }
+    }
+    else{
+        StatsCalculatorWorkerPool::shared().parallelFor(update.tileCount, [&update](size_t tile){
+            updateNumberedTile(update, tile);
+        }, threadCount);
+    }
+
+    for(size_t channel = 0; channel < channelCount; ++channel){
+        means[channel] += blockMeans[channel]*rowCount/combinedCount;
+    }
+    count += rowCount;
+}
+
+/** Private method that folds any rows that were appended individually, and do not
+ * yet fill a block, into the matrix.
+ */
+void StatsCovarianceMatrix::flushPendingRows(){
+    if(pendingRowCount > 0){
+        updateBlock(&pendingRows[0], pendingRowCount);
+        pendingRowCount = 0;
+    }
+}
+
+// PUBLIC METHODS OF STATSCOVARIANCEMATRIX
+
+/** Constructor for the StatsCovarianceMatrix class, which allocates the matrix
+ * and the scratch space for one block.
+ *
+ * \param channelCount - The number of values in each row. The co-moment matrix
+ * holds the square of this number of values, so 1024 channels require 8 MiB.
+ */
+StatsCovarianceMatrix::StatsCovarianceMatrix(size_t channelCount) :
+channelCount(channelCount),
+count(0),
+means(channelCount, 0.0),
+coMoments(channelCount*channelCount, 0.0),
+pendingRows(blockRows*channelCount),
+pendingRowCount(0),
+centredRows(blockRows*channelCount),
+blockMeans(channelCount),
+threadCount(0)
+{}
+
+/** Public method that sets the maximum number of threads that may share each
+ * update. Small matrices (of "tileChannels" channels or fewer) are always
+ * updated on the calling thread.
+ *
+ * \param threads - The number of threads, including the calling thread. Zero
+ * uses one per thread of StatsCalculatorWorkerPool::shared().
+ */
+void StatsCovarianceMatrix::setThreadCount(unsigned threads){
+    threadCount = threads;
+}
+
+/** Public method that returns the number of values in each row.
+ */
+size_t StatsCovarianceMatrix::getChannelCount() const{
+    return channelCount;
+}
+
+/** Public method that returns the number of rows that have been appended,
+ * including any that are still waiting to be folded into the matrix.
+ */
+long long StatsCovarianceMatrix::getCount() const{
+    return count + static_cast<long long>(pendingRowCount);
+}
+
+/** Public method that appends a single row. The row is copied into the pending
+ * block, which is folded into the matrix once it is full.
+ *
+ * \param row - A pointer to the first of "channelCount" values.
+ */
+void StatsCovarianceMatrix::appendRow(const double * row){
+    std::copy(row, row + channelCount, pendingRows.begin() + pendingRowCount*channelCount);
+    if(++pendingRowCount == blockRows){
+        updateBlock(&pendingRows[0], blockRows);
+        pendingRowCount = 0;
+    }
+}
+
+/** Public method that appends several rows that are stored contiguously.
+ *
+ * Rows first complete any partially filled pending block. Whole blocks are then
+ * folded into the matrix directly from the caller's array, without being copied,
+ * and any remaining rows become pending.
+ *
+ * \param rows - A pointer to the first value of the first row.
+ * \param rowCount - The number of rows.
+ */
+void StatsCovarianceMatrix::appendRows(const double * rows, size_t rowCount){
+    while(rowCount > 0 && pendingRowCount > 0){
+        appendRow(rows);
+        rows += channelCount;
+        --rowCount;
+    }
+    while(rowCount >= blockRows){
+        updateBlock(rows, blockRows);
+        rows += blockRows*channelCount;
+        rowCount -= blockRows;
+    }
+    for(size_t row = 0; row < rowCount; ++row){
+        appendRow(rows + row*channelCount);
+    }
+}
+
+/** Public method that accumulates every row summarized by another instance,
+ * using the same formula of Chan et al. that combines each block with the
+ * earlier rows.
+ *
+ * \param other - The instance to merge, which must have the same number of
+ * channels. Its pending rows are folded into its own matrix first.
+ *
+ * \return True on success, or false if the numbers of channels differ.
+ */
+bool StatsCovarianceMatrix::merge(StatsCovarianceMatrix & other){
+    if(other.channelCount != channelCount){
+        return false;
+    }
+    other.flushPendingRows();
+    flushPendingRows();
+    if(other.count == 0){
+        return true;
+    }
+    const double combinedCount = static_cast<double>(count) + other.count;
+    const double mergeFactor = static_cast<double>(count)*other.count/combinedCount;
+    for(size_t row = 0; row < channelCount; ++row){
+        const double rowDifference = other.means[row] - means[row];
+        for(size_t column = row; column < channelCount; ++column){
+            const double columnDifference = other.means[column] - means[column];
+            coMoments[row*channelCount + column] += other.coMoments[row*channelCount + column]
+                + mergeFactor*rowDifference*columnDifference;
+        }
+    }
+    for(size_t channel = 0; channel < channelCount; ++channel){
+        means[channel] += (other.means[channel] - means[channel])*other.count/combinedCount;
+    }
+    count += other.count;
+    return true;
+}
+
+/** Public method that returns the mean of each channel. Any pending rows are
+ * folded into the matrix first.
+ *
+ * \return An immutable reference to a vector of "channelCount" means, which
+ * remains valid until the instance is destroyed.
+ */
+const std::vector<double> & StatsCovarianceMatrix::getMeans(){
+    flushPendingRows();
+    return means;
+}
+
+/** Public method that returns the covariance of two channels. Any pending rows
+ * are folded into the matrix first.
+ *
+ * \param first - The index of the first channel.
+ * \param second - The index of the second channel.
+ * \param sample - If true, the co-moment is divided by one fewer than the number
+ * of rows to give the unbiased (sample) covariance.
+ *
+ * \return The covariance, or zero if there are too few rows to compute it.
+ */
+double StatsCovarianceMatrix::getCovariance(size_t first, size_t second, bool sample){
+    flushPendingRows();
+    const long long divisor = sample ? count - 1 : count;
+    if(divisor <= 0){
+        return 0.0;
+    }
+    if(first > second){
+        std::swap(first, second);
+    }
+    return coMoments[first*channelCount + second]/divisor;
+}
+
+/** Public method that copies the complete covariance matrix. Any pending rows are
+ * folded into the matrix first, and each element of the upper triangle is
+ * copied to both of its positions.
+ *
+ * \param matrix - A pointer to space for channelCount*channelCount values, which
+ * are written row-major. They are all zero if there are too few rows.
+ * \param sample - If true, the unbiased (sample) covariances are written.
+ */
+void StatsCovarianceMatrix::getCovarianceMatrix(double * matrix, bool sample){
+    flushPendingRows();
+    const long long divisor = sample ? count - 1 : count;
+    for(size_t row = 0; row < channelCount; ++row){
+        for(size_t column = row; column < channelCount; ++column){
+            const double covariance = divisor > 0 ? coMoments[row*channelCount + column]/divisor : 0.0;
+            matrix[row*channelCount + column] = covariance;
+            matrix[column*channelCount + row] = covariance;
+        }
+    }
+}
+
+/** Public method that copies the complete correlation matrix. Any pending rows
+ * are folded into the matrix first.
+ *
+ * \param matrix - A pointer to space for channelCount*channelCount values, which
+ * are written row-major. Every element in the row and column of a channel that
+ * has zero variance is zero.
+ */
+void StatsCovarianceMatrix::getCorrelationMatrix(double * matrix){
+    flushPendingRows();
+    for(size_t row = 0; row < channelCount; ++row){
+        const double rowSpread = std::sqrt(coMoments[row*channelCount + row]);
+        for(size_t column = row; column < channelCount; ++column){
+            const double spreads = rowSpread*std::sqrt(coMoments[column*channelCount + column]);
+            const double correlation = spreads > 0.0 ? coMoments[row*channelCount + column]/spreads : 0.0;
+            matrix[row*channelCount + column] = correlation;
+            matrix[column*channelCount + row] = correlation;
+        }
+    }
+}
+
+/** Public method that discards every row. The number of channels and the thread
+ * count are retained.
+ */
+void StatsCovarianceMatrix::reset(){
+    count = 0;
+    pendingRowCount = 0;
+    std::fill(means.begin(), means.end(), 0.0);
+    std::fill(coMoments.begin(), coMoments.end(), 0.0);
+}
@@ -0,0 +1,130 @@
+// IMPLEMENTATION file for StatsIngestScheduler class
+
+// LOCAL HEADER FILES
+
+// Include the stdafx.h header to satisfy Windows requirements
+#include "stdafx.h"
+
+/* The "StatsIngestScheduler.h" header is included to provide a definition of
+ * the StatsIngestScheduler class.
+ */
+#include "StatsIngestScheduler.h"
+
+// PRIVATE METHODS OF STATSINGESTSCHEDULER
+
+/** Private method that counts an ingest that has begun and submits the task for
+ * its first chunk. The ingest is counted BEFORE the task is submitted, so that
+ * wait() cannot return before the task has finished it.
+ *
+ * \param calculator - The instance whose incremental ingest has begun.
+ * \param completion - The function to call once the ingest has finished.
+ */
+void StatsIngestScheduler::schedule(StatsCalculator & calculator,
+                                    const std::function<void(StatsCalculator &)> & completion){
+    std::shared_ptr<ScheduledIngest> ingest = std::make_shared<ScheduledIngest>();
+    ingest->calculator = &calculator;
+    ingest->completion = completion;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        ++pendingCount;
+    }
+    pool.submit([this, ingest](){ resume(ingest); });
+}
+
+/** Private method, executed by a worker thread, that ingests one chunk.
+ *
+ * If the ingest has not finished, the task for its next chunk is submitted to
+ * the BACK of the pool's queue, behind the chunks of every other ingest, which
+ * gives each ingest a turn in round-robin order. Otherwise the completion
+ * function is called and the ingest is no longer counted.
+ *
+ * \param ingest - The ingest.
+ */
+void StatsIngestScheduler::resume(const std::shared_ptr<ScheduledIngest> & ingest){
+    if(!ingest->calculator->resumeIngest()){
+        std::shared_ptr<ScheduledIngest> next(ingest);
+        pool.submit([this, next](){ resume(next); });
+        return;
+    }
+    if(ingest->completion){
+        ingest->completion(*ingest->calculator);
+    }
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    if(--pendingCount == 0){
+        allFinished.notify_all();
+    }
+}
+
+// PUBLIC METHODS OF STATSINGESTSCHEDULER
+
+/** Constructor for the StatsIngestScheduler class.
+ *
+ * \param workerPool - The pool whose threads perform the chunks.
+ */
+StatsIngestScheduler::StatsIngestScheduler(StatsCalculatorWorkerPool & workerPool) :
+pool(workerPool),
+pendingCount(0){
+}
+
+/** Destructor for the StatsIngestScheduler class. The tasks that drive the
+ * ingests refer to this scheduler, so it waits for them all to finish.
+ */
+StatsIngestScheduler::~StatsIngestScheduler(){
+    wait();
+}
+
+/** Public method that opens a file with StatsCalculator::beginIngest() and
+ * schedules its ingest.
+ *
+ * \param calculator - The instance.
+ * \param infileName - The path of the file.
+ * \param completion - A function that is called once the ingest has finished.
+ * \param progress - An optional pointer to an IngestProgress structure.
+ *
+ * \return True if the ingest was scheduled, otherwise false.
+ */
+bool StatsIngestScheduler::ingestFile(StatsCalculator & calculator, const std::string & infileName,
+                                      const std::function<void(StatsCalculator &)> & completion,
+                                      IngestProgress * progress){
+    if(!calculator.beginIngest(infileName, progress)){
+        return false;
+    }
+    schedule(calculator, completion);
+    return true;
+}
+
+/** Public method that begins to append an array of values with
+ * StatsCalculator::beginAppend() and schedules the rest of the ingest.
+ *
+ * \param calculator - The instance.
+ * \param values - A pointer to the first element of the array.
+ * \param count - The number of elements in the array.
+ * \param completion - A function that is called once the ingest has finished.
+ *
+ * \return True if the ingest was scheduled, otherwise false.
+ */
+bool StatsIngestScheduler::appendValues(StatsCalculator & calculator, const double * values, size_t count,
+                                        const std::function<void(StatsCalculator &)> & completion){
+    if(!calculator.beginAppend(values, count)){
+        return false;
+    }
+    schedule(calculator, completion);
+    return true;
+}
+
+/** Public method that blocks until every scheduled ingest has finished.
+ */
+void StatsIngestScheduler::wait(){
+    std::unique_lock<std::mutex> lock(pendingMutex);
+    while(pendingCount > 0){
+        allFinished.wait(lock);
+    }
+}
+
+/** Public method that returns the number of scheduled ingests that have not yet
+ * finished.
+ */
+size_t StatsIngestScheduler::getPendingCount(){
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    return pendingCount;
+}
@@ -0,0 +1,120 @@
+// IMPLEMENTATION file for StatsObserver class
+
+// LOCAL HEADER FILES
+
+// Include the stdafx.h header to satisfy Windows requirements
+#include "stdafx.h"
+
+/* The "StatsObserver.h" header is included to provide a definition of the
+ * StatsObserver class.
+ */
+#include "StatsObserver.h"
+
+// PRIVATE METHODS OF STATSOBSERVER
+
+/** Private method executed by the delivery thread.
+ *
+ * The thread sleeps on the "mailboxChanged" condition variable until a snapshot
+ * is posted, the observer is stopping or (if snapshots are timed) the next
+ * request is due. When a request is due, "requested" is raised and the time of
+ * the next request is advanced by whole periods, so that requests keep to their
+ * schedule but are not queued up while the producer is idle. A posted snapshot
+ * is copied out of the mailbox and the callback is called WITHOUT holding the
+ * mutex, so that publish() never waits for the callback. The thread returns once
+ * the observer is stopping and the mailbox is empty.
+ */
+void StatsObserver::deliveryLoop(){
+    const std::chrono::milliseconds period(millisecondInterval);
+    std::chrono::steady_clock::time_point nextRequest = started + period;
+    std::unique_lock<std::mutex> lock(mailboxMutex);
+    for(;;){
+        while(!mailboxFull && !stopping){
+            if(millisecondInterval == 0){
+                mailboxChanged.wait(lock);
+                continue;
+            }
+            if(mailboxChanged.wait_until(lock, nextRequest) == std::cv_status::timeout){
+                requested.store(true, std::memory_order_relaxed);
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+                while(nextRequest <= now){
+                    nextRequest += period;
+                }
+            }
+        }
+        if(!mailboxFull){
+            // The observer is stopping and there is nothing more to deliver.
+            return;
+        }
+        const StatsSnapshot snapshot = mailbox;
+        mailboxFull = false;
+        lock.unlock();
+        callback(&snapshot, userData);
+        delivered.fetch_add(1, std::memory_order_relaxed);
+        lock.lock();
+    }
+}
+
+// PUBLIC METHODS OF STATSOBSERVER
+
+/** Constructor for the StatsObserver class, which starts the delivery thread.
+ *
+ * \param snapshotCallback - The function that receives the snapshots.
+ * \param callbackData - A pointer that is passed to the function.
+ * \param everySamples - The number of values after which a snapshot is posted,
+ * or zero.
+ * \param everyMilliseconds - The period, in milliseconds, with which snapshots
+ * are posted, or zero.
+ */
+StatsObserver::StatsObserver(StatsCalcSnapshotCallback snapshotCallback, void * callbackData,
+                             long long everySamples, unsigned everyMilliseconds) :
+callback(snapshotCallback),
+userData(callbackData),
+sampleInterval(everySamples),
+millisecondInterval(everyMilliseconds),
+started(std::chrono::steady_clock::now()),
+mailboxFull(false),
+published(0),
+delivered(0),
+stopping(false),
+requested(false){
+    // The thread is started last, once every member that it uses is initialized.
+    deliverer = std::thread(&StatsObserver::deliveryLoop, this);
+}
+
+/** Destructor for the StatsObserver class. It asks the delivery thread to stop
+ * once the mailbox is empty and waits for it to return.
+ */
+StatsObserver::~StatsObserver(){
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex);
+        stopping = true;
+    }
+    mailboxChanged.notify_one();
+    deliverer.join();
+}
+
+/** Public method that posts a snapshot to the mailbox and wakes the delivery
+ * thread. The snapshot is numbered and timestamped here, so that its number and
+ * time describe when it was taken rather than when it was delivered.
+ *
+ * \param statistics - The statistics.
+ */
+void StatsObserver::publish(const StatsResult & statistics){
+    const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    requested.store(false, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mailboxMutex);
+        mailbox.sequence = ++published;
+        mailbox.elapsedSeconds = elapsedSeconds;
+        mailbox.statistics = statistics;
+        mailboxFull = true;
+    }
+    mailboxChanged.notify_one();
+}
+
+/** Public method that returns the number of snapshots that have been delivered
+ * to the callback.
+ */
+long long StatsObserver::getDeliveredCount() const{
+    return delivered.load(std::memory_order_relaxed);
+}
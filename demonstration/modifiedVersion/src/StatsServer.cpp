@@ -0,0 +1,526 @@
+// IMPLEMENTATION file for StatsServer class
+
+/* The "StatsServer.h" header is included to provide a definition of the
+ * StatsServer class.
+ */
+#include "StatsServer.h"
+
+// POSIX AND LINUX HEADER FILES
+
+// The <cerrno> header provides errno and its values.
+#include <cerrno>
+// The <sys/epoll.h> header provides the epoll interface.
+#include <sys/epoll.h>
+// The <sys/eventfd.h> header provides eventfd(), through which stop() wakes the event loop.
+#include <sys/eventfd.h>
+// The <sys/socket.h> header provides the sockets interface.
+#include <sys/socket.h>
+// The <sys/un.h> header provides the Unix domain socket address structure.
+#include <sys/un.h>
+// The <unistd.h> header provides read(), close() and unlink().
+#include <unistd.h>
+
+// STL HEADER FILES
+
+// The <cstring> header provides std::memcpy(), std::memset() and std::strncpy().
+#include <cstring>
+
+/** The number of bytes the server attempts to read from a client at once.
+ */
+static const size_t readChunkBytes = 64*1024;
+
+/** The largest number of bytes read from one client each time epoll reports that
+ * it is readable. The socket is level-triggered, so anything left unread is
+ * reported again on the next iteration of the event loop, after every other
+ * ready socket has had its turn.
+ */
+static const size_t maxReadBytesPerEvent = 4*readChunkBytes;
+
+// PRIVATE METHODS OF STATSSERVER
+
+/** Private method that returns the dataset with an identifier. A dataset that
+ * does not yet exist is created, in streaming mode, unless the server already
+ * holds statsServerMaxDatasets datasets.
+ *
+ * \param identifier - The identifier used by clients.
+ *
+ * \return A pointer to the dataset, or null if the limit has been reached.
+ */
+StatsCalculator * StatsServer::createDataset(std::uint32_t identifier){
+    std::map<std::uint32_t, StatsCalculator>::iterator datasetPos = datasets.find(identifier);
+    if(datasetPos == datasets.end()){
+        if(datasets.size() >= statsServerMaxDatasets){
+            return 0;
+        }
+        datasetPos = datasets.insert(std::make_pair(identifier, StatsCalculator())).first;
+        datasetPos->second.setStreaming(true);
+    }
+    return &datasetPos->second;
+}
+
+/** Private method that returns the dataset with an identifier without creating
+ * it, so that only a PUSH (which is subject to statsServerMaxDatasets) creates
+ * datasets.
+ *
+ * \param identifier - The identifier used by clients.
+ *
+ * \return A reference to the dataset, or to "emptyDataset" if it does not exist.
+ */
+StatsCalculator & StatsServer::findDataset(std::uint32_t identifier){
+    std::map<std::uint32_t, StatsCalculator>::iterator datasetPos = datasets.find(identifier);
+    return datasetPos != datasets.end() ? datasetPos->second : emptyDataset;
+}
+
+/** Private method that accepts every pending connection and registers each new
+ * socket with the epoll instance.
+ */
+void StatsServer::acceptConnections(){
+    for(;;){
+        int clientSocket = accept4(listeningSocket, 0, 0, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(clientSocket < 0){
+            // EAGAIN means every pending connection has been accepted.
+            return;
+        }
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = clientSocket;
+        if(epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, clientSocket, &event) != 0){
+            close(clientSocket);
+            continue;
+        }
+        connections[clientSocket] = Connection();
+    }
+}
+
+/** Private method that reads what a client has sent and processes every
+ * complete message.
+ *
+ * Data is read until the socket reports that no more is available, or until
+ * maxReadBytesPerEvent bytes have been read, so that a client that sends
+ * continuously cannot starve the others. The input buffer therefore never holds
+ * more than one incomplete message plus maxReadBytesPerEvent bytes. The complete
+ * messages at the front of the input buffer are then processed in order, and any
+ * incomplete message is moved to the front of the buffer to await the rest of its
+ * bytes. Finally, all the replies generated are flushed together.
+ *
+ * \param clientSocket - The client's socket.
+ * \param connection - The client's state.
+ *
+ * \return False if the client has disconnected or sent a malformed message.
+ */
+bool StatsServer::readFromClient(int clientSocket, Connection & connection){
+    std::vector<char> & input = connection.input;
+    bool peerClosed = false;
+    size_t readBytes = 0;
+    while(readBytes < maxReadBytesPerEvent){
+        size_t used = input.size();
+        input.resize(used + readChunkBytes);
+        ssize_t received = read(clientSocket, &input[used], readChunkBytes);
+        if(received > 0){
+            input.resize(used + static_cast<size_t>(received));
+            readBytes += static_cast<size_t>(received);
+            continue;
+        }
+        input.resize(used);
+        if(received == 0){
+            // The client closed the connection, but its final messages are still processed.
+            peerClosed = true;
+            break;
+        }
+        if(errno == EAGAIN || errno == EWOULDBLOCK){
+            break;
+        }
+        if(errno != EINTR){
+            return false;
+        }
+    }
+
+    size_t position = 0;
+    while(input.size() - position >= sizeof(StatsServerMessageHeader)){
+        StatsServerMessageHeader header;
+        std::memcpy(&header, &input[position], sizeof(header));
+        if(header.payloadBytes > statsServerMaxPayloadBytes || header.payloadBytes % 8 != 0){
+            return false;
+        }
+        size_t messageBytes = sizeof(header) + header.payloadBytes;
+        if(input.size() - position < messageBytes){
+            break;
+        }
+        if(!processMessage(connection, header, &input[position] + sizeof(header))){
+            return false;
+        }
+        position += messageBytes;
+    }
+    // Move any incomplete message to the front of the buffer.
+    input.erase(input.begin(), input.begin() + position);
+
+    return flushOutput(clientSocket, connection) && !peerClosed;
+}
+
+/** Private method that processes one message and queues any reply.
+ *
+ * \param connection - The state of the client that sent the message.
+ * \param header - The header of the message.
+ * \param payload - The payload of the message.
+ *
+ * \return False if the message is malformed, or if its reply would exceed the
+ * limit on the client's pending output.
+ */
+bool StatsServer::processMessage(Connection & connection, const StatsServerMessageHeader & header, const char * payload){
+    switch(header.type){
+        case STATSSERVER_PUSH: {
+            size_t count = header.payloadBytes/sizeof(double);
+            const double * values = reinterpret_cast<const double *>(payload);
+            /* The payload is normally suitably aligned to be read as doubles in place. If it
+             * is not, it is copied into aligned scratch storage first.
+             */
+            if(reinterpret_cast<std::uintptr_t>(payload) % alignof(double) != 0){
+                alignedValues.resize(count);
+                std::memcpy(alignedValues.data(), payload, header.payloadBytes);
+                values = alignedValues.data();
+            }
+            StatsCalculator * calculator = createDataset(header.dataset);
+            if(calculator == 0){
+                StatsServerError error;
+                error.status = STATSCALC_LIMIT_REACHED;
+                error.reserved = 0;
+                return queueMessage(connection, STATSSERVER_ERROR, header.dataset, header.sequence, &error, sizeof(error));
+            }
+            calculator->appendValues(values, count);
+            return true;
+        }
+        case STATSSERVER_QUERY: {
+            const StatsResult & statistics = findDataset(header.dataset).getStatistics();
+            return queueMessage(connection, STATSSERVER_STATS, header.dataset, header.sequence, &statistics, sizeof(statistics));
+        }
+        case STATSSERVER_SUBSCRIBE: {
+            if(header.payloadBytes != sizeof(StatsServerSubscription)){
+                return false;
+            }
+            StatsServerSubscription request;
+            std::memcpy(&request, payload, sizeof(request));
+            /* Find any existing subscription to the same dataset. The search is linear, but
+             * there are at most statsServerMaxSubscriptions subscriptions to search.
+             */
+            size_t index = 0;
+            while(index < connection.subscriptions.size() && connection.subscriptions[index].dataset != header.dataset){
+                ++index;
+            }
+            // An interval of zero cancels the subscription, if there is one.
+            if(request.intervalMilliseconds == 0){
+                if(index < connection.subscriptions.size()){
+                    connection.subscriptions.erase(connection.subscriptions.begin() + index);
+                }
+                return true;
+            }
+            /* A new subscription is refused if the dataset does not exist (a client should
+             * subscribe after the first PUSH), or if the client already has as many as it may.
+             */
+            if(index == connection.subscriptions.size()){
+                StatsServerError error;
+                error.reserved = 0;
+                if(datasets.find(header.dataset) == datasets.end()){
+                    error.status = STATSCALC_NO_DATA;
+                    return queueMessage(connection, STATSSERVER_ERROR, header.dataset, header.sequence, &error, sizeof(error));
+                }
+                if(connection.subscriptions.size() >= statsServerMaxSubscriptions){
+                    error.status = STATSCALC_LIMIT_REACHED;
+                    return queueMessage(connection, STATSSERVER_ERROR, header.dataset, header.sequence, &error, sizeof(error));
+                }
+                connection.subscriptions.push_back(Subscription());
+            }
+            // Create the subscription, or replace the existing one.
+            Subscription & subscription = connection.subscriptions[index];
+            subscription.dataset = header.dataset;
+            subscription.sequence = header.sequence;
+            subscription.interval = std::chrono::milliseconds(request.intervalMilliseconds);
+            subscription.nextUpdate = Clock::now();
+            return true;
+        }
+        case STATSSERVER_RESET: {
+            // Resetting a dataset that does not exist has no effect.
+            std::map<std::uint32_t, StatsCalculator>::iterator datasetPos = datasets.find(header.dataset);
+            if(datasetPos != datasets.end()){
+                datasetPos->second.reset();
+            }
+            return true;
+        }
+        default: {
+            StatsServerError error;
+            error.status = STATSCALC_UNSUPPORTED;
+            error.reserved = 0;
+            return queueMessage(connection, STATSSERVER_ERROR, header.dataset, header.sequence, &error, sizeof(error));
+        }
+    }
+}
+
+/** Private method that sends as much of a client's pending output as its socket
+ * accepts without blocking. If some output remains, the socket is registered
+ * for writability notifications so that the rest is sent when possible.
+ *
+ * \param clientSocket - The client's socket.
+ * \param connection - The client's state.
+ *
+ * \return False if the socket has failed.
+ */
+bool StatsServer::flushOutput(int clientSocket, Connection & connection){
+    std::vector<char> & output = connection.output;
+    size_t position = 0;
+    while(position < output.size()){
+        ssize_t sent = send(clientSocket, &output[position], output.size() - position, MSG_NOSIGNAL);
+        if(sent > 0){
+            position += static_cast<size_t>(sent);
+        }
+        else if(errno == EAGAIN || errno == EWOULDBLOCK){
+            break;
+        }
+        else if(errno != EINTR){
+            return false;
+        }
+    }
+    output.erase(output.begin(), output.begin() + position);
+
+    bool needToWrite = !output.empty();
+    if(needToWrite != connection.waitingToWrite){
+        epoll_event event;
+        event.events = needToWrite ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+        event.data.fd = clientSocket;
+        epoll_ctl(epollDescriptor, EPOLL_CTL_MOD, clientSocket, &event);
+        connection.waitingToWrite = needToWrite;
+    }
+    return true;
+}
+
+/** Private method that appends a message to a client's pending output.
+ *
+ * \param connection - The client's state.
+ * \param type - A value from StatsServerMessageType.
+ * \param dataset - The dataset to which the message refers.
+ * \param sequence - The sequence number of the request being answered.
+ * \param payload - The payload.
+ * \param payloadBytes - The size of the payload in bytes.
+ *
+ * \return False, and nothing is appended, if the pending output would exceed
+ * statsServerMaxPendingOutputBytes.
+ */
+bool StatsServer::queueMessage(Connection & connection, std::uint16_t type, std::uint32_t dataset,
+                               std::uint32_t sequence, const void * payload, std::uint32_t payloadBytes){
+    if(connection.output.size() + sizeof(StatsServerMessageHeader) + payloadBytes > statsServerMaxPendingOutputBytes){
+        return false;
+    }
+    StatsServerMessageHeader header;
+    header.payloadBytes = payloadBytes;
+    header.type = type;
+    header.reserved = 0;
+    header.dataset = dataset;
+    header.sequence = sequence;
+    const char * headerBytes = reinterpret_cast<const char *>(&header);
+    const char * payloadBytesPointer = static_cast<const char *>(payload);
+    connection.output.insert(connection.output.end(), headerBytes, headerBytes + sizeof(header));
+    connection.output.insert(connection.output.end(), payloadBytesPointer, payloadBytesPointer + payloadBytes);
+    return true;
+}
+
+/** Private method that queues every subscription update that is due, flushes
+ * the affected clients and computes how long the event loop may sleep. An
+ * update for a client whose pending output is already at its limit is skipped,
+ * since the next update will carry more recent statistics anyway.
+ *
+ * \return The number of milliseconds until the next update is due, or -1 if
+ * there are no subscriptions.
+ */
+int StatsServer::serviceSubscriptions(){
+    Clock::time_point now = Clock::now();
+    Clock::time_point nextDue = Clock::time_point::max();
+    std::vector<int> failed;
+
+    for(std::map<int, Connection>::iterator connectionPos = connections.begin();
+        connectionPos != connections.end();
+        ++connectionPos){
+        Connection & connection = connectionPos->second;
+        bool queued = false;
+        for(size_t index = 0; index < connection.subscriptions.size(); ++index){
+            Subscription & subscription = connection.subscriptions[index];
+            if(subscription.nextUpdate <= now){
+                const StatsResult & statistics = findDataset(subscription.dataset).getStatistics();
+                if(queueMessage(connection, STATSSERVER_STATS, subscription.dataset, subscription.sequence,
+                                &statistics, sizeof(statistics))){
+                    queued = true;
+                }
+                subscription.nextUpdate += subscription.interval;
+                // If the server has fallen behind, skip the missed updates.
+                if(subscription.nextUpdate <= now){
+                    subscription.nextUpdate = now + subscription.interval;
+                }
+            }
+            if(subscription.nextUpdate < nextDue){
+                nextDue = subscription.nextUpdate;
+            }
+        }
+        if(queued && !flushOutput(connectionPos->first, connection)){
+            failed.push_back(connectionPos->first);
+        }
+    }
+    for(size_t index = 0; index < failed.size(); ++index){
+        disconnect(failed[index]);
+    }
+
+    if(nextDue == Clock::time_point::max()){
+        return -1;
+    }
+    // Round up, so that the loop does not wake fractionally before the update is due.
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(nextDue - now).count()) + 1;
+}
+
+/** Private method that closes a client's socket and forgets the client. Closing
+ * the socket also removes it from the epoll instance.
+ *
+ * \param clientSocket - The client's socket.
+ */
+void StatsServer::disconnect(int clientSocket){
+    close(clientSocket);
+    connections.erase(clientSocket);
+}
+
+// PUBLIC METHODS OF STATSSERVER
+
+/** Default constructor for the StatsServer class.
+ */
+StatsServer::StatsServer() :
+listeningSocket(-1),
+epollDescriptor(-1),
+wakeDescriptor(-1),
+stopRequested(false){
+}
+
+/** Destructor for the StatsServer class, which closes every socket and removes
+ * the socket file.
+ */
+StatsServer::~StatsServer(){
+    while(!connections.empty()){
+        disconnect(connections.begin()->first);
+    }
+    if(listeningSocket >= 0){
+        close(listeningSocket);
+        unlink(socketPath.c_str());
+    }
+    if(epollDescriptor >= 0){
+        close(epollDescriptor);
+    }
+    if(wakeDescriptor >= 0){
+        close(wakeDescriptor);
+    }
+}
+
+/** Public method that creates the listening socket, the epoll instance and the
+ * eventfd through which stop() wakes the event loop.
+ *
+ * \param path - The file-system path at which to create the socket.
+ *
+ * \return True on success, otherwise false.
+ */
+bool StatsServer::start(const std::string & path){
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if(path.size() >= sizeof(address.sun_path)){
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    listeningSocket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(listeningSocket < 0){
+        return false;
+    }
+    unlink(path.c_str());
+    if(bind(listeningSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0
+       || listen(listeningSocket, 128) != 0){
+        close(listeningSocket);
+        listeningSocket = -1;
+        return false;
+    }
+    socketPath = path;
+
+    epollDescriptor = epoll_create1(EPOLL_CLOEXEC);
+    if(epollDescriptor < 0){
+        return false;
+    }
+    wakeDescriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(wakeDescriptor < 0){
+        return false;
+    }
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = wakeDescriptor;
+    if(epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, wakeDescriptor, &event) != 0){
+        return false;
+    }
+    event.data.fd = listeningSocket;
+    return epoll_ctl(epollDescriptor, EPOLL_CTL_ADD, listeningSocket, &event) == 0;
+}
+
+/** Public method that serves clients until stop() is called.
+ *
+ * Each iteration of the event loop waits (for no longer than the time until the
+ * next subscription update is due) for sockets to become ready, handles every
+ * ready socket, and then sends any subscription updates that are due.
+ */
+void StatsServer::run(){
+    const int maxEvents = 64;
+    epoll_event events[maxEvents];
+    int timeout = -1;
+
+    while(!stopRequested){
+        int readyCount = epoll_wait(epollDescriptor, events, maxEvents, timeout);
+        if(readyCount < 0 && errno != EINTR){
+            return;
+        }
+        for(int index = 0; index < readyCount; ++index){
+            int readySocket = events[index].data.fd;
+            if(readySocket == listeningSocket){
+                acceptConnections();
+                continue;
+            }
+            if(readySocket == wakeDescriptor){
+                // stop() was called. Drain the counter; the loop condition then ends the loop.
+                std::uint64_t wakeCount;
+                while(read(wakeDescriptor, &wakeCount, sizeof(wakeCount)) > 0){
+                }
+                continue;
+            }
+            std::map<int, Connection>::iterator connectionPos = connections.find(readySocket);
+            if(connectionPos == connections.end()){
+                continue;
+            }
+            bool healthy = (events[index].events & (EPOLLERR | EPOLLHUP)) == 0 || (events[index].events & EPOLLIN);
+            if(healthy && (events[index].events & EPOLLIN)){
+                healthy = readFromClient(readySocket, connectionPos->second);
+            }
+            if(healthy && (events[index].events & EPOLLOUT)){
+                healthy = flushOutput(readySocket, connectionPos->second);
+            }
+            if(!healthy){
+                disconnect(readySocket);
+            }
+        }
+        timeout = serviceSubscriptions();
+    }
+}
+
+/** Public method that makes run() return.
+ *
+ * The flag alone is not enough: a signal that arrives after run() has checked it,
+ * but before epoll_wait() blocks, would not interrupt the wait and would be lost.
+ * stop() therefore also writes to the eventfd in the epoll set, which makes a
+ * blocked epoll_wait() return, or keeps one that is about to block from doing so.
+ * Both operations are async-signal-safe.
+ */
+void StatsServer::stop(){
+    stopRequested = true;
+    if(wakeDescriptor >= 0){
+        std::uint64_t one = 1;
+        ssize_t written = write(wakeDescriptor, &one, sizeof(one));
+        // The write can only fail if the counter is about to overflow, in which case the loop is awake already.
+        (void)written;
+    }
+}
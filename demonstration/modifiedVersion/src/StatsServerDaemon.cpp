@@ -0,0 +1,69 @@
+/// \file StatsServerDaemon.cpp Entry point for the statistics server
+
+// The <csignal> header is included to stop the server cleanly on SIGINT and SIGTERM.
+#include <csignal>
+// The <iostream> header is included to enable textual terminal output.
+#include <iostream>
+
+/* Include StatsServer.h to provide the class definition of
+ * StatsServer.
+ */
+#include "StatsServer.h"
+
+/** A pointer to the running server, through which the signal handler asks it
+ * to stop.
+ */
+static StatsServer * runningServer = 0;
+
+/** Signal handler that asks the running server to stop. StatsServer::stop()
+ * wakes the event loop through a file descriptor, so the request is not lost even
+ * if the signal arrives just before the loop goes to sleep.
+ *
+ * \param signalNumber - The signal that was received (unused).
+ */
+static void stopServer(int signalNumber){
+    (void)signalNumber;
+    if(runningServer != 0){
+        runningServer->stop();
+    }
+}
+
+/** The main function is the entry point for the server. It listens on a Unix
+ * domain socket until it receives SIGINT (Ctrl-C) or SIGTERM.
+ *
+ * \param argc - The number of command line tokens including the executable name
+ * and command line arguments.
+ *
+ * \param argv - The \b first command line argument, available as argv[1], is the
+ * path at which to create the socket.
+ *
+ * \return The program returns zero on success and 1 if the socket could not be
+ * created or an incorrect number of command line arguments was provided.
+ */
+int main(int argc, char * argv[]){
+    if(argc != 2){
+        std::cout << "Required Syntax:\n\n"
+        << "./statsServer socketPath\n\n"
+        << "Argument Descriptions:\n\n"
+        << "socketPath - The path at which to create the Unix domain socket."
+        << std::endl;
+        return 1;
+    }
+
+    StatsServer server;
+    if(!server.start(argv[1])){
+        std::cout << "Could not listen on " << argv[1] << std::endl;
+        return 1;
+    }
+
+    runningServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+
+    std::cout << "Serving statistics on " << argv[1] << std::endl;
+    server.run();
+    std::cout << "Server stopped." << std::endl;
+
+    runningServer = 0;
+    return 0;
+}
@@ -0,0 +1,232 @@
+/// \file StatsServerLoadGenerator.cpp Throughput and latency benchmark client for the statistics server
+
+// The <algorithm> header is included to provide std::sort(...).
+#include <algorithm>
+// The <chrono> header is included to provide a high resolution clock for timing.
+#include <chrono>
+// The <cstdlib> header is included to provide the std::atoi(...) function.
+#include <cstdlib>
+// The <cstring> header is included to provide std::memcpy(...) and std::strncpy(...).
+#include <cstring>
+// The <iostream> header is included to enable textual terminal output.
+#include <iostream>
+// The <string> header is included to provide the STL std::string type.
+#include <string>
+// The <thread> header is included to run one client per thread.
+#include <thread>
+// The <vector> header is included to provide the STL std::vector type.
+#include <vector>
+
+// The <sys/socket.h> header provides the sockets interface.
+#include <sys/socket.h>
+// The <sys/un.h> header provides the Unix domain socket address structure.
+#include <sys/un.h>
+// The <unistd.h> header provides read(), write() and close().
+#include <unistd.h>
+
+/* Include StatsServerProtocol.h to provide the message definitions shared
+ * with the server.
+ */
+#include "StatsServerProtocol.h"
+
+/** The type of clock that is used for all timing measurements.
+ */
+typedef std::chrono::steady_clock BenchmarkClock;
+
+/** \struct ClientResult
+ * The measurements made by one client thread.
+ */
+struct ClientResult {
+    /// The time taken to push every batch, in seconds.
+    double pushSeconds;
+    /// The round-trip time of every query, in microseconds.
+    std::vector<double> queryMicroseconds;
+    /// False if the client could not talk to the server.
+    bool succeeded;
+};
+
+/** Connects to the server's Unix domain socket.
+ *
+ * \param path - The path of the socket.
+ *
+ * \return A connected (blocking) socket, or -1 on failure.
+ */
+static int connectToServer(const std::string & path){
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    int clientSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(clientSocket >= 0 && connect(clientSocket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0){
+        close(clientSocket);
+        return -1;
+    }
+    return clientSocket;
+}
+
+/** Writes every byte of a buffer to a socket.
+ *
+ * \return False if the socket failed.
+ */
+static bool writeAll(int clientSocket, const char * bytes, size_t count){
+    while(count > 0){
+        ssize_t sent = send(clientSocket, bytes, count, MSG_NOSIGNAL);
+        if(sent <= 0){
+            return false;
+        }
+        bytes += sent;
+        count -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+/** Reads exactly the requested number of bytes from a socket.
+ *
+ * \return False if the socket failed or was closed.
+ */
+static bool readAll(int clientSocket, char * bytes, size_t count){
+    while(count > 0){
+        ssize_t received = read(clientSocket, bytes, count);
+        if(received <= 0){
+            return false;
+        }
+        bytes += received;
+        count -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+/** Runs one client. It pushes batches of values into its own dataset (without
+ * waiting for replies, as a producer would), then issues queries one at a time
+ * and records the round-trip time of each.
+ *
+ * \param path - The path of the server's socket.
+ * \param dataset - The dataset this client uses.
+ * \param batchCount - The number of batches to push.
+ * \param batchSize - The number of values in each batch.
+ * \param queryCount - The number of queries to issue.
+ * \param result - Receives the measurements.
+ */
+static void runClient(const std::string & path, std::uint32_t dataset, int batchCount, int batchSize,
+                      int queryCount, ClientResult * result){
+    result->succeeded = false;
+    int clientSocket = connectToServer(path);
+    if(clientSocket < 0){
+        return;
+    }
+
+    // Build one PUSH message, which is then sent repeatedly.
+    StatsServerMessageHeader header;
+    header.payloadBytes = static_cast<std::uint32_t>(batchSize*sizeof(double));
+    header.type = STATSSERVER_PUSH;
+    header.reserved = 0;
+    header.dataset = dataset;
+    header.sequence = 0;
+    std::vector<char> pushMessage(sizeof(header) + header.payloadBytes);
+    std::memcpy(&pushMessage[0], &header, sizeof(header));
+    for(int index = 0; index < batchSize; ++index){
+        double value = static_cast<double>(index % 100);
+        std::memcpy(&pushMessage[sizeof(header) + index*sizeof(double)], &value, sizeof(value));
+    }
+
+    BenchmarkClock::time_point start = BenchmarkClock::now();
+    for(int batch = 0; batch < batchCount; ++batch){
+        if(!writeAll(clientSocket, &pushMessage[0], pushMessage.size())){
+            close(clientSocket);
+            return;
+        }
+    }
+
+    /* The first query's reply can only arrive once every push has been processed,
+     * so waiting for it completes the throughput measurement.
+     */
+    StatsServerMessageHeader query;
+    query.payloadBytes = 0;
+    query.type = STATSSERVER_QUERY;
+    query.reserved = 0;
+    query.dataset = dataset;
+    for(int queryIndex = 0; queryIndex <= queryCount; ++queryIndex){
+        query.sequence = static_cast<std::uint32_t>(queryIndex);
+        BenchmarkClock::time_point sent = BenchmarkClock::now();
+        StatsServerMessageHeader reply;
+        StatsResult statistics;
+        if(!writeAll(clientSocket, reinterpret_cast<const char *>(&query), sizeof(query))
+           || !readAll(clientSocket, reinterpret_cast<char *>(&reply), sizeof(reply))
+           || reply.payloadBytes != sizeof(statistics)
+           || !readAll(clientSocket, reinterpret_cast<char *>(&statistics), sizeof(statistics))){
+            close(clientSocket);
+            return;
+        }
+        BenchmarkClock::time_point received = BenchmarkClock::now();
+        if(queryIndex == 0){
+            result->pushSeconds = std::chrono::duration<double>(received - start).count();
+        }
+        else{
+            result->queryMicroseconds.push_back(std::chrono::duration<double, std::micro>(received - sent).count());
+        }
+    }
+
+    close(clientSocket);
+    result->succeeded = true;
+}
+
+/** The main function is the entry point for the load generator. It starts the
+ * requested number of clients, each in its own thread, and reports the combined
+ * push throughput and the distribution of query latencies.
+ *
+ * \param argc - The number of command line tokens including the executable name
+ * and command line arguments.
+ *
+ * \param argv - argv[1] is the path of the server's socket. The optional argv[2]
+ * to argv[5] are the number of clients (default 4), the number of batches each
+ * client pushes (default 10000), the number of values in each batch (default 256)
+ * and the number of queries each client issues (default 1000).
+ *
+ * \return The program returns zero on success and 1 on failure or if an incorrect
+ * number of command line arguments was provided.
+ */
+int main(int argc, char * argv[]){
+    if(argc < 2){
+        std::cout << "Required Syntax:\n\n"
+        << "./statsServerLoadGenerator socketPath [clients] [batches] [batchSize] [queries]"
+        << std::endl;
+        return 1;
+    }
+    std::string path(argv[1]);
+    int clientCount = argc > 2 ? std::atoi(argv[2]) : 4;
+    int batchCount = argc > 3 ? std::atoi(argv[3]) : 10000;
+    int batchSize = argc > 4 ? std::atoi(argv[4]) : 256;
+    int queryCount = argc > 5 ? std::atoi(argv[5]) : 1000;
+
+    std::vector<ClientResult> results(clientCount);
+    std::vector<std::thread> clients;
+    for(int client = 0; client < clientCount; ++client){
+        clients.push_back(std::thread(runClient, path, static_cast<std::uint32_t>(client),
+                                      batchCount, batchSize, queryCount, &results[client]));
+    }
+    for(int client = 0; client < clientCount; ++client){
+        clients[client].join();
+    }
+
+    double slowestPush = 0.0;
+    std::vector<double> latencies;
+    for(int client = 0; client < clientCount; ++client){
+        if(!results[client].succeeded){
+            std::cout << "Client " << client << " could not talk to the server at " << path << std::endl;
+            return 1;
+        }
+        slowestPush = std::max(slowestPush, results[client].pushSeconds);
+        latencies.insert(latencies.end(), results[client].queryMicroseconds.begin(), results[client].queryMicroseconds.end());
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    double totalValues = static_cast<double>(clientCount)*batchCount*batchSize;
+    std::cout << clientCount << " clients, " << batchCount << " batches of " << batchSize << " values each\n"
+    << "Push throughput : " << clientCount*batchCount/slowestPush << " batches/s, "
+    << totalValues/slowestPush/1e6 << " million values/s\n";
+    if(!latencies.empty()){
+        std::cout << "Query latency   : median " << latencies[latencies.size()/2] << " us, "
+        << "99th percentile " << latencies[latencies.size()*99/100] << " us" << std::endl;
+    }
+    return 0;
+}
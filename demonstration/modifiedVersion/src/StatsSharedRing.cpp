@@ -0,0 +1,343 @@
+// IMPLEMENTATION file for StatsSharedRing class
+
+/* The "StatsSharedRing.h" header is included to provide a definition of the
+ * StatsSharedRing class.
+ */
+#include "StatsSharedRing.h"
+
+// The implementation uses POSIX functions and is not available on Windows.
+#ifndef _WIN32
+
+// POSIX HEADER FILES
+
+// The <errno.h> header provides errno and the EEXIST error code.
+#include <errno.h>
+// The <fcntl.h> header provides the O_CREAT and O_RDWR flags.
+#include <fcntl.h>
+// The <sys/mman.h> header provides shm_open(), shm_unlink(), mmap() and munmap().
+#include <sys/mman.h>
+// The <sys/stat.h> header provides fstat().
+#include <sys/stat.h>
+// The <unistd.h> header provides ftruncate() and close().
+#include <unistd.h>
+
+// STL HEADER FILES
+
+// The <algorithm> header provides std::copy().
+#include <algorithm>
+// The <limits> header provides std::numeric_limits, used to bound the capacity.
+#include <limits>
+// The <new> header provides "placement" new, used to construct the header in place.
+#include <new>
+
+/** The value stored in StatsSharedRingHeader::magic once a segment has been
+ * initialized. A segment that does not contain it is not (yet) a valid ring.
+ */
+static const std::uint64_t sharedRingMagic = 0x5354415452494E47ULL;
+
+/* The indices in the header are shared between processes, which is only
+ * possible if the atomic operations on them are implemented with processor
+ * instructions rather than with a (process-local) lock.
+ */
+#if ATOMIC_LLONG_LOCK_FREE != 2
+#error "StatsSharedRing requires lock-free 64-bit atomic operations."
+#endif
+
+// PRIVATE METHODS OF STATSSHAREDRING
+
+/** Private method that maps the whole of an open shared memory segment into
+ * this process and closes the file descriptor, which is no longer needed once
+ * the mapping exists.
+ *
+ * \param fileDescriptor - A descriptor returned by shm_open().
+ * \param bytes - The size of the segment in bytes.
+ *
+ * \return True on success, otherwise false.
+ */
+bool StatsSharedRing::mapSegment(int fileDescriptor, size_t bytes){
+    void * address = mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+    ::close(fileDescriptor);
+    if(address == MAP_FAILED){
+        return false;
+    }
+    header = static_cast<StatsSharedRingHeader *>(address);
+    ringValues = reinterpret_cast<double *>(header + 1);
+    mappedBytes = bytes;
+    return true;
+}
+
+// PUBLIC METHODS OF STATSSHAREDRING
+
+/** Default constructor for the StatsSharedRing class. The instance is not
+ * attached to any segment.
+ */
+StatsSharedRing::StatsSharedRing() :
+header(0),
+ringValues(0),
+mappedBytes(0),
+ringCapacity(0),
+ownsSegment(false),
+cachedReadIndex(0),
+cachedWriteIndex(0){
+}
+
+/** Destructor for the StatsSharedRing class, which detaches from the segment.
+ */
+StatsSharedRing::~StatsSharedRing(){
+    close();
+}
+
+/** Public method that creates a new shared memory segment containing an empty
+ * ring buffer.
+ *
+ * The segment is created with shm_open() and sized with ftruncate(), which fills
+ * it with zeros. The header is then constructed in place. The magic value is
+ * stored LAST, with release ordering, so that a process that observes it (with
+ * acquire ordering) in open() is guaranteed to see a fully initialized header.
+ *
+ * The segment is opened with O_EXCL, so a segment with the same name that
+ * another producer or consumer may still be using is never taken over. Only if
+ * "replaceExisting" is true is an existing segment unlinked first. Processes
+ * attached to it keep their mappings, but are no longer connected to the new ring.
+ *
+ * \param name - The name of the segment, which should begin with a "/".
+ * \param capacity - The minimum number of values the ring must hold.
+ * \param replaceExisting - True to replace a segment that already has the name.
+ *
+ * \return True on success, otherwise false.
+ */
+bool StatsSharedRing::create(const std::string & name, size_t capacity, bool replaceExisting){
+    close();
+
+    /* Round the capacity up to a power of two, so that positions can be found with a mask.
+     * A capacity whose rounded size in bytes cannot be represented is rejected, which also
+     * keeps the loop from shifting the bit out and never terminating.
+     */
+    const size_t maximumCapacity = (std::numeric_limits<size_t>::max() - sizeof(StatsSharedRingHeader))/sizeof(double);
+    size_t roundedCapacity = 1;
+    while(roundedCapacity < capacity){
+        if(roundedCapacity > maximumCapacity/2){
+            return false;
+        }
+        roundedCapacity <<= 1;
+    }
+
+    if(replaceExisting){
+        shm_unlink(name.c_str());
+    }
+    int fileDescriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if(fileDescriptor < 0){
+        // EEXIST means that the name is in use, and the segment is left untouched.
+        return false;
+    }
+    size_t bytes = sizeof(StatsSharedRingHeader) + roundedCapacity*sizeof(double);
+    if(ftruncate(fileDescriptor, static_cast<off_t>(bytes)) != 0){
+        ::close(fileDescriptor);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    if(!mapSegment(fileDescriptor, bytes)){
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    segmentName = name;
+    ownsSegment = true;
+    new (header) StatsSharedRingHeader();
+    header->capacity = roundedCapacity;
+    ringCapacity = roundedCapacity;
+    header->writeIndex.store(0, std::memory_order_relaxed);
+    header->readIndex.store(0, std::memory_order_relaxed);
+    header->producerClosed.store(0, std::memory_order_relaxed);
+    header->magic.store(sharedRingMagic, std::memory_order_release);
+    return true;
+}
+
+/** Public method that attaches to a segment created by another process.
+ *
+ * \param name - The name that was passed to create().
+ *
+ * \return True on success, otherwise false.
+ */
+bool StatsSharedRing::open(const std::string & name){
+    close();
+
+    int fileDescriptor = shm_open(name.c_str(), O_RDWR, 0600);
+    if(fileDescriptor < 0){
+        return false;
+    }
+    struct stat status;
+    if(fstat(fileDescriptor, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(StatsSharedRingHeader)){
+        ::close(fileDescriptor);
+        return false;
+    }
+    if(!mapSegment(fileDescriptor, static_cast<size_t>(status.st_size))){
+        return false;
+    }
+
+    /* Reject a segment that is not yet initialized, or whose declared capacity is not a
+     * power of two (positions are found with a mask of capacity - 1) or does not fit in
+     * the segment. The size is compared by division, so a corrupt capacity cannot overflow.
+     */
+    std::uint64_t declaredCapacity = header->magic.load(std::memory_order_acquire) == sharedRingMagic ? header->capacity : 0;
+    if(declaredCapacity == 0
+       || (declaredCapacity & (declaredCapacity - 1)) != 0
+       || declaredCapacity > (mappedBytes - sizeof(StatsSharedRingHeader))/sizeof(double)){
+        close();
+        return false;
+    }
+    segmentName = name;
+    ringCapacity = declaredCapacity;
+    cachedReadIndex = header->readIndex.load(std::memory_order_acquire);
+    cachedWriteIndex = header->writeIndex.load(std::memory_order_acquire);
+    return true;
+}
+
+/** Public method that detaches from the segment, removing it if this instance
+ * created it. Processes that are still attached keep their mappings until they
+ * detach.
+ */
+void StatsSharedRing::close(){
+    if(header != 0){
+        munmap(header, mappedBytes);
+        if(ownsSegment){
+            shm_unlink(segmentName.c_str());
+        }
+    }
+    header = 0;
+    ringValues = 0;
+    mappedBytes = 0;
+    ringCapacity = 0;
+    ownsSegment = false;
+    cachedReadIndex = 0;
+    cachedWriteIndex = 0;
+    segmentName.clear();
+}
+
+/** Public method that returns the number of values the ring can hold.
+ */
+size_t StatsSharedRing::capacity() const{
+    return static_cast<size_t>(ringCapacity);
+}
+
+/** PRODUCER method that copies as many values as there is space for into the
+ * ring without blocking.
+ *
+ * The free space is computed from the producer's own index and its cached copy
+ * of the consumer's index. Only if that suggests there is too little space is
+ * the consumer's index re-read. A consumer's index that is ahead of the write
+ * index would make the free space appear larger than the ring, so in that case
+ * nothing is written. The values are copied in at most two pieces
+ * (the ring may wrap around), and the new write index is then published with
+ * release ordering so that the consumer sees the values before the index.
+ *
+ * \param values - A pointer to the first element of an array of values.
+ * \param count - The number of elements in the array.
+ *
+ * \return The number of values written.
+ */
+size_t StatsSharedRing::write(const double * values, size_t count){
+    if(header == 0 || count == 0){
+        return 0;
+    }
+    const std::uint64_t writeIndex = header->writeIndex.load(std::memory_order_relaxed);
+
+    std::uint64_t used = writeIndex - cachedReadIndex;
+    if(used > ringCapacity || ringCapacity - used < count){
+        cachedReadIndex = header->readIndex.load(std::memory_order_acquire);
+        used = writeIndex - cachedReadIndex;
+    }
+    if(used > ringCapacity){
+        return 0;
+    }
+    std::uint64_t space = ringCapacity - used;
+    size_t toWrite = count < space ? count : static_cast<size_t>(space);
+    if(toWrite == 0){
+        return 0;
+    }
+
+    size_t position = static_cast<size_t>(writeIndex & (ringCapacity - 1));
+    size_t firstPiece = static_cast<size_t>(ringCapacity) - position;
+    if(firstPiece > toWrite){
+        firstPiece = toWrite;
+    }
+    std::copy(values, values + firstPiece, ringValues + position);
+    std::copy(values + firstPiece, values + toWrite, ringValues);
+
+    header->writeIndex.store(writeIndex + toWrite, std::memory_order_release);
+    return toWrite;
+}
+
+/** PRODUCER method that announces that no more values will be written.
+ */
+void StatsSharedRing::closeProducer(){
+    if(header != 0){
+        header->producerClosed.store(1, std::memory_order_release);
+    }
+}
+
+/** CONSUMER method that appends every value currently in the ring (up to a
+ * limit) to a StatsCalculator without blocking.
+ *
+ * A write index that claims more values than the ring can hold is corrupt, and
+ * nothing is consumed, since reading that many values would run past the end of
+ * the segment. Otherwise the available values occupy at most two contiguous
+ * pieces of the ring. Each
+ * piece is passed directly to StatsCalculator::appendValues(); when the
+ * calculator is streaming, this computes the statistics of the piece in place
+ * without copying the values at all. The new read index is then published with
+ * release ordering, which tells the producer the space may be reused.
+ *
+ * \param calculator - The StatsCalculator to which the values are appended.
+ * \param maxValues - The maximum number of values to consume.
+ *
+ * \return The number of values consumed.
+ */
+size_t StatsSharedRing::consumeInto(StatsCalculator & calculator, size_t maxValues){
+    if(header == 0){
+        return 0;
+    }
+    const std::uint64_t readIndex = header->readIndex.load(std::memory_order_relaxed);
+
+    std::uint64_t available = cachedWriteIndex - readIndex;
+    if(available == 0 || available > ringCapacity){
+        cachedWriteIndex = header->writeIndex.load(std::memory_order_acquire);
+        available = cachedWriteIndex - readIndex;
+    }
+    if(available > ringCapacity){
+        return 0;
+    }
+    size_t toRead = maxValues < available ? maxValues : static_cast<size_t>(available);
+    if(toRead == 0){
+        return 0;
+    }
+
+    size_t position = static_cast<size_t>(readIndex & (ringCapacity - 1));
+    size_t firstPiece = static_cast<size_t>(ringCapacity) - position;
+    if(firstPiece > toRead){
+        firstPiece = toRead;
+    }
+    calculator.appendValues(ringValues + position, firstPiece);
+    calculator.appendValues(ringValues, toRead - firstPiece);
+
+    header->readIndex.store(readIndex + toRead, std::memory_order_release);
+    return toRead;
+}
+
+/** CONSUMER method that returns true once the producer has closed the ring and
+ * every value it wrote has been consumed.
+ *
+ * The closed flag is read BEFORE the write index, so that values written just
+ * before the producer closed the ring are never overlooked.
+ */
+bool StatsSharedRing::finished() const{
+    if(header == 0){
+        return true;
+    }
+    if(header->producerClosed.load(std::memory_order_acquire) == 0){
+        return false;
+    }
+    return header->writeIndex.load(std::memory_order_acquire) == header->readIndex.load(std::memory_order_relaxed);
+}
+
+#endif // _WIN32 was not defined
@@ -0,0 +1,139 @@
+/// \file StatsSharedRingExample.cpp Example producer and consumer for StatsSharedRing
+
+// The <chrono> header is included to provide durations for sleeping.
+#include <chrono>
+// The <cstdlib> header is included to provide the std::atoll(...) function.
+#include <cstdlib>
+// The <iostream> header is included to enable textual terminal output.
+#include <iostream>
+// The <random> header is included to generate example values.
+#include <random>
+// The <string> header is included to provide the STL std::string type.
+#include <string>
+// The <thread> header is included to provide std::this_thread::sleep_for(...).
+#include <thread>
+// The <vector> header is included to provide the STL std::vector type.
+#include <vector>
+
+/* Include StatsSharedRing.h to provide the class definition of
+ * StatsSharedRing (and, indirectly, StatsCalculator).
+ */
+#include "StatsSharedRing.h"
+
+/** Runs the CONSUMER half of the example. It creates the ring, then repeatedly
+ * appends whatever the producer has written to a streaming StatsCalculator,
+ * printing the running statistics once per second until the producer closes
+ * the ring.
+ *
+ * \param ringName - The name of the shared memory segment to create.
+ *
+ * \return Zero on success, 1 if the ring could not be created.
+ */
+static int runConsumer(const std::string & ringName){
+    StatsSharedRing ring;
+    if(!ring.create(ringName, 1 << 20)){
+        std::cout << "Could not create shared memory ring " << ringName
+        << " (is another consumer already using the name?)" << std::endl;
+        return 1;
+    }
+    std::cout << "Created ring " << ringName << " holding " << ring.capacity()
+    << " values. Waiting for a producer..." << std::endl;
+
+    // Stream the values, so that memory use does not grow with their number.
+    StatsCalculator statsCalculator;
+    statsCalculator.setStreaming(true);
+
+    std::chrono::steady_clock::time_point lastReport = std::chrono::steady_clock::now();
+    while(!ring.finished()){
+        if(ring.consumeInto(statsCalculator) == 0){
+            // The ring is empty, so give the producer a moment rather than spinning.
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        if(std::chrono::steady_clock::now() - lastReport > std::chrono::seconds(1)){
+            lastReport = std::chrono::steady_clock::now();
+            const StatsResult & statistics = statsCalculator.getStatistics();
+            std::cout << statistics.count << " values, mean = " << statistics.mean
+            << ", standard deviation = " << statistics.standardDeviation << std::endl;
+        }
+    }
+    statsCalculator.printStats();
+    return 0;
+}
+
+/** Runs the PRODUCER half of the example. It attaches to a ring created by a
+ * consumer and writes normally distributed values into it in blocks, waiting
+ * whenever the ring is full.
+ *
+ * \param ringName - The name of the shared memory segment to attach to.
+ * \param valueCount - The number of values to write.
+ *
+ * \return Zero on success, 1 if the ring could not be opened.
+ */
+static int runProducer(const std::string & ringName, long long valueCount){
+    StatsSharedRing ring;
+    if(!ring.open(ringName)){
+        std::cout << "Could not open shared memory ring " << ringName
+        << ". Start the consumer first." << std::endl;
+        return 1;
+    }
+
+    // Generate values with mean 10 and standard deviation 2 in blocks of 4096.
+    std::mt19937_64 generator(12345);
+    std::normal_distribution<double> distribution(10.0, 2.0);
+    std::vector<double> block(4096);
+
+    long long written = 0;
+    while(written < valueCount){
+        size_t blockSize = block.size();
+        if(valueCount - written < static_cast<long long>(blockSize)){
+            blockSize = static_cast<size_t>(valueCount - written);
+        }
+        for(size_t index = 0; index < blockSize; ++index){
+            block[index] = distribution(generator);
+        }
+        // Write the block, retrying for as long as the ring is full.
+        size_t blockWritten = 0;
+        while(blockWritten < blockSize){
+            size_t justWritten = ring.write(&block[blockWritten], blockSize - blockWritten);
+            if(justWritten == 0){
+                std::this_thread::yield();
+            }
+            blockWritten += justWritten;
+        }
+        written += blockSize;
+    }
+    ring.closeProducer();
+    std::cout << "Wrote " << written << " values to " << ringName << std::endl;
+    return 0;
+}
+
+/** The main function is the entry point for the example program, which is run
+ * twice: once as the consumer and once (in another terminal) as the producer.
+ *
+ * \param argc - The number of command line tokens including the executable name
+ * and command line arguments.
+ *
+ * \param argv - The \b first command line argument, available as argv[1], is
+ * either "consume" or "produce". The \b second, available as argv[2], is the name
+ * of the shared memory segment (for example "/statsCalculatorRing"). When
+ * producing, the \b third, available as argv[3], is the number of values to write.
+ *
+ * \return The program returns zero on success and 1 on failure or if incorrect
+ * command line arguments were provided.
+ */
+int main(int argc, char * argv[]){
+    if(argc == 3 && std::string(argv[1]) == "consume"){
+        return runConsumer(argv[2]);
+    }
+    else if(argc == 4 && std::string(argv[1]) == "produce"){
+        return runProducer(argv[2], std::atoll(argv[3]));
+    }
+    else{ // Invalid arguments were provided.
+        std::cout << "Required Syntax:\n\n"
+        << "./statsSharedRingExample consume ringName\n"
+        << "./statsSharedRingExample produce ringName valueCount\n\n"
+        << "Start the consumer first, then run the producer in another terminal."
+        << std::endl;
+        return 1;
+    }
+}